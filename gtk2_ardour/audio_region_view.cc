@@ -1140,6 +1140,7 @@ AudioRegionView::delete_waves ()
 		delete *i;
 	}
 	_data_ready_connections.clear ();
+	_peak_range_connections.drop_connections ();
 
 	for (vector<ArdourWaveView::WaveView*>::iterator w = waves.begin(); w != waves.end(); ++w) {
 		group->remove(*w);
@@ -1174,6 +1175,7 @@ AudioRegionView::create_waves ()
 	}
 
 	_data_ready_connections.clear ();
+	_peak_range_connections.drop_connections ();
 
 	for (uint32_t i = 0; i < nchans.n_audio(); ++i) {
 		_data_ready_connections.push_back (0);
@@ -1196,6 +1198,9 @@ AudioRegionView::create_waves ()
 				// we'll get a PeaksReady signal from the source in the future
 				// and will call create_one_wave(n) then.
 				pending_peak_data->show ();
+				// the peakfile is built in chunks, the wave can be shown
+				// as soon as the ones covering this region are done.
+				audio_region()->audio_source(n)->PeakRangeReady.connect (_peak_range_connections, invalidator (*this), boost::bind (&AudioRegionView::peak_range_ready_handler, this, n), gui_context());
 			}
 
 		} else {
@@ -1299,6 +1304,7 @@ AudioRegionView::create_one_wave (uint32_t which, bool /*direct*/)
 
 		/* indicate peak-completed */
 		pending_peak_data->hide ();
+		_peak_range_connections.drop_connections ();
 
 		/* Restore stacked coverage */
 		LayerDisplay layer_display;
@@ -1319,6 +1325,19 @@ AudioRegionView::peaks_ready_handler (uint32_t which)
 	// cerr << "AudioRegionView::peaks_ready_handler() called on " << which << " this: " << this << endl;
 }
 
+void
+AudioRegionView::peak_range_ready_handler (uint32_t which)
+{
+	if (which >= _data_ready_connections.size() || !_data_ready_connections[which]) {
+		/* wave has been created already */
+		return;
+	}
+
+	if (audio_region()->audio_source(which)->peaks_ready_for (_region->start(), _region->length())) {
+		create_one_wave (which, false);
+	}
+}
+
 void
 AudioRegionView::add_gain_point_event (ArdourCanvas::Item *item, GdkEvent *ev, bool with_guard_points)
 {
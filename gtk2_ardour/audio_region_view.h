@@ -193,6 +193,7 @@ protected:
 
 	void create_one_wave (uint32_t, bool);
 	void peaks_ready_handler (uint32_t);
+	void peak_range_ready_handler (uint32_t);
 
 	void set_colors ();
 	void set_waveform_colors ();
@@ -217,6 +218,9 @@ private:
 	 */
 	std::vector<PBD::ScopedConnection*> _data_ready_connections;
 
+	/** PeakRangeReady connections of sources whose peakfile is being built */
+	PBD::ScopedConnectionList _peak_range_connections;
+
 	/** RegionViews that we hid the xfades for at the start of the current drag;
 	 *  first list is for start xfades, second list is for end xfades.
 	 */
@@ -4305,6 +4305,8 @@ Editor::cut_copy_points (Editing::CutCopyOp op, Temporal::Beats earliest, bool m
 		*/
 		for (Lists::iterator i = lists.begin(); i != lists.end(); ++i) {
 			i->second.copy = i->first->create (i->first->parameter (), i->first->descriptor());
+			/* points are added in bulk, publish the copy once */
+			i->second.copy->freeze ();
 		}
 
 		/* Add all selected points to the relevant copy ControlLists */
@@ -4347,6 +4349,8 @@ Editor::cut_copy_points (Editing::CutCopyOp op, Temporal::Beats earliest, bool m
 				(*ctrl_evt)->when -= line_offset;
 			}
 
+			al_cpy->thaw ();
+
 			/* And add it to the cut buffer */
 			cut_buffer->add (al_cpy);
 		}
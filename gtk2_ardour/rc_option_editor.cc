@@ -2152,6 +2152,21 @@ RCOptionEditor::RCOptionEditor ()
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("General"), procs);
+
+		ComboOption<GraphScheduler>* gs = new ComboOption<GraphScheduler> (
+				"graph-scheduler",
+				_("Parallel process scheduling"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_scheduler),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_scheduler)
+				);
+
+		gs->add (SharedQueueScheduler, _("shared queue"));
+		gs->add (WorkStealingScheduler, _("per-thread queues with work stealing"));
+
+		Gtkmm2ext::UI::instance()->set_tip (gs->tip_widget(),
+				_("With many routes and many processors, per-thread queues avoid contention between the processing threads. The setting takes effect on the next process cycle."));
+
+		add_option (_("General"), gs);
 	}
 
 	/* Image cache size */
@@ -2786,6 +2801,35 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("Audio"), new BufferingOptions (_rc_config));
 
+	ComboOption<uint32_t>* bio = new ComboOption<uint32_t> (
+			"butler-io-threads",
+			_("Disk I/O threads"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_butler_io_threads),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_butler_io_threads)
+			);
+
+	bio->add (1, _("1 (butler thread only)"));
+	bio->add (2, "2");
+	bio->add (4, "4");
+	bio->add (8, "8");
+	bio->add (16, "16");
+
+	Gtkmm2ext::UI::instance()->set_tip (bio->tip_widget(),
+			_("Number of threads that read and write track data. With many tracks on fast storage, more threads keep more requests in flight, so that buffers refill faster after a locate."));
+	bio->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
+
+	add_option (_("Audio"), bio);
+
+	bo = new BoolOption (
+			"async-disk-reads",
+			_("Batch disk reads asynchronously"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_async_disk_reads),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_async_disk_reads)
+			);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, the reads of all tracks that need more data are submitted to the operating system as one batch (using io_uring or POSIX AIO, where available), before the data is decoded. This helps with many tracks on storage that handles many concurrent requests well (SSD, RAID)."));
+	add_option (_("Audio"), bo);
+
 	add_option (_("Audio"), new OptionEditorHeading (_("Denormals")));
 
 	add_option (_("Audio"),
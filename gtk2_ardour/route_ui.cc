@@ -162,6 +162,7 @@ RouteUI::init ()
 	_solo_release = 0;
 	_mute_release = 0;
 	denormal_menu_item = 0;
+	pipeline_menu_item = 0;
 	step_edit_item = 0;
 	rec_safe_item = 0;
 	multiple_mute_change = false;
@@ -253,6 +254,7 @@ RouteUI::reset ()
 	_color_picker.reset ();
 
 	denormal_menu_item = 0;
+	pipeline_menu_item = 0;
 }
 
 void
@@ -1841,6 +1843,23 @@ RouteUI::toggle_denormal_protection ()
 	}
 }
 
+void
+RouteUI::toggle_pipelined ()
+{
+	if (pipeline_menu_item) {
+
+		bool x;
+
+		ENSURE_GUI_THREAD (*this, &RouteUI::toggle_pipelined)
+
+		if ((x = pipeline_menu_item->get_active()) != _route->pipelined()) {
+			if (!_route->set_pipelined (x)) {
+				pipeline_menu_item->set_active (_route->pipelined());
+			}
+		}
+	}
+}
+
 void
 RouteUI::denormal_protection_changed ()
 {
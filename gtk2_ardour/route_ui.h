@@ -236,6 +236,9 @@ public:
 	void toggle_denormal_protection();
 	virtual void denormal_protection_changed ();
 
+	Gtk::CheckMenuItem *pipeline_menu_item;
+	void toggle_pipelined ();
+
 	void disconnect_input ();
 	void disconnect_output ();
 
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_async_read_h__
+#define __ardour_async_read_h__
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "ardour/libardour_visibility.h"
+
+struct io_uring;
+
+namespace ARDOUR {
+
+/** A batch of file reads that are submitted to the kernel at once.
+ *
+ * This is used to prefetch the data that a butler refill pass is going
+ * to read: all reads of the pass are queued (see AudioFileSource::prefetch),
+ * submitted as one batch and waited for. The following (blocking) reads by
+ * libsndfile are then satisfied from the page-cache.
+ *
+ * The data itself is discarded, all requests share one scratch buffer.
+ *
+ * Backends, in order of preference: io_uring (if built with liburing),
+ * POSIX AIO (lio_listio), plain pread().
+ */
+class LIBARDOUR_API AsyncReadBatch
+{
+public:
+	AsyncReadBatch ();
+	~AsyncReadBatch ();
+
+	/** queue a read of @param len bytes at byte-offset @param offset of file-descriptor @param fd */
+	void add (int fd, int64_t offset, size_t len);
+
+	/** submit all queued requests and wait for them to complete.
+	 * The queue is cleared afterwards.
+	 * @return number of requests that failed
+	 */
+	int submit ();
+
+	size_t size () const { return _requests.size (); }
+	bool empty () const { return _requests.empty (); }
+	void clear () { _requests.clear (); }
+
+	/** name of the backend that submit() uses */
+	std::string backend_name () const;
+
+	/** force the pread() fallback (e.g. for benchmarking) */
+	void set_synchronous (bool yn) { _synchronous = yn; }
+
+	/** max bytes per request, larger reads are split */
+	static const size_t max_request_size = 4 * 1048576;
+
+private:
+	AsyncReadBatch (AsyncReadBatch const&);
+	AsyncReadBatch& operator= (AsyncReadBatch const&);
+
+	struct Request {
+		Request (int f, int64_t o, size_t l) : fd (f), offset (o), len (l) {}
+		int     fd;
+		int64_t offset;
+		size_t  len;
+	};
+
+	std::vector<Request> _requests;
+	char*                _scratch;
+	bool                 _synchronous;
+
+	int submit_sync ();
+	int submit_aio ();
+	int submit_uring ();
+
+	/* only used if built with liburing */
+	struct io_uring* _ring;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_async_read_h__ */
@@ -54,11 +54,27 @@ protected:
 	/* special access for PortManager only (hah, C++) */
 	Sample* engine_get_whole_audio_buffer ();
 
+	/** The backend port that is the only connection of this input,
+	 * if that one is not ours; 0 otherwise. Input ports with the same
+	 * external source receive the same data.
+	 * Set from the connection callback, read by the process thread.
+	 */
+	PortEngine::PortHandle external_source () const { return g_atomic_pointer_get (&_external_source); }
+	void set_external_source (PortEngine::PortHandle ph) { g_atomic_pointer_set (&_external_source, ph); }
+
+	/** Start a cycle by copying the already resampled data of @a other,
+	 * which has the same external source, instead of resampling again.
+	 */
+	void cycle_start_from (pframes_t, AudioPort const& other);
+
 private:
 	AudioBuffer*            _buffer;
 	ArdourZita::VMResampler _src;
 	Sample*                 _data;
 	bool                    _buf_valid;
+	bool                    _src_reset_pending;
+
+	volatile gpointer       _external_source;
 };
 
 } // namespace ARDOUR
@@ -27,6 +27,8 @@
 
 namespace ARDOUR {
 
+class AsyncReadBatch;
+
 struct LIBARDOUR_API SoundFileInfo {
 	float       samplerate;
 	uint16_t    channels;
@@ -60,6 +62,12 @@ public:
 	virtual int update_header (samplepos_t when, struct tm&, time_t) = 0;
 	virtual int flush_header () = 0;
 
+	/** Queue a read of the file-data for @param cnt samples at @param start
+	 * so that a following read() of the range is served from the page-cache.
+	 * @return false if the source does not support prefetching.
+	 */
+	virtual bool prefetch (AsyncReadBatch&, samplepos_t /*start*/, samplecnt_t /*cnt*/) const { return false; }
+
 	void mark_streaming_write_completed (const Lock& lock);
 
 	int setup_peakfile ();
@@ -29,6 +29,7 @@
 namespace ARDOUR  {
 
 class Session;
+class AsyncReadBatch;
 class AudioRegion;
 class Source;
 class AudioPlaylist;
@@ -42,6 +43,7 @@ public:
 	AudioPlaylist (boost::shared_ptr<const AudioPlaylist>, samplepos_t start, samplecnt_t cnt, std::string name, bool hidden = false);
 
 	samplecnt_t read (Sample *dst, Sample *mixdown, float *gain_buffer, samplepos_t start, samplecnt_t cnt, uint32_t chan_n=0);
+	uint32_t prefetch (AsyncReadBatch&, samplepos_t start, samplecnt_t cnt, uint32_t chan_n=0);
 
 	bool destroy_region (boost::shared_ptr<Region>);
 
@@ -57,6 +59,14 @@ private:
 	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 	void source_offset_changed (boost::shared_ptr<AudioRegion>);
         void load_legacy_crossfades (const XMLNode&, int version);
+
+	class ReadPlan;
+	boost::shared_ptr<ReadPlan const> read_plan ();
+
+	/** the read plan of all regions, rebuilt when region_generation() changes */
+	boost::shared_ptr<ReadPlan const> _read_plan;
+	uint32_t                          _read_plan_generation;
+	Glib::Threads::Mutex              _read_plan_lock;
 };
 
 } /* namespace ARDOUR */
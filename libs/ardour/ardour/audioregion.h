@@ -57,6 +57,7 @@ class Playlist;
 class Session;
 class Filter;
 class AudioSource;
+class AsyncReadBatch;
 
 
 class LIBARDOUR_API AudioRegion : public Region
@@ -124,6 +125,8 @@ class LIBARDOUR_API AudioRegion : public Region
 
 	virtual samplecnt_t read_raw_internal (Sample*, samplepos_t, samplecnt_t, int channel) const;
 
+	bool prefetch (AsyncReadBatch&, samplepos_t position, samplecnt_t cnt, uint32_t chan_n = 0) const;
+
 	XMLNode& state ();
 	XMLNode& get_basic_state ();
 	int set_state (const XMLNode&, int version);
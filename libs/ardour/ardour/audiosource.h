@@ -25,6 +25,7 @@
 #include <boost/enable_shared_from_this.hpp>
 
 #include <time.h>
+#include <vector>
 
 #include <glibmm/threads.h>
 #include <boost/function.hpp>
@@ -32,12 +33,51 @@
 
 #include "ardour/source.h"
 #include "ardour/ardour.h"
+#include "ardour/filename_extensions.h"
 #include "ardour/readable.h"
 #include "pbd/stateful.h"
 #include "pbd/xml++.h"
 
 namespace ARDOUR {
 
+class AudioSource;
+
+/** Builds the peakfile of an AudioSource from scratch, in chunks.
+ *
+ * Chunks are independent (each one covers a whole number of peaks), so
+ * several threads can work on one job: the thread that started the build
+ * and any idle peakfile builder thread (see SourceFactory). Each chunk
+ * is written to its place in the peakfile as soon as it is done.
+ */
+class LIBARDOUR_API PeakBuildJob
+{
+  public:
+	PeakBuildJob (AudioSource&, int peakfile_fd, samplecnt_t chunk_size);
+
+	/** compute and write the next chunk that no thread has claimed yet.
+	 * @return false if there was none (or the job failed)
+	 */
+	bool process_one ();
+	/** wait until all claimed chunks are done */
+	void wait ();
+
+	bool failed () const;
+	samplecnt_t chunk_size () const { return _chunk_size; }
+	uint32_t n_chunks () const { return _n_chunks; }
+
+  private:
+	AudioSource& _source;
+	int          _fd;
+	samplecnt_t  _chunk_size;
+	uint32_t     _n_chunks;
+	uint32_t     _next;
+	uint32_t     _in_progress;
+	bool         _failed;
+
+	mutable Glib::Threads::Mutex _lock;
+	Glib::Threads::Cond          _idle;
+};
+
 class LIBARDOUR_API AudioSource : virtual public Source,
 		public ARDOUR::Readable,
 		public boost::enable_shared_from_this<ARDOUR::AudioSource>
@@ -73,6 +113,11 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	int  build_peaks ();
 	bool peaks_ready (boost::function<void()> callWhenReady, PBD::ScopedConnection** connection_created_if_not_ready, PBD::EventLoop* event_loop) const;
+	/** @return true if the peaks of the given range are available. While
+	 * a peakfile is being built, this may be true for parts of the source;
+	 * PeakRangeReady is emitted as more parts become ready.
+	 */
+	bool peaks_ready_for (samplepos_t start, samplecnt_t cnt) const;
 
 	mutable PBD::Signal0<void>  PeaksReady;
 	mutable PBD::Signal2<void,samplepos_t,samplepos_t>  PeakRangeReady;
@@ -98,6 +143,12 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	virtual int setup_peakfile () { return 0; }
 	int close_peakfile ();
 
+	/** Compute the coarser levels from the peakfile, and (atomically)
+	 * replace the peak levels file. Called by the peak-builder threads,
+	 * takes _lock only briefly.
+	 */
+	int build_peak_levels ();
+
 	int prepare_for_peakfile_writes ();
 	void done_with_peakfile_writes (bool done = true);
 
@@ -133,6 +184,13 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	bool force, bool intermediate_peaks_ready_signal);
 	void truncate_peakfile();
 
+	/** the file that a peakfile is built in, until it is complete */
+	std::string peak_build_path () const { return _peakpath + temp_suffix; }
+	/** the file that holds the coarser levels of the peakfile */
+	std::string peak_levels_path () const { return _peakpath + peakfile_levels_suffix; }
+	/** remove the coarser levels, they are rebuilt when needed. */
+	void drop_peak_levels ();
+
 	mutable off_t _peak_byte_max; // modified in compute_and_write_peak()
 
 	virtual samplecnt_t read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const = 0;
@@ -148,7 +206,17 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 				     samplecnt_t samples_per_peak);
 
   private:
+	friend class PeakBuildJob;
+	int build_peak_chunk (int fd, samplepos_t start, samplecnt_t cnt);
+
+	uint32_t peak_levels () const;
+	off_t peak_level_offset (uint32_t level) const;
+
 	bool _peaks_built;
+	/** chunks of a peakfile that is being built, protected by _peaks_ready_lock */
+	std::vector<bool> _peak_chunks_done;
+	samplecnt_t       _peak_chunk_size;
+
 	/** This mutex is used to protect both the _peaks_built
 	 *  variable and also the emission (and handling) of the
 	 *  PeaksReady signal.  Holding the lock when emitting
@@ -169,6 +237,13 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* number of levels in the peak levels file, valid if
+	 * _peak_levels_length == _length (0 while the file is being built).
+	 * protected by _lock
+	 */
+	mutable uint32_t    _n_peak_levels;
+	mutable samplecnt_t _peak_levels_length;
 };
 
 }
@@ -21,12 +21,14 @@
 #define __ardour_butler_h__
 
 #include <pthread.h>
+#include <vector>
 
 #include <glibmm/threads.h>
 
 #include "pbd/crossthread.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/pool.h"
+#include "pbd/semutils.h"
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/session_handle.h"
@@ -35,6 +37,9 @@
 
 namespace ARDOUR {
 
+class AsyncReadBatch;
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -93,6 +98,38 @@ private:
 
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
 
+	/* Config->get_async_disk_reads () */
+	void prefetch_tracks (RouteList const&);
+	AsyncReadBatch* _prefetch;
+
+	/* Optional pool of disk I/O threads (Config->get_butler_io_threads () > 1).
+	 *
+	 * The butler thread remains in charge: it collects the tracks that need
+	 * work, hands them to the pool, takes part in the work and waits for the
+	 * pool to finish before it continues. Pending transport work preempts
+	 * the pool: no new track is started once it is requested.
+	 */
+	enum IOJobType {
+		RefillJob,
+		FlushJob
+	};
+
+	void start_io_threads (uint32_t);
+	void stop_io_threads ();
+	static void* _io_thread_work (void*);
+	void io_thread_work ();
+	void process_io_jobs (Sample* mixdown_buffer, gain_t* gain_buffer);
+	bool run_io_jobs (IOJobType, RouteList const&, uint32_t& errors);
+
+	std::vector<pthread_t>                  _io_threads;
+	volatile gint                           _io_threads_active;
+	IOJobType                               _io_job_type;
+	std::vector<boost::shared_ptr<Track> >  _io_jobs;
+	std::vector<int>                        _io_results;
+	volatile gint                           _io_next_job;
+	PBD::Semaphore                          _io_start_sem;
+	PBD::Semaphore                          _io_done_sem;
+
 	/**
 	 * Add request to butler thread request queue
 	 */
@@ -28,6 +28,7 @@
 namespace ARDOUR
 {
 
+class AsyncReadBatch;
 class Playlist;
 class AudioPlaylist;
 class MidiPlaylist;
@@ -66,6 +67,22 @@ public:
 		return refill (_mixdown_buffer, _gain_buffer, 0);
 	}
 
+	/** For additional butler I/O threads, which provide their own working
+	 * buffers of (at least) working_buffer_size() samples.
+	 */
+	int do_refill (Sample* mixdown_buffer, gain_t* gain_buffer) {
+		return refill (mixdown_buffer, gain_buffer, 0);
+	}
+
+	static samplecnt_t working_buffer_size () { return 2*1048576; }
+
+	/** Queue the file-reads of the next do_refill() so that they can
+	 * be submitted together with those of other tracks.
+	 */
+	int prefetch (AsyncReadBatch& batch) {
+		return prefetch_audio (batch);
+	}
+
 	/** For non-butler contexts (allocates temporary working buffers)
 	 *
 	 * This accessible method has a default argument; derived classes
@@ -154,6 +171,8 @@ private:
 
 	int refill (Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level);
 	int refill_audio (Sample *mixdown_buffer, float *gain_buffer, samplecnt_t fill_level);
+	int prefetch_audio (AsyncReadBatch&);
+	samplecnt_t refill_chunk_size (samplecnt_t total_space) const;
 	int refill_midi ();
 
 	sampleoffset_t calculate_playback_distance (pframes_t);
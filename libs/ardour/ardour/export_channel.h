@@ -37,6 +37,7 @@ namespace ARDOUR {
 
 class Session;
 class AudioTrack;
+class AudioPlaylist;
 class AudioPort;
 class AudioRegion;
 class CapturingProcessor;
@@ -50,6 +51,15 @@ class LIBARDOUR_API ExportChannel : public boost::less_than_comparable<ExportCha
 
 	virtual void set_max_buffer_size(samplecnt_t) { }
 
+	/// Sets the position the next read() starts at, called before a timespan is exported
+	virtual void set_start (samplepos_t) { }
+
+	/** Returns an independent copy of this channel, which can be read outside
+	 *  of the engine's process cycle (see ExportHandler::do_raw_stem_export()).
+	 *  Channels that are fed by the engine return an empty pointer.
+	 */
+	virtual ExportChannelPtr offline_copy () const { return ExportChannelPtr (); }
+
 	virtual void read (Sample const *& data, samplecnt_t samples) const = 0;
 	virtual bool empty () const = 0;
 
@@ -93,6 +103,38 @@ class LIBARDOUR_API PortExportChannel : public ExportChannel
 };
 
 
+/** Export channel that reads one channel of a track's playlist (region gain,
+ *  envelopes and fades, but no route processing). It does not need the engine.
+ */
+class LIBARDOUR_API PlaylistExportChannel : public ExportChannel
+{
+  public:
+	PlaylistExportChannel ();
+	PlaylistExportChannel (boost::shared_ptr<AudioPlaylist> playlist, uint32_t channel);
+	~PlaylistExportChannel ();
+
+	void set_max_buffer_size(samplecnt_t samples);
+	void set_start (samplepos_t start) { _position = start; }
+	ExportChannelPtr offline_copy () const;
+
+	void read (Sample const *& data, samplecnt_t samples) const;
+	bool empty () const { return !_playlist; }
+
+	void get_state (XMLNode * node) const;
+	void set_state (XMLNode * node, Session & session);
+
+	bool operator< (ExportChannel const & other) const;
+
+  private:
+	boost::shared_ptr<AudioPlaylist> _playlist;
+	uint32_t                         _channel;
+	mutable samplepos_t              _position;
+	samplecnt_t                      _buffer_size;
+	boost::scoped_array<Sample>      _buffer;
+	boost::scoped_array<Sample>      _mixdown_buffer;
+	boost::scoped_array<gain_t>      _gain_buffer;
+};
+
 /// Handles RegionExportChannels and does actual reading from region
 class LIBARDOUR_API RegionExportChannelFactory
 {
@@ -42,7 +42,9 @@ namespace AudioGrapher {
 	template <typename T> class CmdPipeWriter;
 	template <typename T> class SilenceTrimmer;
 	template <typename T> class TmpFile;
+	template <typename T> class TmpMemory;
 	template <typename T> class Threader;
+	template <typename T> class AsyncThreader;
 	template <typename T> class AllocatingProcessContext;
 }
 
@@ -60,6 +62,7 @@ class LIBARDOUR_API ExportGraphBuilder
 	typedef boost::shared_ptr<AudioGrapher::Sink<Sample> > FloatSinkPtr;
 	typedef boost::shared_ptr<AudioGrapher::IdentityVertex<Sample> > IdentityVertexPtr;
 	typedef boost::shared_ptr<AudioGrapher::Analyser> AnalysisPtr;
+	typedef boost::shared_ptr<AudioGrapher::AsyncThreader<Sample> > AsyncThreaderPtr;
 	typedef std::map<ExportChannelPtr,  IdentityVertexPtr> ChannelMap;
 	typedef std::map<std::string, AnalysisPtr> AnalysisMap;
 
@@ -88,6 +91,9 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	void add_split_config (FileSpec const & config);
 
+	AsyncThreaderPtr add_async_threader (samplecnt_t max_samples);
+	void wait_for_async_threaders ();
+
 	class Encoder {
             public:
 		template <typename T> boost::shared_ptr<AudioGrapher::Sink<T> > init (FileSpec const & new_config);
@@ -140,6 +146,7 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef boost::shared_ptr<AudioGrapher::SampleFormatConverter<int> >   IntConverterPtr;
 		typedef boost::shared_ptr<AudioGrapher::SampleFormatConverter<short> > ShortConverterPtr;
 
+		ExportGraphBuilder & parent;
 		FileSpec           config;
 		boost::ptr_list<Encoder> children;
 		int                data_width;
@@ -151,6 +158,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		FloatConverterPtr float_converter;
 		IntConverterPtr int_converter;
 		ShortConverterPtr short_converter;
+		// Runs the converter and encoders in a thread of their own
+		AsyncThreaderPtr async_threader;
 	};
 
 	class Intermediate {
@@ -171,9 +180,32 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef boost::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::Normalizer> NormalizerPtr;
 		typedef boost::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
+		typedef boost::shared_ptr<AudioGrapher::TmpMemory<Sample> > TmpMemoryPtr;
 		typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
+		/** One normalization target. All targets of an Intermediate share
+		 *  the analysis and the stored render, see Target::operator==
+		 */
+		class Target {
+		  public:
+			Target (Intermediate & parent, FileSpec const & new_config);
+			void add_child (FileSpec const & new_config);
+			void remove_children (bool remove_out_files);
+			bool operator== (FileSpec const & other_config) const;
+
+			/// Sets the normalization gain from the analysis results
+			void set_peak ();
+
+			NormalizerPtr normalizer;
+
+		  private:
+			Intermediate &       parent;
+			FileSpec             config;
+			ThreaderPtr          threader;
+			boost::ptr_list<SFC> children;
+		};
+
 		void prepare_post_processing ();
 		void start_post_processing ();
 
@@ -185,11 +217,11 @@ class LIBARDOUR_API ExportGraphBuilder
 		bool            use_peak;
 		BufferPtr       buffer;
 		PeakReaderPtr   peak_reader;
+		// The render is kept in memory if it fits, in a file otherwise
 		TmpFilePtr      tmp_file;
-		NormalizerPtr   normalizer;
-		ThreaderPtr     threader;
+		TmpMemoryPtr    tmp_memory;
 		LoudnessReaderPtr    loudness_reader;
-		boost::ptr_list<SFC> children;
+		boost::ptr_list<Target> targets;
 
 		PBD::ScopedConnectionList post_processing_connection;
 	};
@@ -216,6 +248,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		boost::ptr_list<Intermediate> intermediate_children;
 		SRConverterPtr        converter;
 		samplecnt_t            max_samples_out;
+		// Decouples the converter from the render thread (non-realtime only)
+		AsyncThreaderPtr      async_threader;
 	};
 
 	// Silence trimmer + adder
@@ -271,10 +305,16 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	std::list<Intermediate *> intermediates;
 
+	// In order of creation, parents before their children
+	std::list<AsyncThreaderPtr> async_threaders;
+
 	AnalysisMap analysis_map;
 
 	bool _realtime;
 
+	// Bytes left for keeping intermediate renders in memory
+	samplecnt_t _memory_budget;
+
 	Glib::ThreadPool thread_pool;
 };
 
@@ -22,6 +22,9 @@
 #define __ardour_export_handler_h__
 
 #include <map>
+#include <vector>
+
+#include <glibmm/threads.h>
 
 #include <boost/operators.hpp>
 #include <boost/shared_ptr.hpp>
@@ -110,6 +113,18 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	                        BroadcastInfoPtr broadcast_info);
 	void do_export ();
 
+	/** @return true if all channels of all configurations can be
+	 *  read without the engine, see ExportChannel::offline_copy()
+	 */
+	bool raw_stem_export_possible () const;
+
+	/** Export raw stems (playlists without route processing) without
+	 *  freewheeling the engine. Every timespan and channel configuration
+	 *  is rendered by a thread of its own, while the session keeps running.
+	 *  Progress is reported via ExportStatus, just like with do_export().
+	 */
+	void do_raw_stem_export ();
+
 	std::string get_cd_marker_filename(std::string filename, CDMarkerFormat format);
 
 	/** signal emitted when soundcloud export reports progress updates during upload.
@@ -157,6 +172,25 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	PBD::ScopedConnection process_connection;
 	samplepos_t             process_position;
 
+	void finish_file (ExportTimespanPtr timespan, FileSpec const & spec);
+
+	/* Offline export */
+
+	struct OfflineJob {
+		ExportTimespanPtr      timespan;
+		ExportChannelConfigPtr channel_config;
+		std::list<FileSpec>    specs;
+	};
+
+	void offline_export_thread ();
+	void offline_export_worker ();
+	void render_offline (OfflineJob const & job);
+
+	std::vector<OfflineJob> offline_jobs;
+	gint                    offline_job_index;
+	Glib::Threads::Mutex    offline_lock; // protects export_status while rendering offline
+	Glib::Threads::Thread*  offline_thread;
+
 	/* CD Marker stuff */
 
 	struct CDMarkerStatus {
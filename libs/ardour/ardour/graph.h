@@ -31,6 +31,7 @@
 #include <glib.h>
 
 #include "pbd/semutils.h"
+#include "pbd/work_stealing_deque.h"
 
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
@@ -43,6 +44,7 @@ namespace ARDOUR
 class GraphNode;
 class Graph;
 
+class PipelineStageNode;
 class Route;
 class Session;
 class GraphEdges;
@@ -56,6 +58,7 @@ class LIBARDOUR_API Graph : public SessionHandleRef
 {
 public:
 	Graph (Session & session);
+	~Graph ();
 
 	void trigger (GraphNode * n);
 	void rechain (boost::shared_ptr<RouteList>, GraphEdges const &);
@@ -70,6 +73,7 @@ public:
 	int routes_no_roll (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool non_rt_pending );
 
 	void process_one_route (Route * route);
+	void process_one_pipeline_stage (Route * route);
 
 	void clear_other_chain ();
 
@@ -85,18 +89,45 @@ private:
 	void drop_threads ();
 	void restart_cycle();
 	bool run_one();
+	bool run_one_shared ();
+	bool run_one_ws ();
 	void main_thread();
 	void prep();
 
+	GraphNode* ws_find_work (uint32_t);
+	bool ws_work_available () const;
+	bool ws_cancel_sleep ();
+	void ws_wakeup (int);
+	void ws_drop_queues ();
+
 	node_list_t _nodes_rt[2];
 
 	node_list_t _init_trigger_list[2];
 
+	/** second stages of pipelined routes (also in _nodes_rt) */
+	std::vector<boost::shared_ptr<PipelineStageNode> > _pipeline_stages[2];
+
 	std::vector<GraphNode *> _trigger_queue;
 	pthread_mutex_t          _trigger_mutex;
 
 	PBD::Semaphore _execution_sem;
 
+	/* work-stealing scheduler (GraphScheduler == WorkStealingScheduler) */
+	typedef PBD::WorkStealingDeque<GraphNode> WSQueue;
+
+	/** one queue per process thread, indexed by thread-id */
+	std::vector<WSQueue*>    _ws_queues;
+	/** initial nodes of each chain, claimed lock-free at the start of a cycle */
+	std::vector<GraphNode *> _init_trigger_vec[2];
+	/** number of initial nodes of the current cycle that are yet to be claimed */
+	volatile gint _init_trigger_avail;
+	/** next thread-id to hand out to a helper thread */
+	volatile gint _ws_next_thread_id;
+	/** number of nodes that overflowed into _trigger_queue */
+	volatile gint _ws_overflow;
+	/** scheduler used for the current cycle, latched in prep() */
+	volatile bool _ws_active;
+
 	/** Signalled to start a run of the graph for a process callback */
 	PBD::Semaphore _callback_start_sem;
 	PBD::Semaphore _callback_done_sem;
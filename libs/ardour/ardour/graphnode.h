@@ -50,14 +50,15 @@ class LIBARDOUR_API GraphNode
 
 	virtual void process();
 
+    protected:
+	boost::shared_ptr<Graph> _graph;
+
     private:
 	friend class Graph;
 
 	/** Nodes that we directly feed */
 	node_set_t  _activation_set[2];
 
-	boost::shared_ptr<Graph> _graph;
-
 	gint _refcount;
 	/** The number of nodes that we directly feed us (one count for each chain) */
 	gint _init_refcount[2];
@@ -20,6 +20,10 @@
 #ifndef __ardour_internal_return_h__
 #define __ardour_internal_return_h__
 
+#include <list>
+#include <vector>
+
+#include "pbd/rcu.h"
 
 #include "ardour/ardour.h"
 #include "ardour/return.h"
@@ -33,24 +37,57 @@ class LIBARDOUR_API InternalReturn : public Return
 {
 public:
 	InternalReturn (Session&);
+	~InternalReturn ();
 
 	void run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample, double speed, pframes_t nframes, bool);
 	bool configure_io (ChanCount, ChanCount);
 	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
+	int  set_block_size (pframes_t);
 
 	void add_send (InternalSend *);
 	void remove_send (InternalSend *);
 
+	/** Add the output of a send to this return, called by the send from
+	 *  whichever graph thread runs it.
+	 */
+	void accumulate (BufferSet const&, pframes_t nframes);
+
 	void set_playback_offset (samplecnt_t cnt);
 
 protected:
 	XMLNode& state ();
 
 private:
+	typedef std::list<InternalSend*> SendList;
+
 	/** sends that we are receiving data from */
-	std::list<InternalSend*> _sends;
-	/** mutex to protect _sends */
-	Glib::Threads::Mutex _sends_mutex;
+	SerializedRCUManager<SendList> _sends;
+
+	/** A partial sum of the sends of the current cycle.
+	 *
+	 * Sends are summed into one of several lanes by the graph threads
+	 * that run them, so that buses with many sends are summed in parallel.
+	 * run() then only has to add up the lanes.
+	 */
+	struct Lane {
+		Lane () : lock (0), empty (true), cycle (0) {}
+
+		BufferSet bufs;
+		gint      lock;
+		bool      empty;
+		/** cycle that the sends in the lane belong to */
+		uint32_t  cycle;
+	};
+
+	std::vector<Lane*> _lanes;
+	gint               _next_lane;
+	uint32_t           _cycle;
+	/** last cycle for which run() summed the sends directly, bypassing the lanes */
+	uint32_t           _summed_cycle;
+
+	void allocate_lanes (ChanCount const&, pframes_t);
+	void drop_lanes ();
+	void cycle_start (pframes_t);
 };
 
 } // namespace ARDOUR
@@ -21,6 +21,7 @@
 #define __ardour_midi_cursor_h__
 
 #include <set>
+#include <vector>
 
 #include <boost/utility.hpp>
 
@@ -35,8 +36,17 @@
 
 namespace ARDOUR {
 
+class MidiPlaybackCache;
+
 struct MidiCursor : public boost::noncopyable {
-	MidiCursor() : last_read_end(0) {}
+	MidiCursor()
+		: last_read_end(0)
+		, tempo_generation(0)
+		, start_qn(0)
+		, index(0)
+		, played_from(0)
+		, resume_at(0)
+	{}
 
 	void connect(PBD::Signal1<void, bool>& invalidated) {
 		connections.drop_connections();
@@ -46,6 +56,11 @@ struct MidiCursor : public boost::noncopyable {
 
 	void invalidate(bool preserve_notes) {
 		iter.invalidate(preserve_notes ? &active_notes : NULL);
+		if (!preserve_notes) {
+			resume_at = 0;
+		} else if (last_read_end) {
+			resume_at = last_read_end;
+		}
 		last_read_end = 0;
 	}
 
@@ -53,6 +68,21 @@ struct MidiCursor : public boost::noncopyable {
 	std::set<Evoral::Sequence<Temporal::Beats>::WeakNotePtr> active_notes;
 	samplepos_t                                             last_read_end;
 	PBD::ScopedConnectionList                              connections;
+
+	/* State for reading from the source's MidiPlaybackCache */
+
+	/** The cache that samples were computed for */
+	boost::shared_ptr<const MidiPlaybackCache> cache;
+	/** Position of each event of the cache in session samples */
+	std::vector<samplepos_t>                  samples;
+	guint                                     tempo_generation;
+	double                                    start_qn;
+	/** Index of the next event to read */
+	size_t                                    index;
+	/** Notes that started before this have not been played */
+	samplepos_t                               played_from;
+	/** Where reading stopped when the cursor was invalidated with notes preserved */
+	samplepos_t                               resume_at;
 };
 
 }
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_midi_playback_cache_h__
+#define __ardour_midi_playback_cache_h__
+
+#include <vector>
+
+#include <stdint.h>
+
+#include <boost/utility.hpp>
+
+#include "evoral/Parameter.hpp"
+#include "evoral/types.hpp"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class MidiModel;
+class TempoMap;
+
+/** A flat, time-sorted copy of everything a MidiModel plays back: notes,
+ * controllers, sysexes and patch changes, in the order the model's
+ * iterator would produce them.
+ *
+ * Reading from it is a binary search and a linear walk over a few arrays,
+ * instead of merging the model's note, controller, sysex and patch change
+ * lists on every seek.  The cache is immutable, MidiSource replaces it
+ * when the model changes.
+ */
+class LIBARDOUR_API MidiPlaybackCache : public boost::noncopyable
+{
+  public:
+	MidiPlaybackCache (MidiModel const&);
+
+	size_t size () const { return _time.size (); }
+
+	/** @return time of event @param n in quarter notes from the start of the source */
+	double time (size_t n) const { return _time[n]; }
+	Evoral::EventType event_type (size_t n) const { return _type[n]; }
+	uint32_t event_size (size_t n) const { return _size[n]; }
+	const uint8_t* buffer (size_t n) const { return &_data[_offset[n]]; }
+
+	/** @return index of the note on that note off @param n ends, or -1 */
+	int32_t note_on (size_t n) const { return _note_on[n]; }
+
+	/** @return parameter of the controller event @param n was generated from,
+	 * or 0 if it is not a controller event.
+	 */
+	const Evoral::Parameter* parameter (size_t n) const {
+		return _parameter[n] < 0 ? 0 : &_parameters[_parameter[n]];
+	}
+
+	/** Compute the position of every event in session samples.
+	 * @param start_qn position of the start of the source in quarter notes.
+	 */
+	void compute_samples (TempoMap const&, double start_qn, std::vector<samplepos_t>&) const;
+
+  private:
+	std::vector<double>            _time;
+	std::vector<Evoral::EventType> _type;
+	std::vector<uint32_t>          _offset;
+	std::vector<uint32_t>          _size;
+	std::vector<int32_t>           _note_on;
+	std::vector<int16_t>           _parameter;
+	std::vector<Evoral::Parameter> _parameters;
+	std::vector<uint8_t>           _data;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_midi_playback_cache_h__ */
@@ -38,6 +38,7 @@ namespace ARDOUR {
 
 class MidiChannelFilter;
 class MidiModel;
+class MidiPlaybackCache;
 class MidiStateTracker;
 
 template<typename T> class MidiRingBuffer;
@@ -230,6 +231,15 @@ class LIBARDOUR_API MidiSource : virtual public Source, public boost::enable_sha
 	std::string _captured_for;
 
 	boost::shared_ptr<MidiModel> _model;
+
+	/** Flat copy of _model used by midi_read(), built on demand.
+	 *  Protected by the source lock.
+	 */
+	mutable boost::shared_ptr<const MidiPlaybackCache> _playback_cache;
+	/** Set when the model's contents changed without an invalidate() */
+	mutable gint                                       _playback_cache_dirty;
+	mutable PBD::ScopedConnection                      _playback_cache_connection;
+
 	bool                         _writing;
 
 	Temporal::Beats _length_beats;
@@ -251,6 +261,32 @@ class LIBARDOUR_API MidiSource : virtual public Source, public boost::enable_sha
 	 */
 	typedef std::map<Evoral::Parameter, AutoState> AutomationStateMap;
 	AutomationStateMap  _automation_state;
+
+  private:
+	samplecnt_t model_read (const Lock&                        lock,
+	                        Evoral::EventSink<samplepos_t>&     dst,
+	                        samplepos_t                         source_start,
+	                        samplepos_t                         start,
+	                        samplecnt_t                         cnt,
+	                        Evoral::Range<samplepos_t>*         loop_range,
+	                        MidiCursor&                        cursor,
+	                        MidiStateTracker*                  tracker,
+	                        MidiChannelFilter*                 filter,
+	                        const std::set<Evoral::Parameter>& filtered,
+	                        double                             start_qn) const;
+
+	void write_event (Evoral::EventSink<samplepos_t>& dst,
+	                  samplepos_t                     time,
+	                  Evoral::EventType               type,
+	                  uint32_t                        size,
+	                  const uint8_t*                  buf,
+	                  samplepos_t                     start,
+	                  samplepos_t                     end,
+	                  MidiStateTracker*               tracker,
+	                  MidiChannelFilter*              filter) const;
+
+	boost::shared_ptr<const MidiPlaybackCache> playback_cache (const Lock& lock) const;
+	void model_contents_changed () const;
 };
 
 }
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_pipeline_break_h__
+#define __ardour_pipeline_break_h__
+
+#include <vector>
+
+#include <boost/shared_array.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/graphnode.h"
+#include "ardour/processor.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class BufferSet;
+class ChanCount;
+class MidiBuffer;
+class Route;
+class Session;
+
+/** Splits a route's processor chain into two pipeline stages.
+ *
+ * The processor delays its input by one engine period. Processors
+ * before and including the break form the first stage, processors
+ * after it the second stage. Because the second stage only needs data
+ * that the first stage produced in the previous cycle, both stages can
+ * be run concurrently by the process graph (see Route::run_pipeline_stage).
+ *
+ * When the route is not split in the graph (or the graph is not used),
+ * the break behaves like a plain delay-line, so the route's latency is
+ * the same either way and is reported to latency compensation as
+ * signal_latency().
+ */
+class LIBARDOUR_API PipelineBreak : public Processor
+{
+public:
+	PipelineBreak (Session&, const std::string& name);
+	~PipelineBreak ();
+
+	bool set_name (const std::string& str);
+
+	/* processor interface */
+	bool display_to_user () const { return false; }
+	void run (BufferSet&, samplepos_t, samplepos_t, double, pframes_t, bool);
+	bool configure_io (ChanCount in, ChanCount out);
+	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
+	int  set_block_size (pframes_t);
+	void flush ();
+
+	samplecnt_t signal_latency () const { return _delay; }
+
+	/** true if the second stage is run as separate graph node */
+	bool split () const { return _split; }
+	void set_split (bool yn) { _split = yn; }
+
+	/** called by the graph at the start of every cycle when split,
+	 * before either stage runs.
+	 */
+	void cycle_start ();
+
+	/** second stage: fetch the data of the previous cycle */
+	void read (BufferSet&, pframes_t);
+
+protected:
+	XMLNode& state ();
+
+private:
+	void allocate_buffers (ChanCount const&);
+	void clear_buffers ();
+	void write (BufferSet const&, pframes_t);
+	void read_at (BufferSet&, samplecnt_t, pframes_t);
+
+	samplecnt_t _delay;
+	samplecnt_t _bsiz;
+	samplecnt_t _bsiz_mask;
+	samplecnt_t _woff;
+	samplecnt_t _roff;
+
+	volatile bool _split;
+	volatile bool _pending_flush;
+
+	typedef std::vector<boost::shared_array<Sample> > AudioPipeBuf;
+
+	AudioPipeBuf _buf;
+
+	void midi_period_start ();
+
+	/* MIDI is delayed by whole engine periods, [_midi_w] is written in
+	 * this period. Split cycles write and read at an offset into it.
+	 */
+	boost::shared_ptr<MidiBuffer> _midi_buf[2];
+	int         _midi_w;
+	samplecnt_t _midi_period;
+	samplecnt_t _midi_woff;
+	samplecnt_t _midi_roff;
+};
+
+/** The graph node that runs the second stage of a split route */
+class LIBARDOUR_API PipelineStageNode : public GraphNode
+{
+public:
+	PipelineStageNode (boost::shared_ptr<Graph>, Route*, boost::shared_ptr<PipelineBreak>);
+
+	void process ();
+
+	Route* route () const { return _route; }
+	boost::shared_ptr<PipelineBreak> pipeline_break () const { return _break; }
+
+private:
+	Route* _route;
+	boost::shared_ptr<PipelineBreak> _break;
+};
+
+} // namespace ARDOUR
+
+#endif // __ardour_pipeline_break_h__
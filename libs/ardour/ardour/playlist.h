@@ -24,6 +24,7 @@
 #include <set>
 #include <map>
 #include <list>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/utility.hpp>
@@ -50,6 +51,7 @@ namespace ARDOUR  {
 class Session;
 class Playlist;
 class Crossfade;
+class RegionIndex;
 
 namespace Properties {
 	/* fake the type, since regions are handled by SequenceProperty which doesn't
@@ -270,12 +272,14 @@ protected:
 				: Glib::Threads::RWLock::WriterLock (pl->region_lock)
 					, playlist (pl)
 					 , block_notify (do_block_notify) {
+						 playlist->region_index_write_begin ();
 						 if (block_notify) {
 							 playlist->delay_notifications();
 						 }
 					 }
 
 			~RegionWriteLock() {
+				playlist->region_index_write_end ();
 				Glib::Threads::RWLock::WriterLock::release ();
 				if (block_notify) {
 					playlist->release_notifications ();
@@ -342,6 +346,15 @@ protected:
 	void _set_sort_id ();
 
 	boost::shared_ptr<RegionList> regions_touched_locked (samplepos_t start, samplepos_t end);
+	void regions_touched_locked (samplepos_t start, samplepos_t end, std::vector<boost::shared_ptr<Region> >&);
+
+	/** @return a counter that changes whenever the regions, their bounds,
+	 * layering or any other of their properties change.
+	 */
+	uint32_t region_generation () const { return g_atomic_int_get (&_region_generation); }
+
+	/** @return true while a RegionWriteLock is held */
+	bool region_list_being_modified () const { return _region_index_writer; }
 
 	void notify_region_removed (boost::shared_ptr<Region>);
 	void notify_region_added (boost::shared_ptr<Region>);
@@ -420,6 +433,21 @@ private:
 	void coalesce_and_check_crossfades (std::list<Evoral::Range<samplepos_t> >);
 	boost::shared_ptr<RegionList> find_regions_at (samplepos_t);
 
+	/* Interval index of `regions', built on demand by readers and
+	 * dropped on every change. While a RegionWriteLock is held the
+	 * index is not used (the writer may query a half-modified list).
+	 */
+	boost::shared_ptr<RegionIndex const> region_index () const;
+	void invalidate_region_index ();
+	void region_index_write_begin ();
+	void region_index_write_end ();
+
+	mutable boost::shared_ptr<RegionIndex const> _region_index;
+	mutable Glib::Threads::Mutex _region_index_lock;
+	mutable bool _region_index_dirty;
+	bool _region_index_writer;
+	mutable gint _region_generation;
+
 	samplepos_t _end_space;  //this is used when we are pasting a range with extra space at the end
 	bool _playlist_shift_active;
 };
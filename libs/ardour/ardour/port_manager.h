@@ -40,6 +40,7 @@ namespace ARDOUR {
 
 class PortEngine;
 class AudioBackend;
+class AudioPort;
 class Session;
 
 class LIBARDOUR_API PortManager
@@ -199,6 +200,25 @@ class LIBARDOUR_API PortManager
 
 	void cycle_end_fade_out (gain_t, gain_t, pframes_t, Session* s = 0);
 
+	/* Preallocated storage to run the cycle_start() and cycle_end()
+	 * of all ports in parallel when resampling (varispeed), indexed by
+	 * the session's RTTaskList. Sized in ::register_port(); the process
+	 * thread only try-locks and falls back to serial processing.
+	 */
+	typedef std::pair<PortEngine::PortHandle, AudioPort*> ExternalInput;
+
+	Glib::Threads::Mutex       _cycle_tasks_lock;
+	std::vector<Port*>         _cycle_tasks;
+	std::vector<ExternalInput> _cycle_inputs;
+	pframes_t                  _cycle_task_nframes;
+
+	void reserve_cycle_tasks (size_t);
+	void ports_cycle_end (pframes_t, Session*);
+	void update_external_source (boost::shared_ptr<Port>);
+
+	static void cycle_start_task (void*, uint32_t);
+	static void cycle_end_task (void*, uint32_t);
+
 	typedef std::map<std::string,MidiPortInformation> MidiPortInfo;
 
 	mutable Glib::Threads::Mutex midi_port_info_mutex;
@@ -91,6 +91,8 @@ CONFIG_VARIABLE (bool, use_tranzport,  "use-tranzport", false)
 CONFIG_VARIABLE (uint32_t, minimum_disk_write_bytes,  "minimum-disk-write-bytes", ARDOUR::DiskWriter::default_chunk_samples() * sizeof (ARDOUR::Sample))
 CONFIG_VARIABLE (float, midi_readahead,  "midi-readahead", 1.0)
 CONFIG_VARIABLE (BufferingPreset, buffering_preset, "buffering-preset", Medium)
+CONFIG_VARIABLE (uint32_t, butler_io_threads, "butler-io-threads", 1)
+CONFIG_VARIABLE (bool, async_disk_reads, "async-disk-reads", false)
 CONFIG_VARIABLE (float, audio_capture_buffer_seconds, "capture-buffer-seconds", 5.0)
 CONFIG_VARIABLE (float, audio_playback_buffer_seconds, "playback-buffer-seconds", 5.0)
 CONFIG_VARIABLE (float, midi_track_buffer_seconds, "midi-track-buffer-seconds", 1.0)
@@ -208,6 +210,7 @@ CONFIG_VARIABLE (bool, replicate_missing_region_channels, "replicate-missing-reg
 CONFIG_VARIABLE (bool, hiding_groups_deactivates_groups, "hiding-groups-deactivates-groups", true)
 CONFIG_VARIABLE (bool, verify_remove_last_capture, "verify-remove-last-capture", true)
 CONFIG_VARIABLE (bool, save_history, "save-history", true)
+CONFIG_VARIABLE (bool, cache_session_state, "cache-session-state", true)
 CONFIG_VARIABLE (int32_t, saved_history_depth, "save-history-depth", 20)
 CONFIG_VARIABLE (int32_t, history_depth, "history-depth", 20)
 CONFIG_VARIABLE (RegionEquivalence, region_equivalence, "region-equivalence", Enclosed)
@@ -223,6 +226,7 @@ CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-sessi
 #endif
 CONFIG_VARIABLE (bool, allow_special_bus_removal, "allow-special-bus-removal", false)
 CONFIG_VARIABLE (int32_t, processor_usage, "processor-usage", -1)
+CONFIG_VARIABLE (GraphScheduler, graph_scheduler, "graph-scheduler", SharedQueueScheduler)
 CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
@@ -282,3 +286,4 @@ CONFIG_VARIABLE (bool, show_video_server_dialog, "show-video-server-dialog", fal
 
 CONFIG_VARIABLE (float, export_preroll, "export-preroll", 10.0) // seconds
 CONFIG_VARIABLE (float, export_silence_threshold, "export-silence-threshold", -INFINITY) // dB
+CONFIG_VARIABLE (uint32_t, export_memory_spill_limit, "export-memory-spill-limit", 512) // MB, normalized exports up to this size are kept in memory
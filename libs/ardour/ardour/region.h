@@ -180,7 +180,7 @@ public:
 
 	/* meter-based beat at the region position */
 	double beat () const { return _beat; }
-	void set_beat (double beat) { _beat = beat; }
+	void set_beat (double beat) { _beat = beat; invalidate_cached_state (); }
 	/* quarter-note at the region position */
 	double quarter_note () const { return _quarter_note; }
 	void set_quarter_note (double qn) { _quarter_note = qn; }
@@ -289,7 +289,8 @@ public:
 	virtual boost::shared_ptr<Region> get_parent() const;
 
 	uint64_t layering_index () const { return _layering_index; }
-	void set_layering_index (uint64_t when) { _layering_index = when; }
+	/* the playlist changes the index without sending a property change */
+	void set_layering_index (uint64_t when) { _layering_index = when; invalidate_cached_state (); }
 
 	virtual bool is_dependent() const { return false; }
 	virtual bool depends_on (boost::shared_ptr<Region> /*other*/) const { return false; }
@@ -349,6 +350,12 @@ public:
 protected:
 	virtual XMLNode& state ();
 
+	/* compound regions serialize their nested sources.
+	 * Setters that change saved state without send_change() must call
+	 * invalidate_cached_state().
+	 */
+	bool state_cacheable () const { return max_source_level () == 0; }
+
 	friend class RegionFactory;
 
 	/** Construct a region from multiple sources*/
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_region_index_h__
+#define __ardour_region_index_h__
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class Region;
+
+/** An immutable interval index of the regions of a playlist.
+ *
+ * The regions are kept in a vector sorted by position, which is used as an
+ * implicit balanced binary tree: the node of a sub-range [lo, hi) is its
+ * middle element, and each node stores the largest last sample of its
+ * sub-tree. Range and point queries are O(log n + k) and visit the
+ * matching regions in position order (the order of Playlist::regions).
+ *
+ * The bounds of the regions are copied when the index is built; the
+ * playlist drops the index whenever a region or the region list changes.
+ */
+class LIBARDOUR_API RegionIndex
+{
+public:
+	RegionIndex (RegionList::const_iterator begin, RegionList::const_iterator end);
+
+	size_t size () const { return _entries.size (); }
+
+	/** Call @param v (region) for every region that has some part
+	 * within [start, end], in position order.
+	 */
+	template<typename Visitor>
+	void visit_touched (samplepos_t start, samplepos_t end, Visitor& v) const {
+		if (start <= end) {
+			visit (0, _entries.size (), start, end, v);
+		}
+	}
+
+	/** Append regions that have some part within [start, end] to @param result */
+	template<typename Container>
+	void find_touched (samplepos_t start, samplepos_t end, Container& result) const {
+		Appender<Container> a (result);
+		visit_touched (start, end, a);
+	}
+
+	/** Append regions that start within [start, end] to @param result */
+	template<typename Container>
+	void find_starting_within (samplepos_t start, samplepos_t end, Container& result) const {
+		for (size_t i = lower_bound (start); i < _entries.size () && _entries[i].first <= end; ++i) {
+			result.push_back (_entries[i].region);
+		}
+	}
+
+	uint32_t count_touched (samplepos_t start, samplepos_t end) const;
+
+	/** @return the region at @param sample on the highest layer; if there
+	 * are several, the last one in position order.
+	 */
+	boost::shared_ptr<Region> top_at (samplepos_t sample, bool skip_muted) const;
+
+private:
+	struct Entry {
+		Entry (samplepos_t f, samplepos_t l, boost::shared_ptr<Region> r) : first (f), last (l), region (r) {}
+		samplepos_t first;
+		samplepos_t last;
+		boost::shared_ptr<Region> region;
+	};
+
+	template<typename Container>
+	struct Appender {
+		Appender (Container& c) : result (c) {}
+		void operator() (boost::shared_ptr<Region> const& r) { result.push_back (r); }
+		Container& result;
+	};
+
+	template<typename Visitor>
+	void visit (size_t lo, size_t hi, samplepos_t start, samplepos_t end, Visitor& v) const {
+		while (lo < hi) {
+			const size_t mid = lo + (hi - lo) / 2;
+			if (_max_last[mid] < start) {
+				/* nothing in this sub-tree reaches the range */
+				return;
+			}
+			visit (lo, mid, start, end, v);
+			if (_entries[mid].first > end) {
+				/* this and everything after it starts too late */
+				return;
+			}
+			if (_entries[mid].last >= start) {
+				v (_entries[mid].region);
+			}
+			lo = mid + 1;
+		}
+	}
+
+	samplepos_t build (size_t lo, size_t hi);
+	size_t lower_bound (samplepos_t) const;
+
+	std::vector<Entry>       _entries;
+	std::vector<samplepos_t> _max_last;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_region_index_h__ */
@@ -71,6 +71,8 @@ class DiskWriter;
 class IOProcessor;
 class Panner;
 class PannerShell;
+class PipelineBreak;
+class PipelineStageNode;
 class PolarityProcessor;
 class PortSet;
 class Processor;
@@ -304,6 +306,23 @@ public:
 
 	bool strict_io () const { return _strict_io; }
 	bool set_strict_io (bool);
+
+	/** Split the processor chain into two stages that the process graph
+	 * can run concurrently, at the expense of one period of latency.
+	 */
+	bool pipelined () const { return _pipeline_break ? true : false; }
+	bool set_pipelined (bool);
+
+	/** graph node for the second stage, or null if the route is not pipelined */
+	boost::shared_ptr<PipelineStageNode> pipeline_stage () const { return _pipeline_stage; }
+
+	/** true if processors of the first pipeline stage deliver to other
+	 * routes, which then also depend on the first stage.
+	 */
+	bool pipeline_first_stage_feeds () const { return _pipeline_first_stage_feeds; }
+
+	/** run the second pipeline stage (called by the process graph) */
+	int run_pipeline_stage (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool roll, bool session_state_changing);
 	/** reset plugin-insert configuration to default, disable customizations.
 	 *
 	 * This is equivalent to calling
@@ -428,6 +447,19 @@ public:
 	 */
 	bool direct_feeds_according_to_reality (boost::shared_ptr<Route>, bool* via_send_only = 0);
 
+	/** routes owning input ports, keyed by full port name */
+	typedef std::map<std::string, boost::shared_ptr<Route> > PortOwners;
+	/** routes fed directly, and whether only via sends */
+	typedef std::map<boost::shared_ptr<Route>, bool> DirectFeeds;
+
+	/**
+	 * find all routes that this route feeds directly, via either its main
+	 * outs or a send, like direct_feeds_according_to_reality() does for a
+	 * single route. Routes connected to our ports are looked up in
+	 * @param owners, so this is linear in the number of connections.
+	 */
+	void direct_feeds_according_to_reality (PortOwners const & owners, DirectFeeds& feeds);
+
 	/**
 	 * return true if this route feeds the first argument directly, via
 	 * either its main outs or a send, according to the graph that
@@ -616,6 +648,7 @@ protected:
 	                             bool run_disk_processors);
 
 	void flush_processor_buffers_locked (samplecnt_t nframes);
+	void flush_processor_buffers_locked (ProcessorList::const_iterator first, ProcessorList::const_iterator last, samplecnt_t nframes);
 
 	virtual void bounce_process (BufferSet& bufs,
 	                             samplepos_t start_sample, samplecnt_t nframes,
@@ -703,6 +736,10 @@ protected:
 
 	boost::shared_ptr<DelayLine> _delayline;
 
+	boost::shared_ptr<PipelineBreak>     _pipeline_break;
+	boost::shared_ptr<PipelineStageNode> _pipeline_stage;
+	bool                                 _pipeline_first_stage_feeds;
+
 	bool is_internal_processor (boost::shared_ptr<Processor>) const;
 
 	boost::shared_ptr<Processor> the_instrument_unlocked() const;
@@ -745,6 +782,9 @@ private:
 	samplecnt_t update_port_latencies (PortSet& ports, PortSet& feeders, bool playback, samplecnt_t) const;
 
 	void setup_invisible_processors ();
+	void setup_pipeline_break (ProcessorList&);
+	void setup_gain_automation (ProcessorList::const_iterator first, ProcessorList::const_iterator last,
+	                            samplepos_t start_sample, samplepos_t end_sample, pframes_t nframes);
 
 	pframes_t latency_preroll (pframes_t nframes, samplepos_t& start_sample, samplepos_t& end_sample);
 
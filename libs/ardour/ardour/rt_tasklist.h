@@ -19,8 +19,7 @@
 #ifndef _ardour_rt_tasklist_h_
 #define _ardour_rt_tasklist_h_
 
-#include <list>
-#include <boost/function.hpp>
+#include <vector>
 
 #include "pbd/semutils.h"
 
@@ -37,11 +36,13 @@ public:
 	RTTaskList ();
 	~RTTaskList ();
 
-	// TODO use dedicated allocator of a boost::intrusive::list
-	typedef std::list<boost::function<void ()> > TaskList;
+	typedef void (*TaskFunction) (void* arg, uint32_t index);
 
-	/** process tasks in list in parallel, wait for them to complete */
-	void process (TaskList const&);
+	/** call @a fn (@a arg, i) for every i in [0, @a n_tasks) in parallel,
+	 * using the calling thread as one of the workers, and wait for all of
+	 * them to complete. Realtime safe: nothing is allocated or copied.
+	 */
+	void process (TaskFunction fn, void* arg, uint32_t n_tasks);
 
 private:
 	gint _threads_active;
@@ -50,17 +51,20 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 
-	void process_tasklist ();
+	void run_tasks ();
 
 	static void* _thread_run (void *arg);
 	void run ();
 
 	Glib::Threads::Mutex _process_mutex;
-	Glib::Threads::Mutex _tasklist_mutex;
 	PBD::Semaphore _task_run_sem;
 	PBD::Semaphore _task_end_sem;
 
-	TaskList _tasklist;
+	/* the current parallel-for, set before the workers are woken up */
+	TaskFunction _task_fn;
+	void*        _task_arg;
+	gint         _task_count;
+	gint         _task_next;
 };
 
 } // namespace ARDOUR
@@ -31,6 +31,8 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t)	(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)		(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)			    (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef void  (*mix_buffers_with_gain_ramp_t)	(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float, float);
+	typedef void  (*apply_gain_find_peaks_t)	(ARDOUR::Sample *, pframes_t, float, float *, float *);
 
 	LIBARDOUR_API extern compute_peak_t		compute_peak;
 	LIBARDOUR_API extern find_peaks_t               find_peaks;
@@ -38,6 +40,11 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t	mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t	mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t			copy_vector;
+
+	/** dst[i] += src[i] * (gain + i * gain_delta) */
+	LIBARDOUR_API extern mix_buffers_with_gain_ramp_t	mix_buffers_with_gain_ramp;
+	/** buf[i] *= gain, and find the min/max of the result (like find_peaks) in the same pass */
+	LIBARDOUR_API extern apply_gain_find_peaks_t	apply_gain_find_peaks;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
@@ -93,6 +93,7 @@ class Parser;
 
 namespace PBD {
 class Controllable;
+class Timing;
 }
 
 namespace luabridge {
@@ -545,6 +546,10 @@ public:
 	void set_nsm_state (bool state) { _under_nsm_control = state; }
 	bool save_default_options ();
 
+	/** name and duration (in usecs) of each phase of loading the session state */
+	typedef std::vector<std::pair<std::string, uint64_t> > LoadTimings;
+	LoadTimings const & load_timings () const { return _load_timings; }
+
 	PBD::Signal1<void,std::string> StateSaved;
 	PBD::Signal0<void> StateReady;
 
@@ -1372,6 +1377,7 @@ private:
 	std::string _current_snapshot_name;
 
 	XMLTree*         state_tree;
+	LoadTimings      _load_timings;
 	bool             state_was_pending;
 	StateOfTheState _state_of_the_state;
 
@@ -1762,6 +1768,7 @@ private:
 	SourceMap sources;
 
 	int load_sources (const XMLNode& node);
+	void preload_sources (const XMLNodeList&, std::map<XMLNode const*, boost::shared_ptr<Source> >&);
 	XMLNode& get_sources_as_xml ();
 
 	boost::shared_ptr<Source> XMLSourceFactory (const XMLNode&);
@@ -1874,6 +1881,7 @@ private:
 
 	XMLNode& get_state ();
 	int      set_state (const XMLNode& node, int version); // not idempotent
+	void     load_phase_done (std::string const &, PBD::Timing&);
 	XMLNode& get_template ();
 
 	/* click track */
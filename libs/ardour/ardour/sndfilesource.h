@@ -22,6 +22,8 @@
 
 #include <sndfile.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include "ardour/audiofilesource.h"
 #include "ardour/broadcast_info.h"
 #include "ardour/progress.h"
@@ -77,6 +79,8 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 
 	static int get_soundfile_info (const std::string& path, SoundFileInfo& _info, std::string& error_msg);
 
+	bool prefetch (AsyncReadBatch&, samplepos_t start, samplecnt_t cnt) const;
+
   protected:
 	void close ();
 
@@ -92,7 +96,23 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
 
+	/* for prefetching, only valid for uncompressed, read-only files */
+	int     _fd;
+	int64_t _data_offset;
+	int     _bytes_per_frame;
+
+	/* multichannel files: the channels of a file share the most
+	 * recently decoded block, so that reading all of them decodes
+	 * the file only once.
+	 */
+	class SharedBlock;
+	boost::shared_ptr<SharedBlock> _shared_block;
+
+	void attach_shared_block ();
+	bool read_shared (Sample* dst, samplepos_t start, samplecnt_t cnt, samplecnt_t& nread) const;
+
 	void init_sndfile ();
+	void setup_prefetch (int fd);
 	int open();
 	int setup_broadcast_info (samplepos_t when, struct tm&, time_t);
 	void file_closed ();
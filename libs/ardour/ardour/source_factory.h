@@ -34,6 +34,7 @@ namespace ARDOUR {
 
 class Session;
 class AudioSource;
+class PeakBuildJob;
 class Playlist;
 
 class LIBARDOUR_API SourceFactory {
@@ -42,7 +43,7 @@ class LIBARDOUR_API SourceFactory {
 
 	static PBD::Signal1<void,boost::shared_ptr<Source> > SourceCreated;
 
-	static boost::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false);
+	static boost::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false, bool announce = true);
 	static boost::shared_ptr<Source> createSilent (Session&, const XMLNode& node,
 	                                               samplecnt_t nframes, float sample_rate);
 
@@ -68,6 +69,17 @@ class LIBARDOUR_API SourceFactory {
         static Glib::Threads::Mutex                      peak_building_lock;
 	static std::list< boost::weak_ptr<AudioSource> > files_with_peaks;
 
+	/** peakfiles that are being built, and that peak-builder threads can help with */
+	static std::list<boost::shared_ptr<PeakBuildJob> > peak_build_jobs;
+
+	static void add_peak_build_job (boost::shared_ptr<PeakBuildJob>);
+	static void remove_peak_build_job (boost::shared_ptr<PeakBuildJob>);
+
+	/** sources whose peak levels file is missing or out of date */
+	static std::list<boost::weak_ptr<AudioSource> > files_with_peak_levels;
+
+	static void add_peak_levels_job (boost::shared_ptr<AudioSource>);
+
 	static int peak_work_queue_length ();
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
 };
@@ -28,6 +28,7 @@
 
 #include "pbd/undo.h"
 #include "pbd/enum_convert.h"
+#include "pbd/rcu.h"
 
 #include "pbd/stateful.h"
 #include "pbd/statefuldestructible.h"
@@ -46,6 +47,7 @@ namespace ARDOUR {
 
 class Meter;
 class TempoMap;
+class TempoMapSnapshot;
 
 // Find a better place for these
 LIBARDOUR_API bool bbt_time_to_string (const Timecode::BBT_Time& bbt, std::string& str);
@@ -442,6 +444,11 @@ class LIBARDOUR_API TempoMap : public PBD::StatefulDestructible
 
 	samplecnt_t sample_rate () const { return _sample_rate; }
 
+	/** @return a counter that changes whenever the map changes, for
+	 * callers that cache positions computed from the map.
+	 */
+	guint generation () const { return g_atomic_int_get (&_generation); }
+
 	/* TEMPO- AND METER-SENSITIVE FUNCTIONS
 
 	   bbt_at_sample(), sample_at_bbt(), beat_at_sample(), sample_at_beat()
@@ -593,6 +600,24 @@ private:
 	samplecnt_t                    _sample_rate;
 	mutable Glib::Threads::RWLock lock;
 
+	/** A sorted, immutable copy of _metrics for lock-free readers.
+	 * It is replaced by recompute_map() and whenever a MetricsWriterLock
+	 * is released.
+	 */
+	SerializedRCUManager<TempoMapSnapshot> _snapshot;
+	gint _generation;
+	void update_snapshot ();
+
+	/** Writer lock of the map, publishes a new snapshot on release */
+	class MetricsWriterLock {
+	  public:
+		MetricsWriterLock (TempoMap& map) : _map (map), _lm (map.lock) {}
+		~MetricsWriterLock () { _map.update_snapshot (); }
+	  private:
+		TempoMap& _map;
+		Glib::Threads::RWLock::WriterLock _lm;
+	};
+
 	void recompute_tempi (Metrics& metrics);
 	void recompute_meters (Metrics& metrics);
 	void recompute_map (Metrics& metrics, samplepos_t end = -1);
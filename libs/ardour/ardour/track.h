@@ -29,6 +29,7 @@
 
 namespace ARDOUR {
 
+class AsyncReadBatch;
 class Session;
 class Playlist;
 class RouteGroup;
@@ -134,6 +135,8 @@ public:
 	float playback_buffer_load () const;
 	float capture_buffer_load () const;
 	int do_refill ();
+	int do_refill (Sample* mixdown_buffer, gain_t* gain_buffer);
+	int prefetch (AsyncReadBatch&);
 	int do_flush (RunContext, bool force = false);
 	void set_pending_overwrite (bool);
 	int seek (samplepos_t, bool complete_refill = false);
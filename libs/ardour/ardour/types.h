@@ -754,6 +754,11 @@ enum MidiTempoMapDisposition {
 	SMFTempoUse,
 };
 
+enum GraphScheduler {
+	SharedQueueScheduler,
+	WorkStealingScheduler,
+};
+
 struct CaptureInfo {
 	samplepos_t start;
 	samplecnt_t samples;
@@ -56,6 +56,7 @@ DEFINE_ENUM_CONVERT(ARDOUR::PositionLockStyle)
 DEFINE_ENUM_CONVERT(ARDOUR::FadeShape)
 DEFINE_ENUM_CONVERT(ARDOUR::RegionSelectionAfterSplit)
 DEFINE_ENUM_CONVERT(ARDOUR::BufferingPreset)
+DEFINE_ENUM_CONVERT(ARDOUR::GraphScheduler)
 DEFINE_ENUM_CONVERT(ARDOUR::AutoReturnTarget)
 DEFINE_ENUM_CONVERT(ARDOUR::MeterType)
 DEFINE_ENUM_CONVERT(ARDOUR::MeterPoint)
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef WAF_BUILD
+#include "libardour-config.h"
+#endif
+
+#include <algorithm>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_POSIX_AIO
+#include <aio.h>
+#endif
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "pbd/compose.h"
+
+#include "ardour/async_read.h"
+#include "ardour/debug.h"
+
+using namespace PBD;
+using namespace ARDOUR;
+
+/* number of requests in flight at a time */
+static const size_t queue_depth = 64;
+
+const size_t AsyncReadBatch::max_request_size;
+
+AsyncReadBatch::AsyncReadBatch ()
+	: _scratch (0)
+	, _synchronous (false)
+	, _ring (0)
+{
+	_scratch = (char*) malloc (max_request_size);
+
+#ifdef HAVE_LIBURING
+	_ring = new struct io_uring;
+	if (io_uring_queue_init (queue_depth, _ring, 0) < 0) {
+		DEBUG_TRACE (DEBUG::Butler, "io_uring is not available, using fallback\n");
+		delete _ring;
+		_ring = 0;
+	}
+#endif
+}
+
+AsyncReadBatch::~AsyncReadBatch ()
+{
+#ifdef HAVE_LIBURING
+	if (_ring) {
+		io_uring_queue_exit (_ring);
+		delete _ring;
+	}
+#endif
+	free (_scratch);
+}
+
+std::string
+AsyncReadBatch::backend_name () const
+{
+	if (_synchronous) {
+		return "pread";
+	}
+#ifdef HAVE_LIBURING
+	if (_ring) {
+		return "io_uring";
+	}
+#endif
+#ifdef HAVE_POSIX_AIO
+	return "POSIX AIO";
+#endif
+	return "pread";
+}
+
+void
+AsyncReadBatch::add (int fd, int64_t offset, size_t len)
+{
+	while (len > 0) {
+		size_t l = std::min (len, max_request_size);
+		_requests.push_back (Request (fd, offset, l));
+		offset += l;
+		len -= l;
+	}
+}
+
+int
+AsyncReadBatch::submit ()
+{
+	if (_requests.empty () || !_scratch) {
+		_requests.clear ();
+		return 0;
+	}
+
+	int rv;
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("submit %1 prefetch requests using %2\n", _requests.size (), backend_name ()));
+
+	if (_synchronous) {
+		rv = submit_sync ();
+	} else if (_ring) {
+		rv = submit_uring ();
+	} else {
+		rv = submit_aio ();
+	}
+
+	_requests.clear ();
+	return rv;
+}
+
+int
+AsyncReadBatch::submit_sync ()
+{
+	int errors = 0;
+#ifndef PLATFORM_WINDOWS
+	for (std::vector<Request>::const_iterator r = _requests.begin (); r != _requests.end (); ++r) {
+		if (::pread (r->fd, _scratch, r->len, r->offset) < 0) {
+			++errors;
+		}
+	}
+#endif
+	return errors;
+}
+
+int
+AsyncReadBatch::submit_aio ()
+{
+#ifdef HAVE_POSIX_AIO
+	struct aiocb  cbs[queue_depth];
+	struct aiocb* list[queue_depth];
+	int errors = 0;
+
+	for (size_t n = 0; n < _requests.size (); n += queue_depth) {
+
+		const size_t cnt = std::min (queue_depth, _requests.size () - n);
+
+		for (size_t i = 0; i < cnt; ++i) {
+			Request const& r (_requests[n + i]);
+			memset (&cbs[i], 0, sizeof (struct aiocb));
+			cbs[i].aio_fildes     = r.fd;
+			cbs[i].aio_offset     = r.offset;
+			/* the data is discarded, all requests share one buffer */
+			cbs[i].aio_buf        = _scratch;
+			cbs[i].aio_nbytes     = r.len;
+			cbs[i].aio_lio_opcode = LIO_READ;
+			list[i] = &cbs[i];
+		}
+
+		if (lio_listio (LIO_WAIT, list, cnt, 0) == 0) {
+			continue;
+		}
+
+		if (errno != EIO && errno != EINTR) {
+			/* nothing was queued (EAGAIN, ENOSYS, ...) */
+			errors += cnt;
+			continue;
+		}
+
+		/* some requests failed, or the wait was interrupted */
+		for (size_t i = 0; i < cnt; ++i) {
+			while (aio_error (&cbs[i]) == EINPROGRESS) {
+				const struct aiocb* cb = &cbs[i];
+				aio_suspend (&cb, 1, 0);
+			}
+			if (aio_return (&cbs[i]) < 0) {
+				++errors;
+			}
+		}
+	}
+	return errors;
+#else
+	return submit_sync ();
+#endif
+}
+
+int
+AsyncReadBatch::submit_uring ()
+{
+#ifdef HAVE_LIBURING
+	int    errors   = 0;
+	size_t queued   = 0;
+	size_t inflight = 0;
+
+	while (queued < _requests.size () || inflight > 0) {
+
+		/* keep the ring full */
+		while (queued < _requests.size () && inflight < queue_depth) {
+			struct io_uring_sqe* sqe = io_uring_get_sqe (_ring);
+			if (!sqe) {
+				break;
+			}
+			Request const& r (_requests[queued]);
+			io_uring_prep_read (sqe, r.fd, _scratch, r.len, r.offset);
+			++queued;
+			++inflight;
+		}
+
+		const int rv = io_uring_submit_and_wait (_ring, 1);
+		if (rv < 0) {
+			/* in-flight requests cannot be waited for reliably,
+			 * drop the ring (this cancels them) and read the batch
+			 * synchronously. Later batches use the fallback.
+			 */
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("io_uring submit failed (%1), using fallback\n", strerror (-rv)));
+			io_uring_queue_exit (_ring);
+			delete _ring;
+			_ring = 0;
+			return submit_sync ();
+		}
+
+		struct io_uring_cqe* cqe;
+		while (inflight > 0 && io_uring_peek_cqe (_ring, &cqe) == 0) {
+			if (cqe->res < 0) {
+				++errors;
+			}
+			io_uring_cqe_seen (_ring, cqe);
+			--inflight;
+		}
+	}
+	return errors;
+#else
+	return submit_aio ();
+#endif
+}
@@ -21,6 +21,11 @@
 
 #include <cstdlib>
 
+#include <deque>
+#include <map>
+
+#include <glibmm/threads.h>
+
 #include "ardour/types.h"
 #include "ardour/debug.h"
 #include "ardour/audioplaylist.h"
@@ -36,6 +41,7 @@ using namespace PBD;
 
 AudioPlaylist::AudioPlaylist (Session& session, const XMLNode& node, bool hidden)
 	: Playlist (session, node, DataType::AUDIO, hidden)
+	, _read_plan_generation (0)
 {
 #ifndef NDEBUG
 	XMLProperty const * prop = node.property("type");
@@ -55,16 +61,19 @@ AudioPlaylist::AudioPlaylist (Session& session, const XMLNode& node, bool hidden
 
 AudioPlaylist::AudioPlaylist (Session& session, string name, bool hidden)
 	: Playlist (session, name, DataType::AUDIO, hidden)
+	, _read_plan_generation (0)
 {
 }
 
 AudioPlaylist::AudioPlaylist (boost::shared_ptr<const AudioPlaylist> other, string name, bool hidden)
 	: Playlist (other, name, hidden)
+	, _read_plan_generation (0)
 {
 }
 
 AudioPlaylist::AudioPlaylist (boost::shared_ptr<const AudioPlaylist> other, samplepos_t start, samplecnt_t cnt, string name, bool hidden)
 	: Playlist (other, start, cnt, name, hidden)
+	, _read_plan_generation (0)
 {
 	RegionReadLock rlock2 (const_cast<AudioPlaylist*> (other.get()));
 	in_set_state++;
@@ -140,7 +149,7 @@ AudioPlaylist::AudioPlaylist (boost::shared_ptr<const AudioPlaylist> other, samp
 
 /** Sort by descending layer and then by ascending position */
 struct ReadSorter {
-    bool operator() (boost::shared_ptr<Region> a, boost::shared_ptr<Region> b) {
+    bool operator() (boost::shared_ptr<Region> const& a, boost::shared_ptr<Region> const& b) const {
 	    if (a->layer() != b->layer()) {
 		    return a->layer() > b->layer();
 	    }
@@ -151,60 +160,160 @@ struct ReadSorter {
 
 /** A segment of region that needs to be read */
 struct Segment {
-	Segment (boost::shared_ptr<AudioRegion> r, Evoral::Range<samplepos_t> a) : region (r), range (a) {}
+	Segment (boost::shared_ptr<AudioRegion> r, Evoral::Range<samplepos_t> a, uint32_t o) : region (r), range (a), order (o) {}
 
 	boost::shared_ptr<AudioRegion> region; ///< the region
 	Evoral::Range<samplepos_t> range;       ///< range of the region to read, in session samples
+	uint32_t order;                         ///< segments are read in descending order
 };
 
-/** @param start Start position in session samples.
- *  @param cnt Number of samples to read.
+struct SegmentReadSorter {
+	bool operator() (Segment const* a, Segment const* b) const {
+		return a->order > b->order;
+	}
+};
+
+typedef std::vector<boost::shared_ptr<Region> > ReadRegions;
+
+/** Per-thread scratch space of AudioPlaylist::read(), kept between reads
+ *  so that refilling does not need to allocate. There is one level per
+ *  nesting depth, since reading a compound region reads another playlist.
  */
-ARDOUR::samplecnt_t
-AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, samplepos_t start,
-		     samplecnt_t cnt, unsigned chan_n)
-{
-	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 read @ %2 for %3, channel %4, regions %5 mixdown @ %6 gain @ %7\n",
-							   name(), start, cnt, chan_n, regions.size(), mixdown_buffer, gain_buffer));
+struct ReadScratch {
+	struct Level {
+		void clear () {
+			regions.clear ();
+			to_do.clear ();
+			segments.clear ();
+		}
+		ReadRegions                 regions;
+		std::vector<Segment>        to_do;
+		std::vector<Segment const*> segments;
+	};
 
-	/* optimizing this memset() away involves a lot of conditionals
-	   that may well cause more of a hit due to cache misses
-	   and related stuff than just doing this here.
+	ReadScratch () : depth (0) {}
 
-	   it would be great if someone could measure this
-	   at some point.
+	std::deque<Level> levels; /* a deque does not move its elements */
+	size_t depth;
+};
 
-	   one way or another, parts of the requested area
-	   that are not written to by Region::region_at()
-	   for all Regions that cover the area need to be
-	   zeroed.
-	*/
+static Glib::Threads::Private<ReadScratch> thread_read_scratch;
 
-	memset (buf, 0, sizeof (Sample) * cnt);
+class ScratchLevel {
+public:
+	ScratchLevel () {
+		_scratch = thread_read_scratch.get ();
+		if (!_scratch) {
+			_scratch = new ReadScratch;
+			thread_read_scratch.set (_scratch);
+		}
+		if (_scratch->depth == _scratch->levels.size ()) {
+			_scratch->levels.push_back (ReadScratch::Level ());
+		}
+		_level = &_scratch->levels[_scratch->depth++];
+	}
 
-	/* this function is never called from a realtime thread, so
-	   its OK to block (for short intervals).
-	*/
+	~ScratchLevel () {
+		_level->clear ();
+		--_scratch->depth;
+	}
 
-	Playlist::RegionReadLock rl (this);
+	ReadScratch::Level* operator-> () { return _level; }
 
-	/* Find all the regions that are involved in the bit we are reading,
-	   and sort them by descending layer and ascending position.
-	*/
-	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt - 1);
-	all->sort (ReadSorter ());
+private:
+	ReadScratch*        _scratch;
+	ReadScratch::Level* _level;
+};
+
+/** Disjoint ranges (in session samples) that have been handled completely */
+class DoneRanges {
+public:
+	/** Append the parts of @param range that are not done to @param result.
+	 *  Like Evoral::subtract(), a single sample range is passed through as is.
+	 */
+	void subtract (Evoral::Range<samplepos_t> range, std::vector<Evoral::Range<samplepos_t> >& result) const {
+		if (_done.empty () || range.empty ()) {
+			result.push_back (range);
+			return;
+		}
+
+		samplepos_t cur = range.from;
+
+		for (Map::const_iterator i = first_touching (range.from); i != _done.end () && i->first <= range.to; ++i) {
+			if (i->first > cur) {
+				result.push_back (Evoral::Range<samplepos_t> (cur, i->first - 1));
+			}
+			cur = max (cur, i->second + 1);
+			if (cur > range.to) {
+				return;
+			}
+		}
+
+		result.push_back (Evoral::Range<samplepos_t> (cur, range.to));
+	}
+
+	void add (Evoral::Range<samplepos_t> range) {
+		Map::iterator i = first_touching (range.from);
+		while (i != _done.end () && i->first <= range.to) {
+			range.from = min (range.from, i->first);
+			range.to = max (range.to, i->second);
+			_done.erase (i++);
+		}
+		_done.insert (make_pair (range.from, range.to));
+	}
+
+private:
+	typedef std::map<samplepos_t, samplepos_t> Map;
+
+	/* the first range that ends at or after @param pos */
+	Map::const_iterator first_touching (samplepos_t pos) const {
+		Map::const_iterator i = _done.upper_bound (pos);
+		if (i != _done.begin ()) {
+			Map::const_iterator p = i;
+			--p;
+			if (p->second >= pos) {
+				return p;
+			}
+		}
+		return i;
+	}
+
+	Map::iterator first_touching (samplepos_t pos) {
+		Map::iterator i = _done.upper_bound (pos);
+		if (i != _done.begin ()) {
+			Map::iterator p = i;
+			--p;
+			if (p->second >= pos) {
+				return p;
+			}
+		}
+		return i;
+	}
+
+	Map _done;
+};
 
+/** Work out which parts of which regions need to be read, taking
+ *  opaque regions and their fades into account.
+ *
+ *  @param all Regions involved, sorted by ReadSorter.
+ *  @param start First sample of the range of interest.
+ *  @param end Last sample of the range of interest.
+ *  @param to_do Segments to read, in descending layer order; they must
+ *  be read in reverse order.
+ */
+static void
+plan_segments (AudioPlaylist& pl, ReadRegions const& all, bool solo_selection, samplepos_t start, samplepos_t end, std::vector<Segment>& to_do)
+{
 	/* This will be a list of the bits of our read range that we have
 	   handled completely (ie for which no more regions need to be read).
 	   It is a list of ranges in session samples.
 	*/
-	Evoral::RangeList<samplepos_t> done;
-
-	/* This will be a list of the bits of regions that we need to read */
-	list<Segment> to_do;
+	DoneRanges done;
+	std::vector<Evoral::Range<samplepos_t> > region_to_do;
 
 	/* Now go through the `all' list filling in `to_do' and `done' */
-	for (RegionList::iterator i = all->begin(); i != all->end(); ++i) {
+	for (ReadRegions::const_iterator i = all.begin(); i != all.end(); ++i) {
 		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
 
 		/* muted regions don't figure into it at all */
@@ -212,7 +321,7 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 			continue;
 
 		/* check for the case of solo_selection */
-		bool force_transparent = ( _session.solo_selection_active() && SoloSelectedActive() && !SoloSelectedListIncludes( (const Region*) &(**i) ) );
+		bool force_transparent = ( solo_selection && !pl.SoloSelectedListIncludes( (const Region*) &(**i) ) );
 		if ( force_transparent )
 			continue;
 
@@ -221,21 +330,20 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 		*/
 		Evoral::Range<samplepos_t> region_range = ar->range ();
 		region_range.from = max (region_range.from, start);
-		region_range.to = min (region_range.to, start + cnt - 1);
+		region_range.to = min (region_range.to, end);
 
 		/* ... and then remove the bits that are already done */
 
-		Evoral::RangeList<samplepos_t> region_to_do = Evoral::subtract (region_range, done);
+		region_to_do.clear ();
+		done.subtract (region_range, region_to_do);
 
 		/* Make a note to read those bits, adding their bodies (the parts between end-of-fade-in
 		   and start-of-fade-out) to the `done' list.
 		*/
 
-		Evoral::RangeList<samplepos_t>::List t = region_to_do.get ();
-
-		for (Evoral::RangeList<samplepos_t>::List::iterator j = t.begin(); j != t.end(); ++j) {
+		for (std::vector<Evoral::Range<samplepos_t> >::const_iterator j = region_to_do.begin(); j != region_to_do.end(); ++j) {
 			Evoral::Range<samplepos_t> d = *j;
-			to_do.push_back (Segment (ar, d));
+			to_do.push_back (Segment (ar, d, to_do.size ()));
 
 			if (ar->opaque ()) {
 				/* Cut this range down to just the body and mark it done */
@@ -248,19 +356,210 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, sa
 			}
 		}
 	}
+}
+
+/** The result of plan_segments() for the whole playlist.
+ *
+ *  Reading a range with the plan gives the same result as planning the
+ *  range itself: the plan of a range is the plan of the whole playlist,
+ *  cut down to the range. The segments are kept sorted by position, in
+ *  an implicit interval tree (see RegionIndex), so that the segments of
+ *  a read are found in O(log n + k).
+ */
+class AudioPlaylist::ReadPlan
+{
+public:
+	ReadPlan (std::vector<Segment> const& to_do)
+		: _segments (to_do)
+	{
+		sort (_segments.begin (), _segments.end (), SegmentSorter ());
+		_max_to.resize (_segments.size ());
+		build (0, _segments.size ());
+	}
+
+	/** Add the segments which overlap [start, end] to @param result */
+	void find (samplepos_t start, samplepos_t end, std::vector<Segment const*>& result) const {
+		find (0, _segments.size (), start, end, result);
+	}
+
+private:
+	struct SegmentSorter {
+		bool operator() (Segment const& a, Segment const& b) const {
+			return a.range.from < b.range.from;
+		}
+	};
+
+	samplepos_t build (size_t lo, size_t hi) {
+		if (lo >= hi) {
+			return -1;
+		}
+		const size_t mid = lo + (hi - lo) / 2;
+		samplepos_t m = _segments[mid].range.to;
+		m = max (m, build (lo, mid));
+		m = max (m, build (mid + 1, hi));
+		_max_to[mid] = m;
+		return m;
+	}
+
+	void find (size_t lo, size_t hi, samplepos_t start, samplepos_t end, std::vector<Segment const*>& result) const {
+		while (lo < hi) {
+			const size_t mid = lo + (hi - lo) / 2;
+			if (_max_to[mid] < start) {
+				return;
+			}
+			find (lo, mid, start, end, result);
+			if (_segments[mid].range.from > end) {
+				return;
+			}
+			if (_segments[mid].range.to >= start) {
+				result.push_back (&_segments[mid]);
+			}
+			lo = mid + 1;
+		}
+	}
+
+	std::vector<Segment>     _segments;
+	std::vector<samplepos_t> _max_to;
+};
+
+/** Caller must hold the region read-lock.
+ *  @return the read plan, or a null pointer if the region list is being modified.
+ */
+boost::shared_ptr<AudioPlaylist::ReadPlan const>
+AudioPlaylist::read_plan ()
+{
+	if (region_list_being_modified ()) {
+		return boost::shared_ptr<ReadPlan const> ();
+	}
+
+	Glib::Threads::Mutex::Lock lm (_read_plan_lock);
+
+	/* the generation changes with every change to the regions, their
+	 * layering, fades, mute or opaque state.
+	 */
+	uint32_t const generation = region_generation ();
+
+	if (!_read_plan || _read_plan_generation != generation) {
+
+		ReadRegions all (regions.begin (), regions.end ());
+		std::sort (all.begin(), all.end(), ReadSorter ());
+
+		std::vector<Segment> to_do;
+		plan_segments (*this, all, false, 0, max_samplepos, to_do);
+
+		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 new read plan with %2 segments for %3 regions\n", name(), to_do.size(), all.size()));
+
+		/* readers that still use the previous plan keep a reference to it */
+		_read_plan.reset (new ReadPlan (to_do));
+		_read_plan_generation = generation;
+	}
+
+	return _read_plan;
+}
+
+/** @param start Start position in session samples.
+ *  @param cnt Number of samples to read.
+ */
+ARDOUR::samplecnt_t
+AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, samplepos_t start,
+		     samplecnt_t cnt, unsigned chan_n)
+{
+	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 read @ %2 for %3, channel %4, regions %5 mixdown @ %6 gain @ %7\n",
+							   name(), start, cnt, chan_n, regions.size(), mixdown_buffer, gain_buffer));
+
+	/* optimizing this memset() away involves a lot of conditionals
+	   that may well cause more of a hit due to cache misses
+	   and related stuff than just doing this here.
+
+	   it would be great if someone could measure this
+	   at some point.
+
+	   one way or another, parts of the requested area
+	   that are not written to by Region::region_at()
+	   for all Regions that cover the area need to be
+	   zeroed.
+	*/
+
+	memset (buf, 0, sizeof (Sample) * cnt);
+
+	/* this function is never called from a realtime thread, so
+	   its OK to block (for short intervals).
+	*/
+
+	Playlist::RegionReadLock rl (this);
+
+	samplepos_t const end = start + cnt - 1;
+	bool const solo_selection = _session.solo_selection_active() && SoloSelectedActive();
+
+	ScratchLevel scratch;
+	std::vector<Segment const*>& segments (scratch->segments);
+
+	boost::shared_ptr<ReadPlan const> plan;
+
+	if (!solo_selection) {
+		/* with solo-selection, regions are made transparent on the fly */
+		plan = read_plan ();
+	}
+
+	if (plan) {
+		plan->find (start, end, segments);
+	} else {
+		/* Find all the regions that are involved in the bit we are reading,
+		   and sort them by descending layer and ascending position.
+		*/
+		regions_touched_locked (start, end, scratch->regions);
+		std::sort (scratch->regions.begin(), scratch->regions.end(), ReadSorter ());
+
+		plan_segments (*this, scratch->regions, solo_selection, start, end, scratch->to_do);
+
+		for (std::vector<Segment>::const_iterator i = scratch->to_do.begin(); i != scratch->to_do.end(); ++i) {
+			segments.push_back (&(*i));
+		}
+	}
+
+	std::sort (segments.begin(), segments.end(), SegmentReadSorter ());
 
 	/* Now go backwards through the to_do list doing the actual reads */
-	for (list<Segment>::reverse_iterator i = to_do.rbegin(); i != to_do.rend(); ++i) {
+	for (std::vector<Segment const*>::const_iterator i = segments.begin(); i != segments.end(); ++i) {
+		samplepos_t const from = max ((*i)->range.from, start);
+		samplepos_t const to = min ((*i)->range.to, end);
 		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("\tPlaylist %1 read %2 @ %3 for %4, channel %5, buf @ %6 offset %7\n",
-								   name(), i->region->name(), i->range.from,
-								   i->range.to - i->range.from + 1, (int) chan_n,
-								   buf, i->range.from - start));
-		i->region->read_at (buf + i->range.from - start, mixdown_buffer, gain_buffer, i->range.from, i->range.to - i->range.from + 1, chan_n);
+								   name(), (*i)->region->name(), from,
+								   to - from + 1, (int) chan_n,
+								   buf, from - start));
+		(*i)->region->read_at (buf + from - start, mixdown_buffer, gain_buffer, from, to - from + 1, chan_n);
 	}
 
 	return cnt;
 }
 
+/** Queue the source data that read (.., start, cnt, chan_n) is going to need.
+ *  All regions touching the range are considered, including those which
+ *  are covered by opaque regions on higher layers.
+ *  @return number of regions that queued a read.
+ */
+uint32_t
+AudioPlaylist::prefetch (AsyncReadBatch& batch, samplepos_t start, samplecnt_t cnt, uint32_t chan_n)
+{
+	if (cnt <= 0) {
+		return 0;
+	}
+
+	Playlist::RegionReadLock rl (this);
+
+	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt - 1);
+	uint32_t n = 0;
+
+	for (RegionList::const_iterator i = all->begin(); i != all->end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+		if (ar && ar->prefetch (batch, start, cnt, chan_n)) {
+			++n;
+		}
+	}
+
+	return n;
+}
+
 void
 AudioPlaylist::dump () const
 {
@@ -36,6 +36,8 @@ using namespace std;
 AudioPort::AudioPort (const std::string& name, PortFlags flags)
 	: Port (name, DataType::AUDIO, flags)
 	, _buffer (new AudioBuffer (0))
+	, _src_reset_pending (false)
+	, _external_source (0)
 {
 	assert (name.find_first_of (':') == string::npos);
 	cache_aligned_malloc ((void**) &_data, sizeof (Sample) * 8192);
@@ -63,6 +65,11 @@ AudioPort::cycle_start (pframes_t nframes)
 		_src.reset ();
 		memset (_data, 0, _cycle_nframes * sizeof (float));
 	} else {
+		if (_src_reset_pending) {
+			/* the resampler was idle while the data was copied from another port */
+			_src.reset ();
+			_src_reset_pending = false;
+		}
 		_src.inp_data  = (float*)port_engine.get_buffer (_port_handle, nframes);
 		_src.inp_count = nframes;
 		_src.out_count = _cycle_nframes;
@@ -77,6 +84,17 @@ AudioPort::cycle_start (pframes_t nframes)
 	}
 }
 
+void
+AudioPort::cycle_start_from (pframes_t nframes, AudioPort const& other)
+{
+	/* caller must hold process lock */
+	assert (!sends_output () && externally_connected ());
+	Port::cycle_start (nframes);
+
+	memcpy (_data, other._data, _cycle_nframes * sizeof (Sample));
+	_src_reset_pending = true;
+}
+
 void
 AudioPort::cycle_end (pframes_t nframes)
 {
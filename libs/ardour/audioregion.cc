@@ -84,26 +84,31 @@ static void
 reverse_curve (boost::shared_ptr<Evoral::ControlList> dst, boost::shared_ptr<const Evoral::ControlList> src)
 {
 	size_t len = src->back()->when;
+	dst->freeze ();
 	for (Evoral::ControlList::const_reverse_iterator it = src->rbegin(); it!=src->rend(); it++) {
 		dst->fast_simple_add (len - (*it)->when, (*it)->value);
 	}
+	dst->thaw ();
 }
 
 static void
 generate_inverse_power_curve (boost::shared_ptr<Evoral::ControlList> dst, boost::shared_ptr<const Evoral::ControlList> src)
 {
 	// calc inverse curve using sum of squares
+	dst->freeze ();
 	for (Evoral::ControlList::const_iterator it = src->begin(); it!=src->end(); ++it ) {
 		float value = (*it)->value;
 		value = 1 - powf(value,2);
 		value = sqrtf(value);
 		dst->fast_simple_add ( (*it)->when, value );
 	}
+	dst->thaw ();
 }
 
 static void
 generate_db_fade (boost::shared_ptr<Evoral::ControlList> dst, double len, int num_steps, float dB_drop)
 {
+	dst->freeze ();
 	dst->clear ();
 	dst->fast_simple_add (0, 1);
 
@@ -116,6 +121,7 @@ generate_db_fade (boost::shared_ptr<Evoral::ControlList> dst, double len, int nu
 	}
 
 	dst->fast_simple_add (len, GAIN_COEFF_SMALL);
+	dst->thaw ();
 }
 
 static void
@@ -132,6 +138,7 @@ merge_curves (boost::shared_ptr<Evoral::ControlList> dst,
 
 	Evoral::ControlList::const_iterator c1 = curve1->begin();
 	int count = 0;
+	dst->freeze ();
 	for (Evoral::ControlList::const_iterator c2 = curve2->begin(); c2!=curve2->end(); c2++ ) {
 		float v1 = accurate_coefficient_to_dB((*c1)->value);
 		float v2 = accurate_coefficient_to_dB((*c2)->value);
@@ -144,6 +151,7 @@ merge_curves (boost::shared_ptr<Evoral::ControlList> dst,
 		c1++;
 		count++;
 	}
+	dst->thaw ();
 }
 
 void
@@ -341,6 +349,8 @@ AudioRegion::~AudioRegion ()
 void
 AudioRegion::post_set (const PropertyChange& /*ignored*/)
 {
+	invalidate_cached_state ();
+
 	if (!_sync_marked) {
 		_sync_position = _start;
 	}
@@ -772,6 +782,42 @@ AudioRegion::read_from_sources (SourceList const & srcs, samplecnt_t limit, Samp
 	return to_read;
 }
 
+/** Queue the source data that read_at (.., position, cnt, chan_n) is going to need.
+ *  @return true if anything was queued.
+ */
+bool
+AudioRegion::prefetch (AsyncReadBatch& batch, samplepos_t position, samplecnt_t cnt, uint32_t chan_n) const
+{
+	if (n_channels() == 0) {
+		return false;
+	}
+
+	if (position < _position) {
+		cnt -= _position - position;
+		position = _position;
+	}
+
+	sampleoffset_t const internal_offset = position - _position;
+
+	if (cnt <= 0 || internal_offset >= _length) {
+		return false;
+	}
+
+	if (chan_n >= n_channels()) {
+		if (!Config->get_replicate_missing_region_channels()) {
+			return false;
+		}
+		chan_n %= n_channels();
+	}
+
+	boost::shared_ptr<AudioFileSource> afs = boost::dynamic_pointer_cast<AudioFileSource> (_sources[chan_n]);
+	if (!afs) {
+		return false;
+	}
+
+	return afs->prefetch (batch, _start + internal_offset, min (cnt, _length - internal_offset));
+}
+
 XMLNode&
 AudioRegion::get_basic_state ()
 {
@@ -57,6 +57,7 @@
 #include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/i18n.h"
 
@@ -76,11 +77,36 @@ bool AudioSource::_build_peakfiles = false;
 
 #define _FPP 256
 
+/* The peakfile has one peak per _FPP samples. For zoomed-out views, a
+ * separate file holds coarser levels: level N has one peak per
+ * _FPP * peak_level_factor^N samples, each one covering peak_level_factor
+ * peaks of the level below. It is built from the peakfile by the
+ * peak-builder threads the first time a zoomed-out view needs it, so
+ * sessions with peakfiles from before it existed still work as-is.
+ *
+ * File layout: PeakLevelsHeader, followed by the peaks of level 1, 2, ...
+ */
+static const uint32_t peak_level_factor = 4;
+static const uint32_t max_peak_levels = 8;
+
+struct PeakLevelsHeader {
+	char     magic[4];
+	uint32_t version;
+	uint32_t fpp;
+	uint32_t factor;
+	uint32_t n_levels;
+	uint32_t reserved;
+	int64_t  length;
+};
+
+static const char peak_levels_magic[4] = { 'A', 'P', 'L', 'V' };
+
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
 	, _length (0)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
+	, _peak_chunk_size (0)
 	, _peakfile_fd (-1)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
@@ -89,6 +115,8 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _n_peak_levels (0)
+	, _peak_levels_length (-1)
 {
 }
 
@@ -97,6 +125,7 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _length (0)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
+	, _peak_chunk_size (0)
 	, _peakfile_fd (-1)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
@@ -105,6 +134,8 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _n_peak_levels (0)
+	, _peak_levels_length (-1)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -225,6 +256,7 @@ AudioSource::rename_peakfile (string newpath)
 		}
 	}
 
+	drop_peak_levels ();
 	_peakpath = newpath;
 
 	return 0;
@@ -358,9 +390,20 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 
 	GStatBuf statbuf;
 
+	/* while the peakfile is built, the finished chunks are read from
+	 * the file it is being built in.
+	 */
+	std::string peakpath = _peakpath;
+	{
+		Glib::Threads::Mutex::Lock lp (_peaks_ready_lock);
+		if (!_peak_chunks_done.empty ()) {
+			peakpath = peak_build_path ();
+		}
+	}
+
 	expected_peaks = (cnt / (double) samples_per_file_peak);
-	if (g_stat (_peakpath.c_str(), &statbuf) != 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for size check (%2)"), _peakpath, strerror (errno)) << endmsg;
+	if (g_stat (peakpath.c_str(), &statbuf) != 0) {
+		error << string_compose (_("Cannot open peakfile @ %1 for size check (%2)"), peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
 
@@ -395,10 +438,34 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		}
 	}
 
-	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+	/* when zoomed out, read from the coarsest level that still has at
+	 * least one peak per visual peak
+	 */
+	off_t first_peak_offset = 0;
+
+	if (samples_per_file_peak == _FPP && samples_per_visual_peak >= _FPP * peak_level_factor && cnt != npeaks) {
+		uint32_t level = 0;
+		samplecnt_t level_fpp = _FPP;
+		const uint32_t n_levels = peak_levels ();
+
+		while (level < n_levels && level_fpp * peak_level_factor <= samples_per_visual_peak) {
+			level_fpp *= peak_level_factor;
+			++level;
+		}
+
+		if (level > 0) {
+			DEBUG_TRACE (DEBUG::Peaks, string_compose ("using peak level %1 (%2 samples per peak)\n", level, level_fpp));
+			peakpath = peak_levels_path ();
+			first_peak_offset = peak_level_offset (level);
+			samples_per_file_peak = level_fpp;
+			expected_peaks = (cnt / (double) samples_per_file_peak);
+		}
+	}
+
+	ScopedFileDescriptor sfd (g_open (peakpath.c_str(), O_RDONLY, 0444));
 
 	if (sfd < 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
+		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
 
@@ -447,7 +514,7 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 	}
 
 	if (scale == 1.0) {
-		off_t first_peak_byte = (start / samples_per_file_peak) * sizeof (PeakData);
+		off_t first_peak_byte = first_peak_offset + (start / samples_per_file_peak) * sizeof (PeakData);
 		size_t bytes_to_read = sizeof (PeakData) * read_npeaks;
 		/* open, read, close */
 
@@ -545,7 +612,7 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 
 		/* open ... close during out: handling */
 
-		off_t  map_off =  (uint32_t) (ceil (start / (double) samples_per_file_peak)) * sizeof(PeakData);
+		off_t  map_off =  first_peak_offset + (uint32_t) (ceil (start / (double) samples_per_file_peak)) * sizeof(PeakData);
 		off_t  read_map_off = map_off & ~(bufsize - 1);
 		off_t  map_delta = map_off - read_map_off;
 		size_t raw_map_length = chunksize * sizeof(PeakData);
@@ -714,68 +781,457 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 	return 0;
 }
 
+/** @return the number of levels that are available in the peak levels
+ * file. If it is missing or out of date, this queues it to be built by
+ * the peak-builder threads and returns 0 until it is ready.
+ * _lock MUST be held by caller.
+ */
+uint32_t
+AudioSource::peak_levels () const
+{
+	if (_peak_levels_length == _length) {
+		return _n_peak_levels;
+	}
+
+	_n_peak_levels = 0;
+	_peak_levels_length = _length;
+
+	{
+		/* peakfile still being built or written */
+		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
+		if (!_peaks_built || !_peak_chunks_done.empty ()) {
+			_peak_levels_length = -1;
+			return 0;
+		}
+	}
+
+	ScopedFileDescriptor sfd (g_open (peak_levels_path ().c_str(), O_RDONLY, 0444));
+
+	if (sfd >= 0) {
+		PeakLevelsHeader h;
+		if (::read (sfd, &h, sizeof (h)) == sizeof (h)
+		    && !memcmp (h.magic, peak_levels_magic, sizeof (h.magic))
+		    && h.version == 1 && h.fpp == _FPP && h.factor == peak_level_factor
+		    && h.length == _length && h.n_levels <= max_peak_levels) {
+			_n_peak_levels = h.n_levels;
+			return _n_peak_levels;
+		}
+	}
+
+	/* reading the whole peakfile takes a while, do not hold up the
+	 * butler (or the GUI) meanwhile.
+	 */
+	try {
+		SourceFactory::add_peak_levels_job (boost::const_pointer_cast<AudioSource> (shared_from_this ()));
+	} catch (boost::bad_weak_ptr const&) {
+		/* not managed by a shared_ptr (yet), try again next time */
+		_peak_levels_length = -1;
+	}
+
+	return 0;
+}
+
+/** @return the position of the first peak of @param level (> 0) in the
+ * peak levels file.
+ */
+off_t
+AudioSource::peak_level_offset (uint32_t level) const
+{
+	off_t offset = sizeof (PeakLevelsHeader);
+	samplecnt_t npeaks = (_length + _FPP - 1) / _FPP;
+
+	for (uint32_t l = 1; l < level; ++l) {
+		npeaks = (npeaks + peak_level_factor - 1) / peak_level_factor;
+		offset += npeaks * sizeof (PeakData);
+	}
+
+	return offset;
+}
+
 int
-AudioSource::build_peaks_from_scratch ()
+AudioSource::build_peak_levels ()
+{
+	samplecnt_t length;
+	std::string peakpath;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+
+		if (_peak_levels_length != _length || _n_peak_levels != 0) {
+			/* dropped or changed since it was queued, the next read
+			 * queues it again.
+			 */
+			return -1;
+		}
+
+		length = _length;
+		peakpath = _peakpath;
+	}
+
+	const samplecnt_t n_base = (length + _FPP - 1) / _FPP;
+
+	uint32_t n_levels = 0;
+	for (samplecnt_t n = n_base; n > (samplecnt_t) peak_level_factor && n_levels < max_peak_levels; n = (n + peak_level_factor - 1) / peak_level_factor) {
+		++n_levels;
+	}
+
+	if (n_levels == 0) {
+		/* short source, the peakfile is good enough */
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building %1 peak levels for %2\n", n_levels, peakpath));
+
+	ScopedFileDescriptor sfd (g_open (peakpath.c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return -1;
+	}
+
+	std::vector<std::vector<PeakData> > levels (n_levels + 1);
+
+	/* level 1 from the peakfile, read in blocks; the others from the
+	 * level below.
+	 */
+	const samplecnt_t blocksize = 16384 * peak_level_factor;
+	boost::scoped_array<PeakData> block (new PeakData[blocksize]);
+	levels[1].reserve ((n_base + peak_level_factor - 1) / peak_level_factor);
+
+	for (samplecnt_t done = 0; done < n_base; ) {
+		const samplecnt_t to_read = min (blocksize, n_base - done);
+		const ssize_t bytes = sizeof (PeakData) * to_read;
+		if (::read (sfd, block.get(), bytes) != bytes) {
+			return -1;
+		}
+		for (samplecnt_t i = 0; i < to_read; i += peak_level_factor) {
+			PeakData p = block[i];
+			for (samplecnt_t j = i + 1; j < min (i + (samplecnt_t) peak_level_factor, to_read); ++j) {
+				p.min = min (p.min, block[j].min);
+				p.max = max (p.max, block[j].max);
+			}
+			levels[1].push_back (p);
+		}
+		done += to_read;
+	}
+
+	for (uint32_t l = 2; l <= n_levels; ++l) {
+		std::vector<PeakData> const& below (levels[l - 1]);
+		levels[l].reserve ((below.size () + peak_level_factor - 1) / peak_level_factor);
+		for (size_t i = 0; i < below.size (); i += peak_level_factor) {
+			PeakData p = below[i];
+			for (size_t j = i + 1; j < min (i + peak_level_factor, below.size ()); ++j) {
+				p.min = min (p.min, below[j].min);
+				p.max = max (p.max, below[j].max);
+			}
+			levels[l].push_back (p);
+		}
+	}
+
+	PeakLevelsHeader h;
+	memset (&h, 0, sizeof (h));
+	memcpy (h.magic, peak_levels_magic, sizeof (h.magic));
+	h.version = 1;
+	h.fpp = _FPP;
+	h.factor = peak_level_factor;
+	h.n_levels = n_levels;
+	h.length = length;
+
+	/* write a temporary file and rename it, a reader never sees a partial file */
+	const std::string path = peakpath + peakfile_levels_suffix;
+	const std::string tmp = path + temp_suffix;
+
+	{
+		ScopedFileDescriptor wfd (g_open (tmp.c_str(), O_CREAT|O_TRUNC|O_WRONLY, 0664));
+
+		if (wfd < 0) {
+			error << string_compose(_("AudioSource: cannot open peak levels file \"%1\" (%2)"), tmp, strerror (errno)) << endmsg;
+			return -1;
+		}
+
+		bool ok = ::write (wfd, &h, sizeof (h)) == sizeof (h);
+
+		for (uint32_t l = 1; ok && l <= n_levels; ++l) {
+			const ssize_t bytes = sizeof (PeakData) * levels[l].size ();
+			ok = ::write (wfd, &levels[l][0], bytes) == bytes;
+		}
+
+		if (!ok) {
+			error << string_compose(_("%1: could not write peak levels file (%2)"), _name, strerror (errno)) << endmsg;
+			::g_unlink (tmp.c_str());
+			return -1;
+		}
+	}
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	if (_peakpath != peakpath || _length != length || _peak_levels_length != length) {
+		/* renamed, dropped or changed meanwhile */
+		::g_unlink (tmp.c_str());
+		return -1;
+	}
+
+	::g_unlink (path.c_str());
+
+	if (::g_rename (tmp.c_str(), path.c_str())) {
+		::g_unlink (tmp.c_str());
+		return -1;
+	}
+
+	_n_peak_levels = n_levels;
+	return 0;
+}
+
+void
+AudioSource::drop_peak_levels ()
+{
+	::g_unlink (peak_levels_path ().c_str());
+	_peak_levels_length = -1;
+	_first_run = true;
+}
+
+/* peakfiles are built in chunks of this many samples, which can be
+ * computed by several peak-builder threads at once. It must be a
+ * multiple of the disk read size in build_peak_chunk() and of _FPP.
+ */
+static const samplecnt_t peak_chunk_samples = 1048576;
+
+PeakBuildJob::PeakBuildJob (AudioSource& source, int peakfile_fd, samplecnt_t chunk_size)
+	: _source (source)
+	, _fd (peakfile_fd)
+	, _chunk_size (chunk_size)
+	, _n_chunks ((source._length + chunk_size - 1) / chunk_size)
+	, _next (0)
+	, _in_progress (0)
+	, _failed (false)
+{
+}
+
+bool
+PeakBuildJob::process_one ()
+{
+	uint32_t chunk;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		if (_failed || _next >= _n_chunks) {
+			return false;
+		}
+		chunk = _next++;
+		++_in_progress;
+	}
+
+	const samplepos_t start = chunk * _chunk_size;
+	const int ret = _source.build_peak_chunk (_fd, start, min (_chunk_size, _source._length - start));
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	if (ret) {
+		_failed = true;
+	}
+	if (--_in_progress == 0) {
+		_idle.broadcast ();
+	}
+
+	return !_failed;
+}
+
+void
+PeakBuildJob::wait ()
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	while (_in_progress > 0) {
+		_idle.wait (_lock);
+	}
+}
+
+bool
+PeakBuildJob::failed () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	return _failed;
+}
+
+bool
+AudioSource::peaks_ready_for (samplepos_t start, samplecnt_t cnt) const
+{
+	Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
+
+	if (_peaks_built) {
+		return true;
+	}
+
+	if (_peak_chunks_done.empty () || cnt <= 0) {
+		return false;
+	}
+
+	const size_t first = start / _peak_chunk_size;
+	const size_t last = min ((size_t) ((start + cnt - 1) / _peak_chunk_size), _peak_chunks_done.size () - 1);
+
+	for (size_t c = first; c <= last; ++c) {
+		if (!_peak_chunks_done[c]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Compute the peaks of [start, start + cnt) and write them to @param fd.
+ * May be called concurrently for different ranges, @param start must be
+ * a multiple of _FPP.
+ */
+int
+AudioSource::build_peak_chunk (int fd, samplepos_t start, samplecnt_t cnt)
 {
 	const samplecnt_t bufsize = 65536; // 256kB per disk read for mono data is about ideal
 
+	boost::scoped_array<Sample> buf (new Sample[bufsize]);
+	boost::scoped_array<PeakData> peakbuf (new PeakData[(cnt + _FPP - 1) / _FPP]);
+	samplecnt_t npeaks = 0;
+	samplecnt_t done = 0;
+
+	while (done < cnt) {
+
+		if (_session.deletion_in_progress() || _session.peaks_cleanup_in_progres()) {
+			cerr << "peak file creation interrupted: " << _name << endmsg;
+			return -1;
+		}
+
+		const samplecnt_t samples_to_read = min (bufsize, cnt - done);
+
+		/* read() takes _lock for the duration of the disk read only,
+		 * which allows the butler to refill buffers in between.
+		 */
+		if (read (buf.get(), start + done, samples_to_read) != samples_to_read) {
+			error << string_compose(_("%1: could not write read raw data for peak computation (%2)"), _name, strerror (errno)) << endmsg;
+			return -1;
+		}
+
+		for (samplecnt_t i = 0; i < samples_to_read; i += _FPP) {
+			const samplecnt_t this_time = min ((samplecnt_t) _FPP, samples_to_read - i);
+			peakbuf[npeaks].max = buf[i];
+			peakbuf[npeaks].min = buf[i];
+			ARDOUR::find_peaks (&buf[i + 1], this_time - 1, &peakbuf[npeaks].min, &peakbuf[npeaks].max);
+			++npeaks;
+		}
+
+		done += samples_to_read;
+	}
+
+	const off_t first_peak_byte = (start / _FPP) * sizeof (PeakData);
+	const ssize_t bytes_to_write = sizeof (PeakData) * npeaks;
+	ssize_t bytes_written;
+
+#ifdef PLATFORM_WINDOWS
+	{
+		/* no pwrite(), chunks of all files share the seek + write */
+		static Glib::Threads::Mutex write_lock;
+		Glib::Threads::Mutex::Lock lw (write_lock);
+		if (lseek (fd, first_peak_byte, SEEK_SET) != first_peak_byte) {
+			error << string_compose(_("%1: could not seek in peak file data (%2)"), _name, strerror (errno)) << endmsg;
+			return -1;
+		}
+		bytes_written = ::write (fd, peakbuf.get(), bytes_to_write);
+	}
+#else
+	bytes_written = ::pwrite (fd, peakbuf.get(), bytes_to_write, first_peak_byte);
+#endif
+
+	if (bytes_written != bytes_to_write) {
+		error << string_compose(_("%1: could not write peak file data (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
+		if (!_peak_chunks_done.empty ()) {
+			_peak_chunks_done[start / _peak_chunk_size] = true;
+		}
+		PeakRangeReady (start, cnt); /* EMIT SIGNAL */
+	}
+
+	return 0;
+}
+
+int
+AudioSource::build_peaks_from_scratch ()
+{
 	DEBUG_TRACE (DEBUG::Peaks, "Building peaks from scratch\n");
 
 	int ret = -1;
 
 	{
-		/* hold lock while building peaks */
-
 		Glib::Threads::Mutex::Lock lp (_lock);
 
-		if (prepare_for_peakfile_writes ()) {
+		if (_session.deletion_in_progress() || _session.peaks_cleanup_in_progres()) {
 			goto out;
 		}
 
-		samplecnt_t current_sample = 0;
-		samplecnt_t cnt = _length;
+		/* the peakfile is built under a temporary name, and only moved to
+		 * its final path once it is complete. An interrupted build must not
+		 * leave a full-size file that initialize_peakfile() accepts.
+		 */
+		if ((_peakfile_fd = g_open (peak_build_path ().c_str(), O_CREAT|O_RDWR|O_TRUNC, 0664)) < 0) {
+			error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), peak_build_path (), strerror (errno)) << endmsg;
+			goto out;
+		}
 
-		_peaks_built = false;
-		boost::scoped_array<Sample> buf(new Sample[bufsize]);
+		drop_peak_levels ();
 
-		while (cnt) {
+		/* allocate the complete file, so that the peaks of finished chunks
+		 * can be read while the others are still being computed.
+		 */
+		const off_t peakfile_size = ((_length + _FPP - 1) / _FPP) * sizeof (PeakData);
 
-			samplecnt_t samples_to_read = min (bufsize, cnt);
-			samplecnt_t samples_read;
+		if (ftruncate (_peakfile_fd, peakfile_size)) {
+			/* error doesn't actually matter so continue on without testing */
+		}
 
-			if ((samples_read = read_unlocked (buf.get(), current_sample, samples_to_read)) != samples_to_read) {
-				error << string_compose(_("%1: could not write read raw data for peak computation (%2)"), _name, strerror (errno)) << endmsg;
-				done_with_peakfile_writes (false);
-				goto out;
-			}
+		boost::shared_ptr<PeakBuildJob> job (new PeakBuildJob (*this, _peakfile_fd, peak_chunk_samples));
 
-			lp.release(); // allow butler to refill buffers
+		{
+			Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
+			_peaks_built = false;
+			_peak_chunk_size = job->chunk_size ();
+			_peak_chunks_done.assign (job->n_chunks (), false);
+		}
 
-			if (_session.deletion_in_progress() || _session.peaks_cleanup_in_progres()) {
-				cerr << "peak file creation interrupted: " << _name << endmsg;
-				lp.acquire();
-				done_with_peakfile_writes (false);
-				goto out;
-			}
+		/* chunks read from the source, which takes _lock */
+		lp.release ();
 
-			if (compute_and_write_peaks (buf.get(), current_sample, samples_read, true, false, _FPP)) {
-				break;
-			}
+		/* idle peak-builder threads help with the remaining chunks */
+		SourceFactory::add_peak_build_job (job);
 
-			current_sample += samples_read;
-			cnt -= samples_read;
+		while (job->process_one ()) {}
 
-			lp.acquire();
+		job->wait ();
+		SourceFactory::remove_peak_build_job (job);
+
+		lp.acquire ();
+
+		close (_peakfile_fd);
+		_peakfile_fd = -1;
+
+		if (!job->failed ()) {
+			if (::g_rename (peak_build_path ().c_str(), _peakpath.c_str()) == 0) {
+				_peak_byte_max = peakfile_size;
+				ret = 0;
+			} else {
+				error << string_compose(_("AudioSource: cannot rename peakfile \"%1\" (%2)"), peak_build_path (), strerror (errno)) << endmsg;
+			}
 		}
 
-		if (cnt == 0) {
-			/* success */
-			truncate_peakfile();
+		if (ret) {
+			::g_unlink (peak_build_path ().c_str());
 		}
 
-		done_with_peakfile_writes ((cnt == 0));
-		if (cnt == 0) {
-			ret = 0;
+		{
+			Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
+			_peak_chunks_done.clear ();
+			if (ret == 0) {
+				_peaks_built = true;
+				PeaksReady (); /* EMIT SIGNAL */
+			}
 		}
 	}
 
@@ -798,6 +1254,7 @@ AudioSource::close_peakfile ()
 	}
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
+		drop_peak_levels ();
 	}
 	_peaks_built = false;
 	return 0;
@@ -654,6 +654,16 @@ Automatable::find_next_ac_event (boost::shared_ptr<AutomationControl> c, double
 		return;
 	}
 
+	/* the rendered curve only has the points where the curve changes */
+	boost::shared_ptr<const Evoral::ControlList::RenderedCurve> rc (alist->rendered ());
+	if (rc) {
+		double when;
+		if (rc->next_event (start, end, when) && when < next_event.when) {
+			next_event.when = when;
+		}
+		return;
+	}
+
 	for (i = lower_bound (alist->begin(), alist->end(), &cp, Evoral::ControlList::time_comparator); i != alist->end() && (*i)->when < end; ++i) {
 		if ((*i)->when > start) {
 			break;
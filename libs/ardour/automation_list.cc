@@ -214,6 +214,9 @@ AutomationList::set_automation_state (AutoState s)
 		}
 	}
 
+	/* in case a write pass deferred rendering */
+	update_rendered ();
+
 	automation_state_changed (s); /* EMIT SIGNAL */
 }
 
@@ -270,6 +273,9 @@ AutomationList::stop_touch (double)
 	}
 
 	g_atomic_int_set (&_touching, 0);
+
+	/* rendering was deferred while the control was touched */
+	update_rendered ();
 }
 
 /* _before may be owned by the undo stack,
@@ -318,6 +324,7 @@ AutomationList::paste (const ControlList& alist, double pos, DoubleBeatsSamplesC
 	bool to_sample = parameter_is_midi (src_type);
 
 	ControlList cl (alist);
+	cl.freeze ();
 	cl.clear ();
 	for (const_iterator i = alist.begin ();i != alist.end (); ++i) {
 		double when = (*i)->when;
@@ -328,6 +335,7 @@ AutomationList::paste (const ControlList& alist, double pos, DoubleBeatsSamplesC
 		}
 		cl.fast_simple_add (when, (*i)->value);
 	}
+	cl.thaw ();
 	return ControlList::paste (cl, pos);
 }
 
@@ -17,6 +17,7 @@
 
 */
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -25,9 +26,12 @@
 #include <poll.h>
 #endif
 
+#include <boost/scoped_array.hpp>
+
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
 
+#include "ardour/async_read.h"
 #include "ardour/butler.h"
 #include "ardour/debug.h"
 #include "ardour/disk_io.h"
@@ -51,6 +55,12 @@ Butler::Butler(Session& s)
 	, audio_dstream_playback_buffer_size(0)
 	, midi_dstream_buffer_size(0)
 	, pool_trash(16)
+	, _prefetch (0)
+	, _io_threads_active (0)
+	, _io_job_type (RefillJob)
+	, _io_next_job (0)
+	, _io_start_sem ("butler_io_start", 0)
+	, _io_done_sem ("butler_io_done", 0)
 	, _xthread (true)
 {
 	g_atomic_int_set(&should_do_transport_work, 0);
@@ -63,6 +73,7 @@ Butler::Butler(Session& s)
 Butler::~Butler()
 {
 	terminate_thread ();
+	delete _prefetch;
 }
 
 void
@@ -136,6 +147,8 @@ Butler::start_thread()
 	//pthread_detach (thread);
 	have_thread = true;
 
+	start_io_threads (Config->get_butler_io_threads ());
+
 	// we are ready to request buffer adjustments
 	_session.adjust_capture_buffering ();
 	_session.adjust_playback_buffering ();
@@ -151,7 +164,200 @@ Butler::terminate_thread ()
                 DEBUG_TRACE (DEBUG::Butler, string_compose ("%1: ask butler to quit @ %2\n", DEBUG_THREAD_SELF, g_get_monotonic_time()));
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
+		have_thread = false;
+	}
+	stop_io_threads ();
+}
+
+/** Start @param n_threads - 1 additional I/O threads, the butler
+ *  thread itself is the n-th.
+ */
+void
+Butler::start_io_threads (uint32_t n_threads)
+{
+	assert (_io_threads.empty ());
+
+	if (n_threads < 2) {
+		return;
+	}
+
+	g_atomic_int_set (&_io_threads_active, 1);
+
+	for (uint32_t i = 1; i < n_threads; ++i) {
+		pthread_t thread_id;
+		if (pthread_create_and_store ("butler io", &thread_id, _io_thread_work, this)) {
+			error << _("Session: could not create butler I/O thread") << endmsg;
+			break;
+		}
+		_io_threads.push_back (thread_id);
+	}
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("started %1 butler I/O threads\n", _io_threads.size ()));
+}
+
+void
+Butler::stop_io_threads ()
+{
+	if (_io_threads.empty ()) {
+		return;
+	}
+
+	g_atomic_int_set (&_io_threads_active, 0);
+
+	for (std::vector<pthread_t>::const_iterator i = _io_threads.begin (); i != _io_threads.end (); ++i) {
+		_io_start_sem.signal ();
+	}
+	for (std::vector<pthread_t>::const_iterator i = _io_threads.begin (); i != _io_threads.end (); ++i) {
+		void* status;
+		pthread_join (*i, &status);
+	}
+	_io_threads.clear ();
+}
+
+void *
+Butler::_io_thread_work (void* arg)
+{
+	SessionEvent::create_per_thread_pool ("butler io events", 64);
+	pthread_set_name (X_("butler io"));
+	((Butler *) arg)->io_thread_work ();
+	return 0;
+}
+
+void
+Butler::io_thread_work ()
+{
+	/* every thread needs its own working buffers, see DiskReader::allocate_working_buffers() */
+	boost::scoped_array<Sample> mixdown_buffer (new Sample[DiskReader::working_buffer_size ()]);
+	boost::scoped_array<gain_t> gain_buffer (new gain_t[DiskReader::working_buffer_size ()]);
+
+	while (true) {
+		_io_start_sem.wait ();
+		if (!g_atomic_int_get (&_io_threads_active)) {
+			break;
+		}
+		process_io_jobs (mixdown_buffer.get (), gain_buffer.get ());
+		_io_done_sem.signal ();
+	}
+}
+
+/** Called by the butler and all I/O threads. Takes jobs until there are no
+ *  more, or until transport work is requested.
+ *
+ *  The butler thread passes null working buffers and uses the shared ones
+ *  of the DiskReader.
+ */
+void
+Butler::process_io_jobs (Sample* mixdown_buffer, gain_t* gain_buffer)
+{
+	const gint n_jobs = _io_jobs.size ();
+
+	while (!transport_work_requested () && should_run) {
+
+		const gint n = g_atomic_int_add (&_io_next_job, 1);
+
+		if (n >= n_jobs) {
+			break;
+		}
+
+		if (_io_job_type == RefillJob) {
+			if (mixdown_buffer) {
+				_io_results[n] = _io_jobs[n]->do_refill (mixdown_buffer, gain_buffer);
+			} else {
+				_io_results[n] = _io_jobs[n]->do_refill ();
+			}
+		} else {
+			_io_results[n] = _io_jobs[n]->do_flush (ButlerContext, false);
+		}
+	}
+}
+
+static bool
+io_job_cmp (std::pair<float, boost::shared_ptr<Track> > const& a, std::pair<float, boost::shared_ptr<Track> > const& b)
+{
+	return a.first < b.first;
+}
+
+/** Refill or flush the given tracks using the I/O thread pool.
+ *  The tracks with the least data to spare go first.
+ *  @return true if there is disk work outstanding.
+ */
+bool
+Butler::run_io_jobs (IOJobType type, RouteList const& rl, uint32_t& errors)
+{
+	std::vector<std::pair<float, boost::shared_ptr<Track> > > work;
+
+	for (RouteList::const_iterator i = rl.begin(); i != rl.end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		if (type == RefillJob) {
+			boost::shared_ptr<IO> io = tr->input ();
+			if (io && !io->active()) {
+				/* don't read inactive tracks */
+				continue;
+			}
+			/* fraction of the buffer that can be played */
+			work.push_back (std::make_pair (tr->playback_buffer_load (), tr));
+		} else {
+			/* note that we still try to flush diskstreams attached to inactive routes.
+			 * The load is the fraction of the buffer that can still be written.
+			 */
+			work.push_back (std::make_pair (tr->capture_buffer_load (), tr));
+		}
+	}
+
+	std::stable_sort (work.begin (), work.end (), io_job_cmp);
+
+	_io_jobs.clear ();
+	for (std::vector<std::pair<float, boost::shared_ptr<Track> > >::const_iterator i = work.begin (); i != work.end (); ++i) {
+		_io_jobs.push_back (i->second);
+	}
+
+	/* a job that is not run because transport work preempted it, is outstanding */
+	_io_results.assign (_io_jobs.size (), 1);
+	_io_job_type = type;
+	g_atomic_int_set (&_io_next_job, 0);
+
+	for (std::vector<pthread_t>::const_iterator i = _io_threads.begin (); i != _io_threads.end (); ++i) {
+		_io_start_sem.signal ();
+	}
+
+	process_io_jobs (0, 0);
+
+	for (std::vector<pthread_t>::const_iterator i = _io_threads.begin (); i != _io_threads.end (); ++i) {
+		_io_done_sem.wait ();
+	}
+
+	bool disk_work_outstanding = false;
+
+	for (size_t n = 0; n < _io_jobs.size (); ++n) {
+		switch (_io_results[n]) {
+		case 0:
+			break;
+		case 1:
+			disk_work_outstanding = true;
+			break;
+		default:
+			if (type == RefillJob) {
+				error << string_compose(_("Butler read ahead failure on dstream %1"), _io_jobs[n]->name()) << endmsg;
+				std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), _io_jobs[n]->name()) << std::endl;
+			} else {
+				errors++;
+				error << string_compose(_("Butler write-behind failure on dstream %1"), _io_jobs[n]->name()) << endmsg;
+				std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), _io_jobs[n]->name()) << std::endl;
+			}
+			break;
+		}
 	}
+
+	/* drop references */
+	_io_jobs.clear ();
+
+	return disk_work_outstanding;
 }
 
 void *
@@ -231,7 +437,19 @@ Butler::thread_work ()
 
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts refill loop, twr = %1\n", transport_work_requested()));
 
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
+		if (Config->get_async_disk_reads ()) {
+			prefetch_tracks (rl_with_auditioner);
+		}
+
+		if (!_io_threads.empty ()) {
+			uint32_t refill_errors = 0; // reported only, as below
+			disk_work_outstanding = run_io_jobs (RefillJob, rl_with_auditioner, refill_errors);
+			i = rl_with_auditioner.end ();
+		} else {
+			i = rl_with_auditioner.begin ();
+		}
+
+		for (; !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
 
 			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
 
@@ -314,9 +532,55 @@ Butler::thread_work ()
 	return (0);
 }
 
+/** Submit the file-reads of all tracks that are about to be refilled
+ * as a single batch, so that the kernel can schedule them together.
+ * The data ends up in the page-cache, the following refill reads it from there.
+ */
+void
+Butler::prefetch_tracks (RouteList const& rl)
+{
+	if (!_prefetch) {
+		_prefetch = new AsyncReadBatch;
+	}
+
+	for (RouteList::const_iterator i = rl.begin(); !transport_work_requested() && i != rl.end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			continue;
+		}
+
+		tr->prefetch (*_prefetch);
+	}
+
+	if (transport_work_requested()) {
+		/* a locate will invalidate all of it */
+		_prefetch->clear ();
+		return;
+	}
+
+	if (!_prefetch->empty ()) {
+		int errors = _prefetch->submit ();
+		if (errors) {
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 prefetch requests failed\n", errors));
+		}
+	}
+}
+
 bool
 Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
 {
+	if (!_io_threads.empty ()) {
+		return run_io_jobs (FlushJob, *rl, errors);
+	}
+
 	bool disk_work_outstanding = false;
 
 	for (RouteList::iterator i = rl->begin(); !transport_work_requested() && should_run && i != rl->end(); ++i) {
@@ -104,8 +104,8 @@ DiskReader::allocate_working_buffers()
 	   need to reflect the maximum size we could use, which is 4MB reads, or 2M samples
 	   using 16 bit samples.
 	*/
-	_mixdown_buffer       = new Sample[2*1048576];
-	_gain_buffer          = new gain_t[2*1048576];
+	_mixdown_buffer       = new Sample[working_buffer_size ()];
+	_gain_buffer          = new gain_t[working_buffer_size ()];
 }
 
 void
@@ -867,6 +867,131 @@ DiskReader::refill (Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill
  *
  */
 
+/** @return the number of samples that refill_audio() reads at most per pass, given @param total_space */
+samplecnt_t
+DiskReader::refill_chunk_size (samplecnt_t total_space) const
+{
+	/* total_space is in samples. We want to optimize read sizes in various sizes using bytes */
+
+	const size_t bits_per_sample = format_data_width (_session.config.get_native_file_data_format());
+	size_t total_bytes = total_space * bits_per_sample / 8;
+
+	/* chunk size range is 256kB to 4MB. Bigger is faster in terms of MB/sec, but bigger chunk size always takes longer
+	 */
+	size_t byte_size_for_read = max ((size_t) (256 * 1024), min ((size_t) (4 * 1048576), total_bytes));
+
+	/* find nearest (lower) multiple of 16384 */
+
+	byte_size_for_read = (byte_size_for_read / 16384) * 16384;
+
+	/* now back to samples */
+
+	return byte_size_for_read / (bits_per_sample / 8);
+}
+
+/** Queue the file-reads that the next refill_audio() pass is going to do,
+ *  without modifying any state. Only the common case (forward playback,
+ *  at most one loop wrap) is handled; anything else is simply read by
+ *  refill_audio() as usual.
+ *
+ *  @return number of channels for which reads were queued.
+ */
+int
+DiskReader::prefetch_audio (AsyncReadBatch& batch)
+{
+	if (_session.loading() || !_playlists[DataType::AUDIO]) {
+		return 0;
+	}
+
+	if (_session.transport_speed() < 0.0f) {
+		return 0;
+	}
+
+	boost::shared_ptr<ChannelList> c = channels.reader();
+
+	if (c->empty()) {
+		return 0;
+	}
+
+	RingBufferNPT<Sample>::rw_vector vector;
+	c->front()->rbuf->get_write_vector (&vector);
+
+	samplecnt_t total_space = vector.len[0] + vector.len[1];
+
+	/* same conditions as refill_audio() */
+
+	if (total_space == 0) {
+		return 0;
+	}
+
+	if ((total_space < _chunk_samples) && fabs (_session.transport_speed()) < 2.0f) {
+		return 0;
+	}
+
+	if (_slaved && total_space < (samplecnt_t) (c->front()->rbuf->bufsize() / 2)) {
+		return 0;
+	}
+
+	samplepos_t start = file_sample[DataType::AUDIO];
+
+	if (start == max_samplepos) {
+		return 0;
+	}
+
+	samplecnt_t cnt = min (total_space, refill_chunk_size (total_space));
+	cnt = min (cnt, max_samplepos - start);
+
+	/* take a loop into account, see audio_read() */
+
+	samplepos_t loop_start = 0;
+	samplepos_t loop_end = 0;
+	Location* loc = _loop_location;
+
+	if (loc) {
+		loop_start = loc->start();
+		loop_end = loc->end();
+		if (loop_end <= loop_start) {
+			loc = 0;
+		} else if (start >= loop_end) {
+			start = loop_start + ((start - loop_start) % (loop_end - loop_start));
+		}
+	}
+
+	boost::shared_ptr<AudioPlaylist> pl = audio_playlist ();
+	int n = 0;
+	uint32_t chan_n = 0;
+
+	for (ChannelList::iterator i = c->begin(); i != c->end(); ++i, ++chan_n) {
+		samplepos_t pos = start;
+		samplecnt_t remain = cnt;
+		bool queued = false;
+
+		while (remain > 0) {
+			samplecnt_t this_read = remain;
+			if (loc && loop_end - pos < remain) {
+				this_read = loop_end - pos;
+			}
+			if (this_read <= 0) {
+				break;
+			}
+			if (pl->prefetch (batch, pos, this_read, chan_n)) {
+				queued = true;
+			}
+			remain -= this_read;
+			pos += this_read;
+			if (loc && pos >= loop_end) {
+				pos = loop_start;
+			}
+		}
+
+		if (queued) {
+			++n;
+		}
+	}
+
+	return n;
+}
+
 int
 DiskReader::refill_audio (Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level)
 {
@@ -1011,23 +1136,7 @@ DiskReader::refill_audio (Sample* mixdown_buffer, float* gain_buffer, samplecnt_
 	}
 
 	samplepos_t file_sample_tmp = 0;
-
-	/* total_space is in samples. We want to optimize read sizes in various sizes using bytes */
-
-	const size_t bits_per_sample = format_data_width (_session.config.get_native_file_data_format());
-	size_t total_bytes = total_space * bits_per_sample / 8;
-
-	/* chunk size range is 256kB to 4MB. Bigger is faster in terms of MB/sec, but bigger chunk size always takes longer
-	 */
-	size_t byte_size_for_read = max ((size_t) (256 * 1024), min ((size_t) (4 * 1048576), total_bytes));
-
-	/* find nearest (lower) multiple of 16384 */
-
-	byte_size_for_read = (byte_size_for_read / 16384) * 16384;
-
-	/* now back to samples */
-
-	samplecnt_t samples_to_read = byte_size_for_read / (bits_per_sample / 8);
+	samplecnt_t samples_to_read = refill_chunk_size (total_space);
 
 	DEBUG_TRACE (DEBUG::DiskIO, string_compose ("%1: will refill %2 channels with %3 samples\n", name(), c->size(), total_space));
 
@@ -136,6 +136,7 @@ setup_enum_writer ()
 	MTC_Status _MIDI_MTC_Status;
 	Evoral::OverlapType _OverlapType;
 	BufferingPreset _BufferingPreset;
+	GraphScheduler _GraphScheduler;
 	AutoReturnTarget _AutoReturnTarget;
 	PresentationInfo::Flag _PresentationInfo_Flag;
 	MusicalMode::Type mode;
@@ -721,6 +722,10 @@ setup_enum_writer ()
 	REGISTER_ENUM (Custom);
 	REGISTER(_BufferingPreset);
 
+	REGISTER_ENUM (SharedQueueScheduler);
+	REGISTER_ENUM (WorkStealingScheduler);
+	REGISTER(_GraphScheduler);
+
 	REGISTER_ENUM (LastLocate);
 	REGISTER_ENUM (RangeSelectionStart);
 	REGISTER_ENUM (Loop);
@@ -21,14 +21,17 @@
 #include "ardour/audio_buffer.h"
 #include "ardour/audio_port.h"
 #include "ardour/audio_track.h"
+#include "ardour/audioplaylist.h"
 #include "ardour/audioengine.h"
 #include "ardour/audioregion.h"
 #include "ardour/capturing_processor.h"
 #include "ardour/export_channel.h"
 #include "ardour/export_failed.h"
 #include "ardour/session.h"
+#include "ardour/session_playlists.h"
 
 #include "pbd/error.h"
+#include "pbd/types_convert.h"
 
 #include "pbd/i18n.h"
 
@@ -141,6 +144,91 @@ PortExportChannel::set_state (XMLNode * node, Session & session)
 	}
 }
 
+PlaylistExportChannel::PlaylistExportChannel ()
+	: _channel (0)
+	, _position (0)
+	, _buffer_size (0)
+{
+}
+
+PlaylistExportChannel::PlaylistExportChannel (boost::shared_ptr<AudioPlaylist> playlist, uint32_t channel)
+	: _playlist (playlist)
+	, _channel (channel)
+	, _position (0)
+	, _buffer_size (0)
+{
+}
+
+PlaylistExportChannel::~PlaylistExportChannel ()
+{
+}
+
+void
+PlaylistExportChannel::set_max_buffer_size (samplecnt_t samples)
+{
+	_buffer_size = samples;
+	_buffer.reset (new Sample[samples]);
+	_mixdown_buffer.reset (new Sample[samples]);
+	_gain_buffer.reset (new gain_t[samples]);
+}
+
+ExportChannelPtr
+PlaylistExportChannel::offline_copy () const
+{
+	return ExportChannelPtr (new PlaylistExportChannel (_playlist, _channel));
+}
+
+void
+PlaylistExportChannel::read (Sample const *& data, samplecnt_t samples) const
+{
+	assert (_buffer);
+	assert (samples <= _buffer_size);
+
+	if (_playlist) {
+		_playlist->read (_buffer.get(), _mixdown_buffer.get(), _gain_buffer.get(), _position, samples, _channel);
+	} else {
+		memset (_buffer.get(), 0, samples * sizeof (Sample));
+	}
+
+	_position += samples;
+	data = _buffer.get();
+}
+
+void
+PlaylistExportChannel::get_state (XMLNode * node) const
+{
+	if (_playlist) {
+		node->set_property ("playlist", _playlist->id ());
+		node->set_property ("channel", _channel);
+	}
+}
+
+void
+PlaylistExportChannel::set_state (XMLNode * node, Session & session)
+{
+	PBD::ID id;
+	if (!node->get_property ("playlist", id) || !node->get_property ("channel", _channel)) {
+		return;
+	}
+	_playlist = boost::dynamic_pointer_cast<AudioPlaylist> (session.playlists->by_id (id));
+	if (!_playlist) {
+		PBD::warning << string_compose (_("Could not find playlist for export channel \"%1\", dropping the channel"), id) << endmsg;
+	}
+}
+
+bool
+PlaylistExportChannel::operator< (ExportChannel const & other) const
+{
+	PlaylistExportChannel const * pec;
+	if (!(pec = dynamic_cast<PlaylistExportChannel const *> (&other))) {
+		return this < &other;
+	}
+	if (_playlist.get() == pec->_playlist.get()) {
+		return _channel < pec->_channel;
+	}
+	return _playlist.get() < pec->_playlist.get();
+}
+
 RegionExportChannelFactory::RegionExportChannelFactory (Session * session, AudioRegion const & region, AudioTrack & track, Type type)
 	: region (region)
 	, track (track)
@@ -25,6 +25,7 @@
 #include <glibmm/miscutils.h>
 
 #include "audiographer/process_context.h"
+#include "audiographer/general/async_threader.h"
 #include "audiographer/general/chunker.h"
 #include "audiographer/general/cmdpipe_writer.h"
 #include "audiographer/general/interleaver.h"
@@ -36,6 +37,7 @@
 #include "audiographer/general/sr_converter.h"
 #include "audiographer/general/silence_trimmer.h"
 #include "audiographer/general/threader.h"
+#include "audiographer/general/tmp_memory.h"
 #include "audiographer/sndfile/tmp_file.h"
 #include "audiographer/sndfile/tmp_file_rt.h"
 #include "audiographer/sndfile/tmp_file_sync.h"
@@ -48,6 +50,7 @@
 #include "ardour/export_format_specification.h"
 #include "ardour/export_timespan.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session_directory.h"
 #include "ardour/session_metadata.h"
 #include "ardour/sndfile_helpers.h"
@@ -66,6 +69,7 @@ ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	, thread_pool (hardware_concurrency())
 {
 	process_buffer_samples = session.engine().samples_per_cycle();
+	reset ();
 }
 
 ExportGraphBuilder::~ExportGraphBuilder ()
@@ -85,6 +89,11 @@ ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
 		it->second->process (context);
 	}
 
+	if (last_cycle) {
+		/* encoders run asynchronously, make sure all files are complete */
+		wait_for_async_threaders ();
+	}
+
 	return 0;
 }
 
@@ -99,7 +108,12 @@ ExportGraphBuilder::post_process ()
 		}
 	}
 
-	return intermediates.empty();
+	if (intermediates.empty()) {
+		wait_for_async_threaders ();
+		return true;
+	}
+
+	return false;
 }
 
 unsigned
@@ -116,16 +130,25 @@ void
 ExportGraphBuilder::reset ()
 {
 	timespan.reset();
+	async_threaders.clear ();
 	channel_configs.clear ();
 	channels.clear ();
 	intermediates.clear ();
 	analysis_map.clear();
 	_realtime = false;
+	_memory_budget = (samplecnt_t) Config->get_export_memory_spill_limit () * 1048576;
 }
 
 void
 ExportGraphBuilder::cleanup (bool remove_out_files/*=false*/)
 {
+	try {
+		wait_for_async_threaders ();
+	} catch (AudioGrapher::Exception const &) {
+		/* export was aborted or failed, ignore */
+	}
+	async_threaders.clear ();
+
 	ChannelConfigList::iterator iter = channel_configs.begin();
 
 	while (iter != channel_configs.end() ) {
@@ -134,6 +157,25 @@ ExportGraphBuilder::cleanup (bool remove_out_files/*=false*/)
 	}
 }
 
+ExportGraphBuilder::AsyncThreaderPtr
+ExportGraphBuilder::add_async_threader (samplecnt_t max_samples)
+{
+	AsyncThreaderPtr async_threader (new AsyncThreader<Sample> (max_samples));
+	async_threaders.push_back (async_threader);
+	return async_threader;
+}
+
+void
+ExportGraphBuilder::wait_for_async_threaders ()
+{
+	/* Parents were created before their children: once a parent is
+	 * drained, all its data has been queued to the children.
+	 */
+	for (std::list<AsyncThreaderPtr>::iterator i = async_threaders.begin(); i != async_threaders.end(); ++i) {
+		(*i)->wait ();
+	}
+}
+
 void
 ExportGraphBuilder::set_current_timespan (boost::shared_ptr<ExportTimespan> span)
 {
@@ -148,6 +190,7 @@ ExportGraphBuilder::add_config (FileSpec const & config, bool rt)
 	for(ExportChannelConfiguration::ChannelList::const_iterator it = channels.begin();
 	    it != channels.end(); ++it) {
 		(*it)->set_max_buffer_size(process_buffer_samples);
+		(*it)->set_start (timespan->get_start());
 	}
 
 	_realtime = rt;
@@ -401,9 +444,11 @@ ExportGraphBuilder::Encoder::copy_files (std::string orig_path)
 /* SFC */
 
 ExportGraphBuilder::SFC::SFC (ExportGraphBuilder &parent, FileSpec const & new_config, samplecnt_t max_samples)
-	: data_width(0)
+	: parent (parent)
+	, data_width(0)
 {
 	config = new_config;
+	async_threader = parent.add_async_threader (max_samples);
 	data_width = sndfile_data_width (Encoder::get_real_format (config));
 	unsigned channels = new_config.channel_config->get_n_chans();
 	_analyse = config.format->analyse();
@@ -440,6 +485,16 @@ ExportGraphBuilder::SFC::SFC (ExportGraphBuilder &parent, FileSpec const & new_c
 		add_child (config);
 		if (_analyse) { analyser->add_output (float_converter); }
 	}
+
+	if (_analyse) {
+		async_threader->add_output (chunker);
+	} else if (data_width == 8 || data_width == 16) {
+		async_threader->add_output (short_converter);
+	} else if (data_width == 24 || data_width == 32) {
+		async_threader->add_output (int_converter);
+	} else {
+		async_threader->add_output (float_converter);
+	}
 }
 
 void
@@ -453,15 +508,7 @@ ExportGraphBuilder::SFC::set_peak (float gain)
 ExportGraphBuilder::FloatSinkPtr
 ExportGraphBuilder::SFC::sink ()
 {
-	if (_analyse) {
-		return chunker;
-	} else if (data_width == 8 || data_width == 16) {
-		return short_converter;
-	} else if (data_width == 24 || data_width == 32) {
-		return int_converter;
-	} else {
-		return float_converter;
-	}
+	return async_threader;
 }
 
 void
@@ -513,12 +560,6 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 	, use_loudness (false)
 	, use_peak (false)
 {
-	std::string tmpfile_path = parent.session.session_directory().export_path();
-	tmpfile_path = Glib::build_filename(tmpfile_path, "XXXXXX");
-	std::vector<char> tmpfile_path_buf(tmpfile_path.size() + 1);
-	std::copy(tmpfile_path.begin(), tmpfile_path.end(), tmpfile_path_buf.begin());
-	tmpfile_path_buf[tmpfile_path.size()] = '\0';
-
 	config = new_config;
 	uint32_t const channels = config.channel_config->get_n_chans();
 	max_samples_out = 4086 - (4086 % channels); // TODO good chunk size
@@ -534,30 +575,62 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 		loudness_reader.reset (new LoudnessReader (config.format->sample_rate(), channels, max_samples));
 	}
 
-	normalizer.reset (new AudioGrapher::Normalizer (use_loudness ? 0.0 : config.format->normalize_dbfs()));
-	threader.reset (new Threader<Sample> (parent.thread_pool));
-	normalizer->alloc_buffer (max_samples_out);
-	normalizer->add_output (threader);
-
-	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
+	/* Keep the render in memory if it fits, this saves writing it to disk
+	 * and reading it back. Realtime export always uses a file, it relies
+	 * on the disk-thread of TmpFileRt to start post-processing.
+	 */
+	samplecnt_t sample_rate = parent.session.nominal_sample_rate();
+	samplecnt_t sb = config.format->silence_beginning_at (parent.timespan->get_start(), sample_rate);
+	samplecnt_t se = config.format->silence_end_at (parent.timespan->get_end(), sample_rate);
+	samplecnt_t duration = parent.timespan->get_length () + sb + se;
+	samplecnt_t render_samples = channels * (samplecnt_t) ceil (duration * config.format->sample_rate () / (double) sample_rate);
+	samplecnt_t const render_bytes = render_samples * (samplecnt_t) sizeof (Sample);
 
-	if (parent._realtime) {
-		tmp_file.reset (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+	/* all renders of an export share one budget, once it is used up the
+	 * remaining intermediates spill to disk.
+	 */
+	if (!parent._realtime && render_bytes <= parent._memory_budget) {
+		tmp_memory.reset (new TmpMemory<Sample> (channels, render_samples));
+		parent._memory_budget -= render_bytes;
+
+		tmp_memory->Written.connect_same_thread (post_processing_connection,
+		                                         boost::bind (&Intermediate::prepare_post_processing, this));
+		tmp_memory->Written.connect_same_thread (post_processing_connection,
+		                                         boost::bind (&Intermediate::start_post_processing, this));
 	} else {
-		tmp_file.reset (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
-	}
+		std::string tmpfile_path = parent.session.session_directory().export_path();
+		tmpfile_path = Glib::build_filename(tmpfile_path, "XXXXXX");
+		std::vector<char> tmpfile_path_buf(tmpfile_path.size() + 1);
+		std::copy(tmpfile_path.begin(), tmpfile_path.end(), tmpfile_path_buf.begin());
+		tmpfile_path_buf[tmpfile_path.size()] = '\0';
 
-	tmp_file->FileWritten.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::prepare_post_processing, this));
-	tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::start_post_processing, this));
+		int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
+
+		if (parent._realtime) {
+			tmp_file.reset (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+		} else {
+			tmp_file.reset (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+		}
+
+		tmp_file->FileWritten.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::prepare_post_processing, this));
+		tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::start_post_processing, this));
+	}
 
 	add_child (new_config);
 
+	FloatSinkPtr store;
+	if (tmp_memory) {
+		store = tmp_memory;
+	} else {
+		store = tmp_file;
+	}
+
 	if (use_loudness) {
-		loudness_reader->add_output (tmp_file);
+		loudness_reader->add_output (store);
 	} else if (use_peak) {
-		peak_reader->add_output (tmp_file);
+		peak_reader->add_output (store);
 	}
 }
 
@@ -568,6 +641,8 @@ ExportGraphBuilder::Intermediate::sink ()
 		return loudness_reader;
 	} else if (use_peak) {
 		return peak_reader;
+	} else if (tmp_memory) {
+		return tmp_memory;
 	}
 	return tmp_file;
 }
@@ -575,52 +650,52 @@ ExportGraphBuilder::Intermediate::sink ()
 void
 ExportGraphBuilder::Intermediate::add_child (FileSpec const & new_config)
 {
-	for (boost::ptr_list<SFC>::iterator it = children.begin(); it != children.end(); ++it) {
+	for (boost::ptr_list<Target>::iterator it = targets.begin(); it != targets.end(); ++it) {
 		if (*it == new_config) {
 			it->add_child (new_config);
 			return;
 		}
 	}
 
-	children.push_back (new SFC (parent, new_config, max_samples_out));
-	threader->add_output (children.back().sink());
+	targets.push_back (new Target (*this, new_config));
 }
 
 void
 ExportGraphBuilder::Intermediate::remove_children (bool remove_out_files)
 {
-	boost::ptr_list<SFC>::iterator iter = children.begin ();
+	boost::ptr_list<Target>::iterator iter = targets.begin ();
 
-	while (iter != children.end() ) {
+	while (iter != targets.end() ) {
 		iter->remove_children (remove_out_files);
-		iter = children.erase (iter);
+		iter = targets.erase (iter);
 	}
 }
 
 bool
 ExportGraphBuilder::Intermediate::operator== (FileSpec const & other_config) const
 {
+	/* different normalization targets share one analysis and render, see Target */
 	return config.format->normalize() == other_config.format->normalize() &&
-		config.format->normalize_loudness () == other_config.format->normalize_loudness() &&
-		(
-		 (!config.format->normalize_loudness () && config.format->normalize_dbfs() == other_config.format->normalize_dbfs())
-		 ||
-		 // FIXME: allow simultaneous export of two formats with different loundness normalization settings
-		 (config.format->normalize_loudness () /* lufs/dbtp is a result option, not an instantaion option */)
-		);
+		config.format->normalize_loudness () == other_config.format->normalize_loudness();
 }
 
 unsigned
 ExportGraphBuilder::Intermediate::get_postprocessing_cycle_count() const
 {
-	return static_cast<unsigned>(std::ceil(static_cast<float>(tmp_file->get_samples_written()) /
+	samplecnt_t const samples_written = tmp_memory ? tmp_memory->get_samples_written() : tmp_file->get_samples_written();
+	return static_cast<unsigned>(std::ceil(static_cast<float>(samples_written) /
 	                                       max_samples_out));
 }
 
 bool
 ExportGraphBuilder::Intermediate::process()
 {
-	samplecnt_t samples_read = tmp_file->read (*buffer);
+	samplecnt_t samples_read;
+	if (tmp_memory) {
+		samples_read = tmp_memory->read (*buffer);
+	} else {
+		samples_read = tmp_file->read (*buffer);
+	}
 	return samples_read != buffer->samples();
 }
 
@@ -628,21 +703,14 @@ void
 ExportGraphBuilder::Intermediate::prepare_post_processing()
 {
 	// called in sync rt-context
-	float gain;
-	if (use_loudness) {
-		gain = normalizer->set_peak (loudness_reader->get_peak (config.format->normalize_lufs (), config.format->normalize_dbtp ()));
-	} else if (use_peak) {
-		gain = normalizer->set_peak (peak_reader->get_peak());
-	} else {
-		gain = normalizer->set_peak (0.0);
-	}
-	if (use_loudness || use_peak) {
-		// push info to analyzers
-		for (boost::ptr_list<SFC>::iterator i = children.begin(); i != children.end(); ++i) {
-			(*i).set_peak (gain);
+	for (boost::ptr_list<Target>::iterator i = targets.begin(); i != targets.end(); ++i) {
+		i->set_peak ();
+		if (tmp_memory) {
+			tmp_memory->add_output (i->normalizer);
+		} else {
+			tmp_file->add_output (i->normalizer);
 		}
 	}
-	tmp_file->add_output (normalizer);
 	parent.intermediates.push_back (this);
 }
 
@@ -650,12 +718,87 @@ void
 ExportGraphBuilder::Intermediate::start_post_processing()
 {
 	// called in disk-thread (when exporting in realtime)
-	tmp_file->seek (0, SEEK_SET);
-	if (!AudioEngine::instance()->freewheeling ()) {
+	if (tmp_memory) {
+		tmp_memory->rewind ();
+	} else {
+		tmp_file->seek (0, SEEK_SET);
+	}
+	/* non-realtime export is already freewheeling, or does not use the engine at all */
+	if (parent._realtime && !AudioEngine::instance()->freewheeling ()) {
 		AudioEngine::instance()->freewheel (true);
 	}
 }
 
+/* Intermediate::Target (Normalizer) */
+
+ExportGraphBuilder::Intermediate::Target::Target (Intermediate & parent, FileSpec const & new_config)
+	: parent (parent)
+	, config (new_config)
+{
+	normalizer.reset (new AudioGrapher::Normalizer (parent.use_loudness ? 0.0 : config.format->normalize_dbfs()));
+	threader.reset (new Threader<Sample> (parent.parent.thread_pool));
+	normalizer->alloc_buffer (parent.max_samples_out);
+	normalizer->add_output (threader);
+
+	add_child (new_config);
+}
+
+void
+ExportGraphBuilder::Intermediate::Target::add_child (FileSpec const & new_config)
+{
+	for (boost::ptr_list<SFC>::iterator it = children.begin(); it != children.end(); ++it) {
+		if (*it == new_config) {
+			it->add_child (new_config);
+			return;
+		}
+	}
+
+	children.push_back (new SFC (parent.parent, new_config, parent.max_samples_out));
+	threader->add_output (children.back().sink());
+}
+
+void
+ExportGraphBuilder::Intermediate::Target::remove_children (bool remove_out_files)
+{
+	boost::ptr_list<SFC>::iterator iter = children.begin ();
+
+	while (iter != children.end() ) {
+		iter->remove_children (remove_out_files);
+		iter = children.erase (iter);
+	}
+}
+
+bool
+ExportGraphBuilder::Intermediate::Target::operator== (FileSpec const & other_config) const
+{
+	if (parent.use_loudness) {
+		return config.format->normalize_lufs () == other_config.format->normalize_lufs () &&
+			config.format->normalize_dbtp () == other_config.format->normalize_dbtp ();
+	} else if (parent.use_peak) {
+		return config.format->normalize_dbfs() == other_config.format->normalize_dbfs();
+	}
+	return true;
+}
+
+void
+ExportGraphBuilder::Intermediate::Target::set_peak ()
+{
+	float gain;
+	if (parent.use_loudness) {
+		gain = normalizer->set_peak (parent.loudness_reader->get_peak (config.format->normalize_lufs (), config.format->normalize_dbtp ()));
+	} else if (parent.use_peak) {
+		gain = normalizer->set_peak (parent.peak_reader->get_peak());
+	} else {
+		gain = normalizer->set_peak (0.0);
+	}
+	if (parent.use_loudness || parent.use_peak) {
+		// push info to analyzers
+		for (boost::ptr_list<SFC>::iterator i = children.begin(); i != children.end(); ++i) {
+			(*i).set_peak (gain);
+		}
+	}
+}
+
 /* SRC */
 
 ExportGraphBuilder::SRC::SRC (ExportGraphBuilder & parent, FileSpec const & new_config, samplecnt_t max_samples)
@@ -667,12 +810,22 @@ ExportGraphBuilder::SRC::SRC (ExportGraphBuilder & parent, FileSpec const & new_
 	converter->init (parent.session.nominal_sample_rate(), format.sample_rate(), format.src_quality());
 	max_samples_out = converter->allocate_buffers (max_samples);
 
+	if (!parent._realtime) {
+		/* realtime export feeds intermediate files from the process thread,
+		 * keep that path free of additional threads. */
+		async_threader = parent.add_async_threader (max_samples);
+		async_threader->add_output (converter);
+	}
+
 	add_child (new_config);
 }
 
 ExportGraphBuilder::FloatSinkPtr
 ExportGraphBuilder::SRC::sink ()
 {
+	if (async_threader) {
+		return async_threader;
+	}
 	return converter;
 }
 
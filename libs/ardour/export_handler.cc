@@ -25,6 +25,7 @@
 #include <glibmm/convert.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 
 #include "ardour/audioengine.h"
 #include "ardour/audiofile_tagger.h"
@@ -113,6 +114,8 @@ ExportHandler::ExportHandler (Session & session)
   , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
   , post_processing (false)
+  , offline_job_index (0)
+  , offline_thread (0)
   , cue_tracknum (0)
   , cue_indexnum (0)
 {
@@ -120,6 +123,10 @@ ExportHandler::ExportHandler (Session & session)
 
 ExportHandler::~ExportHandler ()
 {
+	if (offline_thread) {
+		export_status->abort ();
+		offline_thread->join ();
+	}
 	graph_builder->cleanup (export_status->aborted () );
 }
 
@@ -164,6 +171,184 @@ ExportHandler::do_export ()
 	start_timespan ();
 }
 
+bool
+ExportHandler::raw_stem_export_possible () const
+{
+	for (ConfigMap::const_iterator it = config_map.begin(); it != config_map.end(); ++it) {
+		if (it->first->realtime ()) {
+			return false;
+		}
+		ExportChannelConfiguration::ChannelList const & channels = it->second.channel_config->get_channels ();
+		for (ExportChannelConfiguration::ChannelList::const_iterator c = channels.begin(); c != channels.end(); ++c) {
+			if (!(*c)->offline_copy ()) {
+				return false;
+			}
+		}
+	}
+	return !config_map.empty ();
+}
+
+void
+ExportHandler::do_raw_stem_export ()
+{
+	assert (raw_stem_export_possible ());
+
+	if (offline_thread) {
+		/* join the thread of the previous export */
+		offline_thread->join ();
+		offline_thread = 0;
+	}
+
+	export_status->init();
+
+	std::set<ExportTimespanPtr> timespan_set;
+	for (ConfigMap::iterator it = config_map.begin(); it != config_map.end(); ++it) {
+		timespan_set.insert (it->first);
+	}
+	export_status->total_timespans = timespan_set.size();
+
+	/* Create one job per timespan and channel configuration. Every job
+	 * gets its own copy of the channels, so that jobs can read concurrently.
+	 */
+
+	offline_jobs.clear ();
+
+	for (std::set<ExportTimespanPtr>::iterator t = timespan_set.begin(); t != timespan_set.end(); ++t) {
+		timespan_bounds = config_map.equal_range (*t);
+		handle_duplicate_format_extensions();
+
+		std::map<ExportChannelConfigPtr, size_t> jobs;
+
+		for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+			FileSpec spec (it->second);
+
+			std::map<ExportChannelConfigPtr, size_t>::iterator j = jobs.find (spec.channel_config);
+			if (j == jobs.end ()) {
+				ExportChannelConfigPtr ccp = add_channel_config ();
+				ccp->set_name (spec.channel_config->name ());
+				ccp->set_split (spec.channel_config->get_split ());
+				ccp->set_region_processing_type (spec.channel_config->region_processing_type ());
+
+				ExportChannelConfiguration::ChannelList const & channels = spec.channel_config->get_channels ();
+				for (ExportChannelConfiguration::ChannelList::const_iterator c = channels.begin(); c != channels.end(); ++c) {
+					ccp->register_channel ((*c)->offline_copy ());
+				}
+
+				offline_jobs.push_back (OfflineJob ());
+				offline_jobs.back ().timespan = *t;
+				offline_jobs.back ().channel_config = ccp;
+				export_status->total_samples += (*t)->get_length ();
+				j = jobs.insert (std::make_pair (spec.channel_config, offline_jobs.size () - 1)).first;
+			}
+
+			OfflineJob & job (offline_jobs[j->second]);
+
+			spec.channel_config = job.channel_config;
+			spec.filename = add_filename_copy (it->second.filename);
+			if (export_status->total_timespans > 1) {
+				// always include timespan if there's more than one.
+				spec.filename->include_timespan = true;
+			}
+			spec.filename->set_timespan (*t);
+			job.specs.push_back (spec);
+		}
+	}
+
+	config_map.clear ();
+
+	export_status->total_samples_current_timespan = export_status->total_samples;
+	export_status->timespan_name = _("Stem Export");
+	export_status->timespan = 1;
+	g_atomic_int_set (&offline_job_index, 0);
+
+	/* Start export */
+
+	Glib::Threads::Mutex::Lock l (export_status->lock());
+	export_status->set_running (true);
+	offline_thread = Glib::Threads::Thread::create (boost::bind (&ExportHandler::offline_export_thread, this));
+}
+
+void
+ExportHandler::offline_export_thread ()
+{
+	uint32_t const n_workers = std::min ((size_t) hardware_concurrency (), offline_jobs.size ());
+
+	std::vector<Glib::Threads::Thread*> workers;
+	for (uint32_t i = 0; i < n_workers; ++i) {
+		workers.push_back (Glib::Threads::Thread::create (boost::bind (&ExportHandler::offline_export_worker, this)));
+	}
+	for (std::vector<Glib::Threads::Thread*>::iterator i = workers.begin(); i != workers.end(); ++i) {
+		(*i)->join ();
+	}
+
+	/* all files are closed now, tag them and run post-export commands */
+
+	if (!export_status->aborted ()) {
+		for (std::vector<OfflineJob>::const_iterator j = offline_jobs.begin(); j != offline_jobs.end(); ++j) {
+			for (std::list<FileSpec>::const_iterator s = j->specs.begin(); s != j->specs.end(); ++s) {
+				finish_file (j->timespan, *s);
+			}
+		}
+	}
+
+	offline_jobs.clear ();
+
+	Glib::Threads::Mutex::Lock l (export_status->lock());
+	export_status->set_running (false);
+}
+
+void
+ExportHandler::offline_export_worker ()
+{
+	while (!export_status->aborted ()) {
+		size_t const n = g_atomic_int_add (&offline_job_index, 1);
+		if (n >= offline_jobs.size ()) {
+			break;
+		}
+		render_offline (offline_jobs[n]);
+	}
+}
+
+void
+ExportHandler::render_offline (OfflineJob const & job)
+{
+	ExportGraphBuilder builder (session);
+
+	try {
+		builder.set_current_timespan (job.timespan);
+		for (std::list<FileSpec>::const_iterator s = job.specs.begin(); s != job.specs.end(); ++s) {
+			builder.add_config (*s, false);
+		}
+
+		samplecnt_t const block_size = session.engine().samples_per_cycle();
+		samplepos_t const end = job.timespan->get_end ();
+		samplepos_t pos = job.timespan->get_start ();
+
+		while (pos < end && !export_status->aborted ()) {
+			samplecnt_t const n = std::min (block_size, end - pos);
+			pos += n;
+			builder.process (n, pos == end);
+
+			Glib::Threads::Mutex::Lock lm (offline_lock);
+			export_status->processed_samples += n;
+			export_status->processed_samples_current_timespan += n;
+		}
+
+		while (!export_status->aborted () && builder.need_postprocessing () && !builder.post_process ()) {
+			;
+		}
+
+		Glib::Threads::Mutex::Lock lm (offline_lock);
+		builder.get_analysis_results (export_status->result_map);
+
+	} catch (std::exception& e) {
+		error << string_compose (_("Export failed: %1"), e.what ()) << endmsg;
+		export_status->abort (true);
+	}
+
+	builder.cleanup (export_status->aborted ());
+}
+
 void
 ExportHandler::start_timespan ()
 {
@@ -340,138 +525,147 @@ ExportHandler::finish_timespan ()
 {
 	graph_builder->get_analysis_results (export_status->result_map);
 
+	/* close files first, otherwise TagLib enounters an ERROR_SHARING_VIOLATION
+	 * The process cannot access the file because it is being used.
+	 * ditto for post-export and upload.
+	 */
+	graph_builder->reset ();
+
 	while (config_map.begin() != timespan_bounds.second) {
+		finish_file (current_timespan, config_map.begin()->second);
+		config_map.erase (config_map.begin());
+	}
 
-		ExportFormatSpecPtr fmt = config_map.begin()->second.format;
-		std::string filename = config_map.begin()->second.filename->get_path(fmt);
-		if (fmt->with_cue()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerCUE);
-		}
+	start_timespan ();
+}
 
-		if (fmt->with_toc()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerTOC);
-		}
+/** Write cue/toc files, tag and run post-export commands for a file that has been
+ *  completely written and closed. Called once for every FileSpec of a timespan,
+ *  also from the raw stem export thread, so it must not touch graph_builder.
+ */
+void
+ExportHandler::finish_file (ExportTimespanPtr timespan, FileSpec const & spec)
+{
+	ExportFormatSpecPtr fmt = spec.format;
+	std::string filename = spec.filename->get_path(fmt);
+	if (fmt->with_cue()) {
+		export_cd_marker_file (timespan, fmt, filename, CDMarkerCUE);
+	}
 
-		if (fmt->with_mp4chaps()) {
-			export_cd_marker_file (current_timespan, fmt, filename, MP4Chaps);
-		}
+	if (fmt->with_toc()) {
+		export_cd_marker_file (timespan, fmt, filename, CDMarkerTOC);
+	}
 
-		Session::Exported (current_timespan->name(), filename); /* EMIT SIGNAL */
+	if (fmt->with_mp4chaps()) {
+		export_cd_marker_file (timespan, fmt, filename, MP4Chaps);
+	}
 
-		/* close file first, otherwise TagLib enounters an ERROR_SHARING_VIOLATION
-		 * The process cannot access the file because it is being used.
-		 * ditto for post-export and upload.
-		 */
-		graph_builder->reset ();
+	Session::Exported (timespan->name(), filename); /* EMIT SIGNAL */
 
-		if (fmt->tag()) {
-			/* TODO: check Umlauts and encoding in filename.
-			 * TagLib eventually calls CreateFileA(),
-			 */
-			export_status->active_job = ExportStatus::Tagging;
-			AudiofileTagger::tag_file(filename, *SessionMetadata::Metadata());
-		}
+	if (fmt->tag()) {
+		/* TODO: check Umlauts and encoding in filename.
+		 * TagLib eventually calls CreateFileA(),
+		 */
+		export_status->active_job = ExportStatus::Tagging;
+		AudiofileTagger::tag_file(filename, *SessionMetadata::Metadata());
+	}
 
-		if (!fmt->command().empty()) {
-			SessionMetadata const & metadata (*SessionMetadata::Metadata());
+	if (!fmt->command().empty()) {
+		SessionMetadata const & metadata (*SessionMetadata::Metadata());
 
 #if 0	// would be nicer with C++11 initialiser...
-			std::map<char, std::string> subs {
-				{ 'f', filename },
-				{ 'd', Glib::path_get_dirname(filename)  + G_DIR_SEPARATOR },
-				{ 'b', PBD::basename_nosuffix(filename) },
-				...
-			};
+		std::map<char, std::string> subs {
+			{ 'f', filename },
+			{ 'd', Glib::path_get_dirname(filename)  + G_DIR_SEPARATOR },
+			{ 'b', PBD::basename_nosuffix(filename) },
+			...
+		};
 #endif
-			export_status->active_job = ExportStatus::Command;
-			PBD::ScopedConnection command_connection;
-			std::map<char, std::string> subs;
-
-			std::stringstream track_number;
-			track_number << metadata.track_number ();
-			std::stringstream total_tracks;
-			total_tracks << metadata.total_tracks ();
-			std::stringstream year;
-			year << metadata.year ();
-
-			subs.insert (std::pair<char, std::string> ('a', metadata.artist ()));
-			subs.insert (std::pair<char, std::string> ('b', PBD::basename_nosuffix (filename)));
-			subs.insert (std::pair<char, std::string> ('c', metadata.copyright ()));
-			subs.insert (std::pair<char, std::string> ('d', Glib::path_get_dirname (filename) + G_DIR_SEPARATOR));
-			subs.insert (std::pair<char, std::string> ('f', filename));
-			subs.insert (std::pair<char, std::string> ('l', metadata.lyricist ()));
-			subs.insert (std::pair<char, std::string> ('n', session.name ()));
-			subs.insert (std::pair<char, std::string> ('s', session.path ()));
-			subs.insert (std::pair<char, std::string> ('o', metadata.conductor ()));
-			subs.insert (std::pair<char, std::string> ('t', metadata.title ()));
-			subs.insert (std::pair<char, std::string> ('z', metadata.organization ()));
-			subs.insert (std::pair<char, std::string> ('A', metadata.album ()));
-			subs.insert (std::pair<char, std::string> ('C', metadata.comment ()));
-			subs.insert (std::pair<char, std::string> ('E', metadata.engineer ()));
-			subs.insert (std::pair<char, std::string> ('G', metadata.genre ()));
-			subs.insert (std::pair<char, std::string> ('L', total_tracks.str ()));
-			subs.insert (std::pair<char, std::string> ('M', metadata.mixer ()));
-			subs.insert (std::pair<char, std::string> ('N', current_timespan->name())); // =?= config_map.begin()->first->name ()
-			subs.insert (std::pair<char, std::string> ('O', metadata.composer ()));
-			subs.insert (std::pair<char, std::string> ('P', metadata.producer ()));
-			subs.insert (std::pair<char, std::string> ('S', metadata.disc_subtitle ()));
-			subs.insert (std::pair<char, std::string> ('T', track_number.str ()));
-			subs.insert (std::pair<char, std::string> ('Y', year.str ()));
-			subs.insert (std::pair<char, std::string> ('Z', metadata.country ()));
-
-			ARDOUR::SystemExec *se = new ARDOUR::SystemExec(fmt->command(), subs);
-			info << "Post-export command line : {" << se->to_s () << "}" << endmsg;
-			se->ReadStdout.connect_same_thread(command_connection, boost::bind(&ExportHandler::command_output, this, _1, _2));
-			int ret = se->start (2);
-			if (ret == 0) {
-				// successfully started
-				while (se->is_running ()) {
-					// wait for system exec to terminate
-					Glib::usleep (1000);
-				}
-			} else {
-				error << "Post-export command FAILED with Error: " << ret << endmsg;
+		export_status->active_job = ExportStatus::Command;
+		PBD::ScopedConnection command_connection;
+		std::map<char, std::string> subs;
+
+		std::stringstream track_number;
+		track_number << metadata.track_number ();
+		std::stringstream total_tracks;
+		total_tracks << metadata.total_tracks ();
+		std::stringstream year;
+		year << metadata.year ();
+
+		subs.insert (std::pair<char, std::string> ('a', metadata.artist ()));
+		subs.insert (std::pair<char, std::string> ('b', PBD::basename_nosuffix (filename)));
+		subs.insert (std::pair<char, std::string> ('c', metadata.copyright ()));
+		subs.insert (std::pair<char, std::string> ('d', Glib::path_get_dirname (filename) + G_DIR_SEPARATOR));
+		subs.insert (std::pair<char, std::string> ('f', filename));
+		subs.insert (std::pair<char, std::string> ('l', metadata.lyricist ()));
+		subs.insert (std::pair<char, std::string> ('n', session.name ()));
+		subs.insert (std::pair<char, std::string> ('s', session.path ()));
+		subs.insert (std::pair<char, std::string> ('o', metadata.conductor ()));
+		subs.insert (std::pair<char, std::string> ('t', metadata.title ()));
+		subs.insert (std::pair<char, std::string> ('z', metadata.organization ()));
+		subs.insert (std::pair<char, std::string> ('A', metadata.album ()));
+		subs.insert (std::pair<char, std::string> ('C', metadata.comment ()));
+		subs.insert (std::pair<char, std::string> ('E', metadata.engineer ()));
+		subs.insert (std::pair<char, std::string> ('G', metadata.genre ()));
+		subs.insert (std::pair<char, std::string> ('L', total_tracks.str ()));
+		subs.insert (std::pair<char, std::string> ('M', metadata.mixer ()));
+		subs.insert (std::pair<char, std::string> ('N', timespan->name()));
+		subs.insert (std::pair<char, std::string> ('O', metadata.composer ()));
+		subs.insert (std::pair<char, std::string> ('P', metadata.producer ()));
+		subs.insert (std::pair<char, std::string> ('S', metadata.disc_subtitle ()));
+		subs.insert (std::pair<char, std::string> ('T', track_number.str ()));
+		subs.insert (std::pair<char, std::string> ('Y', year.str ()));
+		subs.insert (std::pair<char, std::string> ('Z', metadata.country ()));
+
+		ARDOUR::SystemExec *se = new ARDOUR::SystemExec(fmt->command(), subs);
+		info << "Post-export command line : {" << se->to_s () << "}" << endmsg;
+		se->ReadStdout.connect_same_thread(command_connection, boost::bind(&ExportHandler::command_output, this, _1, _2));
+		int ret = se->start (2);
+		if (ret == 0) {
+			// successfully started
+			while (se->is_running ()) {
+				// wait for system exec to terminate
+				Glib::usleep (1000);
 			}
-			delete (se);
+		} else {
+			error << "Post-export command FAILED with Error: " << ret << endmsg;
 		}
+		delete (se);
+	}
 
-		// XXX THIS IS IN REALTIME CONTEXT, CALLED FROM
-		// AudioEngine::process_callback()
-		// freewheeling, yes, but still uploading here is NOT
-		// a good idea.
-		//
-		// even less so, since SoundcloudProgress is using
-		// connect_same_thread() - GUI updates from the RT thread
-		// will cause crashes. http://pastebin.com/UJKYNGHR
-		if (fmt->soundcloud_upload()) {
-			SoundcloudUploader *soundcloud_uploader = new SoundcloudUploader;
-			std::string token = soundcloud_uploader->Get_Auth_Token(soundcloud_username, soundcloud_password);
-			DEBUG_TRACE (DEBUG::Soundcloud, string_compose(
-						"uploading %1 - username=%2, password=%3, token=%4",
-						filename, soundcloud_username, soundcloud_password, token) );
-			std::string path = soundcloud_uploader->Upload (
-					filename,
-					PBD::basename_nosuffix(filename), // title
-					token,
-					soundcloud_make_public,
-					soundcloud_downloadable,
-					this);
-
-			if (path.length() != 0) {
-				info << string_compose ( _("File %1 uploaded to %2"), filename, path) << endmsg;
-				if (soundcloud_open_page) {
-					DEBUG_TRACE (DEBUG::Soundcloud, string_compose ("opening %1", path) );
-					open_uri(path.c_str());  // open the soundcloud website to the new file
-				}
-			} else {
-				error << _("upload to Soundcloud failed. Perhaps your email or password are incorrect?\n") << endmsg;
+	// XXX THIS IS IN REALTIME CONTEXT, CALLED FROM
+	// AudioEngine::process_callback()
+	// freewheeling, yes, but still uploading here is NOT
+	// a good idea.
+	//
+	// even less so, since SoundcloudProgress is using
+	// connect_same_thread() - GUI updates from the RT thread
+	// will cause crashes. http://pastebin.com/UJKYNGHR
+	if (fmt->soundcloud_upload()) {
+		SoundcloudUploader *soundcloud_uploader = new SoundcloudUploader;
+		std::string token = soundcloud_uploader->Get_Auth_Token(soundcloud_username, soundcloud_password);
+		DEBUG_TRACE (DEBUG::Soundcloud, string_compose(
+					"uploading %1 - username=%2, password=%3, token=%4",
+					filename, soundcloud_username, soundcloud_password, token) );
+		std::string path = soundcloud_uploader->Upload (
+				filename,
+				PBD::basename_nosuffix(filename), // title
+				token,
+				soundcloud_make_public,
+				soundcloud_downloadable,
+				this);
+
+		if (path.length() != 0) {
+			info << string_compose ( _("File %1 uploaded to %2"), filename, path) << endmsg;
+			if (soundcloud_open_page) {
+				DEBUG_TRACE (DEBUG::Soundcloud, string_compose ("opening %1", path) );
+				open_uri(path.c_str());  // open the soundcloud website to the new file
 			}
-			delete soundcloud_uploader;
+		} else {
+			error << _("upload to Soundcloud failed. Perhaps your email or password are incorrect?\n") << endmsg;
 		}
-		config_map.erase (config_map.begin());
+		delete soundcloud_uploader;
 	}
-
-	start_timespan ();
 }
 
 void
@@ -27,6 +27,7 @@ const char* const template_suffix = X_(".template");
 const char* const statefile_suffix = X_(".ardour");
 const char* const pending_suffix = X_(".pending");
 const char* const peakfile_suffix = X_(".peak");
+const char* const peakfile_levels_suffix = X_(".levels");
 const char* const backup_suffix = X_(".bak");
 const char* const temp_suffix = X_(".tmp");
 const char* const history_suffix = X_(".history");
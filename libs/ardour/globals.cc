@@ -141,6 +141,8 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain = 0;
 copy_vector_t			ARDOUR::copy_vector = 0;
+mix_buffers_with_gain_ramp_t	ARDOUR::mix_buffers_with_gain_ramp = 0;
+apply_gain_find_peaks_t		ARDOUR::apply_gain_find_peaks = 0;
 
 PBD::Signal1<void,std::string> ARDOUR::BootMessage;
 PBD::Signal3<void,std::string,std::string,bool> ARDOUR::PluginScanMessage;
@@ -172,6 +174,44 @@ setup_hardware_optimization (bool try_optimization)
 
 #if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
 
+		/* the fused functions are only optimized in the AVX-512 and FMA sets */
+		mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
+		apply_gain_find_peaks      = default_apply_gain_find_peaks;
+
+#ifndef PLATFORM_WINDOWS
+		if (fpu->has_avx512f()) {
+
+			info << "Using AVX-512 optimized routines" << endmsg;
+
+			compute_peak               = x86_avx512f_compute_peak;
+			find_peaks                 = x86_avx512f_find_peaks;
+			apply_gain_to_buffer       = x86_avx512f_apply_gain_to_buffer;
+			mix_buffers_with_gain      = x86_avx512f_mix_buffers_with_gain;
+			mix_buffers_no_gain        = x86_avx512f_mix_buffers_no_gain;
+			copy_vector                = x86_avx512f_copy_vector;
+			mix_buffers_with_gain_ramp = x86_avx512f_mix_buffers_with_gain_ramp;
+			apply_gain_find_peaks      = x86_avx512f_apply_gain_find_peaks;
+
+			generic_mix_functions = false;
+
+		} else if (fpu->has_avx() && fpu->has_fma()) {
+
+			info << "Using AVX/FMA optimized routines" << endmsg;
+
+			compute_peak               = x86_fma_compute_peak;
+			find_peaks                 = x86_fma_find_peaks;
+			apply_gain_to_buffer       = x86_fma_apply_gain_to_buffer;
+			mix_buffers_with_gain      = x86_fma_mix_buffers_with_gain;
+			mix_buffers_no_gain        = x86_fma_mix_buffers_no_gain;
+			copy_vector                = x86_fma_copy_vector;
+			mix_buffers_with_gain_ramp = x86_fma_mix_buffers_with_gain_ramp;
+			apply_gain_find_peaks      = x86_fma_apply_gain_find_peaks;
+
+			generic_mix_functions = false;
+
+		} else
+#endif
+
 #ifdef PLATFORM_WINDOWS
 		/* We have AVX-optimized code for Windows */
 
@@ -218,6 +258,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain  = veclib_mix_buffers_with_gain;
 			mix_buffers_no_gain    = veclib_mix_buffers_no_gain;
 			copy_vector            = default_copy_vector;
+			mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
+			apply_gain_find_peaks  = default_apply_gain_find_peaks;
 
 			generic_mix_functions = false;
 
@@ -238,6 +280,8 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_with_gain = default_mix_buffers_with_gain;
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
+		mix_buffers_with_gain_ramp = default_mix_buffers_with_gain_ramp;
+		apply_gain_find_peaks = default_apply_gain_find_peaks;
 
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
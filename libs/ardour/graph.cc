@@ -26,6 +26,8 @@
 
 #include "ardour/debug.h"
 #include "ardour/graph.h"
+#include "ardour/pipeline_break.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/types.h"
 #include "ardour/session.h"
 #include "ardour/route.h"
@@ -51,15 +53,25 @@ int alloc_allowed ()
 }
 #endif
 
+static void do_not_delete_the_thread_id (void*) { }
+
+/** index into Graph::_ws_queues of the calling process-thread */
+static Glib::Threads::Private<uint32_t> graph_thread_id (do_not_delete_the_thread_id);
+
 Graph::Graph (Session & session)
 	: SessionHandleRef (session)
 	, _threads_active (false)
 	, _execution_sem ("graph_execution", 0)
+	, _ws_active (false)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
 {
 	pthread_mutex_init( &_trigger_mutex, NULL);
 
+	_init_trigger_avail = 0;
+	_ws_next_thread_id = 0;
+	_ws_overflow = 0;
+
 	/* XXX: rather hacky `fix' to stop _trigger_queue.push_back() allocating
 	 * memory in the RT thread.
 	 */
@@ -85,6 +97,11 @@ Graph::Graph (Session & session)
 #endif
 }
 
+Graph::~Graph ()
+{
+	ws_drop_queues ();
+}
+
 void
 Graph::engine_stopped ()
 {
@@ -119,6 +136,13 @@ Graph::reset_thread_list ()
 		drop_threads ();
 	}
 
+	/* one work-stealing queue per thread, the main thread uses queue 0 */
+	ws_drop_queues ();
+	for (uint32_t i = 0; i < num_threads; ++i) {
+		_ws_queues.push_back (new WSQueue (8192));
+	}
+	_ws_next_thread_id = 1;
+
 	_threads_active = true;
 
 	if (AudioEngine::instance()->create_process_thread (boost::bind (&Graph::main_thread, this)) != 0) {
@@ -142,9 +166,22 @@ Graph::session_going_away()
 	_nodes_rt[1].clear();
 	_init_trigger_list[0].clear();
 	_init_trigger_list[1].clear();
+	_init_trigger_vec[0].clear();
+	_init_trigger_vec[1].clear();
+	_pipeline_stages[0].clear();
+	_pipeline_stages[1].clear();
 	_trigger_queue.clear();
 }
 
+void
+Graph::ws_drop_queues ()
+{
+	for (std::vector<WSQueue*>::iterator i = _ws_queues.begin(); i != _ws_queues.end(); ++i) {
+		delete *i;
+	}
+	_ws_queues.clear ();
+}
+
 void
 Graph::drop_threads ()
 {
@@ -199,6 +236,8 @@ Graph::clear_other_chain ()
 
 			_nodes_rt[_setup_chain].clear ();
 			_init_trigger_list[_setup_chain].clear ();
+			_init_trigger_vec[_setup_chain].clear ();
+			_pipeline_stages[_setup_chain].clear ();
 			break;
 		}
 		/* setup chain == pending chain - we have
@@ -219,6 +258,12 @@ Graph::prep()
 		if (_current_chain != _pending_chain)
 		{
 			// printf ("chain swap ! %d -> %d\n", _current_chain, _pending_chain);
+			/* routes that are no longer split run the complete
+			 * processor chain themselves.
+			 */
+			for (std::vector<boost::shared_ptr<PipelineStageNode> >::const_iterator i = _pipeline_stages[_current_chain].begin(); i != _pipeline_stages[_current_chain].end(); ++i) {
+				(*i)->pipeline_break()->set_split (false);
+			}
 			_setup_chain = _current_chain;
 			_current_chain = _pending_chain;
 			_cleanup_cond.signal ();
@@ -228,6 +273,9 @@ Graph::prep()
 
 	chain = _current_chain;
 
+	/* the scheduler can only change between cycles, when no nodes are queued */
+	_ws_active = Config->get_graph_scheduler () == WorkStealingScheduler && !_ws_queues.empty ();
+
 	_graph_empty = true;
 	for (i=_nodes_rt[chain].begin(); i!=_nodes_rt[chain].end(); i++) {
 		(*i)->prep( chain);
@@ -235,6 +283,21 @@ Graph::prep()
 	}
 	_finished_refcount = _init_finished_refcount[chain];
 
+	/* the pipeline buffers can only be flipped while neither stage runs */
+	for (std::vector<boost::shared_ptr<PipelineStageNode> >::const_iterator i = _pipeline_stages[chain].begin(); i != _pipeline_stages[chain].end(); ++i) {
+		(*i)->pipeline_break()->set_split (true);
+		(*i)->pipeline_break()->cycle_start ();
+	}
+
+	if (_ws_active) {
+		/* publish the initial nodes, threads claim them in ws_find_work() */
+		int n_init = _init_trigger_vec[chain].size ();
+		g_atomic_int_set (&_init_trigger_avail, n_init);
+		/* this thread will run one of them, wake others for the rest */
+		ws_wakeup (n_init - 1);
+		return;
+	}
+
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
 	pthread_mutex_lock (&_trigger_mutex);
 	for (i=_init_trigger_list[chain].begin(); i!=_init_trigger_list[chain].end(); i++) {
@@ -247,6 +310,17 @@ Graph::prep()
 void
 Graph::trigger (GraphNode* n)
 {
+	if (_ws_active) {
+		uint32_t* id = graph_thread_id.get ();
+		if (id && _ws_queues[*id]->push (n)) {
+			return;
+		}
+		/* not called from a graph thread, or the thread's queue is full:
+		 * fall back to the shared queue.
+		 */
+		g_atomic_int_inc (&_ws_overflow);
+	}
+
 	pthread_mutex_lock (&_trigger_mutex);
 	_trigger_queue.push_back (n);
 	pthread_mutex_unlock (&_trigger_mutex);
@@ -316,6 +390,8 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
 	 * those at the `input' end.
 	 */
 	_init_trigger_list[chain].clear();
+	_init_trigger_vec[chain].clear();
+	_pipeline_stages[chain].clear();
 
 	_nodes_rt[chain].clear();
 
@@ -324,6 +400,13 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
 		(*ri)->_init_refcount[chain] = 0;
 		(*ri)->_activation_set[chain].clear();
 		_nodes_rt[chain].push_back (*ri);
+
+		boost::shared_ptr<PipelineStageNode> stage = (*ri)->pipeline_stage ();
+		if (stage) {
+			stage->_init_refcount[chain] = 0;
+			stage->_activation_set[chain].clear();
+			_pipeline_stages[chain].push_back (stage);
+		}
 	}
 
 	// now add refs for the connections.
@@ -338,25 +421,56 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
 		/* Hence whether r has an output */
 		bool const has_output = !fed_from_r.empty ();
 
+		/* A pipelined route's output is produced by its second stage.
+		 * That stage only depends on data of the previous cycle, so it
+		 * is an initial node, and feeds what the route would have fed.
+		 * The route itself does not feed anything in this cycle.
+		 */
+		boost::shared_ptr<PipelineStageNode> stage = r->pipeline_stage ();
+		boost::shared_ptr<GraphNode> feeder = stage ? boost::shared_ptr<GraphNode> (stage) : boost::shared_ptr<GraphNode> (r);
+
 		/* Set up r's activation set */
 		for (set<GraphVertex>::iterator i = fed_from_r.begin(); i != fed_from_r.end(); ++i) {
-			r->_activation_set[chain].insert (*i);
+			feeder->_activation_set[chain].insert (*i);
+		}
+
+		/* sends in the first stage deliver in this cycle, too */
+		bool const first_stage_feeds = stage && has_output && r->pipeline_first_stage_feeds ();
+
+		if (first_stage_feeds) {
+			for (set<GraphVertex>::iterator i = fed_from_r.begin(); i != fed_from_r.end(); ++i) {
+				r->_activation_set[chain].insert (*i);
+				(*i)->_init_refcount[chain] += 1;
+			}
 		}
 
 		/* r has an input if there are some incoming edges to r in the graph */
 		bool const has_input = !edges.has_none_to (r);
 
 		/* Increment the refcount of any route that we directly feed */
-		for (node_set_t::iterator ai = r->_activation_set[chain].begin(); ai != r->_activation_set[chain].end(); ai++) {
+		for (node_set_t::iterator ai = feeder->_activation_set[chain].begin(); ai != feeder->_activation_set[chain].end(); ai++) {
 			(*ai)->_init_refcount[chain] += 1;
 		}
 
+		if (stage) {
+			_init_trigger_list[chain].push_back (stage);
+			_init_trigger_vec[chain].push_back (stage.get ());
+			/* the route's first stage is a terminal node, unless it feeds others */
+			if (!first_stage_feeds) {
+				_init_finished_refcount[chain] += 1;
+			}
+			if (!has_output) {
+				_init_finished_refcount[chain] += 1;
+			}
+		}
+
 		if (!has_input) {
 			/* no input, so this node needs to be triggered initially to get things going */
 			_init_trigger_list[chain].push_back (*ni);
+			_init_trigger_vec[chain].push_back (ni->get ());
 		}
 
-		if (!has_output) {
+		if (!has_output && !stage) {
 			/* no output, so this is one of the nodes that we can count off to decide
 			 * if we've finished
 			 */
@@ -364,6 +478,11 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
 		}
 	}
 
+	/* add the second stages (after the loop above, which iterates over routes only) */
+	for (std::vector<boost::shared_ptr<PipelineStageNode> >::const_iterator i = _pipeline_stages[chain].begin(); i != _pipeline_stages[chain].end(); ++i) {
+		_nodes_rt[chain].push_back (*i);
+	}
+
 	_pending_chain = chain;
 	dump(chain);
 }
@@ -373,6 +492,15 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
  */
 bool
 Graph::run_one()
+{
+	if (_ws_active) {
+		return run_one_ws ();
+	}
+	return run_one_shared ();
+}
+
+bool
+Graph::run_one_shared ()
 {
 	GraphNode* to_run;
 
@@ -392,7 +520,7 @@ Graph::run_one()
 	/* hence how many threads to wake up */
 	int wakeup = min (et, ts);
 	/* update the number of threads that will still be sleeping */
-	_execution_tokens -= wakeup;
+	g_atomic_int_add (&_execution_tokens, -wakeup);
 
 	DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 signals %2\n", pthread_name(), wakeup));
 
@@ -401,13 +529,17 @@ Graph::run_one()
 	}
 
 	while (to_run == 0) {
-		_execution_tokens += 1;
+		g_atomic_int_inc (&_execution_tokens);
 		pthread_mutex_unlock (&_trigger_mutex);
 		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name()));
 		_execution_sem.wait ();
 		if (!_threads_active) {
 			return true;
 		}
+		if (_ws_active) {
+			/* scheduler was changed while we were asleep */
+			return false;
+		}
 		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 is awake\n", pthread_name()));
 		pthread_mutex_lock (&_trigger_mutex);
 		if (_trigger_queue.size()) {
@@ -425,9 +557,165 @@ Graph::run_one()
 	return !_threads_active;
 }
 
+/* Work-stealing scheduler.
+ *
+ * Every process thread owns a lock-free deque. Nodes that become ready
+ * when a node finishes are pushed to the finishing thread's own deque
+ * (see ::trigger), which it then pops LIFO, so a chain of routes tends to
+ * stay on one core. Idle threads first claim one of the cycle's initial
+ * nodes and otherwise steal (FIFO) from the other threads' deques.
+ *
+ * Sleeping threads are counted in _execution_tokens and woken in batches
+ * via _execution_sem, as with the shared queue. A thread that is about to
+ * sleep first announces itself and then re-checks for work, so a node
+ * that is published concurrently is never missed: either the sleeper sees
+ * it, or the publisher sees the sleeper's token and wakes it.
+ */
+
+GraphNode*
+Graph::ws_find_work (uint32_t id)
+{
+	GraphNode* n = _ws_queues[id]->pop ();
+
+	if (n) {
+		return n;
+	}
+
+	/* claim one of the initial nodes of this cycle */
+	gint avail;
+	while ((avail = g_atomic_int_get (&_init_trigger_avail)) > 0) {
+		if (g_atomic_int_compare_and_exchange (&_init_trigger_avail, avail, avail - 1)) {
+			return _init_trigger_vec[_current_chain][avail - 1];
+		}
+	}
+
+	/* steal from other threads, starting with our neighbour */
+	uint32_t const n_queues = _ws_queues.size ();
+	for (uint32_t i = 1; i < n_queues; ++i) {
+		if ((n = _ws_queues[(id + i) % n_queues]->steal ()) != 0) {
+			return n;
+		}
+	}
+
+	if (g_atomic_int_get (&_ws_overflow) > 0) {
+		pthread_mutex_lock (&_trigger_mutex);
+		if (!_trigger_queue.empty ()) {
+			n = _trigger_queue.back ();
+			_trigger_queue.pop_back ();
+			g_atomic_int_add (&_ws_overflow, -1);
+		}
+		pthread_mutex_unlock (&_trigger_mutex);
+	}
+
+	return n;
+}
+
+bool
+Graph::ws_work_available () const
+{
+	if (g_atomic_int_get (const_cast<gint*> (&_init_trigger_avail)) > 0) {
+		return true;
+	}
+	if (g_atomic_int_get (const_cast<gint*> (&_ws_overflow)) > 0) {
+		return true;
+	}
+	for (std::vector<WSQueue*>::const_iterator i = _ws_queues.begin (); i != _ws_queues.end (); ++i) {
+		if (!(*i)->empty ()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Take back a token that was announced before going to sleep.
+ *  @return false if a waker already consumed the token, in which case
+ *  the semaphore has been signalled for us and must be waited for.
+ */
+bool
+Graph::ws_cancel_sleep ()
+{
+	gint tokens;
+	while ((tokens = g_atomic_int_get (&_execution_tokens)) > 0) {
+		if (g_atomic_int_compare_and_exchange (&_execution_tokens, tokens, tokens - 1)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** wake up to @param n sleeping threads */
+void
+Graph::ws_wakeup (int n)
+{
+	if (n <= 0) {
+		return;
+	}
+
+	gint tokens;
+	int  wakeup;
+
+	do {
+		tokens = g_atomic_int_get (&_execution_tokens);
+		wakeup = min (n, (int) tokens);
+		if (wakeup <= 0) {
+			return;
+		}
+	} while (!g_atomic_int_compare_and_exchange (&_execution_tokens, tokens, tokens - wakeup));
+
+	DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 signals %2\n", pthread_name(), wakeup));
+
+	for (int i = 0; i < wakeup; ++i) {
+		_execution_sem.signal ();
+	}
+}
+
+bool
+Graph::run_one_ws ()
+{
+	uint32_t const id = *graph_thread_id.get ();
+	GraphNode* to_run;
+
+	while ((to_run = ws_find_work (id)) == 0) {
+
+		g_atomic_int_inc (&_execution_tokens);
+
+		if (ws_work_available () && ws_cancel_sleep ()) {
+			continue;
+		}
+
+		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name()));
+		_execution_sem.wait ();
+
+		if (!_threads_active) {
+			return true;
+		}
+		if (!_ws_active) {
+			/* scheduler was changed while we were asleep */
+			return false;
+		}
+		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 is awake\n", pthread_name()));
+	}
+
+	to_run->process ();
+	to_run->finish (_current_chain);
+
+	/* keep one of the nodes that became ready for ourselves,
+	 * wake others to steal the rest.
+	 */
+	ws_wakeup ((int) _ws_queues[id]->size () - 1);
+
+	DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 has finished run_one_ws()\n", pthread_name()));
+
+	return !_threads_active;
+}
+
 void
 Graph::helper_thread()
 {
+	uint32_t id = g_atomic_int_add (&_ws_next_thread_id, 1);
+	assert (id < _ws_queues.size ());
+	graph_thread_id.set (&id);
+
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
 	resume_rt_malloc_checks ();
@@ -448,6 +736,9 @@ Graph::helper_thread()
 void
 Graph::main_thread()
 {
+	uint32_t id = 0;
+	graph_thread_id.set (&id);
+
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
 	resume_rt_malloc_checks ();
@@ -485,6 +776,22 @@ again:
 	delete (pt);
 }
 
+#ifndef NDEBUG
+static std::string
+node_name (node_ptr_t const& n)
+{
+	boost::shared_ptr<Route> r = boost::dynamic_pointer_cast<Route> (n);
+	if (r) {
+		return r->name ();
+	}
+	boost::shared_ptr<PipelineStageNode> s = boost::dynamic_pointer_cast<PipelineStageNode> (n);
+	if (s) {
+		return s->route()->name () + " (stage 2)";
+	}
+	return "?";
+}
+#endif
+
 void
 Graph::dump (int chain)
 {
@@ -496,16 +803,15 @@ Graph::dump (int chain)
 
 	DEBUG_TRACE (DEBUG::Graph, "--------------------------------------------Graph dump:\n");
 	for (ni=_nodes_rt[chain].begin(); ni!=_nodes_rt[chain].end(); ni++) {
-		boost::shared_ptr<Route> rp = boost::dynamic_pointer_cast<Route>( *ni);
-		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", rp->name().c_str(), (*ni)->_init_refcount[chain]));
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", node_name (*ni), (*ni)->_init_refcount[chain]));
 		for (ai=(*ni)->_activation_set[chain].begin(); ai!=(*ni)->_activation_set[chain].end(); ai++) {
-			DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", boost::dynamic_pointer_cast<Route>(*ai)->name().c_str()));
+			DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", node_name (*ai)));
 		}
 	}
 
 	DEBUG_TRACE (DEBUG::Graph, "------------- trigger list:\n");
 	for (ni=_init_trigger_list[chain].begin(); ni!=_init_trigger_list[chain].end(); ni++) {
-		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", boost::dynamic_pointer_cast<Route>(*ni)->name().c_str(), (*ni)->_init_refcount[chain]));
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", node_name (*ni), (*ni)->_init_refcount[chain]));
 	}
 
 	DEBUG_TRACE (DEBUG::Graph, string_compose ("final activation refcount: %1\n", _init_finished_refcount[chain]));
@@ -585,6 +891,22 @@ Graph::process_one_route (Route* route)
 	}
 }
 
+void
+Graph::process_one_pipeline_stage (Route* route)
+{
+	int retval;
+
+	assert (route);
+
+	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 runs 2nd stage of route %2\n", pthread_name(), route->name()));
+
+	retval = route->run_pipeline_stage (_process_nframes, _process_start_sample, _process_end_sample, !_process_noroll, _process_non_rt_pending);
+
+	if (retval) {
+		_process_retval = retval;
+	}
+}
+
 bool
 Graph::in_process_thread () const
 {
@@ -18,51 +18,145 @@
 
 #include <glibmm/threads.h>
 
+#include "ardour/audioengine.h"
 #include "ardour/internal_return.h"
 #include "ardour/internal_send.h"
 #include "ardour/route.h"
+#include "ardour/session.h"
+#include "ardour/utils.h"
 
 using namespace std;
 using namespace ARDOUR;
 
 InternalReturn::InternalReturn (Session& s)
 	: Return (s, true)
+	, _sends (new SendList)
+	, _next_lane (0)
+	, _cycle (0)
+	, _summed_cycle (0)
 {
         _display_to_user = false;
+	InternalSend::CycleStart.connect_same_thread (*this, boost::bind (&InternalReturn::cycle_start, this, _1));
+}
+
+InternalReturn::~InternalReturn ()
+{
+	drop_lanes ();
+}
+
+void
+InternalReturn::cycle_start (pframes_t)
+{
+	++_cycle;
 }
 
 void
 InternalReturn::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sample*/, double /*speed*/, pframes_t nframes, bool)
 {
-	if (!_active && !_pending_active) {
+	const bool active = _active || _pending_active;
+
+	/* the sends have been summed into the lanes by now, add those up.
+	 * Data of a send that ran after us in the previous cycle (a send with
+	 * feedback allowed) is still used, anything older is dropped.
+	 *
+	 * A send with feedback allowed may still be adding to a lane. Do not
+	 * wait for it, sum the buffers of the sends directly instead.
+	 */
+	vector<Lane*>::iterator l;
+
+	for (l = _lanes.begin (); l != _lanes.end (); ++l) {
+		if (!g_atomic_int_compare_and_exchange (&(*l)->lock, 0, 1)) {
+			break;
+		}
+	}
+
+	if (l == _lanes.end ()) {
+		for (l = _lanes.begin (); l != _lanes.end (); ++l) {
+			Lane& lane (**l);
+			if (active && !lane.empty && lane.cycle + 1 >= _cycle && lane.cycle > _summed_cycle) {
+				bufs.merge_from (lane.bufs, nframes);
+			}
+			lane.empty = true;
+			g_atomic_int_set (&lane.lock, 0);
+		}
+	} else {
+		for (vector<Lane*>::iterator u = _lanes.begin (); u != l; ++u) {
+			(*u)->empty = true;
+			g_atomic_int_set (&(*u)->lock, 0);
+		}
+
+		/* lanes of this cycle are already accounted for */
+		_summed_cycle = _cycle;
+
+		if (active) {
+			boost::shared_ptr<SendList> sl = _sends.reader ();
+			for (SendList::const_iterator i = sl->begin (); i != sl->end (); ++i) {
+				if ((*i)->active () && (!(*i)->source_route () || (*i)->source_route ()->active ())) {
+					bufs.merge_from ((*i)->get_buffers (), nframes);
+				}
+			}
+		}
+	}
+
+	if (active) {
+		_active = _pending_active;
+	}
+}
+
+void
+InternalReturn::accumulate (BufferSet const& src, pframes_t nframes)
+{
+	const uint32_t n_lanes = _lanes.size ();
+
+	if (n_lanes == 0) {
 		return;
 	}
 
-	Glib::Threads::Mutex::Lock lm (_sends_mutex, Glib::Threads::TRY_LOCK);
+	/* spread sends over the lanes, and use the next one if another
+	 * graph thread is busy with it.
+	 */
+	uint32_t n = (guint) g_atomic_int_add (&_next_lane, 1) % n_lanes;
+
+	while (!g_atomic_int_compare_and_exchange (&_lanes[n]->lock, 0, 1)) {
+		n = (n + 1) % n_lanes;
+	}
 
-	if (lm.locked ()) {
-		for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
-			if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
-				bufs.merge_from ((*i)->get_buffers(), nframes);
+	Lane& lane (*_lanes[n]);
+
+	if (lane.empty || lane.cycle != _cycle) {
+		/* first send in this lane this cycle, copy instead of clearing and adding */
+		for (DataType::iterator t = DataType::begin (); t != DataType::end (); ++t) {
+			BufferSet::iterator o = lane.bufs.begin (*t);
+			for (BufferSet::const_iterator i = src.begin (*t); i != src.end (*t) && o != lane.bufs.end (*t); ++i, ++o) {
+				o->read_from (*i, nframes);
+			}
+			for (; o != lane.bufs.end (*t); ++o) {
+				o->silence (nframes);
 			}
 		}
+		lane.empty = false;
+		lane.cycle = _cycle;
+	} else {
+		lane.bufs.merge_from (src, nframes);
 	}
 
-	_active = _pending_active;
+	g_atomic_int_set (&lane.lock, 0);
 }
 
 void
 InternalReturn::add_send (InternalSend* send)
 {
-	Glib::Threads::Mutex::Lock lm (_sends_mutex);
-	_sends.push_back (send);
+	RCUWriter<SendList> writer (_sends);
+	boost::shared_ptr<SendList> sl = writer.get_copy ();
+	sl->push_back (send);
 }
 
 void
 InternalReturn::remove_send (InternalSend* send)
 {
-	Glib::Threads::Mutex::Lock lm (_sends_mutex);
-	_sends.remove (send);
+	RCUWriter<SendList> writer (_sends);
+	boost::shared_ptr<SendList> sl = writer.get_copy ();
+	sl->remove (send);
 }
 
 void
@@ -70,12 +164,43 @@ InternalReturn::set_playback_offset (samplecnt_t cnt)
 {
 	Processor::set_playback_offset (cnt);
 
-	Glib::Threads::Mutex::Lock lm (_sends_mutex); // TODO reader lock
-	for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
+	boost::shared_ptr<SendList> sl = _sends.reader ();
+	for (SendList::iterator i = sl->begin(); i != sl->end(); ++i) {
 		(*i)->set_delay_out (cnt);
 	}
 }
 
+void
+InternalReturn::allocate_lanes (ChanCount const& chn, pframes_t nframes)
+{
+	drop_lanes ();
+
+	/* one lane per graph thread */
+	const uint32_t n_lanes = max (1U, how_many_dsp_threads ());
+
+	/* same sizes as the ThreadBuffers, MIDI capacity is in bytes */
+	AudioEngine* engine = AudioEngine::instance ();
+	const size_t audio_size = max ((size_t) nframes, engine->raw_buffer_size (DataType::AUDIO) / sizeof (Sample));
+	const size_t midi_size  = engine->raw_buffer_size (DataType::MIDI);
+
+	for (uint32_t n = 0; n < n_lanes; ++n) {
+		Lane* lane = new Lane;
+		lane->bufs.ensure_buffers (DataType::AUDIO, chn.n_audio (), audio_size);
+		lane->bufs.ensure_buffers (DataType::MIDI, chn.n_midi (), midi_size);
+		lane->bufs.set_count (chn);
+		_lanes.push_back (lane);
+	}
+}
+
+void
+InternalReturn::drop_lanes ()
+{
+	for (vector<Lane*>::iterator l = _lanes.begin (); l != _lanes.end (); ++l) {
+		delete *l;
+	}
+	_lanes.clear ();
+}
+
 XMLNode&
 InternalReturn::state ()
 {
@@ -96,5 +221,13 @@ bool
 InternalReturn::configure_io (ChanCount in, ChanCount out)
 {
 	IOProcessor::configure_io (in, out);
+	allocate_lanes (in, _session.get_block_size ());
 	return true;
 }
+
+int
+InternalReturn::set_block_size (pframes_t nframes)
+{
+	allocate_lanes (input_streams (), nframes);
+	return 0;
+}
@@ -238,6 +238,9 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 
 		_meter->reset ();
 		Amp::apply_simple_gain (mixbufs, nframes, GAIN_COEFF_ZERO);
+		if (mixbufs.count ().n_midi () > 0) {
+			_send_to->internal_return ()->accumulate (mixbufs, nframes);
+		}
 		goto out;
 
 	} else if (tgain != GAIN_COEFF_UNITY) {
@@ -264,7 +267,8 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 
 	_thru_delay->run (bufs, start_sample, end_sample, speed, nframes, true);
 
-	/* target will pick up our output when it is ready */
+	/* sum our output into the target's return, it picks it up when it runs */
+	_send_to->internal_return ()->accumulate (mixbufs, nframes);
 
   out:
 	_active = _pending_active;
@@ -27,22 +27,23 @@ fi
 
 DIR_PATH=$1
 if [ "$DIR_PATH" == "" ]; then
-	echo "Syntax: load-save-session.sh <session dir>"
+	echo "Syntax: load-save-session.sh <session dir> [<number of repeated saves>]"
 	exit 1
 fi
 
 NAME=`basename $DIR_PATH`
+SAVES=$2
 
 if [ "$OPTION" == "--debug" ]; then
-	gdb --args $ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	gdb --args $ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME $SAVES
 elif [ "$OPTION" == "--valgrind" ]; then
 	MEMCHECK_OPTIONS="--leak-check=full"
 	valgrind $MEMCHECK_OPTIONS \
-	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME $SAVES
 elif [ "$OPTION" == "--massif" ]; then
 	MASSIF_OPTIONS="--time-unit=ms --massif-out-file=massif.out.$NAME"
 	valgrind --tool=massif $MASSIF_OPTIONS \
-	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME $SAVES
 else
-	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME $SAVES
 fi
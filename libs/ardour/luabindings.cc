@@ -2368,6 +2368,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("mix_buffers_no_gain", ARDOUR::mix_buffers_no_gain)
 		.addFunction ("mix_buffers_with_gain", ARDOUR::mix_buffers_with_gain)
 		.addFunction ("copy_vector", ARDOUR::copy_vector)
+		.addFunction ("mix_buffers_with_gain_ramp", ARDOUR::mix_buffers_with_gain_ramp)
+		.addFunction ("apply_gain_find_peaks", ARDOUR::apply_gain_find_peaks)
 		.addFunction ("dB_to_coefficient", &dB_to_coefficient)
 		.addFunction ("fast_coefficient_to_dB", &fast_coefficient_to_dB)
 		.addFunction ("accurate_coefficient_to_dB", &accurate_coefficient_to_dB)
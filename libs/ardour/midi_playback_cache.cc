@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <map>
+
+#include "ardour/midi_model.h"
+#include "ardour/midi_playback_cache.h"
+#include "ardour/tempo.h"
+
+using namespace ARDOUR;
+
+MidiPlaybackCache::MidiPlaybackCache (MidiModel const& model)
+{
+	typedef Evoral::Note<Temporal::Beats> Note;
+	std::map<const Note*, int32_t> note_ons;
+
+	/* everything, from the start: which controllers are filtered is
+	   decided per read, since regions using this source may differ
+	*/
+	for (MidiModel::const_iterator i = model.begin (); i != model.end (); ++i) {
+
+		const int32_t n = _time.size ();
+
+		_time.push_back (i->time ().to_double ());
+		_type.push_back (i->event_type ());
+		_offset.push_back (_data.size ());
+		_size.push_back (i->size ());
+		_data.insert (_data.end (), i->buffer (), i->buffer () + i->size ());
+
+		int32_t on = -1;
+		int16_t param = -1;
+
+		if (const Note* note = i.note ().get ()) {
+			if (i->is_note_on ()) {
+				note_ons[note] = n;
+			} else {
+				std::map<const Note*, int32_t>::iterator o = note_ons.find (note);
+				if (o != note_ons.end ()) {
+					on = o->second;
+					note_ons.erase (o);
+				}
+			}
+		} else if (const Evoral::Parameter* p = i.control_parameter ()) {
+			for (param = 0; param < (int16_t) _parameters.size (); ++param) {
+				if (_parameters[param] == *p) {
+					break;
+				}
+			}
+			if (param == (int16_t) _parameters.size ()) {
+				_parameters.push_back (*p);
+			}
+		}
+
+		_note_on.push_back (on);
+		_parameter.push_back (param);
+	}
+}
+
+void
+MidiPlaybackCache::compute_samples (TempoMap const& tmap, double start_qn, std::vector<samplepos_t>& samples) const
+{
+	const size_t n = _time.size ();
+
+	samples.resize (n);
+
+	for (size_t i = 0; i < n; ++i) {
+		samples[i] = tmap.sample_at_quarter_note (_time[i] + start_qn);
+	}
+}
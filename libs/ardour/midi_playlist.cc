@@ -131,9 +131,13 @@ MidiPlaylist::read (Evoral::EventSink<samplepos_t>& dst,
 
 	/* Find relevant regions that overlap [start..end] */
 	const samplepos_t                         end = start + dur - 1;
+	std::vector< boost::shared_ptr<Region> > touched;
 	std::vector< boost::shared_ptr<Region> > regs;
 	std::vector< boost::shared_ptr<Region> > ended;
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
+
+	regions_touched_locked (start, end, touched);
+
+	for (std::vector< boost::shared_ptr<Region> >::const_iterator i = touched.begin(); i != touched.end(); ++i) {
 
 		/* check for the case of solo_selection */
 		bool force_transparent = ( _session.solo_selection_active() && SoloSelectedActive() && !SoloSelectedListIncludes( (const Region*) &(**i) ) );
@@ -243,6 +243,8 @@ MidiRegion::post_set (const PropertyChange& pc)
 void
 MidiRegion::set_start_beats_from_start_samples ()
 {
+	invalidate_cached_state ();
+
 	if (position_lock_style() == AudioTime) {
 		_start_beats = quarter_note() - _session.tempo_map().quarter_note_at_sample (_position - _start);
 	}
@@ -320,6 +322,8 @@ MidiRegion::update_after_tempo_map_change (bool /* send */)
 void
 MidiRegion::update_length_beats (const int32_t sub_num)
 {
+	invalidate_cached_state ();
+
 	_length_beats = _session.tempo_map().exact_qn_at_sample (_position + _length, sub_num) - quarter_note();
 }
 
@@ -644,6 +648,8 @@ MidiRegion::model_automation_state_changed (Evoral::Parameter const & p)
 void
 MidiRegion::fix_negative_start ()
 {
+	invalidate_cached_state ();
+
 	BeatsSamplesConverter c (_session.tempo_map(), _position);
 
 	_ignore_shift = true;
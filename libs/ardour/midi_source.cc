@@ -22,6 +22,7 @@
 #include <fcntl.h>
 #include <float.h>
 #include <cerrno>
+#include <cstring>
 #include <ctime>
 #include <cmath>
 #include <iomanip>
@@ -42,6 +43,7 @@
 #include "ardour/midi_channel_filter.h"
 #include "ardour/midi_cursor.h"
 #include "ardour/midi_model.h"
+#include "ardour/midi_playback_cache.h"
 #include "ardour/midi_source.h"
 #include "ardour/midi_state_tracker.h"
 #include "ardour/session.h"
@@ -59,6 +61,7 @@ using namespace PBD;
 
 MidiSource::MidiSource (Session& s, string name, Source::Flag flags)
 	: Source(s, DataType::MIDI, name, flags)
+	, _playback_cache_dirty(0)
 	, _writing(false)
 	, _length_beats(0.0)
 	, _capture_length(0)
@@ -68,6 +71,7 @@ MidiSource::MidiSource (Session& s, string name, Source::Flag flags)
 
 MidiSource::MidiSource (Session& s, const XMLNode& node)
 	: Source(s, node)
+	, _playback_cache_dirty(0)
 	, _writing(false)
 	, _length_beats(0.0)
 	, _capture_length(0)
@@ -190,9 +194,85 @@ MidiSource::update_length (samplecnt_t)
 void
 MidiSource::invalidate (const Lock& lock)
 {
+	_playback_cache.reset ();
 	Invalidated(_session.transport_rolling());
 }
 
+void
+MidiSource::model_contents_changed () const
+{
+	/* controller edits change the model without invalidating the source */
+	g_atomic_int_set (&_playback_cache_dirty, 1);
+}
+
+boost::shared_ptr<const MidiPlaybackCache>
+MidiSource::playback_cache (const Lock& lock) const
+{
+	if (g_atomic_int_compare_and_exchange (&_playback_cache_dirty, 1, 0)) {
+		_playback_cache.reset ();
+	}
+
+	if (!_playback_cache) {
+		_model->ContentsChanged.connect_same_thread (_playback_cache_connection, boost::bind (&MidiSource::model_contents_changed, this));
+		_playback_cache.reset (new MidiPlaybackCache (*_model));
+		DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("%1: rebuilt playback cache, %2 events\n", _name, _playback_cache->size ()));
+	}
+
+	return _playback_cache;
+}
+
+void
+MidiSource::write_event (Evoral::EventSink<samplepos_t>& dst,
+                         samplepos_t                     time_samples,
+                         Evoral::EventType               type,
+                         uint32_t                        size,
+                         const uint8_t*                  buf,
+                         samplepos_t                     start,
+                         samplepos_t                     end,
+                         MidiStateTracker*               tracker,
+                         MidiChannelFilter*              filter) const
+{
+	const uint8_t status           = buf[0];
+	const bool    is_channel_event = (0x80 <= (status & 0xF0)) && (status <= 0xE0);
+	if (filter && is_channel_event && size <= 3) {
+		/* Copy event so the filter can modify the channel.  I'm not
+		   sure if this is necessary here (channels are mapped later in
+		   buffers anyway), but it preserves existing behaviour without
+		   destroying events in the model during read. */
+		uint8_t ev[3];
+		memcpy (ev, buf, size);
+		if (!filter->filter(ev, size)) {
+			dst.write(time_samples, type, size, ev);
+		} else {
+			DEBUG_TRACE (DEBUG::MidiSourceIO,
+			             string_compose ("%1: filter event @ %2 type %3 size %4\n",
+			                             _name, time_samples, type, size));
+		}
+	} else {
+		dst.write (time_samples, type, size, buf);
+	}
+
+#ifndef NDEBUG
+	if (DEBUG_ENABLED(DEBUG::MidiSourceIO)) {
+		DEBUG_STR_DECL(a);
+		DEBUG_STR_APPEND(a, string_compose ("%1 added event @ %2 sz %3 within %4 .. %5 ",
+		                                    _name, time_samples, size, start, end));
+		for (size_t n=0; n < size; ++n) {
+			DEBUG_STR_APPEND(a,hex);
+			DEBUG_STR_APPEND(a,"0x");
+			DEBUG_STR_APPEND(a,(int)buf[n]);
+			DEBUG_STR_APPEND(a,' ');
+		}
+		DEBUG_STR_APPEND(a,'\n');
+		DEBUG_TRACE (DEBUG::MidiSourceIO, DEBUG_STR(a).str());
+	}
+#endif
+
+	if (tracker) {
+		tracker->track (buf);
+	}
+}
+
 samplecnt_t
 MidiSource::midi_read (const Lock&                        lm,
                        Evoral::EventSink<samplepos_t>&     dst,
@@ -207,8 +287,6 @@ MidiSource::midi_read (const Lock&                        lm,
                        const double                       pos_beats,
                        const double                       start_beats) const
 {
-	BeatsSamplesConverter converter(_session.tempo_map(), source_start);
-
 	const double start_qn = pos_beats - start_beats;
 
 	DEBUG_TRACE (DEBUG::MidiSourceIO,
@@ -219,19 +297,120 @@ MidiSource::midi_read (const Lock&                        lm,
 		return read_unlocked (lm, dst, source_start, start, cnt, loop_range, tracker, filter);
 	}
 
+	if (_model->writing ()) {
+		/* the model is being recorded into, read it directly */
+		_playback_cache.reset ();
+		return model_read (lm, dst, source_start, start, cnt, loop_range, cursor, tracker, filter, filtered, start_qn);
+	}
+
+	/* Note that multiple tracks can use a MidiSource simultaneously, so
+	   all playback state must be in parameters (the cursor) and must not
+	   be cached in the source of model itself.
+	   See http://tracker.ardour.org/view.php?id=6541
+	*/
+
+	boost::shared_ptr<const MidiPlaybackCache> cache = playback_cache (lm);
+	TempoMap& tmap (_session.tempo_map());
+
+	const samplepos_t read_start  = start + source_start;
+	const samplepos_t read_end    = read_start + cnt;
+	const bool        linear_read = cursor.last_read_end != 0 && start == cursor.last_read_end;
+	bool              seek        = !linear_read;
+
+	if (cursor.cache != cache || cursor.tempo_generation != tmap.generation () || cursor.start_qn != start_qn) {
+		/* the model, tempo map or region position changed: only the
+		   sample positions need to be computed again.
+		*/
+		cursor.cache            = cache;
+		cursor.tempo_generation = tmap.generation ();
+		cursor.start_qn         = start_qn;
+		cache->compute_samples (tmap, start_qn, cursor.samples);
+		seek = true;
+	}
+
+	if (seek) {
+		cursor.connect (Invalidated);
+		cursor.index = lower_bound (cursor.samples.begin (), cursor.samples.end (), read_start) - cursor.samples.begin ();
+		if (!linear_read && !(cursor.resume_at != 0 && start == cursor.resume_at)) {
+			/* a locate, nothing is sounding */
+			cursor.played_from = read_start;
+		}
+		cursor.resume_at = 0;
+	}
+
+	cursor.last_read_end = start + cnt;
+
+	const std::vector<samplepos_t>& samples (cursor.samples);
+	const size_t                    n_events = cache->size ();
+
+	// Copy events in [start, start + cnt) into dst
+	for (; cursor.index < n_events; ++cursor.index) {
+
+		const size_t k            = cursor.index;
+		samplepos_t  time_samples = samples[k];
+
+		if (time_samples < read_start) {
+			/* event too early */
+			continue;
+		}
+
+		if (time_samples >= read_end) {
+			DEBUG_TRACE (DEBUG::MidiSourceIO,
+			             string_compose ("%1: reached end with event @ %2 vs. %3\n",
+			                             _name, time_samples, start+cnt));
+			break;
+		}
+
+		const int32_t on = cache->note_on (k);
+		if (on >= 0 && samples[on] < cursor.played_from) {
+			/* note off of a note that was never played */
+			continue;
+		}
+
+		if (!filtered.empty ()) {
+			const Evoral::Parameter* p = cache->parameter (k);
+			if (p && filtered.find (*p) != filtered.end ()) {
+				continue;
+			}
+		}
+
+		if (loop_range) {
+			time_samples = loop_range->squish (time_samples);
+		}
+
+		write_event (dst, time_samples, cache->event_type (k), cache->event_size (k), cache->buffer (k),
+		             read_start, read_end, tracker, filter);
+	}
+
+	return cnt;
+}
+
+samplecnt_t
+MidiSource::model_read (const Lock&                        lm,
+                        Evoral::EventSink<samplepos_t>&     dst,
+                        samplepos_t                         source_start,
+                        samplepos_t                         start,
+                        samplecnt_t                         cnt,
+                        Evoral::Range<samplepos_t>*         loop_range,
+                        MidiCursor&                        cursor,
+                        MidiStateTracker*                  tracker,
+                        MidiChannelFilter*                 filter,
+                        const std::set<Evoral::Parameter>& filtered,
+                        double                             start_qn) const
+{
+	BeatsSamplesConverter converter(_session.tempo_map(), source_start);
+
 	// Find appropriate model iterator
 	Evoral::Sequence<Temporal::Beats>::const_iterator& i = cursor.iter;
 	const bool linear_read = cursor.last_read_end != 0 && start == cursor.last_read_end;
 	if (!linear_read || !i.valid()) {
-		/* Cached iterator is invalid, search for the first event past start.
-		   Note that multiple tracks can use a MidiSource simultaneously, so
-		   all playback state must be in parameters (the cursor) and must not
-		   be cached in the source of model itself.
-		   See http://tracker.ardour.org/view.php?id=6541
-		*/
+		/* Cached iterator is invalid, search for the first event past start. */
 		cursor.connect(Invalidated);
 		cursor.iter = _model->begin(converter.from(start), false, filtered, &cursor.active_notes);
 		cursor.active_notes.clear();
+		/* the cache path must seek when it takes over */
+		cursor.cache.reset ();
+		cursor.played_from = start + source_start;
 	}
 
 	cursor.last_read_end = start + cnt;
@@ -263,45 +442,8 @@ MidiSource::midi_read (const Lock&                        lm,
 				time_samples = loop_range->squish (time_samples);
 			}
 
-			const uint8_t status           = i->buffer()[0];
-			const bool    is_channel_event = (0x80 <= (status & 0xF0)) && (status <= 0xE0);
-			if (filter && is_channel_event) {
-				/* Copy event so the filter can modify the channel.  I'm not
-				   sure if this is necessary here (channels are mapped later in
-				   buffers anyway), but it preserves existing behaviour without
-				   destroying events in the model during read. */
-				Evoral::Event<Temporal::Beats> ev(*i, true);
-				if (!filter->filter(ev.buffer(), ev.size())) {
-					dst.write(time_samples, ev.event_type(), ev.size(), ev.buffer());
-				} else {
-					DEBUG_TRACE (DEBUG::MidiSourceIO,
-					             string_compose ("%1: filter event @ %2 type %3 size %4\n",
-					                             _name, time_samples, i->event_type(), i->size()));
-				}
-			} else {
-				dst.write (time_samples, i->event_type(), i->size(), i->buffer());
-			}
-
-#ifndef NDEBUG
-			if (DEBUG_ENABLED(DEBUG::MidiSourceIO)) {
-				DEBUG_STR_DECL(a);
-				DEBUG_STR_APPEND(a, string_compose ("%1 added event @ %2 sz %3 within %4 .. %5 ",
-				                                    _name, time_samples, i->size(),
-				                                    start + source_start, start + cnt + source_start));
-				for (size_t n=0; n < i->size(); ++n) {
-					DEBUG_STR_APPEND(a,hex);
-					DEBUG_STR_APPEND(a,"0x");
-					DEBUG_STR_APPEND(a,(int)i->buffer()[n]);
-					DEBUG_STR_APPEND(a,' ');
-				}
-				DEBUG_STR_APPEND(a,'\n');
-				DEBUG_TRACE (DEBUG::MidiSourceIO, DEBUG_STR(a).str());
-			}
-#endif
-
-			if (tracker) {
-				tracker->track (*i);
-			}
+			write_event (dst, time_samples, i->event_type(), i->size(), i->buffer(),
+			             start + source_start, start + cnt + source_start, tracker, filter);
 		}
 	}
 
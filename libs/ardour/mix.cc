@@ -142,6 +142,33 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+void
+default_mix_buffers_with_gain_ramp (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, float gain, float gain_delta)
+{
+	/* compute the gain from the index rather than accumulating the delta,
+	 * so that all implementations agree independent of the vector width.
+	 */
+	for (pframes_t i = 0; i < nframes; i++) {
+		dst[i] += src[i] * (gain + (float) i * gain_delta);
+	}
+}
+
+void
+default_apply_gain_find_peaks (ARDOUR::Sample * buf, pframes_t nframes, float gain, float *minf, float *maxf)
+{
+	float a = *maxf;
+	float b = *minf;
+
+	for (pframes_t i = 0; i < nframes; i++) {
+		buf[i] *= gain;
+		a = max (buf[i], a);
+		b = min (buf[i], b);
+	}
+
+	*maxf = a;
+	*minf = b;
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <assert.h>
+
+#include "pbd/compose.h"
+
+#include "ardour/audio_buffer.h"
+#include "ardour/audioengine.h"
+#include "ardour/buffer_set.h"
+#include "ardour/debug.h"
+#include "ardour/graph.h"
+#include "ardour/midi_buffer.h"
+#include "ardour/pipeline_break.h"
+#include "ardour/route.h"
+#include "ardour/runtime_functions.h"
+#include "ardour/session.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+PipelineBreak::PipelineBreak (Session& s, const std::string& name)
+	: Processor (s, string_compose ("pipeline-%1-%2", name, this))
+	, _delay (s.engine ().samples_per_cycle ())
+	, _bsiz (0)
+	, _bsiz_mask (0)
+	, _woff (0)
+	, _roff (0)
+	, _split (false)
+	, _pending_flush (false)
+	, _midi_w (0)
+	, _midi_period (-1)
+	, _midi_woff (0)
+	, _midi_roff (0)
+{
+}
+
+PipelineBreak::~PipelineBreak ()
+{
+}
+
+bool
+PipelineBreak::set_name (const string& name)
+{
+	return Processor::set_name (string_compose ("pipeline-%1-%2", name, this));
+}
+
+bool
+PipelineBreak::can_support_io_configuration (const ChanCount& in, ChanCount& out)
+{
+	out = in;
+	return true;
+}
+
+bool
+PipelineBreak::configure_io (ChanCount in, ChanCount out)
+{
+	if (out != in) { // always 1:1
+		return false;
+	}
+
+	allocate_buffers (out);
+
+	if (in.n_midi () > 0 && !_midi_buf[0]) {
+		_midi_buf[0].reset (new MidiBuffer (16384));
+		_midi_buf[1].reset (new MidiBuffer (16384));
+	}
+
+	return Processor::configure_io (in, out);
+}
+
+int
+PipelineBreak::set_block_size (pframes_t nframes)
+{
+	/* called with the process-lock held */
+	if (nframes != _delay) {
+		_delay = nframes;
+		allocate_buffers (_configured_output);
+	}
+	return 0;
+}
+
+void
+PipelineBreak::allocate_buffers (ChanCount const& cc)
+{
+	samplecnt_t rbs = _delay + 8192 + 1;
+
+	uint64_t power_of_two;
+	for (power_of_two = 1; 1 << power_of_two < rbs; ++power_of_two) {}
+	rbs = 1 << power_of_two;
+
+	if (cc.n_audio () == _buf.size () && _bsiz == rbs) {
+		return;
+	}
+
+	_buf.clear ();
+	_bsiz = rbs;
+	_bsiz_mask = rbs - 1;
+
+	for (uint32_t i = 0; i < cc.n_audio (); ++i) {
+		boost::shared_array<Sample> b (new Sample[_bsiz]);
+		memset (b.get (), 0, _bsiz * sizeof (Sample));
+		_buf.push_back (b);
+	}
+
+	/* the first stage writes one period ahead of the second */
+	_woff = _delay & _bsiz_mask;
+	_roff = 0;
+
+	DEBUG_TRACE (DEBUG::LatencyCompensation,
+			string_compose ("%1 allocate pipeline for %2 samples, %3 channels\n", name (), _delay, cc.n_audio ()));
+}
+
+void
+PipelineBreak::flush ()
+{
+	_pending_flush = true;
+}
+
+void
+PipelineBreak::clear_buffers ()
+{
+	_pending_flush = false;
+	for (AudioPipeBuf::iterator i = _buf.begin (); i != _buf.end (); ++i) {
+		memset ((*i).get (), 0, _bsiz * sizeof (Sample));
+	}
+	if (_midi_buf[0]) {
+		_midi_buf[0]->clear ();
+		_midi_buf[1]->clear ();
+	}
+}
+
+void
+PipelineBreak::cycle_start ()
+{
+	/* no stage is running, it's safe to flip/clear buffers */
+	if (_pending_flush) {
+		clear_buffers ();
+	}
+
+	_roff = (_woff + _bsiz - _delay) & _bsiz_mask;
+	midi_period_start ();
+}
+
+void
+PipelineBreak::midi_period_start ()
+{
+	/* the graph (and run()) may be called more than once per engine
+	 * period if the cycle is split; MIDI is only flipped once per period
+	 * to match the audio delay.
+	 */
+	const samplecnt_t period = _session.engine ().processed_samples ();
+	if (period == _midi_period) {
+		return;
+	}
+	_midi_period = period;
+	_midi_w ^= 1;
+	_midi_woff = 0;
+	_midi_roff = 0;
+	if (_midi_buf[0]) {
+		_midi_buf[_midi_w]->clear ();
+	}
+}
+
+void
+PipelineBreak::write (BufferSet const& bufs, pframes_t n_samples)
+{
+	assert (n_samples < _bsiz);
+
+	AudioPipeBuf::iterator bi = _buf.begin ();
+	for (BufferSet::audio_iterator i = const_cast<BufferSet&>(bufs).audio_begin (); i != const_cast<BufferSet&>(bufs).audio_end () && bi != _buf.end (); ++i, ++bi) {
+		Sample* rb = (*bi).get ();
+		Sample const* src = i->data ();
+		if (_woff + n_samples <= _bsiz) {
+			copy_vector (&rb[_woff], src, n_samples);
+		} else {
+			const samplecnt_t s0 = _bsiz - _woff;
+			copy_vector (&rb[_woff], src, s0);
+			copy_vector (rb, &src[s0], n_samples - s0);
+		}
+	}
+
+	_woff = (_woff + n_samples) & _bsiz_mask;
+
+	if (_midi_buf[0] && bufs.count ().n_midi () > 0) {
+		MidiBuffer const& mb (const_cast<BufferSet&>(bufs).get_midi (0));
+		for (MidiBuffer::const_iterator m = mb.begin (); m != mb.end (); ++m) {
+			const Evoral::Event<MidiBuffer::TimeType> ev (*m, false);
+			_midi_buf[_midi_w]->push_back (ev.time () + _midi_woff, ev.size (), ev.buffer ());
+		}
+		_midi_woff += n_samples;
+	}
+}
+
+void
+PipelineBreak::read_at (BufferSet& bufs, samplecnt_t roff, pframes_t n_samples)
+{
+	assert (n_samples < _bsiz);
+
+	AudioPipeBuf::iterator bi = _buf.begin ();
+	for (BufferSet::audio_iterator i = bufs.audio_begin (); i != bufs.audio_end () && bi != _buf.end (); ++i, ++bi) {
+		Sample const* rb = (*bi).get ();
+		Sample* dst = i->data ();
+		if (roff + n_samples <= _bsiz) {
+			copy_vector (dst, &rb[roff], n_samples);
+		} else {
+			const samplecnt_t s0 = _bsiz - roff;
+			copy_vector (dst, &rb[roff], s0);
+			copy_vector (&dst[s0], rb, n_samples - s0);
+		}
+	}
+
+	if (_midi_buf[0] && bufs.count ().n_midi () > 0) {
+		/* the events of the previous period, at the same position */
+		MidiBuffer& mb (bufs.get_midi (0));
+		mb.silence (n_samples);
+		for (MidiBuffer::iterator m = _midi_buf[_midi_w ^ 1]->begin (); m != _midi_buf[_midi_w ^ 1]->end (); ++m) {
+			const Evoral::Event<MidiBuffer::TimeType> ev (*m, false);
+			if (ev.time () >= _midi_roff && ev.time () < _midi_roff + n_samples) {
+				mb.push_back (ev.time () - _midi_roff, ev.size (), ev.buffer ());
+			}
+		}
+		_midi_roff += n_samples;
+	}
+}
+
+void
+PipelineBreak::read (BufferSet& bufs, pframes_t n_samples)
+{
+	assert (_split);
+	assert (n_samples <= _delay);
+
+	bufs.set_count (_configured_output);
+	read_at (bufs, _roff, n_samples);
+	_roff = (_roff + n_samples) & _bsiz_mask;
+}
+
+void
+PipelineBreak::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /* end_sample */, double /* speed */, pframes_t n_samples, bool)
+{
+	if (_split) {
+		/* first stage: only store, the second stage will pick it up
+		 * in the next cycle.
+		 */
+		write (bufs, n_samples);
+		return;
+	}
+
+	/* single-threaded: a plain delay-line */
+
+	if (_pending_flush) {
+		clear_buffers ();
+	}
+
+	midi_period_start ();
+
+	const samplecnt_t roff = (_woff + _bsiz - _delay) & _bsiz_mask;
+	write (bufs, n_samples);
+	read_at (bufs, roff, n_samples);
+}
+
+XMLNode&
+PipelineBreak::state ()
+{
+	XMLNode& node (Processor::state ());
+	node.set_property ("type", "pipeline");
+	return node;
+}
+
+PipelineStageNode::PipelineStageNode (boost::shared_ptr<Graph> graph, Route* r, boost::shared_ptr<PipelineBreak> b)
+	: GraphNode (graph)
+	, _route (r)
+	, _break (b)
+{
+}
+
+void
+PipelineStageNode::process ()
+{
+	_graph->process_one_pipeline_stage (_route);
+}
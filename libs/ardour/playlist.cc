@@ -35,6 +35,7 @@
 #include "ardour/playlist_source.h"
 #include "ardour/region.h"
 #include "ardour/region_factory.h"
+#include "ardour/region_index.h"
 #include "ardour/region_sorters.h"
 #include "ardour/session.h"
 #include "ardour/session_playlists.h"
@@ -324,6 +325,9 @@ Playlist::init (bool hide)
 	_combine_ops = 0;
 	_end_space = 0;
 	_playlist_shift_active = false;
+	_region_index_dirty = true;
+	_region_index_writer = false;
+	g_atomic_int_set (&_region_generation, 0);
 
 	_session.history().BeginUndoRedo.connect_same_thread (*this, boost::bind (&Playlist::begin_undo, this));
 	_session.history().EndUndoRedo.connect_same_thread (*this, boost::bind (&Playlist::end_undo, this));
@@ -443,6 +447,8 @@ Playlist::release_notifications (bool from_undo)
 void
 Playlist::notify_contents_changed ()
 {
+	invalidate_region_index ();
+
 	if (holding_state ()) {
 		pending_contents_change = true;
 	} else {
@@ -454,6 +460,8 @@ Playlist::notify_contents_changed ()
 void
 Playlist::notify_layering_changed ()
 {
+	invalidate_region_index ();
+
 	if (holding_state ()) {
 		pending_layering = true;
 	} else {
@@ -758,6 +766,7 @@ Playlist::add_region_internal (boost::shared_ptr<Region> region, samplepos_t pos
 
 	regions.insert (upper_bound (regions.begin(), regions.end(), region, cmp), region);
 	all_regions.insert (region);
+	invalidate_region_index ();
 
 	possibly_splice_unlocked (position, region->length(), region);
 
@@ -819,6 +828,7 @@ Playlist::remove_region_internal (boost::shared_ptr<Region> region)
 			samplecnt_t distance = (*i)->length();
 
 			regions.erase (i);
+			invalidate_region_index ();
 
 			possibly_splice_unlocked (pos, -distance);
 
@@ -1737,6 +1747,9 @@ Playlist::region_changed_proxy (const PropertyChange& what_changed, boost::weak_
 		return;
 	}
 
+	/* bounds, layer or mute state may have changed */
+	invalidate_region_index ();
+
 	/* this makes a virtual call to the right kind of playlist ... */
 
 	region_changed (what_changed, region);
@@ -1877,6 +1890,12 @@ uint32_t
 Playlist::count_regions_at (samplepos_t sample) const
 {
 	RegionReadLock rlock (const_cast<Playlist*>(this));
+
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		return index->count_touched (sample, sample);
+	}
+
 	uint32_t cnt = 0;
 
 	for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
@@ -1892,6 +1911,12 @@ boost::shared_ptr<Region>
 Playlist::top_region_at (samplepos_t sample)
 {
 	RegionReadLock rlock (this);
+
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		return index->top_at (sample, false);
+	}
+
 	boost::shared_ptr<RegionList> rlist = find_regions_at (sample);
 	boost::shared_ptr<Region> region;
 
@@ -1908,6 +1933,12 @@ boost::shared_ptr<Region>
 Playlist::top_unmuted_region_at (samplepos_t sample)
 {
 	RegionReadLock rlock (this);
+
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		return index->top_at (sample, true);
+	}
+
 	boost::shared_ptr<RegionList> rlist = find_regions_at (sample);
 
 	for (RegionList::iterator i = rlist->begin(); i != rlist->end(); ) {
@@ -1941,6 +1972,12 @@ Playlist::find_regions_at (samplepos_t sample)
 
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		index->find_touched (sample, sample, *rlist);
+		return rlist;
+	}
+
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
 		if ((*i)->covers (sample)) {
 			rlist->push_back (*i);
@@ -1956,6 +1993,12 @@ Playlist::regions_with_start_within (Evoral::Range<samplepos_t> range)
 	RegionReadLock rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		index->find_starting_within (range.from, range.to, *rlist);
+		return rlist;
+	}
+
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
 		if ((*i)->first_sample() >= range.from && (*i)->first_sample() <= range.to) {
 			rlist->push_back (*i);
@@ -1971,6 +2014,19 @@ Playlist::regions_with_end_within (Evoral::Range<samplepos_t> range)
 	RegionReadLock rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		/* every region that ends within the range also touches it */
+		RegionList touched;
+		index->find_touched (range.from, range.to, touched);
+		for (RegionList::iterator i = touched.begin(); i != touched.end(); ++i) {
+			if ((*i)->last_sample() <= range.to) {
+				rlist->push_back (*i);
+			}
+		}
+		return rlist;
+	}
+
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
 		if ((*i)->last_sample() >= range.from && (*i)->last_sample() <= range.to) {
 			rlist->push_back (*i);
@@ -1996,6 +2052,12 @@ Playlist::regions_touched_locked (samplepos_t start, samplepos_t end)
 {
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		index->find_touched (start, end, *rlist);
+		return rlist;
+	}
+
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
 		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
 			rlist->push_back (*i);
@@ -2005,6 +2067,69 @@ Playlist::regions_touched_locked (samplepos_t start, samplepos_t end)
 	return rlist;
 }
 
+/** Like regions_touched_locked(), but adds the regions to @param result,
+ *  which allows the caller to re-use the container.
+ */
+void
+Playlist::regions_touched_locked (samplepos_t start, samplepos_t end, std::vector<boost::shared_ptr<Region> >& result)
+{
+	boost::shared_ptr<RegionIndex const> index = region_index ();
+	if (index) {
+		index->find_touched (start, end, result);
+		return;
+	}
+
+	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
+		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
+			result.push_back (*i);
+		}
+	}
+}
+
+/** Caller must hold the region lock (read or write).
+ *  @return the current index, or a null pointer while the region
+ *  list is being modified.
+ */
+boost::shared_ptr<RegionIndex const>
+Playlist::region_index () const
+{
+	if (_region_index_writer) {
+		return boost::shared_ptr<RegionIndex const> ();
+	}
+
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+	if (_region_index_dirty || !_region_index) {
+		/* readers that still use the previous index keep a reference to it */
+		_region_index.reset (new RegionIndex (regions.begin (), regions.end ()));
+		_region_index_dirty = false;
+	}
+
+	return _region_index;
+}
+
+void
+Playlist::invalidate_region_index ()
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	_region_index_dirty = true;
+	g_atomic_int_inc (&_region_generation);
+}
+
+void
+Playlist::region_index_write_begin ()
+{
+	invalidate_region_index ();
+	_region_index_writer = true;
+}
+
+void
+Playlist::region_index_write_end ()
+{
+	_region_index_writer = false;
+	invalidate_region_index ();
+}
+
 samplepos_t
 Playlist::find_next_transient (samplepos_t from, int dir)
 {
@@ -2388,7 +2513,7 @@ Playlist::state (bool full_state)
 		node->set_property ("combine-ops", _combine_ops);
 
 		for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-			node->add_child_nocopy ((*i)->get_state());
+			node->add_child_nocopy ((*i)->get_cached_state());
 		}
 	}
 
@@ -17,6 +17,8 @@
 
 */
 
+#include <algorithm>
+
 #ifdef COMPILER_MSVC
 #include <io.h> // Microsoft's nearest equivalent to <unistd.h>
 #include <ardourext/misc.h>
@@ -53,6 +55,7 @@ PortManager::PortManager ()
 	: ports (new Ports)
 	, _port_remove_in_progress (false)
 	, _port_deletions_pending (8192) /* ick, arbitrary sizing */
+	, _cycle_task_nframes (0)
 	, midi_info_dirty (true)
 {
 	load_midi_port_info ();
@@ -435,6 +438,7 @@ PortManager::register_port (DataType dtype, const string& portname, bool input,
 	}
 
 	DEBUG_TRACE (DEBUG::Ports, string_compose ("\t%2 port registration success, ports now = %1\n", ports.reader()->size(), this));
+	reserve_cycle_tasks (ports.reader()->size());
 	return newport;
 }
 
@@ -618,6 +622,11 @@ PortManager::reestablish_ports ()
 	DEBUG_TRACE (DEBUG::Ports, string_compose ("reestablish %1 ports\n", p->size()));
 
 	for (i = p->begin(); i != p->end(); ++i) {
+		boost::shared_ptr<AudioPort> ap = boost::dynamic_pointer_cast<AudioPort> (i->second);
+		if (ap) {
+			/* port handles change, connections will be reported again */
+			ap->set_external_source (0);
+		}
 		if (i->second->reestablish ()) {
 			error << string_compose (_("Re-establising port %1 failed"), i->second->name()) << endmsg;
 			std::cerr << string_compose (_("Re-establising port %1 failed"), i->second->name()) << std::endl;
@@ -684,6 +693,13 @@ PortManager::connect_callback (const string& a, const string& b, bool conn)
 		}
 	}
 
+	if (port_a) {
+		update_external_source (port_a);
+	}
+	if (port_b) {
+		update_external_source (port_b);
+	}
+
 	PortConnectedOrDisconnected (
 		port_a, a,
 		port_b, b,
@@ -691,6 +707,27 @@ PortManager::connect_callback (const string& a, const string& b, bool conn)
 		); /* EMIT SIGNAL */
 }
 
+void
+PortManager::update_external_source (boost::shared_ptr<Port> port)
+{
+	boost::shared_ptr<AudioPort> ap = boost::dynamic_pointer_cast<AudioPort> (port);
+
+	if (!ap || !ap->receives_input () || !_backend) {
+		return;
+	}
+
+	PortEngine::PortHandle src = 0;
+
+	if (ap->externally_connected () == 1 && ap->port_handle ()) {
+		std::vector<std::string> c;
+		if (_backend->get_connections (ap->port_handle (), c) == 1) {
+			src = _backend->get_port_by_name (c.front ());
+		}
+	}
+
+	ap->set_external_source (src);
+}
+
 void
 PortManager::registration_callback ()
 {
@@ -773,6 +810,28 @@ PortManager::graph_order_callback ()
 	return 0;
 }
 
+void
+PortManager::reserve_cycle_tasks (size_t n)
+{
+	Glib::Threads::Mutex::Lock lm (_cycle_tasks_lock);
+	_cycle_tasks.reserve (n);
+	_cycle_inputs.reserve (n);
+}
+
+/*static*/ void
+PortManager::cycle_start_task (void* arg, uint32_t i)
+{
+	PortManager* pm = static_cast<PortManager*> (arg);
+	pm->_cycle_tasks[i]->cycle_start (pm->_cycle_task_nframes);
+}
+
+/*static*/ void
+PortManager::cycle_end_task (void* arg, uint32_t i)
+{
+	PortManager* pm = static_cast<PortManager*> (arg);
+	pm->_cycle_tasks[i]->cycle_end (pm->_cycle_task_nframes);
+}
+
 void
 PortManager::cycle_start (pframes_t nframes, Session* s)
 {
@@ -795,40 +854,83 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	 *    many resamplers need to run) vs. available CPU cores and semaphore
 	 *    synchronization overhead.
 	 *
-	 *  - input ports: it would make sense to resample each input only once
-	 *    (rather than resample into each ardour-owned input port).
-	 *    A single external source-port may be connected to many ardour
-	 *    input-ports. Currently re-sampling is per input.
+	 * A single external source-port may be connected to many ardour
+	 * input-ports. Those are resampled only once, into the first of them,
+	 * and the result is copied to the others.
 	 */
 	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			tl.push_back (boost::bind (&Port::cycle_start, p->second, nframes));
-		}
-		s->rt_tasklist()->process (tl);
-	} else {
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			p->second->cycle_start (nframes);
+		Glib::Threads::Mutex::Lock lm (_cycle_tasks_lock, Glib::Threads::TRY_LOCK);
+		if (lm.locked () && _cycle_tasks.capacity () >= _cycle_ports->size ()) {
+			_cycle_tasks.clear ();
+			_cycle_inputs.clear ();
+
+			for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+				if (p->second->type () == DataType::AUDIO && p->second->receives_input () && p->second->externally_connected ()) {
+					AudioPort* ap = static_cast<AudioPort*> (p->second.get ());
+					PortEngine::PortHandle src = ap->external_source ();
+					if (src) {
+						_cycle_inputs.push_back (std::make_pair (src, ap));
+						continue;
+					}
+				}
+				_cycle_tasks.push_back (p->second.get ());
+			}
+
+			/* group inputs by source, the first of each group resamples */
+			std::sort (_cycle_inputs.begin (), _cycle_inputs.end ());
+			for (std::vector<ExternalInput>::const_iterator i = _cycle_inputs.begin (); i != _cycle_inputs.end (); ++i) {
+				if (i == _cycle_inputs.begin () || i->first != (i - 1)->first) {
+					_cycle_tasks.push_back (i->second);
+				}
+			}
+
+			_cycle_task_nframes = nframes;
+			s->rt_tasklist()->process (&PortManager::cycle_start_task, this, _cycle_tasks.size ());
+
+			AudioPort* first = 0;
+			for (std::vector<ExternalInput>::const_iterator i = _cycle_inputs.begin (); i != _cycle_inputs.end (); ++i) {
+				if (i == _cycle_inputs.begin () || i->first != (i - 1)->first) {
+					first = i->second;
+				} else {
+					i->second->cycle_start_from (nframes, *first);
+				}
+			}
+			return;
 		}
 	}
+
+	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+		p->second->cycle_start (nframes);
+	}
 }
 
 void
-PortManager::cycle_end (pframes_t nframes, Session* s)
+PortManager::ports_cycle_end (pframes_t nframes, Session* s)
 {
 	// see optimzation note in ::cycle_start()
 	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
-		}
-		s->rt_tasklist()->process (tl);
-	} else {
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			p->second->cycle_end (nframes);
+		Glib::Threads::Mutex::Lock lm (_cycle_tasks_lock, Glib::Threads::TRY_LOCK);
+		if (lm.locked () && _cycle_tasks.capacity () >= _cycle_ports->size ()) {
+			_cycle_tasks.clear ();
+			for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+				_cycle_tasks.push_back (p->second.get ());
+			}
+			_cycle_task_nframes = nframes;
+			s->rt_tasklist()->process (&PortManager::cycle_end_task, this, _cycle_tasks.size ());
+			return;
 		}
 	}
 
+	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
+		p->second->cycle_end (nframes);
+	}
+}
+
+void
+PortManager::cycle_end (pframes_t nframes, Session* s)
+{
+	ports_cycle_end (nframes, s);
+
 	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 		p->second->flush_buffers (nframes);
 	}
@@ -919,18 +1021,7 @@ PortManager::check_monitoring ()
 void
 PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t nframes, Session* s)
 {
-	// see optimzation note in ::cycle_start()
-	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
-		}
-		s->rt_tasklist()->process (tl);
-	} else {
-		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
-			p->second->cycle_end (nframes);
-		}
-	}
+	ports_cycle_end (nframes, s);
 
 	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 		p->second->flush_buffers (nframes);
@@ -404,6 +404,7 @@ Region::Region (boost::shared_ptr<const Region> other, const SourceList& srcs)
 	_position_locked = false;
 
 	other->_first_edit = EditChangesName;
+	other->invalidate_cached_state ();
 
 	if (other->_extra_xml) {
 		_extra_xml = new XMLNode (*other->_extra_xml);
@@ -499,6 +500,8 @@ Region::set_length (samplecnt_t len, const int32_t sub_num)
 void
 Region::set_length_internal (samplecnt_t len, const int32_t sub_num)
 {
+	invalidate_cached_state ();
+
 	_last_length = _length;
 	_length = len;
 }
@@ -564,6 +567,8 @@ Region::move_to_natural_position ()
 void
 Region::special_set_position (samplepos_t pos)
 {
+	invalidate_cached_state ();
+
 	/* this is used when creating a whole file region as
 	   a way to store its "natural" or "captured" position.
 	*/
@@ -650,6 +655,8 @@ Region::set_position (samplepos_t pos, int32_t sub_num)
 void
 Region::set_position_internal (samplepos_t pos, bool allow_bbt_recompute, const int32_t sub_num)
 {
+	invalidate_cached_state ();
+
 	/* We emit a change of Properties::position even if the position hasn't changed
 	   (see Region::set_position), so we must always set this up so that
 	   e.g. Playlist::notify_region_moved doesn't use an out-of-date last_position.
@@ -709,6 +716,8 @@ Region::set_position_music (double qn)
 void
 Region::set_position_music_internal (double qn)
 {
+	invalidate_cached_state ();
+
 	/* We emit a change of Properties::position even if the position hasn't changed
 	   (see Region::set_position), so we must always set this up so that
 	   e.g. Playlist::notify_region_moved doesn't use an out-of-date last_position.
@@ -772,6 +781,8 @@ Region::set_initial_position (samplepos_t pos)
 void
 Region::recompute_position_from_lock_style (const int32_t sub_num)
 {
+	invalidate_cached_state ();
+
 	_beat = _session.tempo_map().exact_beat_at_sample (_position, sub_num);
 	_quarter_note = _session.tempo_map().exact_qn_at_sample (_position, sub_num);
 }
@@ -811,6 +822,7 @@ Region::nudge_position (sampleoffset_t n)
 void
 Region::set_ancestral_data (samplepos_t s, samplecnt_t l, float st, float sh)
 {
+	invalidate_cached_state ();
 	_ancestral_length = l;
 	_ancestral_start = s;
 	_stretch = st;
@@ -909,6 +921,8 @@ Region::cut_end (samplepos_t new_endpoint, const int32_t sub_num)
 void
 Region::modify_front (samplepos_t new_position, bool reset_fade, const int32_t sub_num)
 {
+	invalidate_cached_state ();
+
 	if (locked()) {
 		return;
 	}
@@ -954,6 +968,8 @@ Region::modify_front (samplepos_t new_position, bool reset_fade, const int32_t s
 void
 Region::modify_end (samplepos_t new_endpoint, bool reset_fade, const int32_t sub_num)
 {
+	invalidate_cached_state ();
+
 	if (locked()) {
 		return;
 	}
@@ -1089,6 +1105,7 @@ Region::set_hidden (bool yn)
 void
 Region::set_whole_file (bool yn)
 {
+	invalidate_cached_state ();
 	_whole_file = yn;
 	/* no change signal */
 }
@@ -1096,6 +1113,7 @@ Region::set_whole_file (bool yn)
 void
 Region::set_automatic (bool yn)
 {
+	invalidate_cached_state ();
 	_automatic = yn;
 	/* no change signal */
 }
@@ -1271,6 +1289,7 @@ Region::lower_to_bottom ()
 void
 Region::set_layer (layer_t l)
 {
+	invalidate_cached_state ();
 	_layer = l;
 }
 
@@ -1372,9 +1391,12 @@ Region::set_state (const XMLNode& node, int version)
 int
 Region::_set_state (const XMLNode& node, int /*version*/, PropertyChange& what_changed, bool send)
 {
+	invalidate_cached_state ();
+
 	Timecode::BBT_Time bbt_time;
 
 	Stateful::save_extra_xml (node);
+	invalidate_cached_state ();
 
 	what_changed = set_values (node);
 
@@ -1549,6 +1571,8 @@ Region::set_master_sources (const SourceList& srcs)
 	for (SourceList::const_iterator i = _master_sources.begin (); i != _master_sources.end(); ++i) {
 		(*i)->inc_use_count ();
 	}
+
+	invalidate_cached_state ();
 }
 
 bool
@@ -1865,6 +1889,8 @@ Region::drop_sources ()
 	}
 
 	_master_sources.clear ();
+
+	invalidate_cached_state ();
 }
 
 void
@@ -1887,6 +1913,8 @@ Region::use_sources (SourceList const & s)
 			(*i)->DropReferences.connect_same_thread (*this, boost::bind (&Region::source_deleted, this, boost::weak_ptr<Source>(*i)));
 		}
 	}
+
+	invalidate_cached_state ();
 }
 
 Trimmable::CanTrim
@@ -1937,12 +1965,15 @@ Region::is_compound () const
 void
 Region::post_set (const PropertyChange& pc)
 {
+	invalidate_cached_state ();
+
 	_quarter_note = _session.tempo_map().quarter_note_at_beat (_beat);
 }
 
 void
 Region::set_start_internal (samplecnt_t s, const int32_t sub_num)
 {
+	invalidate_cached_state ();
 	_start = s;
 }
 
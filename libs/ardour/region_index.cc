@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "ardour/region.h"
+#include "ardour/region_index.h"
+
+using namespace ARDOUR;
+
+namespace {
+
+struct EntrySorter {
+	template<typename E>
+	bool operator() (E const& a, E const& b) const {
+		return a.first < b.first;
+	}
+};
+
+struct Counter {
+	Counter () : n (0) {}
+	void operator() (boost::shared_ptr<Region> const&) { ++n; }
+	uint32_t n;
+};
+
+struct TopLayer {
+	TopLayer (bool s) : skip_muted (s), layer (0) {}
+	void operator() (boost::shared_ptr<Region> const& r) {
+		if (skip_muted && r->muted ()) {
+			return;
+		}
+		if (!top || r->layer () >= layer) {
+			top = r;
+			layer = r->layer ();
+		}
+	}
+	bool skip_muted;
+	layer_t layer;
+	boost::shared_ptr<Region> top;
+};
+
+}
+
+RegionIndex::RegionIndex (RegionList::const_iterator begin, RegionList::const_iterator end)
+{
+	for (RegionList::const_iterator i = begin; i != end; ++i) {
+		const samplepos_t first = (*i)->first_sample ();
+		const samplepos_t last = (*i)->last_sample ();
+		if (last < first) {
+			/* empty region, never covers anything */
+			continue;
+		}
+		_entries.push_back (Entry (first, last, *i));
+	}
+
+	/* the playlist keeps its regions sorted by position, this is only
+	 * to be sure. A stable sort retains the order of regions with the
+	 * same position.
+	 */
+	std::stable_sort (_entries.begin (), _entries.end (), EntrySorter ());
+
+	_max_last.resize (_entries.size ());
+	build (0, _entries.size ());
+}
+
+samplepos_t
+RegionIndex::build (size_t lo, size_t hi)
+{
+	if (lo >= hi) {
+		return -1;
+	}
+
+	const size_t mid = lo + (hi - lo) / 2;
+	samplepos_t m = _entries[mid].last;
+
+	m = std::max (m, build (lo, mid));
+	m = std::max (m, build (mid + 1, hi));
+
+	_max_last[mid] = m;
+	return m;
+}
+
+size_t
+RegionIndex::lower_bound (samplepos_t pos) const
+{
+	size_t lo = 0;
+	size_t hi = _entries.size ();
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (_entries[mid].first < pos) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+uint32_t
+RegionIndex::count_touched (samplepos_t start, samplepos_t end) const
+{
+	Counter c;
+	visit_touched (start, end, c);
+	return c.n;
+}
+
+boost::shared_ptr<Region>
+RegionIndex::top_at (samplepos_t sample, bool skip_muted) const
+{
+	TopLayer t (skip_muted);
+	visit_touched (sample, sample, t);
+	return t.top;
+}
@@ -65,6 +65,7 @@
 #include "ardour/panner_shell.h"
 #include "ardour/parameter_descriptor.h"
 #include "ardour/phase_control.h"
+#include "ardour/pipeline_break.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/polarity_processor.h"
 #include "ardour/port.h"
@@ -108,6 +109,7 @@ Route::Route (Session& sess, string name, PresentationInfo::Flag flag, DataType
 	, _have_internal_generator (false)
 	, _default_type (default_type)
 	, _loop_location (NULL)
+	, _pipeline_first_stage_feeds (false)
 	, _track_number (0)
 	, _strict_io (false)
 	, _in_configure_processors (false)
@@ -330,19 +332,19 @@ Route::process_output_buffers (BufferSet& bufs,
 		_pannable->automation_run (start_sample + _signal_latency, nframes);
 	}
 
+	/* if the route is pipelined, processors after the break are run
+	 * by the second stage (in a different thread), see run_pipeline_stage()
+	 */
+	ProcessorList::const_iterator last = _processors.end ();
+	if (_pipeline_break && _pipeline_break->split ()) {
+		last = find (_processors.begin (), _processors.end (), _pipeline_break);
+		assert (last != _processors.end ());
+		++last;
+	}
+
 	/* figure out if we're going to use gain automation */
 	if (gain_automation_ok) {
-		_amp->set_gain_automation_buffer (_session.gain_automation_buffer ());
-		_amp->setup_gain_automation (
-				start_sample + _amp->output_latency (),
-				end_sample + _amp->output_latency (),
-				nframes);
-
-		_trim->set_gain_automation_buffer (_session.trim_automation_buffer ());
-		_trim->setup_gain_automation (
-				start_sample + _trim->output_latency (),
-				end_sample + _trim->output_latency (),
-				nframes);
+		setup_gain_automation (_processors.begin (), last, start_sample, end_sample, nframes);
 	}
 
 	/* We align the playhead to output. The user hears what the clock says:
@@ -438,7 +440,7 @@ Route::process_output_buffers (BufferSet& bufs,
 
 	samplecnt_t latency = 0;
 
-	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+	for (ProcessorList::const_iterator i = _processors.begin(); i != last; ++i) {
 
 		/* TODO check for split cycles here.
 		 *
@@ -514,6 +516,110 @@ Route::process_output_buffers (BufferSet& bufs,
 	}
 }
 
+void
+Route::setup_gain_automation (ProcessorList::const_iterator first, ProcessorList::const_iterator last,
+                              samplepos_t start_sample, samplepos_t end_sample, pframes_t nframes)
+{
+	/* the automation-buffers are per process-thread, so this needs to
+	 * be called by the thread that runs the amp.
+	 */
+	for (ProcessorList::const_iterator i = first; i != last; ++i) {
+		if (*i == _amp) {
+			_amp->set_gain_automation_buffer (_session.gain_automation_buffer ());
+			_amp->setup_gain_automation (
+					start_sample + _amp->output_latency (),
+					end_sample + _amp->output_latency (),
+					nframes);
+		} else if (*i == _trim) {
+			_trim->set_gain_automation_buffer (_session.trim_automation_buffer ());
+			_trim->setup_gain_automation (
+					start_sample + _trim->output_latency (),
+					end_sample + _trim->output_latency (),
+					nframes);
+		}
+	}
+}
+
+int
+Route::run_pipeline_stage (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool roll, bool session_state_changing)
+{
+	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked() || !_pipeline_break || !_pipeline_break->split ()) {
+		return 0;
+	}
+
+	/* The conditions under which roll() or no_roll() silence the route's
+	 * output must be mirrored here: the first stage does not wait for
+	 * the second one.
+	 */
+	if (!_active) {
+		return 0;
+	}
+
+	bool gain_automation_ok = false;
+
+	if (roll) {
+		samplecnt_t latency_preroll = _session.remaining_latency_preroll ();
+		if (!_disk_reader || latency_preroll <= playback_latency ()) {
+			gain_automation_ok = (!_disk_writer || !_disk_writer->record_enabled()) && _session.transport_rolling();
+		}
+		start_sample -= latency_preroll;
+		end_sample   -= latency_preroll;
+	} else if (session_state_changing && _session.transport_speed() != 0.0f) {
+		return 0;
+	}
+
+	ProcessorList::const_iterator first = find (_processors.begin (), _processors.end (), _pipeline_break);
+	assert (first != _processors.end ());
+
+	/* latency of the first stage, including the break itself */
+	samplecnt_t latency = 0;
+	for (ProcessorList::const_iterator i = _processors.begin (); i != first; ++i) {
+		if ((*i)->active ()) {
+			latency += (*i)->signal_latency ();
+		}
+	}
+	latency += _pipeline_break->signal_latency ();
+	++first;
+
+	if (gain_automation_ok) {
+		setup_gain_automation (first, _processors.end (), start_sample, end_sample, nframes);
+	}
+
+	const double speed = (is_auditioner() ? 1.0 : _session.transport_speed ());
+	const sampleoffset_t latency_offset = _signal_latency + _output->latency ();
+
+	if (speed < 0) {
+		start_sample -= latency_offset;
+		end_sample -= latency_offset;
+	} else {
+		start_sample += latency_offset;
+		end_sample += latency_offset;
+	}
+
+	BufferSet& bufs (_session.get_route_buffers (n_process_buffers()));
+
+	_pipeline_break->read (bufs, nframes);
+
+	for (ProcessorList::const_iterator i = first; i != _processors.end(); ++i) {
+		if (speed < 0) {
+			(*i)->run (bufs, start_sample + latency, end_sample + latency, speed, nframes, *i != _processors.back());
+		} else {
+			(*i)->run (bufs, start_sample - latency, end_sample - latency, speed, nframes, *i != _processors.back());
+		}
+
+		bufs.set_count ((*i)->output_streams());
+
+		if ((*i)->active ()) {
+			latency += (*i)->signal_latency ();
+		}
+	}
+
+	flush_processor_buffers_locked (first, _processors.end (), nframes);
+	return 0;
+}
+
 void
 Route::bounce_process (BufferSet& buffers, samplepos_t start, samplecnt_t nframes,
 		boost::shared_ptr<Processor> endpoint,
@@ -561,9 +667,9 @@ Route::bounce_process (BufferSet& buffers, samplepos_t start, samplecnt_t nframe
 		}
 
 		/* don't run any processors that do routing.
-		 * Also don't bother with metering.
+		 * Also don't bother with metering or the pipeline delay.
 		 */
-		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i)) {
+		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i) && (*i) != _pipeline_break) {
 			(*i)->run (buffers, start - latency, start - latency + nframes, 1.0, nframes, true);
 			buffers.set_count ((*i)->output_streams());
 			latency += (*i)->signal_latency ();
@@ -594,7 +700,7 @@ Route::bounce_get_latency (boost::shared_ptr<Processor> endpoint,
 		if (!for_export && for_freeze && (*i)->does_routing() && (*i)->active()) {
 			break;
 		}
-		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i)) {
+		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i) && (*i) != _pipeline_break) {
 			latency += (*i)->signal_latency ();
 		}
 		if ((*i) == endpoint) {
@@ -1362,7 +1468,7 @@ Route::clear_processors (Placement p)
 bool
 Route::is_internal_processor (boost::shared_ptr<Processor> p) const
 {
-	if (p == _amp || p == _meter || p == _main_outs || p == _delayline || p == _trim || p == _polarity) {
+	if (p == _amp || p == _meter || p == _main_outs || p == _delayline || p == _trim || p == _polarity || p == _pipeline_break) {
 		return true;
 	}
 	return false;
@@ -2385,6 +2491,42 @@ Route::set_strict_io (const bool enable)
 	return true;
 }
 
+bool
+Route::set_pipelined (const bool enable)
+{
+	if (is_auditioner ()) {
+		return false;
+	}
+
+	Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
+
+	if (pipelined () == enable) {
+		return true;
+	}
+
+	{
+		Glib::Threads::RWLock::WriterLock lm (_processor_lock);
+		if (enable) {
+			_pipeline_break.reset (new PipelineBreak (_session, name ()));
+			_pipeline_break->set_owner (this);
+			_pipeline_stage.reset (new PipelineStageNode (_graph, this, _pipeline_break));
+		} else {
+			/* the graph may still reference the stage-node until
+			 * the next rechain, it will find the route unsplit.
+			 */
+			_pipeline_break.reset ();
+			_pipeline_stage.reset ();
+		}
+		configure_processors_unlocked (0, &lm);
+	}
+
+	lx.release ();
+
+	processors_changed (RouteProcessorChange ()); /* EMIT SIGNAL */
+	_session.set_dirty ();
+	return true;
+}
+
 XMLNode&
 Route::get_state()
 {
@@ -2411,6 +2553,7 @@ Route::state (bool save_template)
 	node->set_property (X_("name"), name());
 	node->set_property (X_("default-type"), _default_type);
 	node->set_property (X_("strict-io"), _strict_io);
+	node->set_property (X_("pipelined"), pipelined ());
 
 	node->add_child_nocopy (_presentation_info.get_state());
 
@@ -2452,7 +2595,7 @@ Route::state (bool save_template)
 	{
 		Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
 		for (i = _processors.begin(); i != _processors.end(); ++i) {
-			if (*i == _delayline) {
+			if (*i == _delayline || *i == _pipeline_break) {
 				continue;
 			}
 			if (save_template) {
@@ -2525,6 +2668,14 @@ Route::set_state (const XMLNode& node, int version)
 
 	node.get_property (X_("strict-io"), _strict_io);
 
+	bool pipelined;
+	if (node.get_property (X_("pipelined"), pipelined) && pipelined && !_pipeline_break && !is_auditioner ()) {
+		/* processors are configured below, which adds the break */
+		_pipeline_break.reset (new PipelineBreak (_session, name ()));
+		_pipeline_break->set_owner (this);
+		_pipeline_stage.reset (new PipelineStageNode (_graph, this, _pipeline_break));
+	}
+
 	if (is_monitor()) {
 		/* monitor bus does not get a panner, but if (re)created
 		   via XML, it will already have one by the time we
@@ -2675,6 +2826,10 @@ Route::set_state (const XMLNode& node, int version)
 		_delayline->set_name (name ());
 	}
 
+	if (_pipeline_break) {
+		_pipeline_break->set_name (name ());
+	}
+
 	return 0;
 }
 
@@ -2912,7 +3067,7 @@ Route::set_processor_state (const XMLNode& node)
 		} else if (prop->value() == "polarity") {
 			_polarity->set_state (**niter, Stateful::current_state_version);
 			new_order.push_back (_polarity);
-		} else if (prop->value() == "delay") {
+		} else if (prop->value() == "delay" || prop->value() == "pipeline") {
 			// skip -- internal
 		} else if (prop->value() == "main-outs") {
 			_main_outs->set_state (**niter, Stateful::current_state_version);
@@ -3440,6 +3595,76 @@ Route::direct_feeds_according_to_reality (boost::shared_ptr<Route> other, bool*
 	return false;
 }
 
+static void
+add_connected_routes (boost::shared_ptr<const IO> io, Route::PortOwners const & owners, std::set<boost::shared_ptr<Route> >& routes)
+{
+	std::vector<std::string> connections;
+
+	for (PortSet::const_iterator p = io->ports().begin(); p != io->ports().end(); ++p) {
+		connections.clear ();
+		p->get_connections (connections);
+		for (std::vector<std::string>::const_iterator c = connections.begin(); c != connections.end(); ++c) {
+			Route::PortOwners::const_iterator o = owners.find (*c);
+			if (o != owners.end ()) {
+				routes.insert (o->second);
+			}
+		}
+	}
+}
+
+void
+Route::direct_feeds_according_to_reality (PortOwners const & owners, DirectFeeds& feeds)
+{
+	std::set<boost::shared_ptr<Route> > fed;
+
+	add_connected_routes (_output, owners, fed);
+
+	for (std::set<boost::shared_ptr<Route> >::const_iterator r = fed.begin(); r != fed.end(); ++r) {
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("%1 direct FEEDS %2\n", _name, (*r)->name()));
+		feeds[*r] = false;
+	}
+
+	Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
+
+	for (ProcessorList::iterator r = _processors.begin(); r != _processors.end(); ++r) {
+
+		boost::shared_ptr<IOProcessor> iop = boost::dynamic_pointer_cast<IOProcessor>(*r);
+		boost::shared_ptr<PluginInsert> pi = boost::dynamic_pointer_cast<PluginInsert>(*r);
+		if (pi != 0) {
+			assert (iop == 0);
+			iop = pi->sidechain();
+		}
+
+		if (iop == 0) {
+			continue;
+		}
+
+		fed.clear ();
+
+		boost::shared_ptr<const IO> iop_out = iop->output();
+		if (iop_out) {
+			add_connected_routes (iop_out, owners, fed);
+		}
+
+		boost::shared_ptr<InternalSend> isend = boost::dynamic_pointer_cast<InternalSend> (iop);
+		if (isend && isend->target_route () && isend->feeds (isend->target_route ())) {
+			fed.insert (isend->target_route ());
+		}
+
+		/* as above, an IOP that feeds its own return does not make us feed ourselves */
+		const bool feeds_own_return = iop_out && iop->input() && iop_out->connected_to (iop->input());
+
+		for (std::set<boost::shared_ptr<Route> >::const_iterator f = fed.begin(); f != fed.end(); ++f) {
+			if (f->get() == this && feeds_own_return) {
+				continue;
+			}
+			DEBUG_TRACE (DEBUG::Graph, string_compose ("%1 IOP %2 does feed %3\n", _name, iop->name(), (*f)->name()));
+			/* does not replace a feed via our main outs */
+			feeds.insert (std::make_pair (*f, true));
+		}
+	}
+}
+
 bool
 Route::direct_feeds_according_to_graph (boost::shared_ptr<Route> other, bool* via_send_only)
 {
@@ -3657,7 +3882,19 @@ Route::pans_required () const
 void
 Route::flush_processor_buffers_locked (samplecnt_t nframes)
 {
-	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
+	if (_pipeline_break && _pipeline_break->split ()) {
+		/* only the first stage, the second stage flushes its own */
+		ProcessorList::const_iterator last = find (_processors.begin (), _processors.end (), _pipeline_break);
+		flush_processor_buffers_locked (_processors.begin (), last, nframes);
+	} else {
+		flush_processor_buffers_locked (_processors.begin (), _processors.end (), nframes);
+	}
+}
+
+void
+Route::flush_processor_buffers_locked (ProcessorList::const_iterator first, ProcessorList::const_iterator last, samplecnt_t nframes)
+{
+	for (ProcessorList::const_iterator i = first; i != last; ++i) {
 		boost::shared_ptr<Delivery> d = boost::dynamic_pointer_cast<Delivery> (*i);
 		if (d) {
 			d->flush_buffers (nframes);
@@ -4950,6 +5187,11 @@ Route::setup_invisible_processors ()
 		}
 	}
 
+	/* PIPELINE BREAK */
+	if (_pipeline_break) {
+		setup_pipeline_break (new_processors);
+	}
+
 	_processors = new_processors;
 
 	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
@@ -4964,6 +5206,86 @@ Route::setup_invisible_processors ()
 	}
 }
 
+/** Insert the pipeline break into the given processor list, which is
+ * otherwise complete.
+ *
+ * The break is placed so that the DSP load of plugins is split evenly
+ * between the two stages. It must come after the disk-i/o, return and
+ * latency delayline (those must see this cycle's data), and before the
+ * main outs.
+ *
+ * Routes fed by this route depend on the second stage in the process
+ * graph, so sends are kept after the break. Plugins with a sidechain
+ * input read this cycle's data of the routes feeding them, and are kept
+ * before the break. If a send has to be in the first stage (it comes
+ * before a sidechain), the first stage feeds those routes as well.
+ */
+void
+Route::setup_pipeline_break (ProcessorList& new_processors)
+{
+	ProcessorList::iterator first = new_processors.begin ();
+	ProcessorList::iterator main  = find (new_processors.begin (), new_processors.end (), _main_outs);
+
+	for (ProcessorList::iterator i = new_processors.begin (); i != main; ++i) {
+		boost::shared_ptr<PluginInsert> pi = boost::dynamic_pointer_cast<PluginInsert> (*i);
+		if (*i == _disk_reader || *i == _disk_writer || *i == _intreturn || *i == _delayline
+		    || *i == _capturing_processor || *i == _polarity || (pi && pi->has_sidechain ())) {
+			first = i;
+			++first;
+		}
+	}
+
+	/* the first send (or any other i/o processor) after that */
+	ProcessorList::iterator last = first;
+	for (; last != main; ++last) {
+		if (boost::dynamic_pointer_cast<IOProcessor> (*last)) {
+			break;
+		}
+	}
+
+	/* weight plugins by their average run time, if known */
+	std::vector<double> weights;
+	double total = 0;
+
+	for (ProcessorList::iterator i = first; i != last; ++i) {
+		boost::shared_ptr<PluginInsert> pi = boost::dynamic_pointer_cast<PluginInsert> (*i);
+		double w = 0;
+		if (pi) {
+			uint64_t min, max;
+			double avg, dev;
+			w = pi->get_stats (min, max, avg, dev) ? std::max (1.0, avg) : 1.0;
+		}
+		weights.push_back (w);
+		total += w;
+	}
+
+	ProcessorList::iterator pos = first;
+	double sum = 0;
+
+	if (total > 0) {
+		for (std::vector<double>::const_iterator w = weights.begin (); w != weights.end (); ++w, ++pos) {
+			sum += *w;
+			if (sum * 2 >= total) {
+				++pos;
+				break;
+			}
+		}
+	} else {
+		/* no plugins, split just before the first send or the main outs */
+		pos = last;
+	}
+
+	_pipeline_first_stage_feeds = false;
+	for (ProcessorList::iterator i = new_processors.begin (); i != pos; ++i) {
+		if (boost::dynamic_pointer_cast<IOProcessor> (*i)) {
+			_pipeline_first_stage_feeds = true;
+			break;
+		}
+	}
+
+	new_processors.insert (pos, _pipeline_break);
+}
+
 void
 Route::unpan ()
 {
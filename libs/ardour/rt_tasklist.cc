@@ -32,6 +32,10 @@ RTTaskList::RTTaskList ()
 	: _threads_active (0)
 	, _task_run_sem ("rt_task_run", 0)
 	, _task_end_sem ("rt_task_done", 0)
+	, _task_fn (0)
+	, _task_arg (0)
+	, _task_count (0)
+	, _task_next (0)
 {
 	reset_thread_list ();
 }
@@ -105,66 +109,55 @@ RTTaskList::reset_thread_list ()
 void
 RTTaskList::run ()
 {
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-	bool wait = true;
-
 	while (true) {
-		if (wait) {
-			_task_run_sem.wait ();
-		}
+		_task_run_sem.wait ();
 
 		if (0 == g_atomic_int_get (&_threads_active)) {
 			_task_end_sem.signal ();
 			break;
 		}
 
-		wait = false;
-
-		boost::function<void ()> to_run;
-		tm.acquire ();
-		if (_tasklist.size () > 0) {
-			to_run = _tasklist.front();
-			_tasklist.pop_front ();
-		}
-		tm.release ();
-
-		if (!to_run.empty ()) {
-			to_run ();
-			continue;
-		}
-
-		if (!wait) {
-			_task_end_sem.signal ();
-		}
-
-		wait = true;
+		run_tasks ();
+		_task_end_sem.signal ();
 	}
 }
 
 void
-RTTaskList::process (TaskList const& tl)
+RTTaskList::run_tasks ()
 {
-	Glib::Threads::Mutex::Lock pm (_process_mutex);
-	_tasklist = tl;
-	process_tasklist ();
-	_tasklist.clear ();
+	/* claim the next index until all are taken */
+	gint i;
+	while ((i = g_atomic_int_add (&_task_next, 1)) < _task_count) {
+		_task_fn (_task_arg, i);
+	}
 }
 
 void
-RTTaskList::process_tasklist ()
+RTTaskList::process (TaskFunction fn, void* arg, uint32_t n_tasks)
 {
-	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0) {
-		for (TaskList::iterator i = _tasklist.begin (); i != _tasklist.end(); ++i) {
-			(*i)();
+	Glib::Threads::Mutex::Lock pm (_process_mutex);
+
+	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0 || n_tasks < 2) {
+		for (uint32_t i = 0; i < n_tasks; ++i) {
+			fn (arg, i);
 		}
 		return;
 	}
 
-	uint32_t nt = std::min (_threads.size (), _tasklist.size ());
+	_task_fn    = fn;
+	_task_arg   = arg;
+	_task_count = n_tasks;
+	g_atomic_int_set (&_task_next, 0);
+
+	/* the calling thread takes tasks, too */
+	uint32_t nt = std::min ((uint32_t) _threads.size (), n_tasks - 1);
 
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_run_sem.signal ();
 	}
+
+	run_tasks ();
+
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_end_sem.wait ();
 	}
@@ -2366,26 +2366,51 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 	 * 2. Begin the process of making routes aware of which other
 	 *    routes directly or indirectly feed them.  This information
 	 *    is used by the solo code.
+	 *
+	 * Rather than asking every route whether it feeds every other
+	 * route, index all input ports by name and let each route look
+	 * up the owners of the ports its outputs are connected to.
 	 */
 
-	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+	Route::PortOwners owners;
 
+	/* like Port::connected_to(), connections only count while the engine runs */
+	if (_engine.running ()) {
+		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+			IOVector const inputs ((*i)->all_inputs ());
+			for (IOVector::const_iterator in = inputs.begin(); in != inputs.end(); ++in) {
+				boost::shared_ptr<const IO> io = in->lock ();
+				if (!io) {
+					continue;
+				}
+				for (PortSet::const_iterator p = io->ports().begin(); p != io->ports().end(); ++p) {
+					owners[_engine.make_port_name_non_relative (p->name ())] = *i;
+				}
+			}
+		}
+	}
+
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
 		/* Clear out the route's list of direct or indirect feeds */
 		(*i)->clear_fed_by ();
+	}
 
-		for (RouteList::iterator j = r->begin(); j != r->end(); ++j) {
+	std::set<boost::shared_ptr<Route> > const listed (r->begin(), r->end());
 
-			bool via_sends_only;
+	for (RouteList::iterator j = r->begin(); j != r->end(); ++j) {
 
-			/* See if this *j feeds *i according to the current state of the JACK
-			   connections and internal sends.
-			*/
-			if ((*j)->direct_feeds_according_to_reality (*i, &via_sends_only)) {
-				/* add the edge to the graph (part #1) */
-				edges.add (*j, *i, via_sends_only);
-				/* tell the route (for part #2) */
-				(*i)->add_fed_by (*j, via_sends_only);
+		Route::DirectFeeds feeds;
+		(*j)->direct_feeds_according_to_reality (owners, feeds);
+
+		for (Route::DirectFeeds::const_iterator i = feeds.begin(); i != feeds.end(); ++i) {
+			if (listed.find (i->first) == listed.end ()) {
+				/* e.g. an internal send to a route not in this list */
+				continue;
 			}
+			/* add the edge to the graph (part #1) */
+			edges.add (*j, i->first, i->second);
+			/* tell the route (for part #2) */
+			i->first->add_fed_by (*j, i->second);
 		}
 	}
 
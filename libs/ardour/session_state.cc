@@ -64,6 +64,7 @@
 #include "evoral/SMF.hpp"
 
 #include "pbd/basename.h"
+#include "pbd/cpus.h"
 #include "pbd/debug.h"
 #include "pbd/enumwriter.h"
 #include "pbd/error.h"
@@ -73,6 +74,7 @@
 #include "pbd/stacktrace.h"
 #include "pbd/types_convert.h"
 #include "pbd/localtime_r.h"
+#include "pbd/timing.h"
 #include "pbd/unwind.h"
 
 #include "ardour/amp.h"
@@ -803,6 +805,12 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 
 	PBD::Unwinder<bool> uw (LV2Plugin::force_state_save, for_archive);
 
+	/* regions that did not change since the last save re-use their
+	 * serialized state. Templates and archives are written elsewhere
+	 * and may rewrite IDs or paths, so they are always built afresh.
+	 */
+	Stateful::CacheSerializedState cs (Config->get_cache_session_state () && !template_only && !for_archive);
+
 	SessionSaveUnderway (); /* EMIT SIGNAL */
 
 	bool mark_as_clean = true;
@@ -1367,7 +1375,7 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool only_used_ass
 					if (boost::dynamic_pointer_cast<AudioRegion>(r)) {
 						child->add_child_nocopy ((boost::dynamic_pointer_cast<AudioRegion>(r))->get_basic_state ());
 					} else {
-						child->add_child_nocopy (r->get_state ());
+						child->add_child_nocopy (r->get_cached_state ());
 					}
 				}
 			}
@@ -1529,7 +1537,9 @@ Session::set_state (const XMLNode& node, int version)
 	XMLNodeList nlist;
 	XMLNode* child;
 	int ret = -1;
+	PBD::Timing phase_timing;
 
+	_load_timings.clear ();
 	_state_of_the_state = StateOfTheState (_state_of_the_state|CannotSave);
 
 	if (node.name() != X_("Session")) {
@@ -1616,6 +1626,8 @@ Session::set_state (const XMLNode& node, int version)
 		_speakers->set_state (*child, version);
 	}
 
+	load_phase_done (X_("options"), phase_timing);
+
 	if ((child = find_named_node (node, "Sources")) == 0) {
 		error << _("Session: XML state has no sources section") << endmsg;
 		goto out;
@@ -1623,6 +1635,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (X_("sources"), phase_timing);
+
 	if ((child = find_named_node (node, "TempoMap")) == 0) {
 		error << _("Session: XML state has no Tempo Map section") << endmsg;
 		goto out;
@@ -1643,6 +1657,8 @@ Session::set_state (const XMLNode& node, int version)
 		AudioFileSource::set_header_position_offset (_session_range_location->start());
 	}
 
+	load_phase_done (X_("tempo map and locations"), phase_timing);
+
 	if ((child = find_named_node (node, "Regions")) == 0) {
 		error << _("Session: XML state has no Regions section") << endmsg;
 		goto out;
@@ -1650,6 +1666,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (X_("regions"), phase_timing);
+
 	if ((child = find_named_node (node, "Playlists")) == 0) {
 		error << _("Session: XML state has no playlists section") << endmsg;
 		goto out;
@@ -1669,6 +1687,8 @@ Session::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	load_phase_done (X_("playlists"), phase_timing);
+
 	if (version >= 3000) {
 		if ((child = find_named_node (node, "Bundles")) == 0) {
 			warning << _("Session: XML state has no bundles section") << endmsg;
@@ -1692,6 +1712,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (X_("routes"), phase_timing);
+
 	/* Now that we have Routes and masters loaded, connect them if appropriate */
 
 	Slavable::Assign (_vca_manager); /* EMIT SIGNAL */
@@ -1753,6 +1775,8 @@ Session::set_state (const XMLNode& node, int version)
 
 	update_route_record_state ();
 
+	load_phase_done (X_("groups, control surfaces and scripts"), phase_timing);
+
 	/* here beginneth the second phase ... */
 	set_snapshot_name (_current_snapshot_name);
 
@@ -1768,6 +1792,15 @@ out:
 	return ret;
 }
 
+void
+Session::load_phase_done (std::string const & name, PBD::Timing& timing)
+{
+	_load_timings.push_back (std::make_pair (name, timing.get_interval ()));
+#ifndef NDEBUG
+	cerr << "loaded " << name << " in " << fixed << setprecision (1) << _load_timings.back ().second / 1000. << " ms\n";
+#endif
+}
+
 int
 Session::load_routes (const XMLNode& node, int version)
 {
@@ -2311,6 +2344,94 @@ Session::reset_write_sources (bool mark_write_complete, bool force)
 	}
 }
 
+namespace {
+
+/** Audio file sources opened ahead of Session::load_sources() by a
+ *  set of worker threads, in the order of their XML nodes.
+ */
+struct SourcePreload {
+	SourcePreload (Session& s) : session (s), next (0) {}
+
+	Session& session;
+	std::vector<XMLNode const*> nodes;
+	std::vector<boost::shared_ptr<Source> > sources;
+	gint next;
+};
+
+void
+preload_sources_thread (SourcePreload* preload)
+{
+	while (true) {
+		guint const n = g_atomic_int_add (&preload->next, 1);
+		if (n >= preload->nodes.size ()) {
+			break;
+		}
+		try {
+			preload->sources[n] = SourceFactory::create (preload->session, *preload->nodes[n], true, false);
+		} catch (...) {
+			/* load_sources() tries again and reports the error */
+		}
+	}
+}
+
+}
+
+/** Open plain audio file sources (and check their peakfiles) in parallel.
+ *  Sources are not announced here: load_sources() does that in session
+ *  file order, and handles any source that could not be preloaded the
+ *  usual way, including asking about missing files.
+ */
+void
+Session::preload_sources (const XMLNodeList& nlist, std::map<XMLNode const*, boost::shared_ptr<Source> >& preloaded)
+{
+	/* with more than one directory to search, FileSource::find()
+	 * may need to ask which of several files with the same name to use.
+	 */
+	if (source_search_path (DataType::AUDIO).size () != 1) {
+		return;
+	}
+
+	SourcePreload preload (*this);
+
+	for (XMLNodeConstIterator niter = nlist.begin(); niter != nlist.end(); ++niter) {
+		DataType type = DataType::AUDIO;
+		(*niter)->get_property ("type", type);
+		if ((*niter)->name () == X_("Source") && type == DataType::AUDIO && !(*niter)->property (X_("playlist"))) {
+			preload.nodes.push_back (*niter);
+		}
+	}
+
+	if (preload.nodes.size () < 2) {
+		return;
+	}
+
+	preload.sources.resize (preload.nodes.size ());
+
+	uint32_t const n_threads = std::min ((size_t) hardware_concurrency (), preload.nodes.size ());
+
+#ifdef PLATFORM_WINDOWS
+	int old_mode = SetErrorMode (SEM_FAILCRITICALERRORS);
+#endif
+
+	std::vector<Glib::Threads::Thread*> threads;
+	for (uint32_t i = 0; i < n_threads; ++i) {
+		threads.push_back (Glib::Threads::Thread::create (boost::bind (&preload_sources_thread, &preload)));
+	}
+	for (std::vector<Glib::Threads::Thread*>::iterator i = threads.begin(); i != threads.end(); ++i) {
+		(*i)->join ();
+	}
+
+#ifdef PLATFORM_WINDOWS
+	SetErrorMode (old_mode);
+#endif
+
+	for (size_t n = 0; n < preload.nodes.size (); ++n) {
+		if (preload.sources[n]) {
+			preloaded[preload.nodes[n]] = preload.sources[n];
+		}
+	}
+}
+
 int
 Session::load_sources (const XMLNode& node)
 {
@@ -2327,11 +2448,21 @@ Session::load_sources (const XMLNode& node)
 	set_dirty();
 	std::map<std::string, std::string> relocation;
 
+	std::map<XMLNode const*, boost::shared_ptr<Source> > preloaded;
+	preload_sources (nlist, preloaded);
+
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
 #ifdef PLATFORM_WINDOWS
 		int old_mode = 0;
 #endif
 
+		std::map<XMLNode const*, boost::shared_ptr<Source> >::iterator p = preloaded.find (*niter);
+
+		if (p != preloaded.end ()) {
+			SourceFactory::SourceCreated (p->second);
+			continue;
+		}
+
 		XMLNode srcnode (**niter);
 		bool try_replace_abspath = true;
 
@@ -3617,6 +3748,7 @@ Session::cleanup_sources (CleanupReport& rep)
 				goto out;
 			}
 		}
+		::g_unlink ((peakpath + peakfile_levels_suffix).c_str ());
 
 		rep.paths.push_back (*x);
 		rep.space += statbuf.st_size;
@@ -26,6 +26,7 @@
 #include <climits>
 #include <cstdarg>
 #include <fcntl.h>
+#include <map>
 
 #include <sys/stat.h>
 
@@ -35,7 +36,11 @@
 #include <glibmm/convert.h>
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
+#include <glibmm/threads.h>
 
+#include <boost/weak_ptr.hpp>
+
+#include "ardour/async_read.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -58,11 +63,120 @@ const Source::Flag SndFileSource::default_writable_flags = Source::Flag (
 		Source::RemovableIfEmpty |
 		Source::CanRename );
 
+/** The last block of interleaved samples read from a multichannel file.
+ *
+ * A multichannel file is used by one SndFileSource per channel, each
+ * with its own SNDFILE. The channels of a region are usually read one
+ * after another for the same range (e.g. by DiskReader::refill_audio()),
+ * so instead of decoding the file once per channel, the first read
+ * decodes all channels into this block and the other channels copy
+ * their samples from it.
+ */
+class SndFileSource::SharedBlock
+{
+  public:
+	SharedBlock (uint32_t c)
+		: channels (c)
+		, buf (0)
+		, capacity (0)
+		, start (0)
+		, length (0)
+	{}
+
+	~SharedBlock () {
+		g_atomic_int_add (&total_capacity, - (gint) capacity);
+		delete [] buf;
+	}
+
+	/** @return the block shared by all channels of the file at @param path */
+	static boost::shared_ptr<SharedBlock> get (std::string const & path, uint32_t channels);
+
+	/** Make room for @param n samples, unless that exceeds the memory
+	 * budget of all blocks. Call with lock held.
+	 * @return false if the block could not be grown
+	 */
+	bool reserve (samplecnt_t n);
+
+	/* larger reads bypass the block, to bound memory use per file */
+	static const samplecnt_t max_samples = 2097152;
+	/* and reads that would exceed this, summed over all files */
+	static const samplecnt_t max_total_samples = 4 * max_samples;
+
+	Glib::Threads::Mutex lock;
+	uint32_t const       channels;
+	Sample*              buf;
+	samplecnt_t          capacity; ///< samples, all channels
+	samplepos_t          start;    ///< first frame in buf
+	samplecnt_t          length;   ///< frames in buf
+
+  private:
+	typedef std::map<std::string, boost::weak_ptr<SharedBlock> > BlockMap;
+	static BlockMap             blocks;
+	static Glib::Threads::Mutex blocks_lock;
+	static volatile gint        total_capacity; ///< samples, all blocks
+};
+
+SndFileSource::SharedBlock::BlockMap SndFileSource::SharedBlock::blocks;
+Glib::Threads::Mutex SndFileSource::SharedBlock::blocks_lock;
+volatile gint SndFileSource::SharedBlock::total_capacity = 0;
+
+bool
+SndFileSource::SharedBlock::reserve (samplecnt_t n)
+{
+	if (capacity >= n) {
+		return true;
+	}
+
+	gint const delta = n - capacity;
+
+	if (g_atomic_int_add (&total_capacity, delta) + delta > max_total_samples) {
+		g_atomic_int_add (&total_capacity, -delta);
+		return false;
+	}
+
+	delete [] buf;
+	buf = new Sample[n];
+	capacity = n;
+
+	return true;
+}
+
+boost::shared_ptr<SndFileSource::SharedBlock>
+SndFileSource::SharedBlock::get (std::string const & path, uint32_t channels)
+{
+	Glib::Threads::Mutex::Lock lm (blocks_lock);
+
+	for (BlockMap::iterator i = blocks.begin(); i != blocks.end(); ) {
+		if (i->second.expired ()) {
+			blocks.erase (i++);
+		} else {
+			++i;
+		}
+	}
+
+	boost::shared_ptr<SharedBlock> block;
+	BlockMap::iterator i = blocks.find (path);
+
+	if (i != blocks.end ()) {
+		block = i->second.lock ();
+	}
+
+	if (!block || block->channels != channels) {
+		block.reset (new SharedBlock (channels));
+		blocks[path] = block;
+	}
+
+	return block;
+}
+
 SndFileSource::SndFileSource (Session& s, const XMLNode& node)
 	: Source(s, node)
 	, AudioFileSource (s, node)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _data_offset (-1)
+	, _bytes_per_frame (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -87,6 +201,9 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn, Flag flag
 	, AudioFileSource (s, path, Flag (flags & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _data_offset (-1)
+	, _bytes_per_frame (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -113,6 +230,9 @@ SndFileSource::SndFileSource (Session& s, const string& path, const string& orig
 	, AudioFileSource (s, path, origin, flags, sfmt, hf)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _data_offset (-1)
+	, _bytes_per_frame (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -225,6 +345,9 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn)
 	, AudioFileSource (s, path, Flag (0))
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _data_offset (-1)
+	, _bytes_per_frame (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -248,6 +371,9 @@ SndFileSource::SndFileSource (Session& s, const AudioFileSource& other, const st
 	, AudioFileSource (s, path, "", Flag ((other.flags () | default_writable_flags | NoPeakFile) & ~RF64_RIFF), /*unused*/ FormatFloat, /*unused*/ WAVE64)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _data_offset (-1)
+	, _bytes_per_frame (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -362,6 +488,10 @@ SndFileSource::close ()
 	if (_sndfile) {
 		sf_close (_sndfile);
 		_sndfile = 0;
+		_fd = -1;
+		_data_offset = -1;
+		/* the block is freed when the last channel of the file is closed */
+		_shared_block.reset ();
 		file_closed ();
 	}
 }
@@ -492,11 +622,161 @@ SndFileSource::open ()
                                 _broadcast_info = 0;
                         }
                 }
-        }
+        } else {
+		setup_prefetch (fd);
+		attach_shared_block ();
+	}
 
 	return 0;
 }
 
+void
+SndFileSource::attach_shared_block ()
+{
+	if (_info.channels < 2 || _shared_block) {
+		return;
+	}
+
+	_shared_block = SharedBlock::get (_path, _info.channels);
+}
+
+/** Read our channel of the given range via the shared block, decoding
+ * it first unless it is already there.
+ * @return false if the shared block could not be used; the caller
+ * then reads the file directly.
+ */
+bool
+SndFileSource::read_shared (Sample* dst, samplepos_t start, samplecnt_t cnt, samplecnt_t& nread) const
+{
+	SharedBlock& block (*_shared_block);
+	samplecnt_t const real_cnt = cnt * block.channels;
+
+	if (real_cnt > SharedBlock::max_samples) {
+		return false;
+	}
+
+	/* another thread is using the block, maybe for a different range
+	 * of the file. Don't wait for it.
+	 */
+	Glib::Threads::Mutex::Lock lm (block.lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked ()) {
+		return false;
+	}
+
+	if (start < block.start || start + cnt > block.start + block.length) {
+
+		if (!block.reserve (real_cnt)) {
+			return false;
+		}
+
+		block.length = 0;
+
+		if (sf_seek (_sndfile, (sf_count_t) start, SEEK_SET|SFM_READ) != (sf_count_t) start) {
+			char errbuf[256];
+			sf_error_str (0, errbuf, sizeof (errbuf) - 1);
+			error << string_compose(_("SndFileSource: could not seek to sample %1 within %2 (%3)"), start, _name.val().substr (1), errbuf) << endmsg;
+			nread = 0;
+			return true;
+		}
+
+		block.start = start;
+		block.length = sf_read_float (_sndfile, block.buf, real_cnt) / block.channels;
+	}
+
+	Sample const * ptr = block.buf + (start - block.start) * block.channels + _channel;
+	nread = std::max ((samplecnt_t) 0, std::min (cnt, block.start + block.length - start));
+
+	if (_gain != 1.f) {
+		for (samplecnt_t n = 0; n < nread; ++n) {
+			dst[n] = *ptr * _gain;
+			ptr += block.channels;
+		}
+	} else {
+		for (samplecnt_t n = 0; n < nread; ++n) {
+			dst[n] = *ptr;
+			ptr += block.channels;
+		}
+	}
+
+	return true;
+}
+
+/** Find the location of the sample data in the file, if reads can be
+ * mapped directly to byte-ranges (uncompressed PCM).
+ */
+void
+SndFileSource::setup_prefetch (int fd)
+{
+	_fd = -1;
+	_data_offset = -1;
+	_bytes_per_frame = 0;
+
+#ifndef PLATFORM_WINDOWS
+	switch (_info.format & SF_FORMAT_TYPEMASK) {
+	case SF_FORMAT_WAV:
+	case SF_FORMAT_WAVEX:
+	case SF_FORMAT_AIFF:
+	case SF_FORMAT_CAF:
+	case SF_FORMAT_RF64:
+		break;
+	default:
+		return;
+	}
+
+	int bytes_per_sample;
+
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_PCM_S8:
+	case SF_FORMAT_PCM_U8:
+		bytes_per_sample = 1;
+		break;
+	case SF_FORMAT_PCM_16:
+		bytes_per_sample = 2;
+		break;
+	case SF_FORMAT_PCM_24:
+		bytes_per_sample = 3;
+		break;
+	case SF_FORMAT_PCM_32:
+	case SF_FORMAT_FLOAT:
+		bytes_per_sample = 4;
+		break;
+	case SF_FORMAT_DOUBLE:
+		bytes_per_sample = 8;
+		break;
+	default:
+		return;
+	}
+
+	/* after seeking to the first sample, the file-position is the start of the data chunk */
+	if (sf_seek (_sndfile, 0, SEEK_SET) != 0) {
+		return;
+	}
+
+	off_t off = ::lseek (fd, 0, SEEK_CUR);
+
+	if (off <= 0) {
+		return;
+	}
+
+	_fd = fd;
+	_data_offset = off;
+	_bytes_per_frame = bytes_per_sample * _info.channels;
+#endif
+}
+
+bool
+SndFileSource::prefetch (AsyncReadBatch& batch, samplepos_t start, samplecnt_t cnt) const
+{
+	if (_fd < 0 || _data_offset < 0 || start >= _length || cnt <= 0) {
+		return false;
+	}
+
+	cnt = std::min (cnt, _length - start);
+	batch.add (_fd, _data_offset + start * _bytes_per_frame, cnt * _bytes_per_frame);
+	return true;
+}
+
 SndFileSource::~SndFileSource ()
 {
 	close ();
@@ -557,6 +837,12 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 		memset (dst+file_cnt, 0, sizeof (Sample) * delta);
 	}
 
+	if (file_cnt && _shared_block && !writable()) {
+		if (read_shared (dst, start, file_cnt, nread)) {
+			return nread;
+		}
+	}
+
 	if (file_cnt) {
 
 		if (sf_seek (_sndfile, (sf_count_t) start, SEEK_SET|SFM_READ) != (sf_count_t) start) {
@@ -24,6 +24,7 @@
 
 #include "pbd/error.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/stacktrace.h"
 
@@ -54,6 +55,8 @@ PBD::Signal1<void,boost::shared_ptr<Source> > SourceFactory::SourceCreated;
 Glib::Threads::Cond SourceFactory::PeaksToBuild;
 Glib::Threads::Mutex SourceFactory::peak_building_lock;
 std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peaks;
+std::list<boost::shared_ptr<PeakBuildJob> > SourceFactory::peak_build_jobs;
+std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peak_levels;
 
 static int active_threads = 0;
 
@@ -67,12 +70,39 @@ peak_thread_work ()
 		SourceFactory::peak_building_lock.lock ();
 
 	  wait:
-		if (SourceFactory::files_with_peaks.empty()) {
+		if (SourceFactory::files_with_peaks.empty() && SourceFactory::peak_build_jobs.empty() && SourceFactory::files_with_peak_levels.empty()) {
 			SourceFactory::PeaksToBuild.wait (SourceFactory::peak_building_lock);
 		}
 
+		if (!SourceFactory::peak_build_jobs.empty()) {
+			/* help to finish files that are already being built
+			 * before starting with the next one.
+			 */
+			boost::shared_ptr<PeakBuildJob> job (SourceFactory::peak_build_jobs.front());
+			SourceFactory::peak_building_lock.unlock ();
+
+			if (!job->process_one ()) {
+				/* all chunks are taken */
+				SourceFactory::remove_peak_build_job (job);
+			}
+			continue;
+		}
+
 		if (SourceFactory::files_with_peaks.empty()) {
-			goto wait;
+
+			if (SourceFactory::files_with_peak_levels.empty()) {
+				goto wait;
+			}
+
+			/* peakfiles first, the levels only speed up zoomed-out views */
+			boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peak_levels.front().lock());
+			SourceFactory::files_with_peak_levels.pop_front ();
+			SourceFactory::peak_building_lock.unlock ();
+
+			if (as) {
+				as->build_peak_levels ();
+			}
+			continue;
 		}
 
 		boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peaks.front().lock());
@@ -99,10 +129,38 @@ SourceFactory::peak_work_queue_length ()
 	return SourceFactory::files_with_peaks.size () + active_threads;
 }
 
+void
+SourceFactory::add_peak_build_job (boost::shared_ptr<PeakBuildJob> job)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	peak_build_jobs.push_back (job);
+	PeaksToBuild.broadcast ();
+}
+
+void
+SourceFactory::remove_peak_build_job (boost::shared_ptr<PeakBuildJob> job)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	peak_build_jobs.remove (job);
+}
+
+void
+SourceFactory::add_peak_levels_job (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	files_with_peak_levels.push_back (boost::weak_ptr<AudioSource> (as));
+	PeaksToBuild.broadcast ();
+}
+
 void
 SourceFactory::init ()
 {
-	for (int n = 0; n < 2; ++n) {
+	/* files are built concurrently, and idle threads help with
+	 * the chunks of files that are already being built.
+	 */
+	const uint32_t n_threads = std::max ((uint32_t) 2, std::min ((uint32_t) 8, hardware_concurrency ()));
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		Glib::Threads::Thread::create (sigc::ptr_fun (::peak_thread_work));
 	}
 }
@@ -147,7 +205,7 @@ SourceFactory::createSilent (Session& s, const XMLNode& node, samplecnt_t nframe
 }
 
 boost::shared_ptr<Source>
-SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
+SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks, bool announce)
 {
 	DataType type = DataType::AUDIO;
 	XMLProperty const * prop = node.property("type");
@@ -171,7 +229,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 
 				ap->check_for_analysis_data_on_disk ();
 
-				SourceCreated (ap);
+				if (announce) {
+					SourceCreated (ap);
+				}
 				return ap;
 
 			} catch (failed_constructor&) {
@@ -191,7 +251,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 					return boost::shared_ptr<Source>();
 				}
 				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
+				if (announce) {
+					SourceCreated (ret);
+				}
 				return ret;
 			}
 
@@ -212,7 +274,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 				}
 
 				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
+				if (announce) {
+					SourceCreated (ret);
+				}
 				return ret;
 #else
 				throw; // rethrow
@@ -228,7 +292,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 			// boost_debug_shared_ptr_mark_interesting (src, "Source");
 #endif
 			src->check_for_analysis_data_on_disk ();
-			SourceCreated (src);
+			if (announce) {
+				SourceCreated (src);
+			}
 			return src;
 		} catch (...) {
 		}
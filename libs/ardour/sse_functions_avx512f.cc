@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* AVX-512F versions of the runtime DSP functions.
+ *
+ * This file is compiled with -mavx512f, the functions must only be
+ * called if the CPU supports it (see setup_hardware_optimization()).
+ *
+ * The last (nframes % 16) samples are processed using masked loads and
+ * stores, there is no scalar tail.
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "ardour/mix.h"
+
+static inline __mmask16
+tail_mask (uint32_t n)
+{
+	return (__mmask16) ((1u << n) - 1);
+}
+
+float
+x86_avx512f_compute_peak (const float * buf, uint32_t nframes, float current)
+{
+	__m512 vmax0 = _mm512_set1_ps (current);
+	__m512 vmax1 = vmax0;
+
+	/* two accumulators to hide the latency of vmaxps */
+	while (nframes >= 32) {
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		vmax1 = _mm512_max_ps (vmax1, _mm512_abs_ps (_mm512_loadu_ps (buf + 16)));
+		buf += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		vmax1 = _mm512_mask_max_ps (vmax1, m, vmax1, _mm512_abs_ps (_mm512_maskz_loadu_ps (m, buf)));
+	}
+
+	current = _mm512_reduce_max_ps (_mm512_max_ps (vmax0, vmax1));
+
+	_mm256_zeroupper ();
+	return current;
+}
+
+void
+x86_avx512f_find_peaks (const float * buf, uint32_t nframes, float *min, float *max)
+{
+	__m512 vmin = _mm512_set1_ps (*min);
+	__m512 vmax = _mm512_set1_ps (*max);
+
+	while (nframes >= 32) {
+		const __m512 w0 = _mm512_loadu_ps (buf);
+		const __m512 w1 = _mm512_loadu_ps (buf + 16);
+		vmin = _mm512_min_ps (vmin, _mm512_min_ps (w0, w1));
+		vmax = _mm512_max_ps (vmax, _mm512_max_ps (w0, w1));
+		buf += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		const __m512 w = _mm512_loadu_ps (buf);
+		vmin = _mm512_min_ps (vmin, w);
+		vmax = _mm512_max_ps (vmax, w);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512 w = _mm512_maskz_loadu_ps (m, buf);
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, w);
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, w);
+	}
+
+	*min = _mm512_reduce_min_ps (vmin);
+	*max = _mm512_reduce_max_ps (vmax);
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_apply_gain_to_buffer (float * buf, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		_mm512_storeu_ps (buf,      _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		_mm512_storeu_ps (buf + 16, _mm512_mul_ps (_mm512_loadu_ps (buf + 16), g));
+		buf += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		_mm512_storeu_ps (dst,      _mm512_fmadd_ps (_mm512_loadu_ps (src), g, _mm512_loadu_ps (dst)));
+		_mm512_storeu_ps (dst + 16, _mm512_fmadd_ps (_mm512_loadu_ps (src + 16), g, _mm512_loadu_ps (dst + 16)));
+		dst += 32;
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_fmadd_ps (_mm512_loadu_ps (src), g, _mm512_loadu_ps (dst)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, src), g, _mm512_maskz_loadu_ps (m, dst)));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_mix_buffers_no_gain (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 32) {
+		_mm512_storeu_ps (dst,      _mm512_add_ps (_mm512_loadu_ps (dst), _mm512_loadu_ps (src)));
+		_mm512_storeu_ps (dst + 16, _mm512_add_ps (_mm512_loadu_ps (dst + 16), _mm512_loadu_ps (src + 16)));
+		dst += 32;
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_add_ps (_mm512_loadu_ps (dst), _mm512_loadu_ps (src)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_maskz_loadu_ps (m, src)));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_copy_vector (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 32) {
+		_mm512_storeu_ps (dst,      _mm512_loadu_ps (src));
+		_mm512_storeu_ps (dst + 16, _mm512_loadu_ps (src + 16));
+		dst += 32;
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_loadu_ps (src));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_mix_buffers_with_gain_ramp (float * dst, const float * src, uint32_t nframes, float gain, float gain_delta)
+{
+	/* gain of sample i is gain + i * gain_delta, i is exact as float
+	 * for all realistic buffer sizes (< 2^24).
+	 */
+	const __m512 g0    = _mm512_set1_ps (gain);
+	const __m512 delta = _mm512_set1_ps (gain_delta);
+	const __m512 step  = _mm512_set1_ps (16.f);
+	const __m512 step2 = _mm512_set1_ps (32.f);
+	__m512 idx = _mm512_setr_ps (0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f);
+	__m512 idx1 = _mm512_add_ps (idx, step);
+
+	while (nframes >= 32) {
+		const __m512 ga = _mm512_add_ps (g0, _mm512_mul_ps (idx, delta));
+		const __m512 gb = _mm512_add_ps (g0, _mm512_mul_ps (idx1, delta));
+		_mm512_storeu_ps (dst,      _mm512_fmadd_ps (_mm512_loadu_ps (src), ga, _mm512_loadu_ps (dst)));
+		_mm512_storeu_ps (dst + 16, _mm512_fmadd_ps (_mm512_loadu_ps (src + 16), gb, _mm512_loadu_ps (dst + 16)));
+		idx  = _mm512_add_ps (idx, step2);
+		idx1 = _mm512_add_ps (idx1, step2);
+		dst += 32;
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		const __m512 g = _mm512_add_ps (g0, _mm512_mul_ps (idx, delta));
+		_mm512_storeu_ps (dst, _mm512_fmadd_ps (_mm512_loadu_ps (src), g, _mm512_loadu_ps (dst)));
+		idx = _mm512_add_ps (idx, step);
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512 g = _mm512_add_ps (g0, _mm512_mul_ps (idx, delta));
+		_mm512_mask_storeu_ps (dst, m, _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, src), g, _mm512_maskz_loadu_ps (m, dst)));
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_avx512f_apply_gain_find_peaks (float * buf, uint32_t nframes, float gain, float *min, float *max)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+	__m512 vmin = _mm512_set1_ps (*min);
+	__m512 vmax = _mm512_set1_ps (*max);
+	__m512 vmin1 = vmin;
+	__m512 vmax1 = vmax;
+
+	while (nframes >= 32) {
+		const __m512 w0 = _mm512_mul_ps (_mm512_loadu_ps (buf), g);
+		const __m512 w1 = _mm512_mul_ps (_mm512_loadu_ps (buf + 16), g);
+		_mm512_storeu_ps (buf, w0);
+		_mm512_storeu_ps (buf + 16, w1);
+		vmin  = _mm512_min_ps (vmin, w0);
+		vmax  = _mm512_max_ps (vmax, w0);
+		vmin1 = _mm512_min_ps (vmin1, w1);
+		vmax1 = _mm512_max_ps (vmax1, w1);
+		buf += 32;
+		nframes -= 32;
+	}
+
+	vmin = _mm512_min_ps (vmin, vmin1);
+	vmax = _mm512_max_ps (vmax, vmax1);
+
+	if (nframes >= 16) {
+		const __m512 w = _mm512_mul_ps (_mm512_loadu_ps (buf), g);
+		_mm512_storeu_ps (buf, w);
+		vmin = _mm512_min_ps (vmin, w);
+		vmax = _mm512_max_ps (vmax, w);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512 w = _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g);
+		_mm512_mask_storeu_ps (buf, m, w);
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, w);
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, w);
+	}
+
+	*min = _mm512_reduce_min_ps (vmin);
+	*max = _mm512_reduce_max_ps (vmax);
+
+	_mm256_zeroupper ();
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* AVX + FMA versions of the runtime DSP functions.
+ *
+ * This file is compiled with -mavx -mfma, the functions must only be
+ * called if the CPU supports both (see setup_hardware_optimization()).
+ *
+ * Buffers need not be aligned: on CPUs that have FMA, unaligned
+ * loads/stores of aligned data are as fast as aligned ones.
+ */
+
+#include <immintrin.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ardour/mix.h"
+
+static inline float
+hmax (__m256 v)
+{
+	__m128 m = _mm_max_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	m = _mm_max_ps (m, _mm_movehl_ps (m, m));
+	m = _mm_max_ss (m, _mm_shuffle_ps (m, m, 1));
+	return _mm_cvtss_f32 (m);
+}
+
+static inline float
+hmin (__m256 v)
+{
+	__m128 m = _mm_min_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	m = _mm_min_ps (m, _mm_movehl_ps (m, m));
+	m = _mm_min_ss (m, _mm_shuffle_ps (m, m, 1));
+	return _mm_cvtss_f32 (m);
+}
+
+float
+x86_fma_compute_peak (const float * buf, uint32_t nframes, float current)
+{
+	const __m256 abs_mask = _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff));
+	__m256 vmax0 = _mm256_set1_ps (current);
+	__m256 vmax1 = vmax0;
+
+	/* two accumulators to hide the latency of vmaxps */
+	while (nframes >= 16) {
+		vmax0 = _mm256_max_ps (vmax0, _mm256_and_ps (_mm256_loadu_ps (buf), abs_mask));
+		vmax1 = _mm256_max_ps (vmax1, _mm256_and_ps (_mm256_loadu_ps (buf + 8), abs_mask));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		vmax0 = _mm256_max_ps (vmax0, _mm256_and_ps (_mm256_loadu_ps (buf), abs_mask));
+		buf += 8;
+		nframes -= 8;
+	}
+
+	current = hmax (_mm256_max_ps (vmax0, vmax1));
+
+	while (nframes > 0) {
+		const float a = fabsf (*buf);
+		current = a > current ? a : current;
+		++buf;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+	return current;
+}
+
+void
+x86_fma_find_peaks (const float * buf, uint32_t nframes, float *min, float *max)
+{
+	__m256 vmin = _mm256_set1_ps (*min);
+	__m256 vmax = _mm256_set1_ps (*max);
+
+	while (nframes >= 16) {
+		const __m256 w0 = _mm256_loadu_ps (buf);
+		const __m256 w1 = _mm256_loadu_ps (buf + 8);
+		vmin = _mm256_min_ps (vmin, _mm256_min_ps (w0, w1));
+		vmax = _mm256_max_ps (vmax, _mm256_max_ps (w0, w1));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		const __m256 w = _mm256_loadu_ps (buf);
+		vmin = _mm256_min_ps (vmin, w);
+		vmax = _mm256_max_ps (vmax, w);
+		buf += 8;
+		nframes -= 8;
+	}
+
+	float a = hmax (vmax);
+	float b = hmin (vmin);
+
+	while (nframes > 0) {
+		a = *buf > a ? *buf : a;
+		b = *buf < b ? *buf : b;
+		++buf;
+		--nframes;
+	}
+
+	*max = a;
+	*min = b;
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_apply_gain_to_buffer (float * buf, uint32_t nframes, float gain)
+{
+	const __m256 g = _mm256_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm256_storeu_ps (buf,     _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+		_mm256_storeu_ps (buf + 8, _mm256_mul_ps (_mm256_loadu_ps (buf + 8), g));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+		buf += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*buf++ *= gain;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
+{
+	const __m256 g = _mm256_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm256_storeu_ps (dst,     _mm256_fmadd_ps (_mm256_loadu_ps (src), g, _mm256_loadu_ps (dst)));
+		_mm256_storeu_ps (dst + 8, _mm256_fmadd_ps (_mm256_loadu_ps (src + 8), g, _mm256_loadu_ps (dst + 8)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_fmadd_ps (_mm256_loadu_ps (src), g, _mm256_loadu_ps (dst)));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++ * gain;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_mix_buffers_no_gain (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm256_storeu_ps (dst,     _mm256_add_ps (_mm256_loadu_ps (dst), _mm256_loadu_ps (src)));
+		_mm256_storeu_ps (dst + 8, _mm256_add_ps (_mm256_loadu_ps (dst + 8), _mm256_loadu_ps (src + 8)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_add_ps (_mm256_loadu_ps (dst), _mm256_loadu_ps (src)));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+void
+x86_fma_copy_vector (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm256_storeu_ps (dst,     _mm256_loadu_ps (src));
+		_mm256_storeu_ps (dst + 8, _mm256_loadu_ps (src + 8));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	_mm256_zeroupper ();
+
+	if (nframes > 0) {
+		memcpy (dst, src, nframes * sizeof (float));
+	}
+}
+
+void
+x86_fma_mix_buffers_with_gain_ramp (float * dst, const float * src, uint32_t nframes, float gain, float gain_delta)
+{
+	/* gain of sample i is gain + i * gain_delta, i is exact as float
+	 * for all realistic buffer sizes (< 2^24).
+	 */
+	const __m256 g0    = _mm256_set1_ps (gain);
+	const __m256 delta = _mm256_set1_ps (gain_delta);
+	const __m256 step  = _mm256_set1_ps (16.f);
+	__m256 idx0 = _mm256_setr_ps (0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+	__m256 idx1 = _mm256_setr_ps (8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f);
+	uint32_t i = 0;
+
+	for (; i + 16 <= nframes; i += 16) {
+		const __m256 ga = _mm256_add_ps (g0, _mm256_mul_ps (idx0, delta));
+		const __m256 gb = _mm256_add_ps (g0, _mm256_mul_ps (idx1, delta));
+		_mm256_storeu_ps (dst + i,     _mm256_fmadd_ps (_mm256_loadu_ps (src + i), ga, _mm256_loadu_ps (dst + i)));
+		_mm256_storeu_ps (dst + i + 8, _mm256_fmadd_ps (_mm256_loadu_ps (src + i + 8), gb, _mm256_loadu_ps (dst + i + 8)));
+		idx0 = _mm256_add_ps (idx0, step);
+		idx1 = _mm256_add_ps (idx1, step);
+	}
+
+	if (i + 8 <= nframes) {
+		const __m256 g = _mm256_add_ps (g0, _mm256_mul_ps (idx0, delta));
+		_mm256_storeu_ps (dst + i, _mm256_fmadd_ps (_mm256_loadu_ps (src + i), g, _mm256_loadu_ps (dst + i)));
+		i += 8;
+	}
+
+	_mm256_zeroupper ();
+
+	for (; i < nframes; ++i) {
+		dst[i] += src[i] * (gain + (float) i * gain_delta);
+	}
+}
+
+void
+x86_fma_apply_gain_find_peaks (float * buf, uint32_t nframes, float gain, float *min, float *max)
+{
+	const __m256 g = _mm256_set1_ps (gain);
+	__m256 vmin0 = _mm256_set1_ps (*min);
+	__m256 vmax0 = _mm256_set1_ps (*max);
+	__m256 vmin1 = vmin0;
+	__m256 vmax1 = vmax0;
+
+	while (nframes >= 16) {
+		const __m256 w0 = _mm256_mul_ps (_mm256_loadu_ps (buf), g);
+		const __m256 w1 = _mm256_mul_ps (_mm256_loadu_ps (buf + 8), g);
+		_mm256_storeu_ps (buf, w0);
+		_mm256_storeu_ps (buf + 8, w1);
+		vmin0 = _mm256_min_ps (vmin0, w0);
+		vmax0 = _mm256_max_ps (vmax0, w0);
+		vmin1 = _mm256_min_ps (vmin1, w1);
+		vmax1 = _mm256_max_ps (vmax1, w1);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		const __m256 w = _mm256_mul_ps (_mm256_loadu_ps (buf), g);
+		_mm256_storeu_ps (buf, w);
+		vmin0 = _mm256_min_ps (vmin0, w);
+		vmax0 = _mm256_max_ps (vmax0, w);
+		buf += 8;
+		nframes -= 8;
+	}
+
+	float a = hmax (_mm256_max_ps (vmax0, vmax1));
+	float b = hmin (_mm256_min_ps (vmin0, vmin1));
+
+	while (nframes > 0) {
+		*buf *= gain;
+		a = *buf > a ? *buf : a;
+		b = *buf < b ? *buf : b;
+		++buf;
+		--nframes;
+	}
+
+	*max = a;
+	*min = b;
+
+	_mm256_zeroupper ();
+}
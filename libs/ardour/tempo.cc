@@ -715,7 +715,376 @@ struct MetricSectionFrameSorter {
     }
 };
 
+/** Convert a meter-based beat to BBT, within the meter section @param m */
+static BBT_Time
+bbt_at_beat_in_meter (const MeterSection& m, double beat)
+{
+	const double beats_in_ms = beat - m.beat();
+	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / m.divisions_per_bar());
+	const uint32_t total_bars = bars_in_ms + (m.bbt().bars - 1);
+	const double remaining_beats = beats_in_ms - (bars_in_ms * m.divisions_per_bar());
+	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
+
+	BBT_Time ret;
+
+	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
+	ret.beats = (uint32_t) floor (remaining_beats);
+	ret.bars = total_bars;
+
+	/* 0 0 0 to 1 1 0 - based mapping*/
+	++ret.bars;
+	++ret.beats;
+
+	if (ret.ticks >= BBT_Time::ticks_per_beat) {
+		++ret.beats;
+		ret.ticks -= BBT_Time::ticks_per_beat;
+	}
+
+	if (ret.beats >= m.divisions_per_bar() + 1) {
+		++ret.bars;
+		ret.beats = 1;
+	}
+
+	return ret;
+}
+
+namespace ARDOUR {
+
+/** An immutable copy of the active tempo sections and the meter sections
+ *  of a TempoMap, with their positions in sorted arrays.
+ *
+ *  The TempoMap publishes a new snapshot (RCU) whenever its metrics change,
+ *  so that readers do not need to take the map's lock. Lookups are binary
+ *  searches which stop at the same section as the linear scans of the
+ *  *_locked() methods, and then use the same section math; the results are
+ *  identical.
+ *
+ *  A map that is not solved may have sections out of order, in that case
+ *  the snapshot is not valid() and readers use the locked methods.
+ */
+class TempoMapSnapshot
+{
+  public:
+	TempoMapSnapshot () : _valid (false) {}
+
+	void rebuild (const Metrics&);
+
+	bool valid () const { return _valid; }
+
+	double pulse_at_minute (const double& minute) const;
+	double minute_at_pulse (const double& pulse) const;
+
+	double beat_at_minute (const double& minute) const;
+	double minute_at_beat (const double& beat) const;
+
+	double pulse_at_beat (const double& beat) const;
+	double beat_at_pulse (const double& pulse) const;
+
+	Tempo tempo_at_minute (const double& minute) const;
+	Tempo tempo_at_pulse (const double& pulse) const;
+
+	BBT_Time bbt_at_minute (const double& minute) const;
+
+	double quarter_notes_between_samples (const samplecnt_t start, const samplecnt_t end) const;
+	double samples_per_quarter_note_at (const samplepos_t sample, const double& minute, const samplecnt_t sr) const;
+
+  private:
+	/* predicate of minute_at_beat(): does tempo @param i start after beat? */
+	struct TempoAfterBeat {
+		TempoAfterBeat (const TempoMapSnapshot& s, const MeterSection& m, const double& b) : snapshot (s), meter (m), beat (b) {}
+		bool operator() (size_t i) const {
+			return ((snapshot._tempo_pulse[i] - meter.pulse()) * meter.note_divisor()) + meter.beat() > beat;
+		}
+		const TempoMapSnapshot& snapshot;
+		const MeterSection& meter;
+		const double& beat;
+	};
+
+	template<typename T>
+	struct KeyAfter {
+		KeyAfter (const std::vector<T>& k, const T& v) : keys (k), value (v) {}
+		bool operator() (size_t i) const { return keys[i] > value; }
+		const std::vector<T>& keys;
+		const T& value;
+	};
+
+	/** @return the index that a scan over @param n sections stops at: the
+	 * section before the first one (never the very first) for which
+	 * @param after is true, or the last section.
+	 */
+	template<typename Pred>
+	static size_t scan (size_t n, const Pred& after) {
+		size_t lo = 1;
+		size_t hi = n;
+		while (lo < hi) {
+			const size_t mid = lo + (hi - lo) / 2;
+			if (after (mid)) {
+				hi = mid;
+			} else {
+				lo = mid + 1;
+			}
+		}
+		return lo - 1;
+	}
+
+	template<typename T>
+	static size_t scan_keys (const std::vector<T>& keys, const T& value) {
+		return scan (keys.size (), KeyAfter<T> (keys, value));
+	}
+
+	template<typename T>
+	static bool sorted (const std::vector<T>& keys) {
+		for (size_t i = 1; i < keys.size (); ++i) {
+			if (keys[i] < keys[i - 1]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const MeterSection& meter_at_minute (const double& minute, const MeterSection** next) const;
+
+	bool _valid;
+
+	std::vector<boost::shared_ptr<const TempoSection> > _tempos;
+	std::vector<double>                                  _tempo_minute;
+	std::vector<double>                                  _tempo_pulse;
+	std::vector<samplepos_t>                             _tempo_sample;
+
+	std::vector<boost::shared_ptr<const MeterSection> > _meters;
+	std::vector<double>                                  _meter_minute;
+	std::vector<double>                                  _meter_beat;
+	std::vector<double>                                  _meter_pulse;
+};
+
+} /* namespace ARDOUR */
+
+void
+TempoMapSnapshot::rebuild (const Metrics& metrics)
+{
+	_tempos.clear ();
+	_tempo_minute.clear ();
+	_tempo_pulse.clear ();
+	_tempo_sample.clear ();
+	_meters.clear ();
+	_meter_minute.clear ();
+	_meter_beat.clear ();
+	_meter_pulse.clear ();
+
+	bool divisors_ok = true;
+
+	for (Metrics::const_iterator i = metrics.begin(); i != metrics.end(); ++i) {
+		if ((*i)->is_tempo()) {
+			const TempoSection* t = static_cast<const TempoSection*> (*i);
+			if (!t->active()) {
+				continue;
+			}
+			_tempos.push_back (boost::shared_ptr<const TempoSection> (new TempoSection (*t)));
+			_tempo_minute.push_back (t->minute());
+			_tempo_pulse.push_back (t->pulse());
+			_tempo_sample.push_back (t->sample());
+		} else {
+			const MeterSection* m = static_cast<const MeterSection*> (*i);
+			_meters.push_back (boost::shared_ptr<const MeterSection> (new MeterSection (*m)));
+			_meter_minute.push_back (m->minute());
+			_meter_beat.push_back (m->beat());
+			_meter_pulse.push_back (m->pulse());
+			divisors_ok = divisors_ok && m->note_divisor() > 0.0;
+		}
+	}
+
+	_valid = !_tempos.empty () && !_meters.empty () && divisors_ok
+		&& sorted (_tempo_minute) && sorted (_tempo_pulse) && sorted (_tempo_sample)
+		&& sorted (_meter_minute) && sorted (_meter_beat) && sorted (_meter_pulse);
+}
+
+/* see TempoMap::pulse_at_minute_locked() */
+double
+TempoMapSnapshot::pulse_at_minute (const double& minute) const
+{
+	const size_t i = scan_keys (_tempo_minute, minute);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size ()) {
+		const double ret = prev_t.pulse_at_minute (minute);
+		/* audio locked section in new meter*/
+		if (_tempos[i + 1]->pulse() < ret) {
+			return _tempos[i + 1]->pulse();
+		}
+		return ret;
+	}
+
+	/* treated as constant for this ts */
+	const double pulses_in_section = ((minute - prev_t.minute()) * prev_t.note_types_per_minute()) / prev_t.note_type();
+
+	return pulses_in_section + prev_t.pulse();
+}
+
+/* see TempoMap::minute_at_pulse_locked() */
+double
+TempoMapSnapshot::minute_at_pulse (const double& pulse) const
+{
+	const size_t i = scan_keys (_tempo_pulse, pulse);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size ()) {
+		return prev_t.minute_at_pulse (pulse);
+	}
+
+	/* must be treated as constant, irrespective of _type */
+	double const dtime = ((pulse - prev_t.pulse()) * prev_t.note_type()) / prev_t.note_types_per_minute();
+
+	return dtime + prev_t.minute();
+}
+
+const MeterSection&
+TempoMapSnapshot::meter_at_minute (const double& minute, const MeterSection** next) const
+{
+	const size_t i = scan_keys (_meter_minute, minute);
+	*next = (i + 1 < _meters.size ()) ? _meters[i + 1].get () : 0;
+	return *_meters[i];
+}
+
+/* see TempoMap::beat_at_minute_locked() */
+double
+TempoMapSnapshot::beat_at_minute (const double& minute) const
+{
+	const TempoSection& ts (*_tempos[scan_keys (_tempo_minute, minute)]);
+	const MeterSection* next_m;
+	const MeterSection& prev_m (meter_at_minute (minute, &next_m));
+
+	const double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* audio locked meters fake their beat */
+	if (next_m && next_m->beat() < beat) {
+		return next_m->beat();
+	}
+
+	return beat;
+}
+
+/* see TempoMap::minute_at_beat_locked() */
+double
+TempoMapSnapshot::minute_at_beat (const double& beat) const
+{
+	const MeterSection& prev_m (*_meters[scan_keys (_meter_beat, beat)]);
+	const TempoSection& prev_t (*_tempos[scan (_tempos.size (), TempoAfterBeat (*this, prev_m, beat))]);
+
+	return prev_t.minute_at_pulse (((beat - prev_m.beat()) / prev_m.note_divisor()) + prev_m.pulse());
+}
+
+/* see TempoMap::pulse_at_beat_locked() */
+double
+TempoMapSnapshot::pulse_at_beat (const double& beat) const
+{
+	const MeterSection& prev_m (*_meters[scan_keys (_meter_beat, beat)]);
+
+	return prev_m.pulse() + ((beat - prev_m.beat()) / prev_m.note_divisor());
+}
+
+/* see TempoMap::beat_at_pulse_locked() */
+double
+TempoMapSnapshot::beat_at_pulse (const double& pulse) const
+{
+	const MeterSection& prev_m (*_meters[scan_keys (_meter_pulse, pulse)]);
+
+	return ((pulse - prev_m.pulse()) * prev_m.note_divisor()) + prev_m.beat();
+}
+
+/* see TempoMap::tempo_at_minute_locked() */
+Tempo
+TempoMapSnapshot::tempo_at_minute (const double& minute) const
+{
+	const size_t i = scan_keys (_tempo_minute, minute);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size ()) {
+		return prev_t.tempo_at_minute (minute);
+	}
+
+	return Tempo (prev_t.note_types_per_minute(), prev_t.note_type(), prev_t.end_note_types_per_minute());
+}
+
+/* see TempoMap::tempo_at_pulse_locked() */
+Tempo
+TempoMapSnapshot::tempo_at_pulse (const double& pulse) const
+{
+	const size_t i = scan_keys (_tempo_pulse, pulse);
+	const TempoSection& prev_t (*_tempos[i]);
+
+	if (i + 1 < _tempos.size ()) {
+		return prev_t.tempo_at_pulse (pulse);
+	}
+
+	return Tempo (prev_t.note_types_per_minute(), prev_t.note_type(), prev_t.end_note_types_per_minute());
+}
+
+/* see TempoMap::bbt_at_minute_locked() */
+BBT_Time
+TempoMapSnapshot::bbt_at_minute (const double& minute) const
+{
+	if (minute < 0) {
+		BBT_Time bbt;
+		bbt.bars = 1;
+		bbt.beats = 1;
+		bbt.ticks = 0;
+		return bbt;
+	}
+
+	const TempoSection& ts (*_tempos[scan_keys (_tempo_minute, minute)]);
+	const MeterSection* next_m;
+	const MeterSection& prev_m (meter_at_minute (minute, &next_m));
+
+	double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* handle sample before first meter */
+	if (minute < prev_m.minute()) {
+		beat = 0.0;
+	}
+	/* audio locked meters fake their beat */
+	if (next_m && next_m->beat() < beat) {
+		beat = next_m->beat();
+	}
+
+	beat = max (0.0, beat);
+
+	return bbt_at_beat_in_meter (prev_m, beat);
+}
+
+/* see TempoMap::quarter_notes_between_samples_locked() */
+double
+TempoMapSnapshot::quarter_notes_between_samples (const samplecnt_t start, const samplecnt_t end) const
+{
+	const size_t s = scan_keys (_tempo_sample, start);
+	const double start_qn = _tempos[s]->pulse_at_sample (start);
+
+	/* the scan for the end continues from the start section */
+	size_t e = s;
+	if (!(_tempo_sample[0] > end)) {
+		e = scan_keys (_tempo_sample, end);
+	}
+	const double end_qn = _tempos[e]->pulse_at_sample (end);
+
+	return (end_qn - start_qn) * 4.0;
+}
+
+/* see TempoMap::samples_per_quarter_note_at() */
+double
+TempoMapSnapshot::samples_per_quarter_note_at (const samplepos_t sample, const double& minute, const samplecnt_t sr) const
+{
+	const size_t i = scan_keys (_tempo_sample, sample);
+	const TempoSection& ts_at (*_tempos[i]);
+
+	if (i + 1 < _tempos.size ()) {
+		return  (60.0 * sr) / ts_at.tempo_at_minute (minute).quarter_notes_per_minute();
+	}
+	/* must be treated as constant tempo */
+	return ts_at.samples_per_quarter_note (sr);
+}
+
 TempoMap::TempoMap (samplecnt_t fr)
+	: _snapshot (new TempoMapSnapshot)
+	, _generation (0)
 {
 	_sample_rate = fr;
 	BBT_Time start (1, 1, 0);
@@ -733,6 +1102,7 @@ TempoMap::TempoMap (samplecnt_t fr)
 	_metrics.push_back (t);
 	_metrics.push_back (m);
 
+	update_snapshot ();
 }
 
 TempoMap&
@@ -740,7 +1110,7 @@ TempoMap::operator= (TempoMap const & other)
 {
 	if (&other != this) {
 		Glib::Threads::RWLock::ReaderLock lr (other.lock);
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		_sample_rate = other._sample_rate;
 
 		Metrics::const_iterator d = _metrics.begin();
@@ -791,13 +1161,24 @@ TempoMap::minute_at_sample (const samplepos_t sample) const
 	return (sample / (double) _sample_rate) / 60.0;
 }
 
+/* HOLD THE WRITER LOCK */
+void
+TempoMap::update_snapshot ()
+{
+	/* the snapshot is rebuilt from scratch, no need to copy the old one */
+	boost::shared_ptr<TempoMapSnapshot> snapshot = _snapshot.write_new ();
+	snapshot->rebuild (_metrics);
+	_snapshot.update (snapshot);
+	g_atomic_int_inc (&_generation);
+}
+
 void
 TempoMap::remove_tempo (const TempoSection& tempo, bool complete_operation)
 {
 	bool removed = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		if ((removed = remove_tempo_locked (tempo))) {
 			if (complete_operation) {
 				recompute_map (_metrics);
@@ -836,7 +1217,7 @@ TempoMap::remove_meter (const MeterSection& tempo, bool complete_operation)
 	bool removed = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		if ((removed = remove_meter_locked (tempo))) {
 			if (complete_operation) {
 				recompute_map (_metrics);
@@ -1029,7 +1410,7 @@ TempoMap::add_tempo (const Tempo& tempo, const double& pulse, const samplepos_t
 
 	TempoSection* ts = 0;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		/* here we default to not clamped for a new tempo section. preference? */
 		ts = add_tempo_locked (tempo, pulse, minute_at_sample (sample), pls, true, false, false);
 
@@ -1054,7 +1435,7 @@ TempoMap::replace_tempo (TempoSection& ts, const Tempo& tempo, const double& pul
 	TempoSection* new_ts = 0;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		TempoSection& first (first_tempo());
 		if (!ts.initial()) {
 			if (locked_to_meter) {
@@ -1131,7 +1512,7 @@ TempoMap::add_meter (const Meter& meter, const Timecode::BBT_Time& where, sample
 {
 	MeterSection* m = 0;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		m = add_meter_locked (meter, where, sample, pls, true);
 	}
 
@@ -1150,7 +1531,7 @@ void
 TempoMap::replace_meter (const MeterSection& ms, const Meter& meter, const BBT_Time& where, samplepos_t sample, PositionLockStyle pls)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 
 		if (!ms.initial()) {
 			remove_meter_locked (ms);
@@ -1245,7 +1626,7 @@ TempoMap::change_initial_tempo (double note_types_per_minute, double note_type,
 				continue;
 			}
 			{
-				Glib::Threads::RWLock::WriterLock lm (lock);
+				MetricsWriterLock lm (*this);
 				*((Tempo*) t) = newtempo;
 				recompute_map (_metrics);
 			}
@@ -1298,7 +1679,7 @@ TempoMap::change_existing_tempo_at (samplepos_t where, double note_types_per_min
 	/* reset */
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		/* cannot move the first tempo section */
 		*((Tempo*)prev) = newtempo;
 		recompute_map (_metrics);
@@ -1522,6 +1903,10 @@ TempoMap::recompute_map (Metrics& metrics, samplepos_t end)
 
 	recompute_tempi (metrics);
 	recompute_meters (metrics);
+
+	if (&metrics == &_metrics) {
+		update_snapshot ();
+	}
 }
 
 TempoMetric
@@ -1600,6 +1985,12 @@ TempoMap::metric_at (BBT_Time bbt) const
 double
 TempoMap::beat_at_sample (const samplecnt_t sample) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->beat_at_minute (minute_at_sample (sample));
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return beat_at_minute_locked (_metrics, minute_at_sample (sample));
@@ -1642,6 +2033,12 @@ TempoMap::beat_at_minute_locked (const Metrics& metrics, const double& minute) c
 samplepos_t
 TempoMap::sample_at_beat (const double& beat) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return sample_at_minute (snapshot->minute_at_beat (beat));
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return sample_at_minute (minute_at_beat_locked (_metrics, beat));
@@ -1697,6 +2094,12 @@ TempoMap::minute_at_beat_locked (const Metrics& metrics, const double& beat) con
 Tempo
 TempoMap::tempo_at_sample (const samplepos_t sample) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->tempo_at_minute (minute_at_sample (sample));
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return tempo_at_minute_locked (_metrics, minute_at_sample (sample));
@@ -1847,6 +2250,12 @@ TempoMap::pulse_at_tempo_locked (const Metrics& metrics, const Tempo& tempo) con
 Tempo
 TempoMap::tempo_at_quarter_note (const double& qn) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->tempo_at_pulse (qn / 4.0);
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return tempo_at_pulse_locked (_metrics, qn / 4.0);
@@ -2242,6 +2651,12 @@ TempoMap::bbt_at_sample (samplepos_t sample)
 
 	const double minute =  minute_at_sample (sample);
 
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->bbt_at_minute (minute);
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return bbt_at_minute_locked (_metrics, minute);
@@ -2252,6 +2667,12 @@ TempoMap::bbt_at_sample_rt (samplepos_t sample)
 {
 	const double minute =  minute_at_sample (sample);
 
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->bbt_at_minute (minute);
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
@@ -2302,33 +2723,7 @@ TempoMap::bbt_at_minute_locked (const Metrics& metrics, const double& minute) co
 
 	beat = max (0.0, beat);
 
-	const double beats_in_ms = beat - prev_m->beat();
-	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / prev_m->divisions_per_bar());
-	const uint32_t total_bars = bars_in_ms + (prev_m->bbt().bars - 1);
-	const double remaining_beats = beats_in_ms - (bars_in_ms * prev_m->divisions_per_bar());
-	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
-
-	BBT_Time ret;
-
-	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
-	ret.beats = (uint32_t) floor (remaining_beats);
-	ret.bars = total_bars;
-
-	/* 0 0 0 to 1 1 0 - based mapping*/
-	++ret.bars;
-	++ret.beats;
-
-	if (ret.ticks >= BBT_Time::ticks_per_beat) {
-		++ret.beats;
-		ret.ticks -= BBT_Time::ticks_per_beat;
-	}
-
-	if (ret.beats >= prev_m->divisions_per_bar() + 1) {
-		++ret.bars;
-		ret.beats = 1;
-	}
-
-	return ret;
+	return bbt_at_beat_in_meter (*prev_m, beat);
 }
 
 /** Returns the sample position corresponding to the supplied BBT time.
@@ -2381,6 +2776,12 @@ TempoMap::quarter_note_at_sample (const samplepos_t sample) const
 {
 	const double minute =  minute_at_sample (sample);
 
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->pulse_at_minute (minute) * 4.0;
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return pulse_at_minute_locked (_metrics, minute) * 4.0;
@@ -2391,6 +2792,12 @@ TempoMap::quarter_note_at_sample_rt (const samplepos_t sample) const
 {
 	const double minute =  minute_at_sample (sample);
 
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->pulse_at_minute (minute) * 4.0;
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
@@ -2411,6 +2818,12 @@ TempoMap::quarter_note_at_sample_rt (const samplepos_t sample) const
 samplepos_t
 TempoMap::sample_at_quarter_note (const double quarter_note) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return sample_at_minute (snapshot->minute_at_pulse (quarter_note / 4.0));
+	}
+
 	double minute;
 	{
 		Glib::Threads::RWLock::ReaderLock lm (lock);
@@ -2431,6 +2844,12 @@ TempoMap::sample_at_quarter_note (const double quarter_note) const
 double
 TempoMap::quarter_note_at_beat (const double beat) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->pulse_at_beat (beat) * 4.0;
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return pulse_at_beat_locked (_metrics, beat) * 4.0;
@@ -2446,6 +2865,12 @@ TempoMap::quarter_note_at_beat (const double beat) const
 double
 TempoMap::beat_at_quarter_note (const double quarter_note) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->beat_at_pulse (quarter_note / 4.0);
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return beat_at_pulse_locked (_metrics, quarter_note / 4.0);
@@ -2464,6 +2889,12 @@ TempoMap::beat_at_quarter_note (const double quarter_note) const
 samplecnt_t
 TempoMap::samples_between_quarter_notes (const double start, const double end) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return sample_at_minute (snapshot->minute_at_pulse (end / 4.0) - snapshot->minute_at_pulse (start / 4.0));
+	}
+
 	double minutes;
 
 	{
@@ -2484,6 +2915,12 @@ TempoMap::minutes_between_quarter_notes_locked (const Metrics& metrics, const do
 double
 TempoMap::quarter_notes_between_samples (const samplecnt_t start, const samplecnt_t end) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->quarter_notes_between_samples (start, end);
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return quarter_notes_between_samples_locked (_metrics, start, end);
@@ -3186,7 +3623,7 @@ TempoMap::gui_set_tempo_position (TempoSection* ts, const samplepos_t sample, co
 	if (ts->position_lock_style() == MusicTime) {
 		{
 			/* if we're snapping to a musical grid, set the pulse exactly instead of via the supplied sample. */
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriterLock lm (*this);
 			TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 			tempo_copy->set_position_lock_style (AudioTime);
@@ -3205,7 +3642,7 @@ TempoMap::gui_set_tempo_position (TempoSection* ts, const samplepos_t sample, co
 	} else {
 
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriterLock lm (*this);
 			TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 
@@ -3258,7 +3695,7 @@ TempoMap::gui_set_meter_position (MeterSection* ms, const samplepos_t sample)
 	if (ms->position_lock_style() == AudioTime) {
 
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriterLock lm (*this);
 			MeterSection* copy = copy_metrics_and_point (_metrics, future_map, ms);
 
 			if (solve_map_minute (future_map, copy, minute_at_sample (sample))) {
@@ -3268,7 +3705,7 @@ TempoMap::gui_set_meter_position (MeterSection* ms, const samplepos_t sample)
 		}
 	} else {
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			MetricsWriterLock lm (*this);
 			MeterSection* copy = copy_metrics_and_point (_metrics, future_map, ms);
 
 			const double beat = beat_at_minute_locked (_metrics, minute_at_sample (sample));
@@ -3296,7 +3733,7 @@ TempoMap::gui_change_tempo (TempoSection* ts, const Tempo& bpm)
 	Metrics future_map;
 	bool can_solve = false;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 		if (tempo_copy->type() == TempoSection::Constant) {
@@ -3363,7 +3800,7 @@ TempoMap::gui_stretch_tempo (TempoSection* ts, const samplepos_t sample, const s
 	Metrics future_map;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 
 		if (!ts) {
 			return;
@@ -3469,7 +3906,7 @@ TempoMap::gui_stretch_tempo_end (TempoSection* ts, const samplepos_t sample, con
 	Metrics future_map;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 
 		if (!ts) {
 			return;
@@ -3548,7 +3985,7 @@ TempoMap::gui_twist_tempi (TempoSection* ts, const Tempo& bpm, const samplepos_t
 	samplepos_t const min_dframe = 2;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		if (!ts) {
 			return false;
 		}
@@ -4342,6 +4779,12 @@ TempoMap::next_tempo_section_locked (const Metrics& metrics, TempoSection* ts) c
 double
 TempoMap::samples_per_quarter_note_at (const samplepos_t sample, const samplecnt_t sr) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return snapshot->samples_per_quarter_note_at (sample, minute_at_sample (sample), _sample_rate);
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	const TempoSection* ts_at = 0;
@@ -4565,7 +5008,7 @@ int
 TempoMap::set_state (const XMLNode& node, int /*version*/)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 
 		XMLNodeList nlist;
 		XMLNodeConstIterator niter;
@@ -4770,7 +5213,7 @@ TempoMap::remove_time (samplepos_t where, samplecnt_t amount)
 	bool tempo_after = false; // is there a tempo marker at the first sample after the removed range?
 	bool meter_after = false; // is there a meter marker likewise?
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		MetricsWriterLock lm (*this);
 		for (Metrics::iterator i = _metrics.begin(); i != _metrics.end(); ++i) {
 			if ((*i)->sample() >= where && (*i)->sample() < where+amount) {
 				metric_kill_list.push_back(*i);
@@ -4825,6 +5268,13 @@ TempoMap::remove_time (samplepos_t where, samplecnt_t amount)
 samplepos_t
 TempoMap::samplepos_plus_qn (samplepos_t sample, Temporal::Beats beats) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		const double sample_qn = snapshot->pulse_at_minute (minute_at_sample (sample)) * 4.0;
+		return sample_at_minute (snapshot->minute_at_pulse ((sample_qn + beats.to_double()) / 4.0));
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 	const double sample_qn = pulse_at_minute_locked (_metrics, minute_at_sample (sample)) * 4.0;
 
@@ -4861,6 +5311,12 @@ TempoMap::samplepos_plus_bbt (samplepos_t pos, BBT_Time op) const
 Temporal::Beats
 TempoMap::framewalk_to_qn (samplepos_t pos, samplecnt_t distance) const
 {
+	boost::shared_ptr<TempoMapSnapshot> snapshot (_snapshot.reader ());
+
+	if (snapshot->valid ()) {
+		return Temporal::Beats (snapshot->quarter_notes_between_samples (pos, pos + distance));
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
 	return Temporal::Beats (quarter_notes_between_samples_locked (_metrics, pos, pos + distance));
@@ -10,6 +10,7 @@
 
 #include "ardour/ardour.h"
 #include "ardour/audioengine.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 
 #include "test_ui.h"
@@ -35,11 +36,13 @@ pause_for_effect()
 
 int main (int argc, char* argv[])
 {
-	if (argc != 3) {
-		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name>\n";
+	if (argc != 3 && argc != 4) {
+		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name> [<number of repeated saves>]\n";
 		exit (EXIT_FAILURE);
 	}
 
+	const int repeated_saves = argc == 4 ? atoi (argv[3]) : 0;
+
 	std::cerr << "ARDOUR::init" << std::endl;
 
 	PBD::Timing ardour_init_timing;
@@ -96,6 +99,37 @@ int main (int argc, char* argv[])
 	std::cerr << "Saving session time : " << save_session_timing.elapsed()
 	          << " usecs" << std::endl;
 
+	if (repeated_saves > 0) {
+
+		/* nothing changed since the first save, so these measure saving
+		 * with all cacheable state re-used, and then without the cache.
+		 */
+
+		PBD::TimingData cached_timing;
+
+		for (int i = 0; i < repeated_saves; ++i) {
+			cached_timing.start_timing ();
+			s->save_state("");
+			cached_timing.add_elapsed ();
+		}
+
+		std::cerr << "Repeated save time : " << cached_timing.summary() << std::endl;
+
+		Config->set_cache_session_state (false);
+
+		PBD::TimingData uncached_timing;
+
+		for (int i = 0; i < repeated_saves; ++i) {
+			uncached_timing.start_timing ();
+			s->save_state("");
+			uncached_timing.add_elapsed ();
+		}
+
+		std::cerr << "Repeated save time without cache : " << uncached_timing.summary() << std::endl;
+
+		Config->set_cache_session_state (true);
+	}
+
 	std::cerr << "AudioEngine::remove_session" << std::endl;
 
 	AudioEngine::instance()->remove_session ();
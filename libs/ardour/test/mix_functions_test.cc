@@ -0,0 +1,224 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "pbd/fpu.h"
+
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+#include "mix_functions_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MixFunctionsTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+namespace {
+
+/** A set of optimized functions to compare with the default_* ones */
+struct KernelSet {
+	const char*                  name;
+	compute_peak_t               compute_peak;
+	find_peaks_t                 find_peaks;
+	apply_gain_to_buffer_t       apply_gain_to_buffer;
+	mix_buffers_with_gain_t      mix_buffers_with_gain;
+	mix_buffers_no_gain_t        mix_buffers_no_gain;
+	copy_vector_t                copy_vector;
+	mix_buffers_with_gain_ramp_t mix_buffers_with_gain_ramp;
+	apply_gain_find_peaks_t      apply_gain_find_peaks;
+};
+
+vector<KernelSet> kernel_sets;
+
+/* test unaligned buffers and all tail lengths of 8 and 16 sample vectors */
+const pframes_t max_offset = 4;
+const pframes_t lengths[] = { 0, 1, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 100, 1023, 1024, 8192 };
+const size_t    n_lengths = sizeof (lengths) / sizeof (lengths[0]);
+const pframes_t buffer_size = 8192 + max_offset;
+
+void
+fill_random (vector<Sample>& buf)
+{
+	for (size_t i = 0; i < buf.size (); ++i) {
+		buf[i] = 2.f * (rand () / (float) RAND_MAX) - 1.f;
+	}
+}
+
+/* the FMA versions round once where the default ones round twice */
+void
+check_close (vector<Sample> const& expected, vector<Sample> const& actual)
+{
+	CPPUNIT_ASSERT_EQUAL (expected.size (), actual.size ());
+	for (size_t i = 0; i < expected.size (); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (expected[i], actual[i], 1e-6 * (1.0 + fabs (expected[i])));
+	}
+}
+
+}
+
+void
+MixFunctionsTest::setUp ()
+{
+	kernel_sets.clear ();
+
+#if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS) && !defined (PLATFORM_WINDOWS)
+	PBD::FPU* fpu = PBD::FPU::instance ();
+
+	if (fpu->has_avx () && fpu->has_fma ()) {
+		KernelSet k = {
+			"AVX/FMA",
+			x86_fma_compute_peak,
+			x86_fma_find_peaks,
+			x86_fma_apply_gain_to_buffer,
+			x86_fma_mix_buffers_with_gain,
+			x86_fma_mix_buffers_no_gain,
+			x86_fma_copy_vector,
+			x86_fma_mix_buffers_with_gain_ramp,
+			x86_fma_apply_gain_find_peaks
+		};
+		kernel_sets.push_back (k);
+	}
+
+	if (fpu->has_avx512f ()) {
+		KernelSet k = {
+			"AVX-512",
+			x86_avx512f_compute_peak,
+			x86_avx512f_find_peaks,
+			x86_avx512f_apply_gain_to_buffer,
+			x86_avx512f_mix_buffers_with_gain,
+			x86_avx512f_mix_buffers_no_gain,
+			x86_avx512f_copy_vector,
+			x86_avx512f_mix_buffers_with_gain_ramp,
+			x86_avx512f_apply_gain_find_peaks
+		};
+		kernel_sets.push_back (k);
+	}
+#endif
+
+	if (kernel_sets.empty ()) {
+		cout << "MixFunctionsTest: no optimized functions for this CPU/build, nothing to compare\n";
+	}
+
+	srand (42);
+}
+
+void
+MixFunctionsTest::tearDown ()
+{
+	kernel_sets.clear ();
+}
+
+void
+MixFunctionsTest::kernelTest ()
+{
+	vector<Sample> src (buffer_size);
+	vector<Sample> dst (buffer_size);
+
+	for (vector<KernelSet>::const_iterator k = kernel_sets.begin (); k != kernel_sets.end (); ++k) {
+		for (size_t l = 0; l < n_lengths; ++l) {
+			for (pframes_t off = 0; off < max_offset; ++off) {
+				const pframes_t n = lengths[l];
+
+				fill_random (src);
+				fill_random (dst);
+
+				/* compute_peak */
+				CPPUNIT_ASSERT_EQUAL (default_compute_peak (&src[off], n, 0.f), k->compute_peak (&src[off], n, 0.f));
+				CPPUNIT_ASSERT_EQUAL (default_compute_peak (&src[off], n, 0.5f), k->compute_peak (&src[off], n, 0.5f));
+
+				/* find_peaks */
+				float emin = 0.1f, emax = -0.1f;
+				float amin = 0.1f, amax = -0.1f;
+				default_find_peaks (&src[off], n, &emin, &emax);
+				k->find_peaks (&src[off], n, &amin, &amax);
+				CPPUNIT_ASSERT_EQUAL (emin, amin);
+				CPPUNIT_ASSERT_EQUAL (emax, amax);
+
+				/* apply_gain_to_buffer, results are exact */
+				vector<Sample> expected (dst);
+				vector<Sample> actual (dst);
+				default_apply_gain_to_buffer (&expected[off], n, 0.7f);
+				k->apply_gain_to_buffer (&actual[off], n, 0.7f);
+				CPPUNIT_ASSERT (expected == actual);
+
+				/* mix_buffers_no_gain */
+				expected = dst;
+				actual = dst;
+				default_mix_buffers_no_gain (&expected[off], &src[off], n);
+				k->mix_buffers_no_gain (&actual[off], &src[off], n);
+				CPPUNIT_ASSERT (expected == actual);
+
+				/* copy_vector, also with different alignment of src and dst */
+				expected = dst;
+				actual = dst;
+				default_copy_vector (&expected[off], &src[0], n);
+				k->copy_vector (&actual[off], &src[0], n);
+				CPPUNIT_ASSERT (expected == actual);
+
+				/* mix_buffers_with_gain */
+				expected = dst;
+				actual = dst;
+				default_mix_buffers_with_gain (&expected[off], &src[0], n, 0.3f);
+				k->mix_buffers_with_gain (&actual[off], &src[0], n, 0.3f);
+				check_close (expected, actual);
+			}
+		}
+	}
+}
+
+void
+MixFunctionsTest::fusedTest ()
+{
+	vector<Sample> src (buffer_size);
+	vector<Sample> dst (buffer_size);
+
+	for (size_t l = 0; l < n_lengths; ++l) {
+		for (pframes_t off = 0; off < max_offset; ++off) {
+			const pframes_t n = lengths[l];
+
+			fill_random (src);
+			fill_random (dst);
+
+			/* the default fused functions are equivalent to the two passes they replace */
+			vector<Sample> expected (dst);
+			vector<Sample> actual (dst);
+			float emin = 0.f, emax = 0.f;
+			float amin = 0.f, amax = 0.f;
+			default_apply_gain_to_buffer (&expected[off], n, 0.25f);
+			default_find_peaks (&expected[off], n, &emin, &emax);
+			default_apply_gain_find_peaks (&actual[off], n, 0.25f, &amin, &amax);
+			CPPUNIT_ASSERT (expected == actual);
+			CPPUNIT_ASSERT_EQUAL (emin, amin);
+			CPPUNIT_ASSERT_EQUAL (emax, amax);
+
+			expected = dst;
+			actual = dst;
+			default_mix_buffers_with_gain (&expected[off], &src[off], n, 0.5f);
+			default_mix_buffers_with_gain_ramp (&actual[off], &src[off], n, 0.5f, 0.f);
+			CPPUNIT_ASSERT (expected == actual);
+
+			for (vector<KernelSet>::const_iterator k = kernel_sets.begin (); k != kernel_sets.end (); ++k) {
+
+				/* apply_gain_find_peaks */
+				expected = dst;
+				actual = dst;
+				emin = emax = amin = amax = 0.f;
+				default_apply_gain_find_peaks (&expected[off], n, 1.5f, &emin, &emax);
+				k->apply_gain_find_peaks (&actual[off], n, 1.5f, &amin, &amax);
+				CPPUNIT_ASSERT (expected == actual);
+				CPPUNIT_ASSERT_EQUAL (emin, amin);
+				CPPUNIT_ASSERT_EQUAL (emax, amax);
+
+				/* mix_buffers_with_gain_ramp, fade out over the buffer */
+				const float delta = n > 0 ? -1.f / n : 0.f;
+				expected = dst;
+				actual = dst;
+				default_mix_buffers_with_gain_ramp (&expected[off], &src[0], n, 1.f, delta);
+				k->mix_buffers_with_gain_ramp (&actual[off], &src[0], n, 1.f, delta);
+				check_close (expected, actual);
+			}
+		}
+	}
+}
@@ -0,0 +1,17 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class MixFunctionsTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (MixFunctionsTest);
+	CPPUNIT_TEST (kernelTest);
+	CPPUNIT_TEST (fusedTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void kernelTest ();
+	void fusedTest ();
+};
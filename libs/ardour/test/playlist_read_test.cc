@@ -213,6 +213,58 @@ PlaylistReadTest::miscReadTest ()
 	_audio_playlist->read (_buf, _mbuf, _gbuf, 53, 54, 0);
 }
 
+/* Reads use a plan of the whole playlist which is kept between reads;
+ * check that it follows changes to the regions.
+ */
+void
+PlaylistReadTest::changedReadTest ()
+{
+	_audio_playlist->add_region (_ar[0], 0);
+	_ar[0]->set_default_fade_in ();
+	_ar[0]->set_default_fade_out ();
+	_ar[0]->set_length (256);
+
+	/* Middle of the region, away from the fades */
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 100, 50, 0);
+	check_staircase (_buf, 100, 50);
+
+	_ar[0]->set_muted (true);
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 100, 50, 0);
+	for (int i = 0; i < 50; ++i) {
+		CPPUNIT_ASSERT_EQUAL (float (0), _buf[i]);
+	}
+
+	_ar[0]->set_muted (false);
+	_ar[0]->set_position (512);
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 100, 50, 0);
+	for (int i = 0; i < 50; ++i) {
+		CPPUNIT_ASSERT_EQUAL (float (0), _buf[i]);
+	}
+
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 612, 50, 0);
+	check_staircase (_buf, 100, 50);
+
+	/* An opaque region on top hides _ar[0] */
+	_audio_playlist->add_region (_ar[1], 500);
+	_ar[1]->set_default_fade_in ();
+	_ar[1]->set_default_fade_out ();
+	_ar[1]->set_length (256);
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 612, 50, 0);
+	check_staircase (_buf, 112, 50);
+
+	_ar[1]->set_position (1024);
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 612, 50, 0);
+	check_staircase (_buf, 100, 50);
+
+	_ar[1]->set_position (500);
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 612, 50, 0);
+	check_staircase (_buf, 112, 50);
+
+	_audio_playlist->remove_region (_ar[1]);
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 612, 50, 0);
+	check_staircase (_buf, 100, 50);
+}
+
 void
 PlaylistReadTest::check_staircase (Sample* b, int offset, int N)
 {
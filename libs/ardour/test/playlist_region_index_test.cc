@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/playlist.h"
+#include "ardour/region.h"
+#include "playlist_region_index_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistRegionIndexTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+void
+PlaylistRegionIndexTest::queryTest ()
+{
+	/* regions are 100 samples long:
+	 * _r[0] 0 - 99, _r[1] 50 - 149, _r[2] 300 - 399
+	 */
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 50);
+	_playlist->add_region (_r[2], 300);
+
+	boost::shared_ptr<RegionList> rl = _playlist->regions_touched (0, 10);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), rl->size ());
+	CPPUNIT_ASSERT (rl->front () == _r[0]);
+
+	rl = _playlist->regions_touched (60, 99);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), rl->size ());
+	CPPUNIT_ASSERT (rl->front () == _r[0]);
+	CPPUNIT_ASSERT (rl->back () == _r[1]);
+
+	rl = _playlist->regions_touched (150, 299);
+	CPPUNIT_ASSERT (rl->empty ());
+
+	rl = _playlist->regions_touched (149, 300);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), rl->size ());
+	CPPUNIT_ASSERT (rl->front () == _r[1]);
+	CPPUNIT_ASSERT (rl->back () == _r[2]);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (2), _playlist->count_regions_at (75));
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), _playlist->count_regions_at (200));
+	CPPUNIT_ASSERT (_playlist->top_region_at (75) == _r[1]);
+	CPPUNIT_ASSERT (_playlist->top_region_at (25) == _r[0]);
+	CPPUNIT_ASSERT (!_playlist->top_region_at (200));
+
+	rl = _playlist->regions_with_start_within (Evoral::Range<samplepos_t> (40, 300));
+	CPPUNIT_ASSERT_EQUAL (size_t (2), rl->size ());
+	CPPUNIT_ASSERT (rl->front () == _r[1]);
+	CPPUNIT_ASSERT (rl->back () == _r[2]);
+
+	rl = _playlist->regions_with_end_within (Evoral::Range<samplepos_t> (140, 150));
+	CPPUNIT_ASSERT_EQUAL (size_t (1), rl->size ());
+	CPPUNIT_ASSERT (rl->front () == _r[1]);
+}
+
+void
+PlaylistRegionIndexTest::changeTest ()
+{
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 50);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (2), _playlist->count_regions_at (75));
+
+	/* moving a region must be reflected in the next query */
+	_r[0]->set_position (1000);
+
+	CPPUNIT_ASSERT (_playlist->regions_touched (0, 10)->empty ());
+	CPPUNIT_ASSERT_EQUAL (size_t (1), _playlist->regions_at (1050)->size ());
+	CPPUNIT_ASSERT (_playlist->top_region_at (1050) == _r[0]);
+
+	/* .. as must removing one */
+	_playlist->remove_region (_r[1]);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), _playlist->count_regions_at (75));
+
+	/* and muting */
+	_r[0]->set_muted (true);
+
+	CPPUNIT_ASSERT (_playlist->top_region_at (1050) == _r[0]);
+	CPPUNIT_ASSERT (!_playlist->top_unmuted_region_at (1050));
+}
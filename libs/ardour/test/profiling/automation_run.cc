@@ -0,0 +1,102 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+#include <glib.h>
+
+#include "pbd/compose.h"
+
+#include "evoral/Curve.hpp"
+
+#include "ardour/ardour.h"
+#include "ardour/automation_list.h"
+#include "ardour/gain_control.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Time automation playback of a route's gain with N automation events,
+ * e.g. dense automation recorded from a hardware controller.
+ */
+
+static pframes_t const block_size = 1024;
+
+static void
+fill (boost::shared_ptr<AutomationList> alist, int n_events)
+{
+	alist->freeze ();
+	alist->clear ();
+	/* one event every 64 samples, a slow sine sweep */
+	for (int n = 0; n < n_events; ++n) {
+		alist->fast_simple_add (n * 64.0, 1.0 + 0.5 * sin (n / 100.0));
+	}
+	alist->thaw ();
+}
+
+static void
+run (boost::shared_ptr<Route> route, int n_events, int n_cycles)
+{
+	boost::shared_ptr<AutomationList> alist = route->gain_control ()->alist ();
+	fill (alist, n_events);
+
+	const samplepos_t length = n_events * 64;
+	const int cycles = min ((samplepos_t) n_cycles, max ((samplepos_t) 1, length / block_size));
+
+	/* linear playback, as in the process thread */
+	gint64 before = g_get_monotonic_time ();
+	for (int i = 0; i < n_cycles; ++i) {
+		route->automation_run ((i % cycles) * block_size, block_size);
+	}
+	gint64 elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("%1 events, automation_run: %2 us per cycle\n", n_events, (double) elapsed / n_cycles);
+
+	/* the gain curve of one cycle, as Amp uses it */
+	float vec[block_size];
+	before = g_get_monotonic_time ();
+	for (int i = 0; i < n_cycles; ++i) {
+		const double start = (i % cycles) * block_size;
+		alist->curve ().rt_safe_get_vector (start, start + block_size, vec, block_size);
+	}
+	elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("%1 events, rt_safe_get_vector: %2 us per cycle\n", n_events, (double) elapsed / n_cycles);
+
+	/* random locates */
+	double sum = 0;
+	bool ok;
+	before = g_get_monotonic_time ();
+	for (int i = 0; i < n_cycles; ++i) {
+		sum += alist->rt_safe_eval ((samplepos_t) (length * (rand () / (double) RAND_MAX)), ok);
+	}
+	elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("%1 events, random rt_safe_eval: %2 us per call (%3)\n", n_events, (double) elapsed / n_cycles, sum);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int const n_cycles = argc > 1 ? atoi (argv[1]) : 10000;
+
+	ARDOUR::init (false, true, localedir);
+
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	boost::shared_ptr<Route> route = session->get_routes ()->back ();
+	route->gain_control ()->set_automation_state (Play);
+
+	int const sizes[] = { 100, 1000, 10000, 100000, 1000000 };
+
+	for (size_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i) {
+		run (route, sizes[i], n_cycles);
+	}
+
+	return 0;
+}
@@ -0,0 +1,240 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <getopt.h>
+
+#include "pbd/compose.h"
+#include "pbd/fpu.h"
+#include "pbd/malign.h"
+#include "pbd/timing.h"
+
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+/* Measure the runtime DSP functions of all sets that the CPU supports,
+ * and the fused functions against the two passes they replace.
+ */
+
+struct KernelSet {
+	const char*                  name;
+	compute_peak_t               compute_peak;
+	find_peaks_t                 find_peaks;
+	apply_gain_to_buffer_t       apply_gain_to_buffer;
+	mix_buffers_with_gain_t      mix_buffers_with_gain;
+	mix_buffers_no_gain_t        mix_buffers_no_gain;
+	copy_vector_t                copy_vector;
+	mix_buffers_with_gain_ramp_t mix_buffers_with_gain_ramp;
+	apply_gain_find_peaks_t      apply_gain_find_peaks;
+};
+
+static pframes_t n_samples  = 1024;
+static int       iterations = 100000;
+static Sample*   src = 0;
+static Sample*   dst = 0;
+
+static volatile float sink;
+
+static void
+report (const char* set, const char* func, PBD::Timing const& t)
+{
+	/* samples per microsecond */
+	const double rate = (double) n_samples * iterations / (double) t.elapsed ();
+	cout << string_compose ("%1 %2: %3 ms, %4 Msamples/sec\n", set, func, t.elapsed_msecs (), rate);
+}
+
+static void
+run (KernelSet const& k)
+{
+	PBD::Timing t;
+	float peak = 0;
+	float mn = 0, mx = 0;
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		peak = k.compute_peak (src, n_samples, peak);
+	}
+	t.update ();
+	sink = peak;
+	report (k.name, "compute_peak", t);
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		k.find_peaks (src, n_samples, &mn, &mx);
+	}
+	t.update ();
+	sink = mx - mn;
+	report (k.name, "find_peaks", t);
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		/* alternate gains to keep the data in range */
+		k.apply_gain_to_buffer (dst, n_samples, (i & 1) ? 2.f : 0.5f);
+	}
+	t.update ();
+	report (k.name, "apply_gain_to_buffer", t);
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		k.mix_buffers_with_gain (dst, src, n_samples, (i & 1) ? 0.5f : -0.5f);
+	}
+	t.update ();
+	report (k.name, "mix_buffers_with_gain", t);
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		k.mix_buffers_no_gain (dst, src, n_samples);
+	}
+	t.update ();
+	report (k.name, "mix_buffers_no_gain", t);
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		k.copy_vector (dst, src, n_samples);
+	}
+	t.update ();
+	report (k.name, "copy_vector", t);
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		k.mix_buffers_with_gain_ramp (dst, src, n_samples, (i & 1) ? 0.5f : -0.5f, (i & 1) ? -1.f / n_samples : 1.f / n_samples);
+	}
+	t.update ();
+	report (k.name, "mix_buffers_with_gain_ramp", t);
+
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		k.apply_gain_find_peaks (dst, n_samples, (i & 1) ? 2.f : 0.5f, &mn, &mx);
+	}
+	t.update ();
+	sink = mx - mn;
+	report (k.name, "apply_gain_find_peaks", t);
+
+	/* the two passes that apply_gain_find_peaks replaces */
+	t.start ();
+	for (int i = 0; i < iterations; ++i) {
+		k.apply_gain_to_buffer (dst, n_samples, (i & 1) ? 2.f : 0.5f);
+		k.find_peaks (dst, n_samples, &mn, &mx);
+	}
+	t.update ();
+	sink = mx - mn;
+	report (k.name, "apply_gain_to_buffer + find_peaks", t);
+}
+
+static void
+usage ()
+{
+	cerr << "Syntax: dsp_kernels [-n <samples per call>] [-i <iterations>]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int c;
+	while ((c = getopt (argc, argv, "n:i:h")) != -1) {
+		switch (c) {
+		case 'n':
+			n_samples = atoi (optarg);
+			break;
+		case 'i':
+			iterations = atoi (optarg);
+			break;
+		default:
+			usage ();
+		}
+	}
+
+	if (n_samples == 0 || iterations <= 0) {
+		usage ();
+	}
+
+	/* the SSE functions require 16 byte alignment */
+	cache_aligned_malloc ((void**) &src, n_samples * sizeof (Sample));
+	cache_aligned_malloc ((void**) &dst, n_samples * sizeof (Sample));
+
+	for (pframes_t i = 0; i < n_samples; ++i) {
+		src[i] = 2.f * (rand () / (float) RAND_MAX) - 1.f;
+		dst[i] = 2.f * (rand () / (float) RAND_MAX) - 1.f;
+	}
+
+	vector<KernelSet> sets;
+
+	KernelSet d = {
+		"default",
+		default_compute_peak,
+		default_find_peaks,
+		default_apply_gain_to_buffer,
+		default_mix_buffers_with_gain,
+		default_mix_buffers_no_gain,
+		default_copy_vector,
+		default_mix_buffers_with_gain_ramp,
+		default_apply_gain_find_peaks
+	};
+	sets.push_back (d);
+
+#if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
+	PBD::FPU* fpu = PBD::FPU::instance ();
+
+	if (fpu->has_sse ()) {
+		KernelSet k = {
+			"SSE",
+			x86_sse_compute_peak,
+			x86_sse_find_peaks,
+			x86_sse_apply_gain_to_buffer,
+			x86_sse_mix_buffers_with_gain,
+			x86_sse_mix_buffers_no_gain,
+			default_copy_vector,
+			default_mix_buffers_with_gain_ramp,
+			default_apply_gain_find_peaks
+		};
+		sets.push_back (k);
+	}
+
+#ifndef PLATFORM_WINDOWS
+	if (fpu->has_avx () && fpu->has_fma ()) {
+		KernelSet k = {
+			"AVX/FMA",
+			x86_fma_compute_peak,
+			x86_fma_find_peaks,
+			x86_fma_apply_gain_to_buffer,
+			x86_fma_mix_buffers_with_gain,
+			x86_fma_mix_buffers_no_gain,
+			x86_fma_copy_vector,
+			x86_fma_mix_buffers_with_gain_ramp,
+			x86_fma_apply_gain_find_peaks
+		};
+		sets.push_back (k);
+	}
+
+	if (fpu->has_avx512f ()) {
+		KernelSet k = {
+			"AVX-512",
+			x86_avx512f_compute_peak,
+			x86_avx512f_find_peaks,
+			x86_avx512f_apply_gain_to_buffer,
+			x86_avx512f_mix_buffers_with_gain,
+			x86_avx512f_mix_buffers_no_gain,
+			x86_avx512f_copy_vector,
+			x86_avx512f_mix_buffers_with_gain_ramp,
+			x86_avx512f_apply_gain_find_peaks
+		};
+		sets.push_back (k);
+	}
+#endif
+#endif
+
+	cout << "INFO: " << n_samples << " samples per call, " << iterations << " iterations.\n";
+
+	for (vector<KernelSet>::const_iterator k = sets.begin (); k != sets.end (); ++k) {
+		run (*k);
+	}
+
+	cache_aligned_free (src);
+	cache_aligned_free (dst);
+
+	return 0;
+}
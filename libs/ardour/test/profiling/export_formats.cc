@@ -0,0 +1,201 @@
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/id.h"
+#include "pbd/xml++.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/export_channel.h"
+#include "ardour/export_channel_configuration.h"
+#include "ardour/export_filename.h"
+#include "ardour/export_format_specification.h"
+#include "ardour/export_handler.h"
+#include "ardour/export_status.h"
+#include "ardour/export_timespan.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Export one timespan of a synthetic stereo signal to N formats at once
+ * (cycling through WAV/FLAC, sample formats and sample rates) and report
+ * the wall-clock time, compared to exporting a single format.
+ */
+
+/** Export channel that produces white noise, so that encoders
+ *  and sample rate converters get realistic input.
+ */
+class NoiseExportChannel : public ExportChannel
+{
+  public:
+	NoiseExportChannel (uint32_t seed)
+		: _seed (seed)
+	{}
+
+	void set_max_buffer_size (samplecnt_t samples)
+	{
+		_buffer.resize (samples);
+		for (samplecnt_t i = 0; i < samples; ++i) {
+			_seed = _seed * 1103515245 + 12345;
+			_buffer[i] = ((_seed >> 16) & 0x7fff) / 32768.f - .5f;
+		}
+	}
+
+	void read (Sample const *& data, samplecnt_t samples) const
+	{
+		assert (samples <= (samplecnt_t) _buffer.size ());
+		data = &_buffer[0];
+	}
+
+	bool empty () const { return false; }
+	void get_state (XMLNode*) const {}
+	void set_state (XMLNode*, Session&) {}
+	bool operator< (ExportChannel const & other) const { return this < &other; }
+
+  private:
+	uint32_t           _seed;
+	std::vector<Sample> _buffer;
+};
+
+static ExportFormatSpecPtr
+add_format (Session* session, int n)
+{
+	static char const* const encodings[][3] = {
+		{ "F_WAV",  "wav",  "SF_16" },
+		{ "F_FLAC", "flac", "SF_24" },
+		{ "F_WAV",  "wav",  "SF_Float" },
+		{ "F_FLAC", "flac", "SF_16" },
+		{ "F_WAV",  "wav",  "SF_24" },
+	};
+	static int const rates[] = { 1 /* SR_Session */, 48000, 96000, 44100 };
+
+	char const* const* e = encodings[n % 5];
+	int const rate = rates[(n / 5) % 4];
+
+	XMLTree tree;
+	tree.read_buffer (string_compose (
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		"<ExportFormatSpecification name=\"format-%1\" id=\"%2\">"
+		"  <Encoding id=\"%3\" type=\"T_Sndfile\" extension=\"%4\" name=\"%4\" has-sample-format=\"true\" channel-limit=\"256\"/>"
+		"  <SampleRate rate=\"%5\"/>"
+		"  <SRCQuality quality=\"SRC_SincMedium\"/>"
+		"  <EncodingOptions>"
+		"    <Option name=\"sample-format\" value=\"%6\"/>"
+		"    <Option name=\"dithering\" value=\"D_None\"/>"
+		"    <Option name=\"tag-metadata\" value=\"false\"/>"
+		"    <Option name=\"tag-support\" value=\"false\"/>"
+		"    <Option name=\"broadcast-info\" value=\"false\"/>"
+		"  </EncodingOptions>"
+		"  <Processing>"
+		"    <Normalize enabled=\"false\" target=\"0\"/>"
+		"  </Processing>"
+		"</ExportFormatSpecification>",
+		n, PBD::ID ().to_s (), e[0], e[1], rate, e[2]));
+
+	return session->get_export_handler ()->add_format (*tree.root ());
+}
+
+static int64_t
+run (Session* session, string const & dir, int n_formats, samplecnt_t duration)
+{
+	boost::shared_ptr<ExportHandler> handler = session->get_export_handler ();
+
+	ExportTimespanPtr tsp = handler->add_timespan ();
+	tsp->set_range (0, duration);
+	tsp->set_range_id ("session");
+	tsp->set_name (string_compose ("export-%1", n_formats));
+
+	ExportChannelConfigPtr ccp = handler->add_channel_config ();
+	ccp->register_channel (ExportChannelPtr (new NoiseExportChannel (1)));
+	ccp->register_channel (ExportChannelPtr (new NoiseExportChannel (2)));
+
+	for (int n = 0; n < n_formats; ++n) {
+		ExportFilenamePtr fnp = handler->add_filename ();
+		fnp->set_folder (dir);
+		fnp->set_timespan (tsp);
+		fnp->include_label = false;
+		fnp->include_format_name = true;
+
+		handler->add_export_config (tsp, ccp, add_format (session, n), fnp, BroadcastInfoPtr ());
+	}
+
+	int64_t const start = g_get_monotonic_time ();
+
+	handler->do_export ();
+
+	boost::shared_ptr<ExportStatus> status = session->get_export_status ();
+	while (status->running ()) {
+		Glib::usleep (1000);
+	}
+
+	int64_t const elapsed = g_get_monotonic_time () - start;
+
+	status->finish ();
+	return elapsed;
+}
+
+static void
+usage ()
+{
+	cerr << "Syntax: export_formats [-n <formats>] [-d <seconds>]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int n_formats = 8;
+	int seconds   = 120;
+
+	int c;
+	while ((c = getopt (argc, argv, "n:d:h")) != -1) {
+		switch (c) {
+		case 'n':
+			n_formats = atoi (optarg);
+			break;
+		case 'd':
+			seconds = atoi (optarg);
+			break;
+		default:
+			usage ();
+		}
+	}
+
+	ARDOUR::init (false, true, localedir);
+	create_and_start_dummy_backend ();
+
+	string const dir = new_test_output_dir ("export_formats");
+
+	BusProfile bus_profile;
+	bus_profile.master_out_channels = 2;
+
+	Session* session = new Session (*AudioEngine::instance(), Glib::build_filename (dir, "session"), "export_formats", &bus_profile);
+	AudioEngine::instance()->set_session (session);
+
+	samplecnt_t const duration = seconds * session->nominal_sample_rate ();
+
+	int64_t const single = run (session, dir, 1, duration);
+	int64_t const multi  = run (session, dir, n_formats, duration);
+
+	cout << string_compose ("1 format: %1 [ms], %2 formats: %3 [ms], %4 [ms] per format\n",
+	                        single / 1000, n_formats, multi / 1000, multi / (1000 * n_formats));
+
+	AudioEngine::instance()->remove_session ();
+	delete session;
+
+	stop_and_destroy_backend ();
+
+	return 0;
+}
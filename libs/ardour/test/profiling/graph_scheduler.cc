@@ -0,0 +1,135 @@
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/enumwriter.h"
+#include "pbd/timing.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Measure the time the process graph needs per cycle for a session of
+ * N empty busses. Those do (next to) no DSP, so the time per cycle
+ * is dominated by the scheduling overhead of the graph.
+ */
+
+static Session*         session = 0;
+static PBD::TimingStats stats;
+static volatile gint    cycles = 0;
+
+static void
+freewheel_process (pframes_t nframes)
+{
+	stats.start ();
+	session->process (nframes);
+	stats.update ();
+	g_atomic_int_inc (&cycles);
+}
+
+static void
+run (GraphScheduler scheduler, int n_cycles)
+{
+	Config->set_graph_scheduler (scheduler);
+
+	/* let the graph pick up the change */
+	Glib::usleep (100000);
+
+	stats.reset ();
+	g_atomic_int_set (&cycles, 0);
+
+	AudioEngine::instance()->freewheel (true);
+	while (g_atomic_int_get (&cycles) < n_cycles) {
+		Glib::usleep (10000);
+	}
+	AudioEngine::instance()->freewheel (false);
+
+	uint64_t min, max;
+	double   avg, dev;
+
+	if (!stats.get_stats (min, max, avg, dev)) {
+		cerr << "not enough data\n";
+		return;
+	}
+
+	cout << string_compose ("%1: %2 cycles, per cycle min %3 max %4 avg %5 dev %6 [us], avg per route %7 [us]\n",
+	                        enum_2_string (scheduler), n_cycles, min, max, avg, dev,
+	                        avg / session->get_routes()->size ());
+}
+
+static void
+usage ()
+{
+	cerr << "Syntax: graph_scheduler [-r <routes>] [-t <threads>] [-c <cycles>]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_routes  = 300;
+	int      n_threads = 0;
+	int      n_cycles  = 10000;
+
+	int c;
+	while ((c = getopt (argc, argv, "r:t:c:h")) != -1) {
+		switch (c) {
+		case 'r':
+			n_routes = atoi (optarg);
+			break;
+		case 't':
+			n_threads = atoi (optarg);
+			break;
+		case 'c':
+			n_cycles = atoi (optarg);
+			break;
+		default:
+			usage ();
+		}
+	}
+
+	ARDOUR::init (false, true, localedir);
+
+	/* the number of DSP threads is read when the engine starts */
+	Config->set_processor_usage (n_threads);
+
+	create_and_start_dummy_backend ();
+
+	string const dir = Glib::build_filename (new_test_output_dir ("graph_scheduler"), "session");
+
+	BusProfile bus_profile;
+	bus_profile.master_out_channels = 2;
+
+	session = new Session (*AudioEngine::instance(), dir, "graph_scheduler", &bus_profile);
+	AudioEngine::instance()->set_session (session);
+
+	session->new_audio_route (2, 2, 0, n_routes, "Bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+
+	cout << "INFO: " << session->get_routes()->size() << " routes, "
+	     << AudioEngine::instance()->process_thread_count () << " process threads.\n";
+
+	AudioEngine::instance()->Freewheel.connect_same_thread (*session, boost::bind (&freewheel_process, _1));
+
+	run (SharedQueueScheduler, n_cycles);
+	run (WorkStealingScheduler, n_cycles);
+
+	AudioEngine::instance()->remove_session ();
+	delete session;
+
+	stop_and_destroy_backend ();
+
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include "test_util.h"
 #include "pbd/failed_constructor.h"
+#include "pbd/timing.h"
 #include "ardour/ardour.h"
 #include "ardour/audioengine.h"
 #include "ardour/session.h"
@@ -22,6 +23,8 @@ int main (int argc, char* argv[])
 
 	Session* s = 0;
 
+	PBD::Timing load_timing;
+
 	try {
 		s = load_session (argv[1], argv[2]);
 	} catch (failed_constructor& e) {
@@ -38,6 +41,14 @@ int main (int argc, char* argv[])
 		exit (EXIT_FAILURE);
 	}
 
+	load_timing.update ();
+
+	Session::LoadTimings const & phases (s->load_timings ());
+	for (Session::LoadTimings::const_iterator i = phases.begin(); i != phases.end(); ++i) {
+		cout << i->first << ": " << i->second / 1000 << " ms\n";
+	}
+	cout << "total: " << load_timing.elapsed_msecs () << " ms\n";
+
 	AudioEngine::instance()->remove_session ();
 	delete s;
 	AudioEngine::instance()->stop ();
@@ -1,3 +1,8 @@
+#include <iostream>
+#include <cstdlib>
+
+#include <glib.h>
+
 #include "test_util.h"
 #include "ardour/ardour.h"
 #include "ardour/midi_track.h"
@@ -12,9 +17,36 @@ using namespace PBD;
 
 static const char* localedir = LOCALEDIR;
 
+/* Time range and point queries, spread over the whole playlist */
+static void
+query (boost::shared_ptr<Playlist> playlist, int n_queries)
+{
+	std::pair<samplepos_t, samplepos_t> const extent = playlist->get_extent ();
+	samplecnt_t const step = max ((samplecnt_t) 1, (extent.second - extent.first) / n_queries);
+
+	size_t found = 0;
+	gint64 before = g_get_monotonic_time ();
+
+	for (int i = 0; i < n_queries; ++i) {
+		samplepos_t const pos = extent.first + i * step;
+		found += playlist->regions_touched (pos, pos + 8192)->size ();
+		if (playlist->top_region_at (pos)) {
+			++found;
+		}
+	}
+
+	gint64 elapsed = g_get_monotonic_time () - before;
+
+	cout << playlist->n_regions () << " regions, " << n_queries << " range + point queries: "
+	     << elapsed / 1000.0 << " ms, " << (double) elapsed / n_queries << " us per query pair ("
+	     << found << " hits)\n";
+}
+
 int
 main (int argc, char* argv[])
 {
+	int const copies = argc > 1 ? atoi (argv[1]) : 1000;
+
 	ARDOUR::init (false, true, localedir);
 	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
 
@@ -35,7 +67,7 @@ main (int argc, char* argv[])
 	/* Duplicate it a lot */
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
-	playlist->duplicate (region, region->last_sample() + 1, 1000);
+	playlist->duplicate (region, region->last_sample() + 1, copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
 
@@ -45,7 +77,9 @@ main (int argc, char* argv[])
 	/* And do it again */
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
-	playlist->duplicate (region, region->last_sample() + 1, 1000);
+	playlist->duplicate (region, region->last_sample() + 1, copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
+
+	query (playlist, 10000);
 }
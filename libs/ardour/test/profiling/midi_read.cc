@@ -0,0 +1,132 @@
+#include <iostream>
+#include <cstdlib>
+#include <set>
+
+#include <glib.h>
+
+#include "pbd/compose.h"
+
+#include "evoral/Note.hpp"
+
+#include "ardour/ardour.h"
+#include "ardour/midi_buffer.h"
+#include "ardour/midi_cursor.h"
+#include "ardour/midi_model.h"
+#include "ardour/midi_source.h"
+#include "ardour/midi_state_tracker.h"
+#include "ardour/session.h"
+#include "ardour/tempo.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Time MidiSource::midi_read() on a synthetic, dense MIDI source:
+ * 16th-note chords on all 16 channels plus a controller sweep per channel,
+ * played linearly and with a locate before every read.
+ */
+
+static pframes_t const block_size = 1024;
+
+static boost::shared_ptr<MidiSource>
+create_source (Session* session, int n_beats)
+{
+	typedef Evoral::Note<Temporal::Beats> Note;
+
+	boost::shared_ptr<MidiSource> src = session->create_midi_source_for_session ("midi_read");
+
+	{
+		Source::Lock lm (src->mutex ());
+		src->load_model (lm);
+	}
+
+	boost::shared_ptr<MidiModel> model = src->model ();
+
+	MidiModel::NoteDiffCommand* cmd = model->new_note_diff_command ();
+	for (int n = 0; n < n_beats * 4; ++n) {
+		for (uint8_t chn = 0; chn < 16; ++chn) {
+			cmd->add (boost::shared_ptr<Note> (new Note (chn, Temporal::Beats (n / 4.0), Temporal::Beats (1 / 8.0), 48 + (n + chn) % 36, 100)));
+		}
+	}
+	model->apply_command (*session, cmd);
+
+	for (uint8_t chn = 0; chn < 16; ++chn) {
+		boost::shared_ptr<Evoral::ControlList> list = model->control (Evoral::Parameter (MidiCCAutomation, chn, 1), true)->list ();
+		list->freeze ();
+		for (int n = 0; n < n_beats * 16; ++n) {
+			list->fast_simple_add (n / 16.0, n % 128);
+		}
+		list->thaw ();
+	}
+
+	return src;
+}
+
+static void
+run (Session* session, int n_beats, int n_cycles)
+{
+	boost::shared_ptr<MidiSource> src = create_source (session, n_beats);
+
+	const samplepos_t length = session->tempo_map ().sample_at_quarter_note (n_beats);
+	const int cycles = max ((samplepos_t) 1, length / block_size);
+
+	MidiBuffer buf (65536);
+	MidiStateTracker tracker;
+	std::set<Evoral::Parameter> filtered;
+	MidiCursor cursor;
+
+	Source::Lock lm (src->mutex ());
+
+	/* the first read builds the cache */
+	gint64 before = g_get_monotonic_time ();
+	src->midi_read (lm, buf, 0, 0, block_size, 0, cursor, &tracker, 0, filtered, 0, 0);
+	gint64 elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("%1 beats, first read: %2 us\n", n_beats, elapsed);
+
+	/* linear playback, as the disk reader does */
+	size_t n_bytes = 0;
+	before = g_get_monotonic_time ();
+	for (int i = 0; i < n_cycles; ++i) {
+		buf.silence (block_size);
+		src->midi_read (lm, buf, 0, (i % cycles) * block_size, block_size, 0, cursor, &tracker, 0, filtered, 0, 0);
+		n_bytes += buf.size ();
+		tracker.reset ();
+	}
+	elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("%1 beats, linear read: %2 us per cycle (%3 bytes)\n", n_beats, (double) elapsed / n_cycles, n_bytes);
+
+	/* a locate before every read */
+	before = g_get_monotonic_time ();
+	for (int i = 0; i < n_cycles; ++i) {
+		buf.silence (block_size);
+		const samplepos_t start = (samplepos_t) ((length - block_size) * (rand () / (double) RAND_MAX));
+		src->midi_read (lm, buf, 0, start, block_size, 0, cursor, &tracker, 0, filtered, 0, 0);
+		tracker.reset ();
+	}
+	elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("%1 beats, random read: %2 us per cycle\n", n_beats, (double) elapsed / n_cycles);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int const n_cycles = argc > 1 ? atoi (argv[1]) : 1000;
+
+	ARDOUR::init (false, true, localedir);
+
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	int const sizes[] = { 16, 256, 4096 };
+
+	for (size_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i) {
+		run (session, sizes[i], n_cycles);
+	}
+
+	return 0;
+}
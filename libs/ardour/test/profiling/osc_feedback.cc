@@ -0,0 +1,170 @@
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <glib.h>
+#include <glibmm/timer.h>
+
+#include <lo/lo.h>
+
+#include "pbd/compose.h"
+
+using namespace std;
+
+/* Measure the time the OSC surface needs to send one tick of strip
+ * feedback to a surface over UDP loopback: every message as a datagram
+ * of its own (followed by the 1us sleep that OSC::send_message uses),
+ * and bundled per address, max_bundle_messages at a time.
+ */
+
+static const int max_bundle_messages = 32;
+
+static const char* paths[] = { "/strip/fader", "/strip/meter", "/strip/mute", "/strip/solo" };
+static const int n_paths = sizeof (paths) / sizeof (paths[0]);
+
+static volatile gint received = 0;
+
+static int
+count_message (const char*, const char*, lo_arg**, int, lo_message, void*)
+{
+	g_atomic_int_inc (&received);
+	return 0;
+}
+
+static lo_message
+strip_message (int strip, int n)
+{
+	lo_message msg = lo_message_new ();
+	lo_message_add_int32 (msg, strip + 1);
+	lo_message_add_float (msg, (float) ((strip + n) % 100) / 100.f);
+	return msg;
+}
+
+static void
+wait_for (int expected)
+{
+	/* give the receiver some time to catch up, datagrams may be dropped */
+	for (int i = 0; i < 1000 && g_atomic_int_get (&received) < expected; ++i) {
+		Glib::usleep (1000);
+	}
+}
+
+static void
+run_unbundled (lo_address addr, uint32_t n_strips, int n_ticks)
+{
+	g_atomic_int_set (&received, 0);
+
+	gint64 before = g_get_monotonic_time ();
+
+	for (int t = 0; t < n_ticks; ++t) {
+		for (uint32_t s = 0; s < n_strips; ++s) {
+			for (int p = 0; p < n_paths; ++p) {
+				lo_message msg = strip_message (s, t);
+				lo_send_message (addr, paths[p], msg);
+				Glib::usleep (1);
+				lo_message_free (msg);
+			}
+		}
+	}
+
+	gint64 elapsed = g_get_monotonic_time () - before;
+
+	int const sent = n_ticks * n_strips * n_paths;
+	wait_for (sent);
+
+	cout << string_compose ("%1 strips, one datagram per message: %2 [us] per tick, %3 of %4 messages received\n",
+	                        n_strips, (double) elapsed / n_ticks, g_atomic_int_get (&received), sent);
+}
+
+static void
+run_bundled (lo_address addr, uint32_t n_strips, int n_ticks)
+{
+#ifdef HAVE_LO_BUNDLE_FREE_RECURSIVE
+	g_atomic_int_set (&received, 0);
+
+	gint64 before = g_get_monotonic_time ();
+
+	for (int t = 0; t < n_ticks; ++t) {
+		lo_bundle bundle = 0;
+		int messages = 0;
+		for (uint32_t s = 0; s < n_strips; ++s) {
+			for (int p = 0; p < n_paths; ++p) {
+				if (!bundle) {
+					bundle = lo_bundle_new (LO_TT_IMMEDIATE);
+				}
+				lo_bundle_add_message (bundle, paths[p], strip_message (s, t));
+				if (++messages >= max_bundle_messages) {
+					lo_send_bundle (addr, bundle);
+					lo_bundle_free_recursive (bundle);
+					bundle = 0;
+					messages = 0;
+				}
+			}
+		}
+		if (bundle) {
+			lo_send_bundle (addr, bundle);
+			lo_bundle_free_recursive (bundle);
+		}
+	}
+
+	gint64 elapsed = g_get_monotonic_time () - before;
+
+	int const sent = n_ticks * n_strips * n_paths;
+	wait_for (sent);
+
+	cout << string_compose ("%1 strips, bundles of %2 messages: %3 [us] per tick, %4 of %5 messages received\n",
+	                        n_strips, max_bundle_messages, (double) elapsed / n_ticks, g_atomic_int_get (&received), sent);
+#else
+	cout << "liblo without lo_bundle_free_recursive(), the OSC surface does not bundle feedback\n";
+#endif
+}
+
+static void
+usage ()
+{
+	cerr << "Syntax: osc_feedback [-s <strips>] [-t <ticks>]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_strips = 64;
+	int      n_ticks  = 100;
+
+	int c;
+	while ((c = getopt (argc, argv, "s:t:h")) != -1) {
+		switch (c) {
+		case 's':
+			n_strips = atoi (optarg);
+			break;
+		case 't':
+			n_ticks = atoi (optarg);
+			break;
+		default:
+			usage ();
+		}
+	}
+
+	/* the surface, on a port of the OS' choosing */
+	lo_server_thread surface = lo_server_thread_new_with_proto (NULL, LO_UDP, NULL);
+	if (!surface) {
+		cerr << "Cannot create OSC server\n";
+		return EXIT_FAILURE;
+	}
+	lo_server_thread_add_method (surface, NULL, NULL, count_message, NULL);
+	lo_server_thread_start (surface);
+
+	char* port = g_strdup_printf ("%d", lo_server_thread_get_port (surface));
+	lo_address addr = lo_address_new ("127.0.0.1", port);
+	g_free (port);
+
+	run_unbundled (addr, n_strips, n_ticks);
+	run_bundled (addr, n_strips, n_ticks);
+
+	lo_address_free (addr);
+	lo_server_thread_stop (surface);
+	lo_server_thread_free (surface);
+
+	return 0;
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/port.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Measure the time the engine needs per cycle to resample N input ports
+ * and N output ports at a given varispeed ratio. The inputs are
+ * connected to S physical ports of the dummy backend, inputs that share
+ * a source are resampled only once.
+ */
+
+static volatile gint cycles = 0;
+
+static void
+freewheel_process (pframes_t)
+{
+	/* no session processing, only port I/O is timed */
+	g_atomic_int_inc (&cycles);
+}
+
+static void
+run (double ratio, int n_cycles, uint32_t n_ports, uint32_t n_sources)
+{
+	/* the speed ratio is not updated from transport masters while
+	 * freewheeling with a Freewheel handler connected.
+	 */
+	Port::set_speed_ratio (ratio);
+	g_atomic_int_set (&cycles, 0);
+
+	gint64 before = g_get_monotonic_time ();
+
+	AudioEngine::instance()->freewheel (true);
+	while (g_atomic_int_get (&cycles) < n_cycles) {
+		Glib::usleep (1000);
+	}
+	AudioEngine::instance()->freewheel (false);
+
+	gint64 elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("ratio %1: %2 inputs from %3 sources, %4 [us] per cycle\n",
+	                        Port::speed_ratio (), n_ports, n_sources, (double) elapsed / g_atomic_int_get (&cycles));
+}
+
+static void
+usage ()
+{
+	cerr << "Syntax: port_resample [-p <ports>] [-s <sources>] [-r <ratio>] [-t <threads>] [-c <cycles>]\n";
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_ports   = 64;
+	uint32_t n_sources = 1;
+	double   ratio     = 1.1;
+	int      n_threads = 0;
+	int      n_cycles  = 10000;
+
+	int c;
+	while ((c = getopt (argc, argv, "p:s:r:t:c:h")) != -1) {
+		switch (c) {
+		case 'p':
+			n_ports = atoi (optarg);
+			break;
+		case 's':
+			n_sources = atoi (optarg);
+			break;
+		case 'r':
+			ratio = atof (optarg);
+			break;
+		case 't':
+			n_threads = atoi (optarg);
+			break;
+		case 'c':
+			n_cycles = atoi (optarg);
+			break;
+		default:
+			usage ();
+		}
+	}
+
+	ARDOUR::init (false, true, localedir);
+
+	/* the number of DSP threads is read when the engine starts */
+	Config->set_processor_usage (n_threads);
+
+	create_and_start_dummy_backend ();
+
+	string const dir = Glib::build_filename (new_test_output_dir ("port_resample"), "session");
+
+	BusProfile bus_profile;
+	bus_profile.master_out_channels = 2;
+
+	Session* session = new Session (*AudioEngine::instance(), dir, "port_resample", &bus_profile);
+	AudioEngine::instance()->set_session (session);
+
+	vector<string> physical;
+	vector<string> playback;
+	AudioEngine::instance()->get_physical_outputs (DataType::AUDIO, physical);
+	AudioEngine::instance()->get_physical_inputs (DataType::AUDIO, playback);
+	n_sources = max ((uint32_t) 1, min (n_sources, (uint32_t) physical.size ()));
+
+	vector<boost::shared_ptr<Port> > ports;
+	for (uint32_t i = 0; i < n_ports; ++i) {
+		boost::shared_ptr<Port> p = AudioEngine::instance()->register_input_port (DataType::AUDIO, string_compose ("in %1", i + 1));
+		p->connect (physical[i % n_sources]);
+		ports.push_back (p);
+		p = AudioEngine::instance()->register_output_port (DataType::AUDIO, string_compose ("out %1", i + 1));
+		p->connect (playback[i % playback.size ()]);
+		ports.push_back (p);
+	}
+
+	/* let the backend report the new connections */
+	Glib::usleep (100000);
+
+	AudioEngine::instance()->Freewheel.connect_same_thread (*session, boost::bind (&freewheel_process, _1));
+
+	run (1.0, n_cycles, n_ports, n_sources);
+	run (ratio, n_cycles, n_ports, n_sources);
+
+	for (vector<boost::shared_ptr<Port> >::iterator i = ports.begin (); i != ports.end (); ++i) {
+		AudioEngine::instance()->unregister_port (*i);
+	}
+	ports.clear ();
+
+	AudioEngine::instance()->remove_session ();
+	delete session;
+
+	stop_and_destroy_backend ();
+
+	return 0;
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <cstdlib>
+
+#include <glib.h>
+
+#include "pbd/compose.h"
+
+#include "ardour/ardour.h"
+#include "ardour/tempo.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace Timecode;
+
+/* Time the conversions that the process thread uses (MIDI, click, BBT)
+ * for a tempo map with N tempo changes, e.g. a film score.
+ */
+
+static int const sample_rate = 48000;
+
+static void
+fill (TempoMap& map, int n_tempos)
+{
+	/* starts with the default 4/4, 120 bpm */
+	for (int n = 1; n < n_tempos; ++n) {
+		/* mostly constant, some ramps; one change every bar */
+		const double bpm = 90.0 + (n % 13) * 5.0;
+		const double end = (n % 4) ? bpm : bpm + 10.0;
+		map.add_tempo (Tempo (bpm, 4.0, end), n, 0, MusicTime);
+	}
+}
+
+static void
+run (TempoMap& map, int n_tempos, int n_queries)
+{
+	const samplepos_t length = map.sample_at_quarter_note (n_tempos * 4.0);
+	const samplecnt_t step = max ((samplecnt_t) 1, length / n_queries);
+
+	double sum = 0;
+	gint64 before = g_get_monotonic_time ();
+
+	for (int i = 0; i < n_queries; ++i) {
+		const samplepos_t pos = i * step;
+		sum += map.quarter_note_at_sample (pos);
+		sum += map.beat_at_sample (pos);
+		sum += map.sample_at_quarter_note (i * 4.0 * n_tempos / n_queries);
+		sum += map.bbt_at_sample (pos).beats;
+		sum += map.tempo_at_sample (pos).note_types_per_minute ();
+	}
+
+	gint64 elapsed = g_get_monotonic_time () - before;
+
+	cout << string_compose ("%1 tempo sections, %2 x 5 conversions: %3 ms, %4 ns per conversion (%5)\n",
+	                        map.n_tempos (), n_queries, elapsed / 1000.0, 1000.0 * elapsed / (5.0 * n_queries), sum);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int const n_queries = argc > 1 ? atoi (argv[1]) : 100000;
+
+	for (int n_tempos = 1; n_tempos <= 10000; n_tempos *= 10) {
+		TempoMap map (sample_rate);
+		fill (map, n_tempos);
+		run (map, n_tempos, n_queries);
+	}
+
+	return 0;
+}
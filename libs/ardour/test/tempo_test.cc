@@ -635,3 +635,60 @@ TempoTest::tempoFundamentalsTest ()
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (164.0, tE->quarter_notes_per_minute (), 1e-17);
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (41.0, tE->pulses_per_minute (), 1e-17);
 }
+
+/* The public conversions use the map's snapshot, check them against
+ * the linear scans of the metrics.
+ */
+void
+TempoTest::snapshotTest ()
+{
+	int const sampling_rate = 48000;
+
+	TempoMap map (sampling_rate);
+	Meter meterA (4, 4);
+	map.replace_meter (map.first_meter(), meterA, BBT_Time (1, 1, 0), 0, AudioTime);
+	Tempo tempoA (100.0, 4.0, 140.0);
+	map.replace_tempo (map.first_tempo(), tempoA, 0.0, 0, AudioTime);
+
+	for (int n = 1; n < 200; ++n) {
+		Tempo t (100.0 + (n % 7) * 10.0, 4.0, 100.0 + ((n + 3) % 7) * 10.0);
+		if (n % 5) {
+			map.add_tempo (t, n * 2.0, 0, MusicTime);
+		} else {
+			map.add_tempo (t, 0.0, (samplepos_t) n * sampling_rate, AudioTime);
+		}
+	}
+
+	Meter meterB (3, 4);
+	map.add_meter (meterB, BBT_Time (20, 1, 0), 0, MusicTime);
+	Meter meterC (7, 8);
+	map.add_meter (meterC, BBT_Time (61, 1, 0), 0, MusicTime);
+
+	for (int n = 0; n < 2; ++n) {
+
+		for (samplepos_t s = -sampling_rate; s < 600 * sampling_rate; s += 12345) {
+			const double minute = map.minute_at_sample (s);
+			const double qn = s / 10000.0;
+
+			CPPUNIT_ASSERT_EQUAL (map.beat_at_minute_locked (map._metrics, minute), map.beat_at_sample (s));
+			CPPUNIT_ASSERT_EQUAL (map.pulse_at_minute_locked (map._metrics, minute) * 4.0, map.quarter_note_at_sample (s));
+			CPPUNIT_ASSERT_EQUAL (map.pulse_at_minute_locked (map._metrics, minute) * 4.0, map.quarter_note_at_sample_rt (s));
+			CPPUNIT_ASSERT_EQUAL (map.tempo_at_minute_locked (map._metrics, minute).note_types_per_minute(), map.tempo_at_sample (s).note_types_per_minute());
+			CPPUNIT_ASSERT_EQUAL (map.quarter_notes_between_samples_locked (map._metrics, s, s + 4567), map.quarter_notes_between_samples (s, s + 4567));
+
+			if (s >= 0) {
+				CPPUNIT_ASSERT (map.bbt_at_minute_locked (map._metrics, minute) == map.bbt_at_sample (s));
+				CPPUNIT_ASSERT (map.bbt_at_minute_locked (map._metrics, minute) == map.bbt_at_sample_rt (s));
+			}
+
+			CPPUNIT_ASSERT_EQUAL (map.sample_at_minute (map.minute_at_beat_locked (map._metrics, qn)), map.sample_at_beat (qn));
+			CPPUNIT_ASSERT_EQUAL (map.sample_at_minute (map.minute_at_pulse_locked (map._metrics, qn / 4.0)), map.sample_at_quarter_note (qn));
+			CPPUNIT_ASSERT_EQUAL (map.pulse_at_beat_locked (map._metrics, qn) * 4.0, map.quarter_note_at_beat (qn));
+			CPPUNIT_ASSERT_EQUAL (map.beat_at_pulse_locked (map._metrics, qn / 4.0), map.beat_at_quarter_note (qn));
+			CPPUNIT_ASSERT_EQUAL (map.tempo_at_pulse_locked (map._metrics, qn / 4.0).note_types_per_minute(), map.tempo_at_quarter_note (qn).note_types_per_minute());
+		}
+
+		/* the snapshot follows changes of the map */
+		map.change_initial_tempo (60.0, 4.0, 200.0);
+	}
+}
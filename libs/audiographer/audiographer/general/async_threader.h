@@ -0,0 +1,192 @@
+#ifndef AUDIOGRAPHER_ASYNC_THREADER_H
+#define AUDIOGRAPHER_ASYNC_THREADER_H
+
+#include <pthread.h>
+
+#include <glib.h>
+#include <glibmm/threads.h>
+#include <boost/format.hpp>
+#include <vector>
+
+#include "pbd/semutils.h"
+
+#include "audiographer/visibility.h"
+#include "audiographer/sink.h"
+#include "audiographer/type_utils.h"
+#include "audiographer/exception.h"
+#include "audiographer/general/threader.h"
+#include "audiographer/utils/listed_source.h"
+
+namespace AudioGrapher
+{
+
+/** Class that runs its outputs in a thread of their own.
+  *
+  * Processed data is copied into a ring of preallocated buffers and
+  * handed to the worker thread, process() returns immediately unless
+  * the ring is full. This decouples e.g. encoders and sample rate
+  * converters from the thread that renders the data, and from each other.
+  *
+  * Exceptions thrown by the outputs are passed on by the next call to
+  * process() or wait().
+  */
+template <typename T = DefaultSampleType>
+class /*LIBAUDIOGRAPHER_API*/ AsyncThreader
+  : public ListedSource<T>
+  , public Sink<T>
+{
+  public:
+
+	/** Constructor
+	  * \n NOT RT safe
+	  * \param max_samples largest number of samples passed to process()
+	  * \param n_buffers number of buffers the worker may lag behind
+	  */
+	AsyncThreader (samplecnt_t max_samples, unsigned int n_buffers = 16)
+	  : max_samples (max_samples)
+	  , write_index (0)
+	  , read_index (0)
+	  , space_sem ("async_threader_space", n_buffers)
+	  , data_sem ("async_threader_data", 0)
+	  , running (1)
+	{
+		for (unsigned int i = 0; i < n_buffers; ++i) {
+			buffers.push_back (new T[max_samples]);
+			slots.push_back (Slot ());
+		}
+
+		if (pthread_create (&thread, NULL, _thread_run, this)) {
+			cleanup ();
+			throw Exception (*this, "Cannot create thread");
+		}
+	}
+
+	~AsyncThreader ()
+	{
+		g_atomic_int_set (&running, 0);
+		data_sem.signal ();
+		pthread_join (thread, NULL);
+		cleanup ();
+	}
+
+	/// Queues the context for the outputs, blocks only if the ring is full
+	void process (ProcessContext<T> const & c)
+	{
+		throw_if_failed ();
+
+		if (c.samples() > max_samples) {
+			throw Exception (*this, boost::str (boost::format
+				("process() called with too many samples, %1% instead of %2%")
+				% c.samples() % max_samples));
+		}
+
+		space_sem.wait ();
+
+		unsigned int const n = write_index;
+		TypeUtils<T>::copy (c.data(), buffers[n], c.samples());
+		slots[n].samples  = c.samples();
+		slots[n].channels = c.channels();
+		slots[n].flags    = c.flags();
+
+		write_index = (n + 1) % buffers.size();
+		data_sem.signal ();
+	}
+
+	using Sink<T>::process;
+
+	/// Waits until all queued data has been processed by the outputs
+	void wait ()
+	{
+		/* all buffers are free once the worker is done */
+		for (size_t i = 0; i < buffers.size(); ++i) {
+			space_sem.wait ();
+		}
+		for (size_t i = 0; i < buffers.size(); ++i) {
+			space_sem.signal ();
+		}
+
+		throw_if_failed ();
+	}
+
+  private:
+
+	static void * _thread_run (void * arg)
+	{
+		static_cast<AsyncThreader *> (arg)->run ();
+		pthread_exit (0);
+		return 0;
+	}
+
+	void run ()
+	{
+		while (true) {
+			data_sem.wait ();
+
+			if (!g_atomic_int_get (&running)) {
+				break;
+			}
+
+			unsigned int const n = read_index;
+
+			if (!exception) {
+				ProcessContext<T> c (buffers[n], slots[n].samples, slots[n].channels);
+				for (FlagField::iterator f = slots[n].flags.begin(); f != slots[n].flags.end(); ++f) {
+					c.set_flag (*f);
+				}
+
+				try {
+					ListedSource<T>::output (c);
+				} catch (std::exception const & e) {
+					Glib::Threads::Mutex::Lock lm (exception_mutex);
+					exception.reset (new ThreaderException (*this, e));
+				}
+			}
+
+			read_index = (n + 1) % buffers.size();
+			space_sem.signal ();
+		}
+	}
+
+	void throw_if_failed ()
+	{
+		Glib::Threads::Mutex::Lock lm (exception_mutex);
+		if (exception) {
+			throw *exception;
+		}
+	}
+
+	void cleanup ()
+	{
+		for (typename std::vector<T *>::iterator i = buffers.begin(); i != buffers.end(); ++i) {
+			delete [] *i;
+		}
+		buffers.clear ();
+	}
+
+	/// What is needed to recreate the context of a buffer
+	struct Slot {
+		Slot () : samples (0), channels (1) {}
+		samplecnt_t  samples;
+		ChannelCount channels;
+		FlagField    flags;
+	};
+
+	samplecnt_t max_samples;
+
+	std::vector<T *>                 buffers;
+	std::vector<Slot>                slots;
+	unsigned int                     write_index;
+	unsigned int                     read_index;
+
+	PBD::Semaphore space_sem;
+	PBD::Semaphore data_sem;
+	gint           running;
+	pthread_t      thread;
+
+	Glib::Threads::Mutex exception_mutex;
+	boost::shared_ptr<ThreaderException> exception;
+};
+
+} // namespace
+
+#endif //AUDIOGRAPHER_ASYNC_THREADER_H
@@ -47,6 +47,8 @@ class LIBAUDIOGRAPHER_API LoudnessReader : public ListedSource<float>, public Si
 	using Sink<float>::process;
 
   protected:
+	void measure ();
+
 	Vamp::Plugin*  _ebur_plugin;
 	Vamp::Plugin** _dbtp_plugin;
 
@@ -55,6 +57,12 @@ class LIBAUDIOGRAPHER_API LoudnessReader : public ListedSource<float>, public Si
 	samplecnt_t   _bufsize;
 	samplecnt_t   _pos;
 	float*       _bufs[2];
+
+	bool         _measured;
+	float        _lufs;
+	float        _dbtp;
+	bool         _have_lufs;
+	bool         _have_dbtp;
 };
 
 } // namespace
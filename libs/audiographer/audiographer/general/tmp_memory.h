@@ -0,0 +1,150 @@
+#ifndef AUDIOGRAPHER_TMP_MEMORY_H
+#define AUDIOGRAPHER_TMP_MEMORY_H
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "pbd/signals.h"
+
+#include "audiographer/visibility.h"
+#include "audiographer/flag_debuggable.h"
+#include "audiographer/throwing.h"
+#include "audiographer/sink.h"
+#include "audiographer/type_utils.h"
+#include "audiographer/utils/listed_source.h"
+
+namespace AudioGrapher
+{
+
+/** In-memory counterpart of TmpFile: stores everything written to it
+  * and plays it back to its outputs with read().
+  *
+  * Data is kept in fixed size blocks, writing never moves data that
+  * has already been stored. Blocks for \a reserve samples are allocated
+  * up front, more are added when needed.
+  */
+template<typename T = DefaultSampleType>
+class /*LIBAUDIOGRAPHER_API*/ TmpMemory
+  : public ListedSource<T>
+  , public Sink<T>
+  , public Throwing<>
+  , public FlagDebuggable<>
+{
+  public:
+	/** Constructor
+	  * \n NOT RT safe
+	  * \param channels number of interleaved channels
+	  * \param reserve number of samples (for all channels) to allocate in advance
+	  */
+	TmpMemory (ChannelCount channels, samplecnt_t reserve = 0)
+	  : _channels (channels)
+	  , _samples_written (0)
+	  , _read_position (0)
+	{
+		add_supported_flag (ProcessContext<T>::EndOfInput);
+		while ((samplecnt_t) _blocks.size() * block_size < reserve) {
+			_blocks.push_back (new T[block_size]);
+		}
+	}
+
+	~TmpMemory ()
+	{
+		for (typename std::vector<T *>::iterator i = _blocks.begin(); i != _blocks.end(); ++i) {
+			delete [] *i;
+		}
+	}
+
+	samplecnt_t get_samples_written () const { return _samples_written; }
+
+	/// Stores data, RT safe as long as it fits in the reserved space
+	void process (ProcessContext<T> const & c)
+	{
+		check_flags (*this, c);
+
+		if (throw_level (ThrowStrict) && c.channels() != _channels) {
+			throw Exception (*this, boost::str (boost::format
+				("Wrong number of channels given to process(), %1% instead of %2%")
+				% c.channels() % _channels));
+		}
+
+		T const * data = c.data();
+		samplecnt_t remain = c.samples();
+
+		while (remain > 0) {
+			size_t const block = _samples_written / block_size;
+			samplecnt_t const offset = _samples_written % block_size;
+
+			if (block == _blocks.size()) {
+				_blocks.push_back (new T[block_size]);
+			}
+
+			samplecnt_t const n = std::min (remain, block_size - offset);
+			TypeUtils<T>::copy (data, &_blocks[block][offset], n);
+
+			data += n;
+			remain -= n;
+			_samples_written += n;
+		}
+
+		if (c.has_flag (ProcessContext<T>::EndOfInput)) {
+			Written ();
+		}
+	}
+
+	using Sink<T>::process;
+
+	/// Restarts reading at the beginning of the stored data
+	void rewind () { _read_position = 0; }
+
+	/** Read data into buffer in \a context, only the data is modified (not sample count)
+	 *  Note that the data read is output to the outputs, as well as read into the context
+	 *  \return number of samples read
+	 */
+	samplecnt_t read (ProcessContext<T> & context)
+	{
+		if (throw_level (ThrowStrict) && context.channels() != _channels) {
+			throw Exception (*this, boost::str (boost::format
+				("Wrong number of channels given to read(), %1% instead of %2%")
+				% context.channels() % _channels));
+		}
+
+		samplecnt_t const samples_read = std::min (context.samples(), _samples_written - _read_position);
+		samplecnt_t done = 0;
+
+		while (done < samples_read) {
+			size_t const block = _read_position / block_size;
+			samplecnt_t const offset = _read_position % block_size;
+			samplecnt_t const n = std::min (samples_read - done, block_size - offset);
+
+			TypeUtils<T>::copy (&_blocks[block][offset], &context.data()[done], n);
+
+			done += n;
+			_read_position += n;
+		}
+
+		ProcessContext<T> c_out = context.beginning (samples_read);
+
+		if (samples_read < context.samples()) {
+			c_out.set_flag (ProcessContext<T>::EndOfInput);
+		}
+		this->output (c_out);
+		return samples_read;
+	}
+
+	/// Emitted when the EndOfInput flag has been processed
+	PBD::Signal0<void> Written;
+
+  private:
+	static const samplecnt_t block_size = 1048576;
+
+	ChannelCount     _channels;
+	std::vector<T *> _blocks;
+	samplecnt_t      _samples_written;
+	samplecnt_t      _read_position;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_TMP_MEMORY_H
@@ -28,6 +28,11 @@ LoudnessReader::LoudnessReader (float sample_rate, unsigned int channels, sample
 	, _channels (channels)
 	, _bufsize (bufsize / channels)
 	, _pos (0)
+	, _measured (false)
+	, _lufs (-200)
+	, _dbtp (0)
+	, _have_lufs (false)
+	, _have_dbtp (false)
 {
 	//printf ("NEW LoudnessReader %p r:%.1f c:%d f:%ld\n", this, sample_rate, channels, bufsize);
 	assert (bufsize % channels == 0);
@@ -77,6 +82,8 @@ LoudnessReader::~LoudnessReader ()
 void
 LoudnessReader::reset ()
 {
+	_measured = false;
+
 	if (_ebur_plugin) {
 		_ebur_plugin->reset ();
 	}
@@ -141,9 +148,17 @@ LoudnessReader::process (ProcessContext<float> const & ctx)
 	ListedSource<float>::output (ctx);
 }
 
-float
-LoudnessReader::get_normalize_gain (float target_lufs, float target_dbtp)
+void
+LoudnessReader::measure ()
 {
+	/* the plugins' remaining features can only be retrieved once,
+	 * keep them so that several targets can be computed
+	 */
+	if (_measured) {
+		return;
+	}
+	_measured = true;
+
 	float dBTP = 0;
 	float LUFS = -200;
 	uint32_t have_lufs = 0;
@@ -169,19 +184,30 @@ LoudnessReader::get_normalize_gain (float target_lufs, float target_dbtp)
 		}
 	}
 
+	_lufs = LUFS;
+	_dbtp = dBTP;
+	_have_lufs = have_lufs > 0;
+	_have_dbtp = have_dbtp > 0;
+}
+
+float
+LoudnessReader::get_normalize_gain (float target_lufs, float target_dbtp)
+{
+	measure ();
+
 	float g = 100000.0; // +100dB
 	bool set = false;
-	if (have_lufs && LUFS > -180.0f && target_lufs <= 0.f) {
-		const float ge = pow (10.f, (target_lufs * 0.05f)) / pow (10.f, (LUFS * 0.05f));
-		//printf ("LU: %f LUFS, %f\n", LUFS, ge);
+	if (_have_lufs && _lufs > -180.0f && target_lufs <= 0.f) {
+		const float ge = pow (10.f, (target_lufs * 0.05f)) / pow (10.f, (_lufs * 0.05f));
+		//printf ("LU: %f LUFS, %f\n", _lufs, ge);
 		g = std::min (g, ge);
 		set = true;
 	}
 
 	// TODO check that all channels were used.. ? (have_dbtp == _channels)
-	if (have_dbtp && dBTP > 0.f && target_dbtp <= 0.f) {
-		const float ge = pow (10.f, (target_dbtp * 0.05f)) / dBTP;
-		//printf ("TP:(%d chn) %fdBTP -> %f\n", have_dbtp, dBTP, ge);
+	if (_have_dbtp && _dbtp > 0.f && target_dbtp <= 0.f) {
+		const float ge = pow (10.f, (target_dbtp * 0.05f)) / _dbtp;
+		//printf ("TP: %fdBTP -> %f\n", _dbtp, ge);
 		g = std::min (g, ge);
 		set = true;
 	}
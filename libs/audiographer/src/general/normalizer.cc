@@ -68,11 +68,15 @@ void Normalizer::process (ProcessContext<float> const & c)
 		throw Exception (*this, "Too many samples given to process()");
 	}
 
-	if (enabled) {
-		memcpy (buffer, c.data(), c.samples() * sizeof(float));
-		Routines::apply_gain_to_buffer (buffer, c.samples(), gain);
+	if (!enabled) {
+		/* nothing to do, the buffer was not written to */
+		ListedSource<float>::output (c);
+		return;
 	}
 
+	memcpy (buffer, c.data(), c.samples() * sizeof(float));
+	Routines::apply_gain_to_buffer (buffer, c.samples(), gain);
+
 	ProcessContext<float> c_out (c, buffer);
 	ListedSource<float>::output (c_out);
 }
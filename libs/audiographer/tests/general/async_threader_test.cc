@@ -0,0 +1,110 @@
+#include "tests/utils.h"
+
+#include "audiographer/general/async_threader.h"
+
+using namespace AudioGrapher;
+
+class AsyncThreaderTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (AsyncThreaderTest);
+  CPPUNIT_TEST (testProcess);
+  CPPUNIT_TEST (testRingFull);
+  CPPUNIT_TEST (testFlags);
+  CPPUNIT_TEST (testExceptions);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		samples = 128;
+		random_data = TestUtils::init_random_data (samples * 64, 1.0);
+
+		threader.reset (new AsyncThreader<float> (samples, 4));
+		sink_a.reset (new AppendingVectorSink<float>());
+		sink_b.reset (new AppendingVectorSink<float>());
+		throwing_sink.reset (new ThrowingSink<float>());
+	}
+
+	void tearDown()
+	{
+		threader.reset ();
+		delete [] random_data;
+	}
+
+	void testProcess()
+	{
+		threader->add_output (sink_a);
+		threader->add_output (sink_b);
+
+		ProcessContext<float> c (random_data, samples, 1);
+		threader->process (c);
+		threader->wait ();
+
+		CPPUNIT_ASSERT_EQUAL (samples, (samplecnt_t) sink_a->get_data().size());
+		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_a->get_array(), samples));
+		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_b->get_array(), samples));
+	}
+
+	void testRingFull()
+	{
+		threader->add_output (sink_a);
+
+		/* more cycles than buffers, the data is copied so the
+		 * input may change as soon as process() returns.
+		 */
+		float * data = new float[samples];
+		for (unsigned int i = 0; i < 64; ++i) {
+			memcpy (data, &random_data[i * samples], samples * sizeof (float));
+			ProcessContext<float> c (data, samples, 1);
+			threader->process (c);
+			memset (data, 0, samples * sizeof (float));
+		}
+		threader->wait ();
+		delete [] data;
+
+		CPPUNIT_ASSERT_EQUAL (samples * 64, (samplecnt_t) sink_a->get_data().size());
+		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_a->get_array(), samples * 64));
+	}
+
+	void testFlags()
+	{
+		boost::shared_ptr<ProcessContextGrabber<float> > grabber (new ProcessContextGrabber<float>());
+		threader->add_output (grabber);
+
+		ProcessContext<float> c (random_data, samples, 2);
+		threader->process (c);
+		c.set_flag (ProcessContext<float>::EndOfInput);
+		threader->process (c.beginning (samples / 2));
+		threader->wait ();
+
+		CPPUNIT_ASSERT_EQUAL ((size_t) 2, grabber->contexts.size());
+		CPPUNIT_ASSERT_EQUAL ((ChannelCount) 2, grabber->contexts.front().channels());
+		CPPUNIT_ASSERT (!grabber->contexts.front().has_flag (ProcessContext<float>::EndOfInput));
+		CPPUNIT_ASSERT_EQUAL (samples / 2, grabber->contexts.back().samples());
+		CPPUNIT_ASSERT (grabber->contexts.back().has_flag (ProcessContext<float>::EndOfInput));
+	}
+
+	void testExceptions()
+	{
+		threader->add_output (sink_a);
+		threader->add_output (throwing_sink);
+
+		ProcessContext<float> c (random_data, samples, 1);
+		threader->process (c);
+		CPPUNIT_ASSERT_THROW (threader->wait (), Exception);
+		CPPUNIT_ASSERT_THROW (threader->process (c), Exception);
+
+		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_a->get_array(), samples));
+	}
+
+  private:
+	boost::shared_ptr<AsyncThreader<float> > threader;
+	boost::shared_ptr<AppendingVectorSink<float> > sink_a;
+	boost::shared_ptr<AppendingVectorSink<float> > sink_b;
+	boost::shared_ptr<ThrowingSink<float> > throwing_sink;
+
+	float * random_data;
+	samplecnt_t samples;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AsyncThreaderTest);
@@ -9,6 +9,7 @@ class NormalizerTest : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE (NormalizerTest);
   CPPUNIT_TEST (testConstAmplify);
+  CPPUNIT_TEST (testConstPassThrough);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -48,6 +49,24 @@ class NormalizerTest : public CppUnit::TestFixture
 		CPPUNIT_ASSERT (-FLT_EPSILON <= (peak - 1.0) && (peak - 1.0) <= 0.0);
 	}
 
+	void testConstPassThrough()
+	{
+		random_data = TestUtils::init_random_data(samples, 0.5);
+
+		normalizer.reset (new Normalizer(0.0));
+		sink.reset (new VectorSink<float>());
+
+		// silence disables normalization, data must be passed on unmodified
+		ProcessContext<float> const c (random_data, samples, 1);
+		normalizer->alloc_buffer (samples);
+		normalizer->set_peak (0.0);
+		normalizer->add_output (sink);
+		normalizer->process (c);
+
+		CPPUNIT_ASSERT_EQUAL (samples, (samplecnt_t) sink->get_data().size());
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, sink->get_array(), samples));
+	}
+
   private:
 	boost::shared_ptr<Normalizer> normalizer;
 	boost::shared_ptr<PeakReader> peak_reader;
@@ -0,0 +1,108 @@
+#include "tests/utils.h"
+
+#include "audiographer/general/tmp_memory.h"
+
+using namespace AudioGrapher;
+
+class TmpMemoryTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (TmpMemoryTest);
+  CPPUNIT_TEST (testProcess);
+  CPPUNIT_TEST (testBlockBoundaries);
+  CPPUNIT_TEST (testEndOfInput);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		samples = 128;
+		random_data = TestUtils::init_random_data(samples);
+	}
+
+	void tearDown()
+	{
+		delete [] random_data;
+	}
+
+	void testProcess()
+	{
+		uint32_t channels = 2;
+		memory.reset (new TmpMemory<float>(channels, samples));
+		AllocatingProcessContext<float> c (random_data, samples, channels);
+		c.set_flag (ProcessContext<float>::EndOfInput);
+		memory->process (c);
+		CPPUNIT_ASSERT_EQUAL (samples, memory->get_samples_written());
+
+		TypeUtils<float>::zero_fill (c.data (), c.samples());
+
+		memory->rewind ();
+		memory->read (c);
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, c.data(), c.samples()));
+	}
+
+	void testBlockBoundaries()
+	{
+		// Write and read in chunks that do not line up with the internal blocks
+		samplecnt_t const total = 2500000;
+		samplecnt_t const chunk = 300001;
+		float * data = TestUtils::init_random_data (total);
+
+		memory.reset (new TmpMemory<float>(1));
+		for (samplecnt_t pos = 0; pos < total; pos += chunk) {
+			ProcessContext<float> const c (&data[pos], std::min (chunk, total - pos), 1);
+			memory->process (c);
+		}
+		CPPUNIT_ASSERT_EQUAL (total, memory->get_samples_written());
+
+		sink.reset (new AppendingVectorSink<float>());
+		memory->add_output (sink);
+
+		AllocatingProcessContext<float> c (chunk, 1);
+		while (memory->read (c) == c.samples()) {}
+
+		CPPUNIT_ASSERT_EQUAL (total, (samplecnt_t) sink->get_data().size());
+		CPPUNIT_ASSERT (TestUtils::array_equals (data, sink->get_array(), total));
+		delete [] data;
+	}
+
+	void testEndOfInput()
+	{
+		written = false;
+		memory.reset (new TmpMemory<float>(1));
+		memory->Written.connect_same_thread (connection, boost::bind (&TmpMemoryTest::set_written, this));
+
+		ProcessContext<float> c (random_data, samples, 1);
+		memory->process (c);
+		CPPUNIT_ASSERT (!written);
+
+		c.set_flag (ProcessContext<float>::EndOfInput);
+		memory->process (c);
+		CPPUNIT_ASSERT (written);
+
+		boost::shared_ptr<ProcessContextGrabber<float> > grabber (new ProcessContextGrabber<float>());
+		memory->add_output (grabber);
+
+		AllocatingProcessContext<float> out (samples, 1);
+		CPPUNIT_ASSERT_EQUAL (samples, memory->read (out));
+		CPPUNIT_ASSERT (!grabber->contexts.begin()->has_flag (ProcessContext<float>::EndOfInput));
+
+		// last read is short and flagged
+		AllocatingProcessContext<float> last (2 * samples, 1);
+		CPPUNIT_ASSERT_EQUAL (samples, memory->read (last));
+		CPPUNIT_ASSERT_EQUAL (samples, (++grabber->contexts.begin())->samples());
+		CPPUNIT_ASSERT ((++grabber->contexts.begin())->has_flag (ProcessContext<float>::EndOfInput));
+	}
+
+  private:
+	void set_written () { written = true; }
+
+	boost::shared_ptr<TmpMemory<float> > memory;
+	boost::shared_ptr<AppendingVectorSink<float> > sink;
+	PBD::ScopedConnection connection;
+	bool written;
+
+	float * random_data;
+	samplecnt_t samples;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TmpMemoryTest);
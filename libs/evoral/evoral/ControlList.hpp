@@ -19,8 +19,10 @@
 #ifndef EVORAL_CONTROL_LIST_HPP
 #define EVORAL_CONTROL_LIST_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -28,6 +30,7 @@
 
 #include <glibmm/threads.h>
 
+#include "pbd/rcu.h"
 #include "pbd/signals.h"
 
 #include "evoral/visibility.h"
@@ -218,38 +221,80 @@ public:
 	 */
 	double rt_safe_eval (double where, bool& ok) const {
 
+		boost::shared_ptr<const RenderedCurve> r (rendered ());
+		if (r) {
+			ok = true;
+			return r->eval (where);
+		}
+
 		Glib::Threads::RWLock::ReaderLock lm (_lock, Glib::Threads::TRY_LOCK);
 
-		if ((ok = lm.locked())) {
-			return unlocked_eval (where);
-		} else {
-			return 0.0;
+		if (lm.locked()) {
+			boost::shared_ptr<const FlatEvents> ev (rt_flat_events ());
+			if (ev) {
+				ok = true;
+				return unlocked_eval (*ev, where);
+			}
 		}
+
+		ok = false;
+		return 0.0;
 	}
 
 	static inline bool time_comparator (const ControlEvent* a, const ControlEvent* b) {
 		return a->when < b->when;
 	}
 
-	/** Lookup cache for eval functions, range contains equivalent values */
-	struct LookupCache {
-		LookupCache() : left(-1) {}
-		double left;  /* leftmost x coordinate used when finding "range" */
-		std::pair<ControlList::const_iterator,ControlList::const_iterator> range;
+	/** Contiguous (structure-of-arrays) copy of the events.
+	 *
+	 * The read paths (eval, Curve, rt_safe_earliest_event) use this
+	 * instead of the list: lookups are binary searches over the
+	 * sorted times, and consecutive points are adjacent in memory.
+	 * It is published via RCU: the writer side rebuilds it along with
+	 * the rendered curve, and readers that hold the lock rebuild it if
+	 * it is out of date. The process thread never does (see
+	 * rt_flat_events()).
+	 */
+	struct FlatEvents {
+		FlatEvents () : generation (-1) {}
+
+		gint                             generation; ///< of the list when built
+		std::vector<double>              when;
+		std::vector<double>              value;
+		std::vector<const ControlEvent*> event;
+
+		size_t size () const { return when.size (); }
+
+		/** @return index of the first event at or after @param x */
+		size_t lower_bound (double x, size_t from = 0) const {
+			return std::lower_bound (when.begin () + from, when.end (), x) - when.begin ();
+		}
 	};
 
-	/** Lookup cache for point finding, range contains points after left */
+	/** Lookup cache for point finding, index of the first point after left */
 	struct SearchCache {
-		SearchCache () : left(-1) {}
+		SearchCache () : left(-1), first (0) {}
 		double left;  /* leftmost x coordinate used when finding "first" */
-		ControlList::const_iterator first;
+		size_t first; /* index in flat_events(), size() if none */
 	};
 
 	const EventList& events() const { return _events; }
 
+	/** @return the contiguous copy of the events, rebuilt if the list
+	 * changed since it was published. The caller must hold (at least) a
+	 * read-lock, and must not be the process thread.
+	 */
+	boost::shared_ptr<const FlatEvents> flat_events () const;
+
+	/** @return the published contiguous copy of the events if it is up to
+	 * date with the list, or an empty pointer. Never rebuilds the copy, so
+	 * it is safe to call from the process thread. The caller must hold
+	 * (at least) a read-lock.
+	 */
+	boost::shared_ptr<const FlatEvents> rt_flat_events () const;
+
 	// FIXME: const violations for Curve
 	Glib::Threads::RWLock& lock()       const { return _lock; }
-	LookupCache& lookup_cache() const { return _lookup_cache; }
 	SearchCache& search_cache() const { return _search_cache; }
 
 	/** Called by locked entry point and various private
@@ -298,6 +343,55 @@ public:
 	 */
 	bool set_interpolation (InterpolationStyle is);
 
+	/** The events of the list, rendered for the process thread.
+	 *
+	 * A copy of the list that is published via RCU after every change
+	 * (when frozen, at thaw; when recording, once the touch or the write
+	 * pass ends), so that it can be read without taking the lock. Runs
+	 * of points that do not change the shape of the curve (a constant
+	 * value, or points on a straight line for Linear interpolation) are
+	 * merged, which leaves one segment per run to fill and to split a
+	 * cycle at.
+	 */
+	class LIBEVORAL_API RenderedCurve {
+	public:
+		RenderedCurve () : generation (-1), interpolation (Linear), lower (0), upper (1), normal (0) {}
+
+		size_t size () const { return when.size (); }
+
+		/** @return the value at @param x, as ControlList::unlocked_eval() */
+		double eval (double x) const;
+
+		/** Fill @param vec with @param veclen values from @param x0 to
+		 * @param x1, as Curve::get_vector().
+		 */
+		void get_vector (double x0, double x1, float* vec, int32_t veclen) const;
+
+		/** @return true if there is a point after @param start and before
+		 * @param end, whose time is stored in @param when.
+		 */
+		bool next_event (double start, double end, double& when) const;
+
+	private:
+		friend class ControlList;
+
+		void fill_segment (size_t s, double lx, double dx, float* vec, int32_t from, int32_t to) const;
+
+		gint                generation; ///< of the list when rendered
+		InterpolationStyle  interpolation;
+		double              lower;
+		double              upper;
+		double              normal;
+		std::vector<double> when;
+		std::vector<double> value;
+	};
+
+	/** @return the rendered curve if it is up to date with the list, or
+	 * an empty pointer (in which case the caller must fall back to the
+	 * locked methods). Lists with Curved interpolation are never rendered.
+	 */
+	boost::shared_ptr<const RenderedCurve> rendered () const;
+
 	virtual bool touching() const { return false; }
 	virtual bool writing() const { return false; }
 	virtual bool touch_enabled() const { return false; }
@@ -319,10 +413,16 @@ public:
 
 protected:
 
+	double unlocked_eval (FlatEvents const&, double x) const;
+
 	/** Called by unlocked_eval() to handle cases of 3 or more control points. */
-	double multipoint_eval (double x) const;
+	double multipoint_eval (FlatEvents const&, double x) const;
+
+	void build_search_cache_if_necessary (FlatEvents const&, double start) const;
 
-	void build_search_cache_if_necessary (double start) const;
+	bool rt_safe_earliest_event_unlocked (FlatEvents const&, double start, double& x, double& y, bool inclusive) const;
+	bool rt_safe_earliest_event_linear_unlocked (FlatEvents const&, double start, double& x, double& y, bool inclusive) const;
+	bool rt_safe_earliest_event_discrete_unlocked (FlatEvents const&, double start, double& x, double& y, bool inclusive) const;
 
 	boost::shared_ptr<ControlList> cut_copy_clear (double, double, int op);
 	bool erase_range_internal (double start, double end, EventList &);
@@ -333,9 +433,13 @@ protected:
 
 	virtual void maybe_signal_changed ();
 
+	/** Publish a new rendered curve if the list changed since the last
+	 * one. Must be called without holding the lock.
+	 */
+	void update_rendered ();
+
 	void _x_scale (double factor);
 
-	mutable LookupCache   _lookup_cache;
 	mutable SearchCache   _search_cache;
 
 	mutable Glib::Threads::RWLock _lock;
@@ -357,6 +461,11 @@ private:
 	bool       did_write_during_pass;
 	bool       _in_write_pass;
 
+	mutable SerializedRCUManager<FlatEvents> _flat;
+
+	mutable gint                        _generation;
+	SerializedRCUManager<RenderedCurve> _rendered;
+
 	void unlocked_remove_duplicates ();
 	void unlocked_invalidate_insert_iterator ();
 	void add_guard_point (double when, double offset);
@@ -23,11 +23,10 @@
 #include <boost/utility.hpp>
 
 #include "evoral/visibility.h"
+#include "evoral/ControlList.hpp"
 
 namespace Evoral {
 
-class ControlList;
-
 class LIBEVORAL_API Curve : public boost::noncopyable
 {
 public:
@@ -41,9 +40,9 @@ public:
 	void mark_dirty() const { _dirty = true; }
 
 private:
-	double multipoint_eval (double x) const;
+	double multipoint_eval (ControlList::FlatEvents const&, double x, size_t& next) const;
 
-	void _get_vector (double x0, double x1, float *arg, int32_t veclen) const;
+	void _get_vector (ControlList::FlatEvents const&, double x0, double x1, float *arg, int32_t veclen) const;
 
 	mutable bool       _dirty;
 	const ControlList& _list;
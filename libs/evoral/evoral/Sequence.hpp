@@ -237,6 +237,16 @@ public:
 
 		const const_iterator& operator++(); // prefix only
 
+		/** @return the note the current event is the on or off event of,
+		 * or a null pointer if it is not a note event.
+		 */
+		NotePtr note() const;
+
+		/** @return the parameter of the controller the current event was
+		 * generated from, or 0 if it is not a controller event.
+		 */
+		const Parameter* control_parameter() const;
+
 		bool operator==(const const_iterator& other) const;
 		bool operator!=(const const_iterator& other) const { return ! operator==(other); }
 
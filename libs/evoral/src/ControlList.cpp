@@ -59,14 +59,13 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 	, _desc(desc)
 	, _interpolation (default_interpolation ())
 	, _curve(0)
+	, _flat (new FlatEvents)
+	, _rendered (new RenderedCurve)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
-	_lookup_cache.left = -1;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
 	_search_cache.left = -1;
-	_search_cache.first = _events.end();
+	_generation = 0;
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -80,12 +79,12 @@ ControlList::ControlList (const ControlList& other)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
+	, _flat (new FlatEvents)
+	, _rendered (new RenderedCurve)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
+	_generation = 0;
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -102,12 +101,12 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
+	, _flat (new FlatEvents)
+	, _rendered (new RenderedCurve)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
+	_generation = 0;
 	_sort_pending = false;
 
 	/* now grab the relevant points, and shift them back if necessary */
@@ -126,6 +125,7 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	most_recent_insert_iterator = _events.end();
 
 	mark_dirty ();
+	update_rendered ();
 }
 
 ControlList::~ControlList()
@@ -225,6 +225,12 @@ ControlList::maybe_signal_changed ()
 
 	if (_frozen) {
 		_changed_when_thawed = true;
+	} else if (_in_write_pass && (writing () || touching ())) {
+		/* points are added every few ms while recording, and nothing
+		 * plays the list back: render once the touch or the pass ends.
+		 */
+	} else {
+		update_rendered ();
 	}
 }
 
@@ -247,19 +253,29 @@ ControlList::clear ()
 void
 ControlList::x_scale (double factor)
 {
-	Glib::Threads::RWLock::WriterLock lm (_lock);
-	_x_scale (factor);
+	{
+		Glib::Threads::RWLock::WriterLock lm (_lock);
+		_x_scale (factor);
+	}
+	if (!_frozen) {
+		update_rendered ();
+	}
 }
 
 bool
 ControlList::extend_to (double when)
 {
-	Glib::Threads::RWLock::WriterLock lm (_lock);
-	if (_events.empty() || _events.back()->when == when) {
-		return false;
+	{
+		Glib::Threads::RWLock::WriterLock lm (_lock);
+		if (_events.empty() || _events.back()->when == when) {
+			return false;
+		}
+		double factor = when / _events.back()->when;
+		_x_scale (factor);
+	}
+	if (!_frozen) {
+		update_rendered ();
 	}
-	double factor = when / _events.back()->when;
-	_x_scale (factor);
 	return true;
 }
 
@@ -412,7 +428,10 @@ void
 ControlList::fast_simple_add (double when, double value)
 {
 	Glib::Threads::RWLock::WriterLock lm (_lock);
-	/* to be used only for loading pre-sorted data from saved state */
+	/* to be used only for loading pre-sorted data from saved state.
+	 * This only marks the published copies stale: callers that add
+	 * points in bulk freeze the list, and publish once at thaw().
+	 */
 	_events.insert (_events.end(), new ControlEvent (when, value));
 
 	mark_dirty ();
@@ -494,6 +513,8 @@ ControlList::write_pass_finished (double /*when*/, double thinning_factor)
 	}
 	new_write_pass = true;
 	_in_write_pass = false;
+
+	update_rendered ();
 }
 
 void
@@ -507,6 +528,8 @@ ControlList::set_in_write_pass (bool yn, bool add_point, double when)
 		Glib::Threads::RWLock::WriterLock lm (_lock);
 		add_guard_point (when, 0);
 	}
+
+	update_rendered ();
 }
 
 void
@@ -546,7 +569,23 @@ ControlList::add_guard_point (double when, double offset)
 	ControlEvent cp (when, 0.0);
 	most_recent_insert_iterator = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
 
-	double eval_value = unlocked_eval (when);
+	/* evaluate from the points either side of the guard point, the
+	 * flat copy may be stale (the caller may have added points already,
+	 * without mark_dirty()) and rebuilding it here is O(n).
+	 */
+	FlatEvents around;
+	if (most_recent_insert_iterator != _events.begin ()) {
+		iterator b = most_recent_insert_iterator;
+		--b;
+		around.when.push_back ((*b)->when);
+		around.value.push_back ((*b)->value);
+	}
+	if (most_recent_insert_iterator != _events.end ()) {
+		around.when.push_back ((*most_recent_insert_iterator)->when);
+		around.value.push_back ((*most_recent_insert_iterator)->value);
+	}
+
+	double eval_value = unlocked_eval (around, when);
 
 	if (most_recent_insert_iterator == _events.end()) {
 
@@ -586,6 +625,12 @@ ControlList::add_guard_point (double when, double offset)
 
 		++most_recent_insert_iterator;
 	}
+
+	/* the published copies are stale now, they are rebuilt once the
+	 * caller is done (maybe_signal_changed() or update_rendered()).
+	 */
+	_search_cache.left = -1;
+	g_atomic_int_inc (&_generation);
 }
 
 bool
@@ -1132,18 +1177,18 @@ ControlList::thaw ()
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
+			mark_dirty ();
 		}
 	}
+
+	update_rendered ();
 }
 
 void
 ControlList::mark_dirty () const
 {
-	_lookup_cache.left = -1;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
 	_search_cache.left = -1;
-	_search_cache.first = _events.end();
+	g_atomic_int_inc (&_generation);
 
 	if (_curve) {
 		_curve->mark_dirty();
@@ -1152,6 +1197,360 @@ ControlList::mark_dirty () const
 	Dirty (); /* EMIT SIGNAL */
 }
 
+boost::shared_ptr<const ControlList::FlatEvents>
+ControlList::flat_events () const
+{
+	boost::shared_ptr<const FlatEvents> ev (_flat.reader ());
+	const gint generation = g_atomic_int_get (&_generation);
+
+	if (ev->generation == generation) {
+		return ev;
+	}
+
+	/* readers share the lock, so more than one of them may rebuild the
+	 * copy, the RCU manager serializes publishing it. Writers (which
+	 * change the generation) hold the lock exclusively.
+	 */
+	boost::shared_ptr<FlatEvents> f = _flat.write_new ();
+
+	f->generation = generation;
+	f->when.reserve (_events.size ());
+	f->value.reserve (_events.size ());
+	f->event.reserve (_events.size ());
+
+	for (const_iterator i = _events.begin(); i != _events.end(); ++i) {
+		f->when.push_back ((*i)->when);
+		f->value.push_back ((*i)->value);
+		f->event.push_back (*i);
+	}
+
+	_flat.update (f);
+
+	return f;
+}
+
+boost::shared_ptr<const ControlList::FlatEvents>
+ControlList::rt_flat_events () const
+{
+	boost::shared_ptr<const FlatEvents> ev (_flat.reader ());
+
+	if (ev->generation != g_atomic_int_get (&_generation)) {
+		return boost::shared_ptr<const FlatEvents> ();
+	}
+
+	return ev;
+}
+
+/** Points on a straight line (Linear interpolation) are merged in the
+ * rendered curve if they are within this fraction of the parameter range
+ * of the line, which is about the resolution of a float.
+ */
+static const double rendered_tolerance = 1e-7;
+
+void
+ControlList::update_rendered ()
+{
+	if (_rendered.reader ()->generation == g_atomic_int_get (&_generation)) {
+		return;
+	}
+
+	/* this serializes writers, so that an older rendering can not replace
+	 * a newer one.
+	 */
+	boost::shared_ptr<RenderedCurve> r = _rendered.write_new ();
+
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_lock);
+
+		/* this also publishes the flat copy for the process thread */
+		boost::shared_ptr<const FlatEvents> ev (flat_events ());
+
+		r->generation    = ev->generation;
+		r->interpolation = _interpolation;
+		r->lower         = _desc.lower;
+		r->upper         = _desc.upper;
+		r->normal        = _desc.normal;
+
+		if (_interpolation == Curved) {
+			/* x-fades, not used in the process thread */
+			r->generation = -1;
+		} else {
+			const double tol = rendered_tolerance * (_desc.upper - _desc.lower);
+			/* range of slopes from the next to last point, for which a
+			 * line passes all points that were merged into the last one
+			 */
+			double lo = 1;
+			double hi = -1;
+
+			r->when.reserve (ev->size ());
+			r->value.reserve (ev->size ());
+
+			for (size_t i = 0; i < ev->size (); ++i) {
+				const double x = ev->when[i];
+				const double y = ev->value[i];
+				const size_t n = r->when.size ();
+
+				if (n >= 2 && x > r->when[n - 2]) {
+					const double ax = r->when[n - 2];
+					const double ay = r->value[n - 2];
+					bool merge;
+
+					switch (_interpolation) {
+					case Discrete:
+						/* the last point does not change the value */
+						merge = (r->value[n - 1] == ay);
+						break;
+					case Linear:
+						merge = ((y - ay) / (x - ax) >= lo && (y - ay) / (x - ax) <= hi);
+						break;
+					default:
+						merge = (r->value[n - 1] == ay && y == ay);
+						break;
+					}
+
+					if (merge) {
+						/* replace the last point */
+						r->when[n - 1] = x;
+						r->value[n - 1] = y;
+						lo = max (lo, (y - tol - ay) / (x - ax));
+						hi = min (hi, (y + tol - ay) / (x - ax));
+						continue;
+					}
+				}
+
+				r->when.push_back (x);
+				r->value.push_back (y);
+
+				if (n >= 1 && x > r->when[n - 1]) {
+					lo = (y - tol - r->value[n - 1]) / (x - r->when[n - 1]);
+					hi = (y + tol - r->value[n - 1]) / (x - r->when[n - 1]);
+				} else {
+					lo = 1;
+					hi = -1;
+				}
+			}
+		}
+	}
+
+	_rendered.update (r);
+}
+
+boost::shared_ptr<const ControlList::RenderedCurve>
+ControlList::rendered () const
+{
+	boost::shared_ptr<const RenderedCurve> r (_rendered.reader ());
+
+	if (r->generation != g_atomic_int_get (&_generation)) {
+		return boost::shared_ptr<const RenderedCurve> ();
+	}
+
+	return r;
+}
+
+double
+ControlList::RenderedCurve::eval (double x) const
+{
+	const size_t npoints = when.size ();
+
+	if (npoints == 0) {
+		return normal;
+	}
+
+	if (npoints == 1 || x <= when.front ()) {
+		return value.front ();
+	}
+
+	if (x >= when.back ()) {
+		return value.back ();
+	}
+
+	/* first point at or after x, there is one before it */
+	const size_t i = std::lower_bound (when.begin (), when.end (), x) - when.begin ();
+
+	if (when[i] == x) {
+		return value[i];
+	}
+
+	if (interpolation == Discrete) {
+		return value[i - 1];
+	}
+
+	const double fraction = (x - when[i - 1]) / (when[i] - when[i - 1]);
+
+	switch (interpolation) {
+		case Logarithmic:
+			return interpolate_logarithmic (value[i - 1], value[i], fraction, lower, upper);
+		case Exponential:
+			return interpolate_gain (value[i - 1], value[i], fraction, upper);
+		default: // Linear
+			return interpolate_linear (value[i - 1], value[i], fraction);
+	}
+}
+
+/** Fill vec[from .. to) with the values of the segment from point @param s
+ * to the next one, vec[i] being the value at lx + i * dx.
+ *
+ * The loops are kept simple for the compiler to vectorize them.
+ */
+void
+ControlList::RenderedCurve::fill_segment (size_t s, double lx, double dx, float* vec, int32_t from, int32_t to) const
+{
+	const double x0 = when[s];
+	const double y0 = value[s];
+	const double y1 = value[s + 1];
+
+	if (y0 == y1 || interpolation == Discrete) {
+		const float v = y0;
+		for (int32_t i = from; i < to; ++i) {
+			vec[i] = v;
+		}
+		return;
+	}
+
+	const double range = when[s + 1] - x0;
+
+	switch (interpolation) {
+		case Logarithmic:
+			for (int32_t i = from; i < to; ++i) {
+				vec[i] = interpolate_logarithmic (y0, y1, (lx + i * dx - x0) / range, lower, upper);
+			}
+			break;
+		case Exponential:
+			for (int32_t i = from; i < to; ++i) {
+				vec[i] = interpolate_gain (y0, y1, (lx + i * dx - x0) / range, upper);
+			}
+			break;
+		default: // Linear
+			{
+				/* vec[i] = a + b * i */
+				const double slope = (y1 - y0) / range;
+				const double a = y0 + slope * (lx - x0);
+				const double b = slope * dx;
+				for (int32_t i = from; i < to; ++i) {
+					vec[i] = a + b * i;
+				}
+			}
+			break;
+	}
+}
+
+void
+ControlList::RenderedCurve::get_vector (double x0, double x1, float* vec, int32_t veclen) const
+{
+	const size_t npoints = when.size ();
+
+	if (veclen <= 0) {
+		return;
+	}
+
+	if (npoints < 2 || x0 > when.back () || x1 < when.front ()) {
+		/* constant, at the default, first or final value */
+		float v;
+		if (npoints == 0) {
+			v = normal;
+		} else if (x0 > when.back ()) {
+			v = value.back ();
+		} else {
+			v = value.front ();
+		}
+		for (int32_t i = 0; i < veclen; ++i) {
+			vec[i] = v;
+		}
+		return;
+	}
+
+	const double min_x = when.front ();
+	const double max_x = when.back ();
+	const int32_t original_veclen = veclen;
+
+	/* fill the parts before the first and after the last point,
+	 * as Curve::_get_vector()
+	 */
+	if (x0 < min_x) {
+		const double frac = (min_x - x0) / (x1 - x0);
+		const int32_t fill_len = (int32_t) min ((int64_t) floor (veclen * frac), (int64_t) veclen);
+		const float v = value.front ();
+
+		for (int32_t i = 0; i < fill_len; ++i) {
+			vec[i] = v;
+		}
+
+		veclen -= fill_len;
+		vec += fill_len;
+	}
+
+	if (veclen && x1 > max_x) {
+		const double frac = (x1 - max_x) / (x1 - x0);
+		const int32_t fill_len = (int32_t) min ((int64_t) floor (original_veclen * frac), (int64_t) veclen);
+		const float v = value.back ();
+
+		for (int32_t i = veclen - fill_len; i < veclen; ++i) {
+			vec[i] = v;
+		}
+
+		veclen -= fill_len;
+	}
+
+	const double lx = max (min_x, x0);
+	const double hx = min (max_x, x1);
+	const double dx = veclen > 1 ? (hx - lx) / (veclen - 1) : 0;
+
+	/* the segment that contains lx */
+	size_t s = std::upper_bound (when.begin (), when.end (), lx) - when.begin ();
+	s = s > 0 ? s - 1 : 0;
+
+	int32_t i = 0;
+
+	while (i < veclen) {
+		const double x = lx + i * dx;
+
+		while (s + 1 < npoints && when[s + 1] <= x) {
+			++s;
+		}
+
+		if (s + 1 == npoints) {
+			/* at the last point */
+			for (; i < veclen; ++i) {
+				vec[i] = value.back ();
+			}
+			break;
+		}
+
+		/* first sample at or after the end of this segment */
+		int32_t end = veclen;
+
+		if (dx > 0) {
+			const double e = ceil ((when[s + 1] - lx) / dx);
+			if (e < end) {
+				end = max ((int32_t) e, i + 1);
+				/* the division may be rounded either way */
+				while (end > i + 1 && lx + (end - 1) * dx >= when[s + 1]) {
+					--end;
+				}
+				while (end < veclen && lx + end * dx < when[s + 1]) {
+					++end;
+				}
+			}
+		}
+
+		fill_segment (s, lx, dx, vec, i, end);
+		i = end;
+	}
+}
+
+bool
+ControlList::RenderedCurve::next_event (double start, double end, double& next) const
+{
+	std::vector<double>::const_iterator i = std::upper_bound (when.begin (), when.end (), start);
+
+	if (i == when.end () || *i >= end) {
+		return false;
+	}
+
+	next = *i;
+	return true;
+}
+
 void
 ControlList::truncate_end (double last_coordinate)
 {
@@ -1359,37 +1758,35 @@ ControlList::truncate_start (double overall_length)
 double
 ControlList::unlocked_eval (double x) const
 {
-	pair<EventList::iterator,EventList::iterator> range;
-	int32_t npoints;
+	return unlocked_eval (*flat_events (), x);
+}
+
+double
+ControlList::unlocked_eval (FlatEvents const& ev, double x) const
+{
+	const size_t npoints = ev.size ();
 	double lpos, upos;
 	double lval, uval;
 	double fraction;
 
-	const_iterator length_check_iter = _events.begin();
-	for (npoints = 0; npoints < 4; ++npoints, ++length_check_iter) {
-		if (length_check_iter == _events.end()) {
-			break;
-		}
-	}
-
 	switch (npoints) {
 	case 0:
 		return _desc.normal;
 
 	case 1:
-		return _events.front()->value;
+		return ev.value[0];
 
 	case 2:
-		if (x >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (x <= _events.front()->when) {
-			return _events.front()->value;
+		if (x >= ev.when[1]) {
+			return ev.value[1];
+		} else if (x <= ev.when[0]) {
+			return ev.value[0];
 		}
 
-		lpos = _events.front()->when;
-		lval = _events.front()->value;
-		upos = _events.back()->when;
-		uval = _events.back()->value;
+		lpos = ev.when[0];
+		lval = ev.value[0];
+		upos = ev.when[1];
+		uval = ev.value[1];
 
 		fraction = (double) (x - lpos) / (double) (upos - lpos);
 
@@ -1408,13 +1805,13 @@ ControlList::unlocked_eval (double x) const
 		}
 
 	default:
-		if (x >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (x <= _events.front()->when) {
-			return _events.front()->value;
+		if (x >= ev.when.back()) {
+			return ev.value.back();
+		} else if (x <= ev.when.front()) {
+			return ev.value.front();
 		}
 
-		return multipoint_eval (x);
+		return multipoint_eval (ev, x);
 	}
 
 	abort(); /*NOTREACHED*/ /* stupid gcc */
@@ -1422,112 +1819,71 @@ ControlList::unlocked_eval (double x) const
 }
 
 double
-ControlList::multipoint_eval (double x) const
+ControlList::multipoint_eval (FlatEvents const& ev, double x) const
 {
 	double upos, lpos;
 	double uval, lval;
 	double fraction;
 
-	/* "Stepped" lookup (no interpolation) */
-	/* FIXME: no cache.  significant? */
-	if (_interpolation == Discrete) {
-		const ControlEvent cp (x, 0);
-		EventList::const_iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+	/* first point at or after x. unlocked_eval() handled x outside of
+	 * the list, so there is a point before and one after.
+	 */
+	const size_t i = ev.lower_bound (x);
 
-		// shouldn't have made it to multipoint_eval
-		assert(i != _events.end());
+	assert (i > 0 && i < ev.size ());
 
-		if (i == _events.begin() || (*i)->when == x)
-			return (*i)->value;
-		else
-			return (*(--i))->value;
+	if (ev.when[i] == x) {
+		/* x is a control point in the data */
+		return ev.value[i];
 	}
 
-	/* Only do the range lookup if x is in a different range than last time
-	 * this was called (or if the lookup cache has been marked "dirty" (left<0) */
-	if ((_lookup_cache.left < 0) ||
-	    ((_lookup_cache.left > x) ||
-	     (_lookup_cache.range.first == _events.end()) ||
-	     ((*_lookup_cache.range.second)->when < x))) {
-
-		const ControlEvent cp (x, 0);
-
-		_lookup_cache.range = equal_range (_events.begin(), _events.end(), &cp, time_comparator);
+	/* "Stepped" lookup (no interpolation) */
+	if (_interpolation == Discrete) {
+		return ev.value[i - 1];
 	}
 
-	pair<const_iterator,const_iterator> range = _lookup_cache.range;
+	lpos = ev.when[i - 1];
+	lval = ev.value[i - 1];
+	upos = ev.when[i];
+	uval = ev.value[i];
 
-	if (range.first == range.second) {
+	fraction = (double) (x - lpos) / (double) (upos - lpos);
 
-		/* x does not exist within the list as a control point */
-
-		_lookup_cache.left = x;
-
-		if (range.first != _events.begin()) {
-			--range.first;
-			lpos = (*range.first)->when;
-			lval = (*range.first)->value;
-		}  else {
-			/* we're before the first point */
-			// return _default_value;
-			return _events.front()->value;
-		}
-
-		if (range.second == _events.end()) {
-			/* we're after the last point */
-			return _events.back()->value;
-		}
-
-		upos = (*range.second)->when;
-		uval = (*range.second)->value;
-
-		fraction = (double) (x - lpos) / (double) (upos - lpos);
-
-		switch (_interpolation) {
-			case Logarithmic:
-				return interpolate_logarithmic (lval, uval, fraction, _desc.lower, _desc.upper);
-			case Exponential:
-				return interpolate_gain (lval, uval, fraction, _desc.upper);
-			case Discrete:
-				/* should not reach here */
-				assert (0);
-			case Curved:
-				/* only used x-fade curves, never direct eval */
-				assert (0);
-			default: // Linear
-				return interpolate_linear (lval, uval, fraction);
-				break;
-		}
-		assert (0);
+	switch (_interpolation) {
+		case Logarithmic:
+			return interpolate_logarithmic (lval, uval, fraction, _desc.lower, _desc.upper);
+		case Exponential:
+			return interpolate_gain (lval, uval, fraction, _desc.upper);
+		case Discrete:
+			/* should not reach here */
+			assert (0);
+		case Curved:
+			/* only used x-fade curves, never direct eval */
+			assert (0);
+		default: // Linear
+			return interpolate_linear (lval, uval, fraction);
 	}
-
-	/* x is a control point in the data */
-	_lookup_cache.left = -1;
-	return (*range.first)->value;
 }
 
 void
-ControlList::build_search_cache_if_necessary (double start) const
+ControlList::build_search_cache_if_necessary (FlatEvents const& ev, double start) const
 {
-	if (_events.empty()) {
+	if (ev.size () == 0) {
 		/* Empty, nothing to cache, move to end. */
-		_search_cache.first = _events.end();
+		_search_cache.first = 0;
 		_search_cache.left = 0;
 		return;
 	} else if ((_search_cache.left < 0) || (_search_cache.left > start)) {
 		/* Marked dirty (left < 0), or we're too far forward, re-search. */
-
-		const ControlEvent start_point (start, 0);
-
-		_search_cache.first = lower_bound (_events.begin(), _events.end(), &start_point, time_comparator);
+		_search_cache.first = ev.lower_bound (start);
 		_search_cache.left = start;
 	}
 
 	/* We now have a search cache that is not too far right, but it may be too
 	   far left and need to be advanced. */
 
-	while (_search_cache.first != end() && (*_search_cache.first)->when < start) {
-		++_search_cache.first;
+	if (_search_cache.first < ev.size () && ev.when[_search_cache.first] < start) {
+		_search_cache.first = ev.lower_bound (start, _search_cache.first);
 	}
 	_search_cache.left = start;
 }
@@ -1548,7 +1904,13 @@ ControlList::rt_safe_earliest_event (double start, double& x, double& y, bool in
 		return false;
 	}
 
-	return rt_safe_earliest_event_unlocked (start, x, y, inclusive);
+	/* the writer side has not published the changed list yet */
+	boost::shared_ptr<const FlatEvents> ev (rt_flat_events ());
+	if (!ev) {
+		return false;
+	}
+
+	return rt_safe_earliest_event_unlocked (*ev, start, x, y, inclusive);
 }
 
 
@@ -1561,11 +1923,17 @@ ControlList::rt_safe_earliest_event (double start, double& x, double& y, bool in
  */
 bool
 ControlList::rt_safe_earliest_event_unlocked (double start, double& x, double& y, bool inclusive) const
+{
+	return rt_safe_earliest_event_unlocked (*flat_events (), start, x, y, inclusive);
+}
+
+bool
+ControlList::rt_safe_earliest_event_unlocked (FlatEvents const& ev, double start, double& x, double& y, bool inclusive) const
 {
 	if (_interpolation == Discrete) {
-		return rt_safe_earliest_event_discrete_unlocked(start, x, y, inclusive);
+		return rt_safe_earliest_event_discrete_unlocked (ev, start, x, y, inclusive);
 	} else {
-		return rt_safe_earliest_event_linear_unlocked(start, x, y, inclusive);
+		return rt_safe_earliest_event_linear_unlocked (ev, start, x, y, inclusive);
 	}
 }
 
@@ -1580,18 +1948,24 @@ ControlList::rt_safe_earliest_event_unlocked (double start, double& x, double& y
 bool
 ControlList::rt_safe_earliest_event_discrete_unlocked (double start, double& x, double& y, bool inclusive) const
 {
-	build_search_cache_if_necessary (start);
+	return rt_safe_earliest_event_discrete_unlocked (*flat_events (), start, x, y, inclusive);
+}
+
+bool
+ControlList::rt_safe_earliest_event_discrete_unlocked (FlatEvents const& ev, double start, double& x, double& y, bool inclusive) const
+{
+	build_search_cache_if_necessary (ev, start);
 
-	if (_search_cache.first != _events.end()) {
-		const ControlEvent* const first = *_search_cache.first;
+	if (_search_cache.first < ev.size ()) {
+		const double first_when = ev.when[_search_cache.first];
 
-		const bool past_start = (inclusive ? first->when >= start : first->when > start);
+		const bool past_start = (inclusive ? first_when >= start : first_when > start);
 
 		/* Earliest points is in range, return it */
 		if (past_start) {
 
-			x = first->when;
-			y = first->value;
+			x = first_when;
+			y = ev.value[_search_cache.first];
 
 			/* Move left of cache to this point
 			 * (Optimize for immediate call this cycle within range) */
@@ -1620,57 +1994,65 @@ ControlList::rt_safe_earliest_event_discrete_unlocked (double start, double& x,
  */
 bool
 ControlList::rt_safe_earliest_event_linear_unlocked (double start, double& x, double& y, bool inclusive) const
+{
+	return rt_safe_earliest_event_linear_unlocked (*flat_events (), start, x, y, inclusive);
+}
+
+bool
+ControlList::rt_safe_earliest_event_linear_unlocked (FlatEvents const& ev, double start, double& x, double& y, bool inclusive) const
 {
 	// cout << "earliest_event(start: " << start << ", x: " << x << ", y: " << y << ", inclusive: " << inclusive <<  ")" << endl;
 
-	const_iterator length_check_iter = _events.begin();
-	if (_events.empty()) { // 0 events
+	if (ev.size () == 0) { // 0 events
 		return false;
-	} else if (_events.end() == ++length_check_iter) { // 1 event
-		return rt_safe_earliest_event_discrete_unlocked (start, x, y, inclusive);
+	} else if (ev.size () == 1) { // 1 event
+		return rt_safe_earliest_event_discrete_unlocked (ev, start, x, y, inclusive);
 	}
 
 	// Hack to avoid infinitely repeating the same event
-	build_search_cache_if_necessary (start);
+	build_search_cache_if_necessary (ev, start);
 
-	if (_search_cache.first != _events.end()) {
+	if (_search_cache.first < ev.size ()) {
 
-		const ControlEvent* first = NULL;
-		const ControlEvent* next = NULL;
+		size_t first;
+		size_t next;
 
-		if (_search_cache.first == _events.begin() || (*_search_cache.first)->when <= start) {
+		if (_search_cache.first == 0 || ev.when[_search_cache.first] <= start) {
 			/* Step is after first */
-			first = *_search_cache.first;
+			first = _search_cache.first;
 			++_search_cache.first;
-			if (_search_cache.first == _events.end()) {
+			if (_search_cache.first == ev.size ()) {
 				return false;
 			}
-			next = *_search_cache.first;
+			next = _search_cache.first;
 
 		} else {
 			/* Step is before first */
-			const_iterator prev = _search_cache.first;
-			--prev;
-			first = *prev;
-			next = *_search_cache.first;
+			first = _search_cache.first - 1;
+			next = _search_cache.first;
 		}
 
-		if (inclusive && first->when == start) {
-			x = first->when;
-			y = first->value;
+		const double first_when  = ev.when[first];
+		const double first_value = ev.value[first];
+		const double next_when   = ev.when[next];
+		const double next_value  = ev.value[next];
+
+		if (inclusive && first_when == start) {
+			x = first_when;
+			y = first_value;
 			/* Move left of cache to this point
 			 * (Optimize for immediate call this cycle within range) */
 			_search_cache.left = x;
 			return true;
-		} else if (next->when < start || (!inclusive && next->when == start)) {
+		} else if (next_when < start || (!inclusive && next_when == start)) {
 			/* "Next" is before the start, no points left. */
 			return false;
 		}
 
-		if (fabs(first->value - next->value) <= 1) {
-			if (next->when > start) {
-				x = next->when;
-				y = next->value;
+		if (fabs(first_value - next_value) <= 1) {
+			if (next_when > start) {
+				x = next_when;
+				y = next_value;
 				/* Move left of cache to this point
 				 * (Optimize for immediate call this cycle within range) */
 				_search_cache.left = x;
@@ -1680,35 +2062,35 @@ ControlList::rt_safe_earliest_event_linear_unlocked (double start, double& x, do
 			}
 		}
 
-		const double slope = (next->value - first->value) / (double)(next->when - first->when);
+		const double slope = (next_value - first_value) / (double)(next_when - first_when);
 		//cerr << "start y: " << start_y << endl;
 
-		//y = first->value + (slope * fabs(start - first->when));
-		y = first->value;
+		//y = first_value + (slope * fabs(start - first_when));
+		y = first_value;
 
-		if (first->value < next->value) // ramping up
+		if (first_value < next_value) // ramping up
 			y = ceil(y);
 		else // ramping down
 			y = floor(y);
 
-		x = first->when + (y - first->value) / (double)slope;
+		x = first_when + (y - first_value) / (double)slope;
 
-		while ((inclusive && x < start) || (x <= start && y != next->value)) {
+		while ((inclusive && x < start) || (x <= start && y != next_value)) {
 
-			if (first->value < next->value) // ramping up
+			if (first_value < next_value) // ramping up
 				y += 1.0;
 			else // ramping down
 				y -= 1.0;
 
-			x = first->when + (y - first->value) / (double)slope;
+			x = first_when + (y - first_value) / (double)slope;
 		}
 
-		/*cerr << first->value << " @ " << first->when << " ... "
-		  << next->value << " @ " << next->when
+		/*cerr << first_value << " @ " << first_when << " ... "
+		  << next_value << " @ " << next_when
 		  << " = " << y << " @ " << x << endl;*/
 
-		assert(    (y >= first->value && y <= next->value)
-		           || (y <= first->value && y >= next->value) );
+		assert(    (y >= first_value && y <= next_value)
+		           || (y <= first_value && y >= next_value) );
 
 
 		const bool past_start = (inclusive ? x >= start : x > start);
@@ -1720,7 +2102,7 @@ ControlList::rt_safe_earliest_event_linear_unlocked (double start, double& x, do
 			return true;
 		} else {
 			if (inclusive) {
-				x = next->when;
+				x = next_when;
 			} else {
 				x = start;
 			}
@@ -2006,6 +2388,8 @@ ControlList::set_interpolation (InterpolationStyle s)
 	}
 
 	_interpolation = s;
+	g_atomic_int_inc (&_generation);
+	update_rendered ();
 	InterpolationChanged (s); /* EMIT SIGNAL */
 	return true;
 }
@@ -173,25 +173,39 @@ Curve::solve () const
 bool
 Curve::rt_safe_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 {
+	boost::shared_ptr<const ControlList::RenderedCurve> r (_list.rendered ());
+
+	if (r) {
+		r->get_vector (x0, x1, vec, veclen);
+		return true;
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm(_list.lock(), Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
 		return false;
-	} else {
-		_get_vector (x0, x1, vec, veclen);
-		return true;
 	}
+
+	/* the writer side has not published the changed list yet */
+	boost::shared_ptr<const ControlList::FlatEvents> ev (_list.rt_flat_events ());
+
+	if (!ev) {
+		return false;
+	}
+
+	_get_vector (*ev, x0, x1, vec, veclen);
+	return true;
 }
 
 void
 Curve::get_vector (double x0, double x1, float *vec, int32_t veclen) const
 {
 	Glib::Threads::RWLock::ReaderLock lm(_list.lock());
-	_get_vector (x0, x1, vec, veclen);
+	_get_vector (*_list.flat_events (), x0, x1, vec, veclen);
 }
 
 void
-Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
+Curve::_get_vector (ControlList::FlatEvents const& ev, double x0, double x1, float *vec, int32_t veclen) const
 {
 	double rx, lx, hx, max_x, min_x;
 	int32_t i;
@@ -202,7 +216,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		return;
 	}
 
-	if ((npoints = _list.events().size()) == 0) {
+	if ((npoints = ev.size()) == 0) {
 		/* no events in list, so just fill the entire array with the default value */
 		for (int32_t i = 0; i < veclen; ++i) {
 			vec[i] = _list.descriptor().normal;
@@ -212,20 +226,20 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 
 	if (npoints == 1) {
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = ev.value.front();
 		}
 		return;
 	}
 
 	/* events is now known not to be empty */
 
-	max_x = _list.events().back()->when;
-	min_x = _list.events().front()->when;
+	max_x = ev.when.back();
+	min_x = ev.when.front();
 
 	if (x0 > max_x) {
 		/* totally past the end - just fill the entire array with the final value */
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().back()->value;
+			vec[i] = ev.value.back();
 		}
 		return;
 	}
@@ -235,7 +249,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		 * the initial value.
 		 */
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = ev.value.front();
 		}
 		return;
 	}
@@ -254,7 +268,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		fill_len = min (fill_len, (int64_t)veclen);
 
 		for (i = 0; i < fill_len; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = ev.value.front();
 		}
 
 		veclen -= fill_len;
@@ -270,7 +284,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		float val;
 
 		fill_len = min (fill_len, (int64_t)veclen);
-		val = _list.events().back()->value;
+		val = ev.value.back();
 
 		for (i = veclen - fill_len; i < veclen; ++i) {
 			vec[i] = val;
@@ -284,11 +298,10 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 
 	if (npoints == 2) {
 
-		const double lpos = _list.events().front()->when;
-		const double lval = _list.events().front()->value;
-		const double upos = _list.events().back()->when;
-		const double uval = _list.events().back()->value;
-
+		const double lpos = ev.when.front();
+		const double lval = ev.value.front();
+		const double upos = ev.when.back();
+		const double uval = ev.value.back();
 		/* dx that we are using */
 		if (veclen > 1) {
 			const double dx_num = hx - lx;
@@ -360,94 +373,76 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		dx = (hx - lx) / (veclen - 1);
 	}
 
+	/* rx only increases, so the segment is found by walking forward from
+	 * the previous one.
+	 */
+	size_t next = ev.lower_bound (lx);
+
 	for (i = 0; i < veclen; ++i, rx += dx) {
-		vec[i] = multipoint_eval (rx);
+		vec[i] = multipoint_eval (ev, rx, next);
 	}
 }
 
+/** @param next index of the first point at or after x, or of an earlier
+ * point; it is advanced to the first point at or after x.
+ */
 double
-Curve::multipoint_eval (double x) const
+Curve::multipoint_eval (ControlList::FlatEvents const& ev, double x, size_t& next) const
 {
-	pair<ControlList::EventList::const_iterator,ControlList::EventList::const_iterator> range;
+	const size_t npoints = ev.size ();
 
-	ControlList::LookupCache& lookup_cache = _list.lookup_cache();
-
-	if ((lookup_cache.left < 0) ||
-	    ((lookup_cache.left > x) ||
-	     (lookup_cache.range.first == _list.events().end()) ||
-	     ((*lookup_cache.range.second)->when < x))) {
-
-		ControlEvent cp (x, 0.0);
-
-		lookup_cache.range = equal_range (_list.events().begin(), _list.events().end(), &cp, ControlList::time_comparator);
+	while (next < npoints && ev.when[next] < x) {
+		++next;
 	}
 
-	range = lookup_cache.range;
-
-	/* EITHER
-
-	   a) x is an existing control point, so first == existing point, second == next point
-
-	   OR
-
-	   b) x is between control points, so range is empty (first == second, points to where
-	       to insert x)
-
-	*/
-
-	if (range.first == range.second) {
-
-		/* x does not exist within the list as a control point */
-
-		lookup_cache.left = x;
+	if (next < npoints && ev.when[next] == x) {
+		/* x is a control point in the data */
+		return ev.value[next];
+	}
 
-		if (range.first == _list.events().begin()) {
-			/* we're before the first point */
-			// return default_value;
-			return _list.events().front()->value;
-		}
+	if (next == 0) {
+		/* we're before the first point */
+		// return default_value;
+		return ev.value.front();
+	}
 
-		if (range.second == _list.events().end()) {
-			/* we're after the last point */
-			return _list.events().back()->value;
-		}
+	if (next == npoints) {
+		/* we're after the last point */
+		return ev.value.back();
+	}
 
-		ControlEvent* after = (*range.second);
-		range.second--;
-		ControlEvent* before = (*range.second);
+	const double before_when = ev.when[next - 1];
+	const double before_value = ev.value[next - 1];
+	const double after_value = ev.value[next];
 
-		double vdelta = after->value - before->value;
+	double vdelta = after_value - before_value;
 
-		if (vdelta == 0.0) {
-			return before->value;
-		}
+	if (vdelta == 0.0) {
+		return before_value;
+	}
 
-		double tdelta = x - before->when;
-		double trange = after->when - before->when;
-
-		switch (_list.interpolation()) {
-			case ControlList::Discrete:
-				return before->value;
-			case ControlList::Logarithmic:
-				return interpolate_logarithmic (before->value, after->value, tdelta / trange, _list.descriptor().lower, _list.descriptor().upper);
-			case ControlList::Exponential:
-				return interpolate_gain (before->value, after->value, tdelta / trange, _list.descriptor().upper);
-			case ControlList::Curved:
-				if (after->coeff) {
-					ControlEvent* ev = after;
-					double x2 = x * x;
-					return ev->coeff[0] + (ev->coeff[1] * x) + (ev->coeff[2] * x2) + (ev->coeff[3] * x2 * x);
-				}
-				/* fall through */
-			case ControlList::Linear:
-				return before->value + (vdelta * (tdelta / trange));
-		}
+	double tdelta = x - before_when;
+	double trange = ev.when[next] - before_when;
+
+	switch (_list.interpolation()) {
+		case ControlList::Discrete:
+			return before_value;
+		case ControlList::Logarithmic:
+			return interpolate_logarithmic (before_value, after_value, tdelta / trange, _list.descriptor().lower, _list.descriptor().upper);
+		case ControlList::Exponential:
+			return interpolate_gain (before_value, after_value, tdelta / trange, _list.descriptor().upper);
+		case ControlList::Curved:
+			if (ev.event[next]->coeff) {
+				const ControlEvent* after = ev.event[next];
+				double x2 = x * x;
+				return after->coeff[0] + (after->coeff[1] * x) + (after->coeff[2] * x2) + (after->coeff[3] * x2 * x);
+			}
+			/* fall through */
+		case ControlList::Linear:
+			return before_value + (vdelta * (tdelta / trange));
 	}
 
-	/* x is a control point in the data */
-	/* invalidate the cached range because its not usable */
-	lookup_cache.left = -1;
-	return (*range.first)->value;
+	return before_value;
 }
 
 } // namespace Evoral
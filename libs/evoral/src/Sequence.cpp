@@ -409,6 +409,30 @@ Sequence<Time>::const_iterator::operator++()
 	return *this;
 }
 
+template<typename Time>
+typename Sequence<Time>::NotePtr
+Sequence<Time>::const_iterator::note() const
+{
+	switch (_type) {
+	case NOTE_ON:
+		return *_note_iter;
+	case NOTE_OFF:
+		return _active_notes.top();
+	default:
+		return NotePtr();
+	}
+}
+
+template<typename Time>
+const Parameter*
+Sequence<Time>::const_iterator::control_parameter() const
+{
+	if (_type != CONTROL || _is_end) {
+		return 0;
+	}
+	return &_control_iter->list->parameter();
+}
+
 template<typename Time>
 bool
 Sequence<Time>::const_iterator::operator==(const const_iterator& other) const
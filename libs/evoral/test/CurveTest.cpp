@@ -69,16 +69,27 @@ CurveTest::rtGet ()
 	// Create simple control list
 	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
 	cl->create_curve ();
+	cl->freeze ();
 	cl->fast_simple_add(0.0, 42.0);
+	cl->thaw ();
 
 	{
 		// Write-lock list
 		Glib::Threads::RWLock::WriterLock lm(cl->lock());
 
-		// Attempt to get vector in RT (expect failure)
-		CPPUNIT_ASSERT (!cl->curve().rt_safe_get_vector (1024.0, 2047.0, vec, 1024));
+		// Attempt to get vector in RT (expect success, from the published copy)
+		CPPUNIT_ASSERT (cl->curve().rt_safe_get_vector (1024.0, 2047.0, vec, 1024));
 	}
 
+	// Modify the list, it is not published until thawed
+	cl->freeze ();
+	cl->fast_simple_add(512.0, 42.0);
+
+	// Attempt to get vector in RT (expect failure)
+	CPPUNIT_ASSERT (!cl->curve().rt_safe_get_vector (1024.0, 2047.0, vec, 1024));
+
+	cl->thaw ();
+
 	// Attempt to get vector in RT (expect success)
 	CPPUNIT_ASSERT (cl->curve().rt_safe_get_vector (1024.0, 2047.0, vec, 1024));
 	for (int i = 0; i < 1024; ++i) {
@@ -472,3 +483,53 @@ CurveTest::constrainedCubic ()
 		CPPUNIT_ASSERT_DOUBLES_EQUAL(v, g[x], 0.000008);
 	}
 }
+
+void
+CurveTest::rtRendered ()
+{
+	float vec[101];
+
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	cl->create_curve ();
+	cl->set_interpolation (ControlList::Linear);
+
+	// a ramp with points on a straight line, and a constant part
+	for (int i = 0; i <= 10; ++i) {
+		cl->add (i * 10.0, i * 0.05, false, false);
+	}
+	cl->add (150.0, 0.5, false, false);
+	cl->add (200.0, 0.5, false, false);
+	cl->add (250.0, 1.0, false, false);
+
+	// only the points where the slope changes remain
+	boost::shared_ptr<const ControlList::RenderedCurve> r = cl->rendered ();
+	CPPUNIT_ASSERT (r);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, r->size ());
+
+	double when;
+	CPPUNIT_ASSERT (r->next_event (0.0, 1000.0, when));
+	CPPUNIT_ASSERT_EQUAL (100.0, when);
+	CPPUNIT_ASSERT (!r->next_event (100.0, 200.0, when));
+
+	{
+		// Write-lock list
+		Glib::Threads::RWLock::WriterLock lm(cl->lock());
+
+		// the rendered curve does not need the lock
+		CPPUNIT_ASSERT (cl->curve().rt_safe_get_vector (0.0, 100.0, vec, 101));
+		for (int i = 0; i <= 100; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (i * 0.005, vec[i], 1e-6);
+		}
+
+		bool ok;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (0.75, cl->rt_safe_eval (225.0, ok), 1e-6);
+		CPPUNIT_ASSERT (ok);
+	}
+
+	// a modified list is rendered again
+	cl->add (300.0, 0.0, false, false);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 5, cl->rendered ()->size ());
+	CPPUNIT_ASSERT (cl->curve().rt_safe_get_vector (250.0, 300.0, vec, 2));
+	CPPUNIT_ASSERT_EQUAL (1.0f, vec[0]);
+	CPPUNIT_ASSERT_EQUAL (0.0f, vec[1]);
+}
@@ -69,6 +69,32 @@ __cpuid(int regs[4], int cpuid_leaf)
 	         "%ecx", "%edx", "memory");
 }
 
+/* __cpuidex() is __cpuid() with a sub-leaf in %ecx, as needed for leaf 7 */
+
+static void
+__cpuidex(int regs[4], int cpuid_leaf, int cpuid_subleaf)
+{
+        asm volatile (
+#if defined(__i386__)
+	        "pushl %%ebx;\n\t"
+#endif
+	        "cpuid;\n\t"
+	        "movl %%eax, (%2);\n\t"
+	        "movl %%ebx, 4(%2);\n\t"
+	        "movl %%ecx, 8(%2);\n\t"
+	        "movl %%edx, 12(%2);\n\t"
+#if defined(__i386__)
+	        "popl %%ebx;\n\t"
+#endif
+	        :"=a" (cpuid_leaf), "=c" (cpuid_subleaf) /* %eax, %ecx clobbered by CPUID */
+	        :"S" (regs), "a" (cpuid_leaf), "c" (cpuid_subleaf)
+	        :
+#if !defined(__i386__)
+	         "%ebx",
+#endif
+	         "%edx", "memory");
+}
+
 #endif /* !PLATFORM_WINDOWS */
 
 #ifndef HAVE_XGETBV // Allow definition by build system
@@ -192,6 +218,21 @@ FPU::FPU ()
 		    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0x6) == 0x6)) { /* OS really supports XSAVE */
 			info << _("AVX-capable processor") << endmsg;
 			_flags = Flags (_flags | (HasAVX) );
+
+			if (cpu_info[2] & (1<<12) /* FMA */) {
+				info << _("FMA-capable processor") << endmsg;
+				_flags = Flags (_flags | (HasFMA) );
+			}
+
+			if (num_ids >= 7 &&
+			    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0xe0) == 0xe0)) { /* OS saves opmask and ZMM state */
+				int ext_info[4];
+				__cpuidex (ext_info, 7, 0);
+				if (ext_info[1] & (1<<16) /* AVX512F */) {
+					info << _("AVX-512-capable processor") << endmsg;
+					_flags = Flags (_flags | (HasAVX512F) );
+				}
+			}
 		}
 
 		if (cpu_info[3] & (1<<25)) {
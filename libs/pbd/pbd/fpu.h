@@ -31,7 +31,9 @@ class LIBPBD_API FPU {
 		HasDenormalsAreZero = 0x2,
 		HasSSE = 0x4,
 		HasSSE2 = 0x8,
-		HasAVX = 0x10
+		HasAVX = 0x10,
+		HasFMA = 0x20,
+		HasAVX512F = 0x40
 	};
 
   public:
@@ -45,6 +47,8 @@ class LIBPBD_API FPU {
 	bool has_sse () const { return _flags & HasSSE; }
 	bool has_sse2 () const { return _flags & HasSSE2; }
 	bool has_avx () const { return _flags & HasAVX; }
+	bool has_fma () const { return _flags & HasFMA; }
+	bool has_avx512f () const { return _flags & HasAVX512F; }
 
   private:
 	Flags _flags;
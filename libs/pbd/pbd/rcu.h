@@ -122,26 +122,7 @@ public:
 
 	boost::shared_ptr<T> write_copy ()
 	{
-		m_lock.lock();
-
-		// clean out any dead wood
-
-		typename std::list<boost::shared_ptr<T> >::iterator i;
-
-		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
-			if ((*i).unique()) {
-				i = m_dead_wood.erase (i);
-			} else {
-				++i;
-			}
-		}
-
-		/* store the current so that we can do compare and exchange
-		   when someone calls update(). Notice that we hold
-		   a lock, so this store of m_rcu_value is atomic.
-		*/
-
-		current_write_old = RCUManager<T>::x.m_rcu_value;
+		lock_for_write ();
 
 		boost::shared_ptr<T> new_copy (new T(**current_write_old));
 
@@ -152,6 +133,16 @@ public:
 		*/
 	}
 
+	/** as write_copy(), for writers that replace the value as a whole:
+	 * returns a default constructed T instead of a copy.
+	 */
+	boost::shared_ptr<T> write_new ()
+	{
+		lock_for_write ();
+
+		return boost::shared_ptr<T> (new T);
+	}
+
 	bool update (boost::shared_ptr<T> new_value)
 	{
 		/* we still hold the write lock - other writers are locked out */
@@ -194,6 +185,30 @@ public:
 	}
 
 private:
+	void lock_for_write ()
+	{
+		m_lock.lock();
+
+		// clean out any dead wood
+
+		typename std::list<boost::shared_ptr<T> >::iterator i;
+
+		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
+			if ((*i).unique()) {
+				i = m_dead_wood.erase (i);
+			} else {
+				++i;
+			}
+		}
+
+		/* store the current so that we can do compare and exchange
+		   when someone calls update(). Notice that we hold
+		   a lock, so this store of m_rcu_value is atomic.
+		*/
+
+		current_write_old = RCUManager<T>::x.m_rcu_value;
+	}
+
 	Glib::Threads::Mutex                      m_lock;
 	boost::shared_ptr<T>*            current_write_old;
 	std::list<boost::shared_ptr<T> > m_dead_wood;
@@ -58,8 +58,10 @@ class LIBPBD_API SignalBase
 {
 public:
 	SignalBase ()
+	: _emitting (0)
+	, _dead_slots_pending (0)
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
-	: _debug_connection (false)
+	, _debug_connection (false)
 #endif
 	{}
 	virtual ~SignalBase () {}
@@ -69,7 +71,30 @@ public:
 #endif
 
 protected:
+	/** Marks an emission in progress for its lifetime. Slot lists which
+	 *  are replaced by connect or disconnect must not be deleted while
+	 *  any emission may still be iterating over them.
+	 */
+	class EmissionScope {
+	public:
+		EmissionScope (SignalBase& s) : _signal (s) { g_atomic_int_inc (&_signal._emitting); }
+		~EmissionScope () {
+			/* the last emission to finish releases replaced slot lists */
+			if (g_atomic_int_dec_and_test (&_signal._emitting) && g_atomic_int_get (&_signal._dead_slots_pending)) {
+				_signal.drop_dead_slots_if_idle ();
+			}
+		}
+	private:
+		SignalBase& _signal;
+	};
+
+	bool emitting () const { return g_atomic_int_get (&_emitting) != 0; }
+	virtual void drop_dead_slots_if_idle () = 0;
+
+	/** serializes connect and disconnect, never taken during emission */
 	mutable Glib::Threads::Mutex _mutex;
+	volatile gint _emitting;
+	volatile gint _dead_slots_pending; ///< set while replaced slot lists await deletion
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	bool _debug_connection;
 #endif
@@ -103,19 +103,69 @@ def signal(f, n, v):
     print("""
 	/** The slots that this signal will call on emission */
 	typedef std::map<boost::shared_ptr<Connection>, slot_function_type> Slots;
-	Slots _slots;
-""", file=f)
+
+	/* The slot list is read-copy-update: a published list is never
+	   modified. connect and disconnect (serialized by _mutex) publish
+	   a modified copy, emission uses the current list without locking.
+	   Replaced lists are kept in _dead_slots until no emission is in
+	   progress, they are dropped by the writer or by the last emission
+	   to finish. NULL if nothing is connected.
+	*/
+	volatile gpointer _slots;
+	std::list<Slots*> _dead_slots;
+
+	Slots const * slots () const {
+		return (Slots const *) g_atomic_pointer_get (&_slots);
+	}
+
+	/* must be called with _mutex held */
+	void publish (Slots* s) {
+		Slots* old = (Slots*) g_atomic_pointer_get (&_slots);
+		g_atomic_pointer_set (&_slots, s);
+		if (old) {
+			_dead_slots.push_back (old);
+			g_atomic_int_set (&_dead_slots_pending, 1);
+		}
+		/* an emission starting now will see the new list */
+		if (!emitting ()) {
+			drop_dead_slots ();
+		}
+	}
+
+	void drop_dead_slots () {
+		for (%sstd::list<Slots*>::iterator i = _dead_slots.begin(); i != _dead_slots.end(); ++i) {
+			delete *i;
+		}
+		_dead_slots.clear ();
+		g_atomic_int_set (&_dead_slots_pending, 0);
+	}
+
+	void drop_dead_slots_if_idle () {
+		/* never wait for a writer, it drops them itself when idle */
+		Glib::Threads::Mutex::Lock lm (_mutex, Glib::Threads::TRY_LOCK);
+		if (lm.locked () && !emitting ()) {
+			drop_dead_slots ();
+		}
+	}
+""" % typename, file=f)
 
     print("public:", file=f)
     print("", file=f)
+    print("\tSignal%d () : _slots (0) {}" % n, file=f)
+    print("", file=f)
     print("\t~Signal%d () {" % n, file=f)
 
     print("\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t/* Tell our connection objects that we are going away, so they don't try to call us */", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = _slots.begin(); i != _slots.end(); ++i) {" % typename, file=f)
+    print("\t\tSlots* s = (Slots*) g_atomic_pointer_get (&_slots);", file=f)
+    print("\t\tif (s) {", file=f)
+    print("\t\t\t/* Tell our connection objects that we are going away, so they don't try to call us */", file=f)
+    print("\t\t\tfor (%sSlots::const_iterator i = s->begin(); i != s->end(); ++i) {" % typename, file=f)
 
-    print("\t\t\ti->first->signal_going_away ();", file=f)
+    print("\t\t\t\ti->first->signal_going_away ();", file=f)
+    print("\t\t\t}", file=f)
+    print("\t\t\tdelete s;", file=f)
     print("\t\t}", file=f)
+    print("\t\tdrop_dead_slots ();", file=f)
     print("\t}", file=f)
     print("", file=f)
 
@@ -230,30 +280,32 @@ def signal(f, n, v):
     else:
         print("\ttypename C::result_type operator() (%s)" % comma_separated(Anan), file=f)
     print("\t{", file=f)
-    print("\t\t/* First, take a copy of our list of slots as it is now */", file=f)
+    print("\t\t/* Use our list of slots as it is now. It is not modified while we", file=f)
+    print("\t\t   iterate, and stays alive until the last emission has finished.", file=f)
+    print("\t\t*/", file=f)
     print("", file=f)
-    print("\t\tSlots s;", file=f)
-    print("\t\t{", file=f)
-    print("\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t\ts = _slots;", file=f)
-    print("\t\t}", file=f)
+    print("\t\tEmissionScope es (*this);", file=f)
+    print("\t\tSlots const * s = slots ();", file=f)
     print("", file=f)
     if not v:
         print("\t\tstd::list<R> r;", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = s.begin(); i != s.end(); ++i) {" % typename, file=f)
+    print("\t\tif (!s) {", file=f)
+    if v:
+        print("\t\t\treturn;", file=f)
+    else:
+        print("\t\t\tC c;", file=f)
+        print("\t\t\treturn c (r.begin(), r.end());", file=f)
+    print("\t\t}", file=f)
+    print("", file=f)
+    print("\t\tfor (%sSlots::const_iterator i = s->begin(); i != s->end(); ++i) {" % typename, file=f)
     print("""
 			/* We may have just called a slot, and this may have resulted in
-			   disconnection of other slots from us.  The list copy means that
-			   this won't cause any problems with invalidated iterators, but we
-			   must check to see if the slot we are about to call is still on the list.
+			   disconnection of other slots from us. We must check to see if
+			   the slot we are about to call is still on the current list.
 			*/
-			bool still_there = false;
-			{
-				Glib::Threads::Mutex::Lock lm (_mutex);
-				still_there = _slots.find (i->first) != _slots.end ();
-			}
+			Slots const * cur = slots ();
 
-			if (still_there) {""", file=f)
+			if (cur == s || (cur && cur->find (i->first) != cur->end ())) {""", file=f)
     if v:
         print("\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
     else:
@@ -269,14 +321,13 @@ def signal(f, n, v):
 
     print("""
 	bool empty () const {
-		Glib::Threads::Mutex::Lock lm (_mutex);
-		return _slots.empty ();
+		return slots () == 0;
 	}
 """, file=f)
     print("""
 	bool size () const {
 		Glib::Threads::Mutex::Lock lm (_mutex);
-		return _slots.size ();
+		return slots () && !slots ()->empty ();
 	}
 """, file=f)
 
@@ -294,10 +345,12 @@ def signal(f, n, v):
 	{
 		boost::shared_ptr<Connection> c (new Connection (this, ir));
 		Glib::Threads::Mutex::Lock lm (_mutex);
-		_slots[c] = f;
+		Slots* s = slots () ? new Slots (*slots ()) : new Slots;
+		(*s)[c] = f;
+		publish (s);
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
                 if (_debug_connection) {
-                        std::cerr << "+++++++ CONNECT " << this << " size now " << _slots.size() << std::endl;
+                        std::cerr << "+++++++ CONNECT " << this << " size now " << s->size() << std::endl;
                         PBD::stacktrace (std::cerr, 10);
                 }
 #endif
@@ -309,12 +362,21 @@ def signal(f, n, v):
 	{
 		{
 			Glib::Threads::Mutex::Lock lm (_mutex);
-    			_slots.erase (c);
-    		}
+			Slots const * cur = slots ();
+			if (cur && cur->find (c) != cur->end ()) {
+				Slots* s = new Slots (*cur);
+				s->erase (c);
+				if (s->empty ()) {
+					delete s;
+					s = 0;
+				}
+				publish (s);
+			}
+		}
 		c->disconnected ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
                	if (_debug_connection) {
-    			std::cerr << "------- DISCCONNECT " << this << " size now " << _slots.size() << std::endl;
+    			std::cerr << "------- DISCCONNECT " << this << " size now " << (slots () ? slots ()->size () : 0) << std::endl;
                         PBD::stacktrace (std::cerr, 10);
 		}
 #endif
@@ -50,6 +50,13 @@ class LIBPBD_API Stateful {
 	virtual XMLNode& get_state (void) = 0;
 	virtual int set_state (const XMLNode&, int version) = 0;
 
+	/** Like get_state(), but if the object is cacheable and has not
+	 *  changed since the last call, return a fragment node holding its
+	 *  previously serialized state instead of rebuilding it.
+	 *  Only used in a thread holding a CacheSerializedState.
+	 */
+	XMLNode& get_cached_state ();
+
 	virtual bool apply_changes (PropertyBase const &);
 	PropertyChange apply_changes (PropertyList const &);
 
@@ -81,6 +88,19 @@ class LIBPBD_API Stateful {
 		}
 	};
 
+	/* RAII structure to manage thread-local reuse of serialized state
+	 * by get_cached_state(). The resulting XML may contain fragment
+	 * nodes, so it is only suitable for writing to disk.
+	 */
+	struct CacheSerializedState {
+		CacheSerializedState (bool yn) {
+			set_cache_serialized_state_in_this_thread (yn);
+		}
+		~CacheSerializedState () {
+			set_cache_serialized_state_in_this_thread (false);
+		}
+	};
+
 	/* history management */
 
 	void clear_changes ();
@@ -133,13 +153,27 @@ class LIBPBD_API Stateful {
 
 	bool regenerate_xml_or_string_ids () const;
 
+	/** derived classes return true if all of their state is covered by
+	 *  send_change() and invalidate_cached_state(), so that
+	 *  get_cached_state() can reuse a previous serialization.
+	 */
+	virtual bool state_cacheable () const { return false; }
+	void invalidate_cached_state () const { g_atomic_int_inc (&_state_generation); }
+
   private:
 	friend struct ForceIDRegeneration;
+	friend struct CacheSerializedState;
 	static Glib::Threads::Private<bool> _regenerate_xml_or_string_ids;
+	static Glib::Threads::Private<bool> _cache_serialized_state;
 	PBD::ID  _id;
 	gint     _stateful_frozen;
 
+	mutable gint _state_generation;
+	gint         _cached_state_generation;
+	std::string  _cached_state;
+
 	static void set_regenerate_xml_and_string_ids_in_this_thread (bool yn);
+	static void set_cache_serialized_state_in_this_thread (bool yn);
 };
 
 } // namespace PBD
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _pbd_work_stealing_deque_h_
+#define _pbd_work_stealing_deque_h_
+
+#include <glib.h>
+
+#include "pbd/libpbd_visibility.h"
+
+namespace PBD {
+
+/** A fixed-size, lock-free work-stealing deque of pointers (Chase-Lev).
+ *
+ * Exactly one thread (the owner) may call push() and pop(); these operate
+ * LIFO on the "bottom" end. Any other thread may call steal(), which takes
+ * items FIFO from the "top" end.
+ *
+ * The indices are free-running and are never reset while the deque is in
+ * use, which avoids ABA problems between a thief holding a stale index and
+ * the owner re-using a slot. They wrap modulo 2^32; all comparisons are
+ * done on the (signed) difference.
+ *
+ * The deque never allocates after construction: push() fails if the deque
+ * is full, and the caller must provide a fallback.
+ */
+template<class T>
+class /*LIBPBD_API*/ WorkStealingDeque
+{
+  public:
+	WorkStealingDeque (guint sz) {
+		guint power_of_two;
+		for (power_of_two = 1; 1U << power_of_two < sz; ++power_of_two) {}
+		_size = 1 << power_of_two;
+		_size_mask = _size - 1;
+		_buf = new gpointer[_size];
+		for (guint i = 0; i < _size; ++i) {
+			_buf[i] = 0;
+		}
+		_top = 0;
+		_bottom = 0;
+	}
+
+	~WorkStealingDeque () {
+		delete [] _buf;
+	}
+
+	guint capacity () const { return _size; }
+
+	/** owner only. @return false if the deque is full */
+	bool push (T* item) {
+		guint b = (guint) g_atomic_int_get (&_bottom);
+		guint t = (guint) g_atomic_int_get (&_top);
+		if ((gint)(b - t) >= (gint)_size) {
+			return false;
+		}
+		g_atomic_pointer_set (&_buf[b & _size_mask], (gpointer) item);
+		/* publish the item: full barrier */
+		g_atomic_int_set (&_bottom, (gint)(b + 1));
+		return true;
+	}
+
+	/** owner only. @return most recently pushed item, or 0 if empty */
+	T* pop () {
+		/* reserve the bottom slot; fetch-and-add is a full barrier, which
+		 * orders the store to _bottom before the load of _top below.
+		 */
+		guint b = (guint) g_atomic_int_add (&_bottom, -1) - 1;
+		guint t = (guint) g_atomic_int_get (&_top);
+
+		if ((gint)(b - t) < 0) {
+			/* empty, restore */
+			g_atomic_int_set (&_bottom, (gint)(b + 1));
+			return 0;
+		}
+
+		T* item = (T*) g_atomic_pointer_get (&_buf[b & _size_mask]);
+
+		if (b != t) {
+			/* more than one item left, no race with thieves */
+			return item;
+		}
+
+		/* last item: race against thieves for it */
+		if (!g_atomic_int_compare_and_exchange (&_top, (gint)t, (gint)(t + 1))) {
+			item = 0;
+		}
+		g_atomic_int_set (&_bottom, (gint)(b + 1));
+		return item;
+	}
+
+	/** any thread. @return the oldest item, or 0 if empty or if
+	 * the steal lost a race (the caller may retry).
+	 */
+	T* steal () {
+		guint t = (guint) g_atomic_int_get (&_top);
+		guint b = (guint) g_atomic_int_get (&_bottom);
+
+		if ((gint)(b - t) <= 0) {
+			return 0;
+		}
+
+		T* item = (T*) g_atomic_pointer_get (&_buf[t & _size_mask]);
+
+		if (!g_atomic_int_compare_and_exchange (&_top, (gint)t, (gint)(t + 1))) {
+			return 0;
+		}
+		return item;
+	}
+
+	/** any thread; only a hint, the result may be stale by the time it is used */
+	bool empty () const {
+		guint t = (guint) g_atomic_int_get (&_top);
+		guint b = (guint) g_atomic_int_get (&_bottom);
+		return (gint)(b - t) <= 0;
+	}
+
+	/** any thread; only a hint, see empty() */
+	guint size () const {
+		guint t = (guint) g_atomic_int_get (&_top);
+		guint b = (guint) g_atomic_int_get (&_bottom);
+		gint  n = (gint)(b - t);
+		return n > 0 ? (guint) n : 0;
+	}
+
+  private:
+	WorkStealingDeque (WorkStealingDeque const&);
+	WorkStealingDeque& operator= (WorkStealingDeque const&);
+
+	gpointer* _buf;
+	guint     _size;
+	guint     _size_mask;
+
+	/* keep the thief and owner ends on separate cache lines */
+	mutable gint _top;
+	char         _pad[64 - sizeof (gint)];
+	mutable gint _bottom;
+};
+
+} /* namespace */
+
+#endif /* _pbd_work_stealing_deque_h_ */
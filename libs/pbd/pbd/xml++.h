@@ -122,6 +122,13 @@ public:
 
 	bool          is_content() const { return _is_content; }
 	const std::string& content()    const { return _content; }
+
+	/** Create a node which holds an already serialized subtree, see
+	 *  XMLWriter::serialize(). It has no name, properties or children,
+	 *  content() is the serialized text, which is written as-is.
+	 */
+	static XMLNode* fragment (const std::string& serialized);
+	bool          is_fragment() const { return _is_fragment; }
 	const std::string& set_content(const std::string&);
 	XMLNode*      add_content(const std::string& s = std::string());
 
@@ -192,6 +199,7 @@ public:
 private:
 	std::string         _name;
 	bool                _is_content;
+	bool                _is_fragment;
 	std::string         _content;
 	XMLNodeList         _children;
 	XMLPropertyList     _proplist;
@@ -200,6 +208,39 @@ private:
 	void clear_lists ();
 };
 
+/** Writes XML to a file while it is being generated, without building
+ *  a libxml2 document of the whole tree first. The output is formatted
+ *  like XMLTree::write() used to do it via libxml2.
+ */
+class LIBPBD_API XMLWriter {
+public:
+	XMLWriter (const std::string& filename);
+	~XMLWriter ();
+
+	/** write a node, including its children */
+	void write (const XMLNode&);
+
+	/** flush and close the file
+	 *  @return true if everything has been written successfully
+	 */
+	bool finish ();
+
+	/** @return the (unformatted) serialization of a node and its children,
+	 *  to be used with XMLNode::fragment()
+	 */
+	static std::string serialize (const XMLNode&);
+
+private:
+	XMLWriter ();
+
+	void write_node (const XMLNode&, int depth, bool format);
+	void flush ();
+
+	FILE*       _file;
+	std::string _buf;
+	bool        _ok;
+};
+
 class LIBPBD_API XMLException: public std::exception {
 public:
 	explicit XMLException(const std::string msg) : _message(msg) {}
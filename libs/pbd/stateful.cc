@@ -46,12 +46,15 @@ int Stateful::current_state_version = 0;
 int Stateful::loading_state_version = 0;
 
 Glib::Threads::Private<bool> Stateful::_regenerate_xml_or_string_ids;
+Glib::Threads::Private<bool> Stateful::_cache_serialized_state;
 
 Stateful::Stateful ()
 	: _extra_xml (0)
 	, _instant_xml (0)
 	, _properties (new OwnedPropertyList)
 	, _stateful_frozen (0)
+	, _state_generation (0)
+	, _cached_state_generation (-1)
 {
 }
 
@@ -74,6 +77,8 @@ Stateful::add_extra_xml (XMLNode& node)
 
 	_extra_xml->remove_nodes_and_delete (node.name());
 	_extra_xml->add_child_nocopy (node);
+
+	invalidate_cached_state ();
 }
 
 XMLNode *
@@ -83,6 +88,8 @@ Stateful::extra_xml (const string& str, bool add_if_missing)
 
 	if (_extra_xml) {
 		node = _extra_xml->child (str.c_str());
+		/* the caller may modify the returned node */
+		invalidate_cached_state ();
 	}
 
 	if (!node && add_if_missing) {
@@ -107,7 +114,29 @@ Stateful::save_extra_xml (const XMLNode& node)
 	if (xtra) {
 		delete _extra_xml;
 		_extra_xml = new XMLNode (*xtra);
+		invalidate_cached_state ();
+	}
+}
+
+XMLNode&
+Stateful::get_cached_state ()
+{
+	bool* cache = _cache_serialized_state.get();
+
+	if (!cache || !*cache || !state_cacheable () || regenerate_xml_or_string_ids ()) {
+		return get_state ();
+	}
+
+	const gint generation = g_atomic_int_get (&_state_generation);
+
+	if (generation != _cached_state_generation) {
+		XMLNode& node (get_state ());
+		_cached_state = XMLWriter::serialize (node);
+		_cached_state_generation = generation;
+		delete &node;
 	}
+
+	return *XMLNode::fragment (_cached_state);
 }
 
 void
@@ -284,6 +313,8 @@ Stateful::send_change (const PropertyChange& what_changed)
 		return;
 	}
 
+	invalidate_cached_state ();
+
 	{
 		Glib::Threads::Mutex::Lock lm (_lock);
 		if (property_changes_suspended ()) {
@@ -433,4 +464,11 @@ Stateful::set_regenerate_xml_and_string_ids_in_this_thread (bool yn)
 	_regenerate_xml_or_string_ids.set (val);
 }
 
+void
+Stateful::set_cache_serialized_state_in_this_thread (bool yn)
+{
+	bool* val = new bool (yn);
+	_cache_serialized_state.set (val);
+}
+
 } // namespace PBD
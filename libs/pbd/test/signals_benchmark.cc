@@ -0,0 +1,189 @@
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <map>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/threads.h>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "pbd/signals.h"
+
+/* Compare emission throughput of PBD::Signal with the previous
+ * implementation, which copied the slot list under a mutex on every
+ * emission. N threads emit the same signal concurrently, optionally
+ * while another thread keeps connecting and disconnecting slots.
+ */
+
+/** The emission scheme PBD::Signal used before its slot list was RCU */
+class LockedSignal1
+{
+  public:
+	typedef boost::function<void(int)> slot_function_type;
+
+	boost::shared_ptr<int> connect (slot_function_type const & f)
+	{
+		boost::shared_ptr<int> c (new int);
+		Glib::Threads::Mutex::Lock lm (_mutex);
+		_slots[c] = f;
+		return c;
+	}
+
+	void disconnect (boost::shared_ptr<int> c)
+	{
+		Glib::Threads::Mutex::Lock lm (_mutex);
+		_slots.erase (c);
+	}
+
+	void operator() (int a1)
+	{
+		Slots s;
+		{
+			Glib::Threads::Mutex::Lock lm (_mutex);
+			s = _slots;
+		}
+		for (Slots::const_iterator i = s.begin(); i != s.end(); ++i) {
+			bool still_there = false;
+			{
+				Glib::Threads::Mutex::Lock lm (_mutex);
+				still_there = _slots.find (i->first) != _slots.end ();
+			}
+			if (still_there) {
+				(i->second)(a1);
+			}
+		}
+	}
+
+  private:
+	typedef std::map<boost::shared_ptr<int>, slot_function_type> Slots;
+	Slots _slots;
+	Glib::Threads::Mutex _mutex;
+};
+
+static volatile gint received = 0;
+static volatile gint running = 0;
+
+static void
+receiver (int v)
+{
+	g_atomic_int_add (&received, v);
+}
+
+template<typename S>
+static void
+emit (S* signal, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		(*signal) (1);
+	}
+}
+
+static void
+churn_rcu (PBD::Signal1<void, int>* signal)
+{
+	while (g_atomic_int_get (&running)) {
+		PBD::ScopedConnection c;
+		signal->connect_same_thread (c, boost::bind (&receiver, _1));
+		c.disconnect ();
+	}
+}
+
+static void
+churn_locked (LockedSignal1* signal)
+{
+	while (g_atomic_int_get (&running)) {
+		signal->disconnect (signal->connect (boost::bind (&receiver, _1)));
+	}
+}
+
+template<typename S>
+static double
+run (S* signal, boost::function<void()> churn, int n_threads, int n_emissions)
+{
+	g_atomic_int_set (&received, 0);
+	g_atomic_int_set (&running, 1);
+
+	Glib::Threads::Thread* churner = 0;
+	if (churn) {
+		churner = Glib::Threads::Thread::create (churn);
+	}
+
+	int64_t const start = g_get_monotonic_time ();
+
+	std::vector<Glib::Threads::Thread*> threads;
+	for (int i = 0; i < n_threads; ++i) {
+		threads.push_back (Glib::Threads::Thread::create (boost::bind (&emit<S>, signal, n_emissions)));
+	}
+	for (std::vector<Glib::Threads::Thread*>::iterator i = threads.begin(); i != threads.end(); ++i) {
+		(*i)->join ();
+	}
+
+	int64_t const elapsed = g_get_monotonic_time () - start;
+
+	g_atomic_int_set (&running, 0);
+	if (churner) {
+		churner->join ();
+	}
+
+	/* emissions per second */
+	return n_threads * (double) n_emissions * 1e6 / std::max ((int64_t) 1, elapsed);
+}
+
+static void
+usage ()
+{
+	fprintf (stderr, "Syntax: signals-benchmark [-t <threads>] [-n <emissions per thread>] [-s <slots>]\n");
+	exit (EXIT_FAILURE);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int n_threads   = 4;
+	int n_emissions = 200000;
+	int n_slots     = 4;
+
+	int c;
+	while ((c = getopt (argc, argv, "t:n:s:h")) != -1) {
+		switch (c) {
+		case 't':
+			n_threads = atoi (optarg);
+			break;
+		case 'n':
+			n_emissions = atoi (optarg);
+			break;
+		case 's':
+			n_slots = atoi (optarg);
+			break;
+		default:
+			usage ();
+		}
+	}
+
+	PBD::Signal1<void, int> rcu_signal;
+	LockedSignal1           locked_signal;
+	PBD::ScopedConnectionList connections;
+
+	for (int i = 0; i < n_slots; ++i) {
+		rcu_signal.connect_same_thread (connections, boost::bind (&receiver, _1));
+		locked_signal.connect (boost::bind (&receiver, _1));
+	}
+
+	printf ("%d threads, %d slots, emissions/sec:\n", n_threads, n_slots);
+
+	for (int t = 1; t <= n_threads; t *= 2) {
+		double const rcu        = run (&rcu_signal, boost::function<void()> (), t, n_emissions);
+		double const locked     = run (&locked_signal, boost::function<void()> (), t, n_emissions);
+		double const rcu_churn  = run (&rcu_signal, boost::bind (&churn_rcu, &rcu_signal), t, n_emissions);
+		double const lock_churn = run (&locked_signal, boost::bind (&churn_locked, &locked_signal), t, n_emissions);
+
+		printf ("%2d emitters: RCU %10.0f locked %10.0f (x%.1f) | with connect/disconnect: RCU %10.0f locked %10.0f (x%.1f)\n",
+		        t, rcu, locked, rcu / locked, rcu_churn, lock_churn, rcu_churn / lock_churn);
+	}
+
+	return 0;
+}
@@ -89,3 +89,73 @@ SignalsTest::testScopedConnectionList ()
 
 	CPPUNIT_ASSERT_EQUAL (1, N);
 }
+
+static PBD::ScopedConnection other;
+
+void
+disconnecting_receiver (PBD::ScopedConnection* c)
+{
+	++N;
+	c->disconnect ();
+}
+
+void
+SignalsTest::testDisconnectDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection c;
+	e->Fred.connect_same_thread (c, boost::bind (&disconnecting_receiver, &other));
+	e->Fred.connect_same_thread (other, boost::bind (&disconnecting_receiver, &c));
+
+	/* whichever slot is called first disconnects the other one */
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+
+	c.disconnect ();
+	other.disconnect ();
+	CPPUNIT_ASSERT (e->Fred.empty ());
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (0, N);
+
+	delete e;
+}
+
+static Emitter* connecting_emitter = 0;
+
+void
+connecting_receiver ()
+{
+	++N;
+	if (N == 1) {
+		connecting_emitter->Fred.connect_same_thread (other, boost::bind (&receiver));
+	}
+}
+
+void
+SignalsTest::testConnectDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	connecting_emitter = e;
+
+	PBD::ScopedConnection c;
+	e->Fred.connect_same_thread (c, boost::bind (&connecting_receiver));
+
+	/* a slot connected during emission is called from the next emission on */
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (3, N);
+
+	other.disconnect ();
+	delete e;
+	connecting_emitter = 0;
+}
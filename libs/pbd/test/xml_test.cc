@@ -304,3 +304,34 @@ XMLTest::testPerfLargeXMLDocument ()
 
 	test_xml_document ("testPerfLargeXMLDocument", node_options);
 }
+
+void
+XMLTest::testFragment ()
+{
+	const string output_path = Glib::build_filename (test_output_directory ("testFragment"), "fragment.xml");
+
+	XMLNode region ("Region");
+	region.set_property ("name", "a <\"quoted\"> & escaped\tname");
+	region.add_child ("Envelope")->set_property ("default", "yes");
+
+	XMLNode* root = new XMLNode (root_node_name);
+	root->add_child ("Before");
+	root->add_child_nocopy (*XMLNode::fragment (XMLWriter::serialize (region)));
+	root->add_child ("After");
+
+	XMLTree tree;
+	tree.set_root (root);
+	CPPUNIT_ASSERT (tree.write (output_path));
+
+	/* a fragment reads back as the node it was serialized from */
+	XMLTree read_doc (output_path);
+	CPPUNIT_ASSERT (read_doc.root());
+
+	const XMLNode* read_region = read_doc.root()->child ("Region");
+	CPPUNIT_ASSERT (read_region);
+	CPPUNIT_ASSERT (*read_region == region);
+	CPPUNIT_ASSERT (read_doc.root()->child ("Before"));
+	CPPUNIT_ASSERT (read_doc.root()->child ("After"));
+
+	CPPUNIT_ASSERT (g_remove (output_path.c_str ()) == 0);
+}
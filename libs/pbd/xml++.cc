@@ -5,8 +5,10 @@
  * Modified for Ardour and released under the same terms.
  */
 
+#include <algorithm>
 #include <iostream>
 
+#include "pbd/gstdio_compat.h"
 #include "pbd/stacktrace.h"
 #include "pbd/xml++.h"
 
@@ -151,6 +153,12 @@ XMLTree::read_buffer(const string& buffer, bool to_tree_doc)
 bool
 XMLTree::write() const
 {
+	if (_compression == 0) {
+		XMLWriter writer (_filename);
+		writer.write (*_root);
+		return writer.finish ();
+	}
+
 	xmlDocPtr doc;
 	XMLNodeList children;
 	int result;
@@ -227,6 +235,7 @@ static const int PROPERTY_RESERVE_COUNT = 16;
 XMLNode::XMLNode(const string& n)
 	: _name(n)
 	, _is_content(false)
+	, _is_fragment(false)
 {
 	_proplist.reserve (PROPERTY_RESERVE_COUNT);
 }
@@ -234,17 +243,28 @@ XMLNode::XMLNode(const string& n)
 XMLNode::XMLNode(const string& n, const string& c)
 	: _name(n)
 	, _is_content(true)
+	, _is_fragment(false)
 	, _content(c)
 {
 	_proplist.reserve (PROPERTY_RESERVE_COUNT);
 }
 
 XMLNode::XMLNode(const XMLNode& from)
+	: _is_fragment(false)
 {
 	_proplist.reserve (PROPERTY_RESERVE_COUNT);
 	*this = from;
 }
 
+XMLNode*
+XMLNode::fragment (const string& serialized)
+{
+	XMLNode* node = new XMLNode (string());
+	node->_is_fragment = true;
+	node->_content = serialized;
+	return node;
+}
+
 XMLNode::~XMLNode()
 {
 	clear_lists ();
@@ -283,6 +303,11 @@ XMLNode::operator= (const XMLNode& from)
 	_name = from.name ();
 	set_content (from.content ());
 
+	if (from.is_fragment ()) {
+		_is_content = false;
+		_is_fragment = true;
+	}
+
 	const XMLPropertyList& props = from.properties ();
 
 	for (XMLPropertyConstIterator prop_iter = props.begin (); prop_iter != props.end (); ++prop_iter) {
@@ -300,10 +325,14 @@ XMLNode::operator= (const XMLNode& from)
 bool
 XMLNode::operator== (const XMLNode& other) const
 {
-	if (is_content () != other.is_content ()) {
+	if (is_content () != other.is_content () || is_fragment () != other.is_fragment ()) {
 		return false;
 	}
 
+	if (is_fragment ()) {
+		return content () == other.content ();
+	}
+
 	if (is_content ()) {
 		if (content () != other.content ()) {
 			return false;
@@ -730,6 +759,20 @@ writenode(xmlDocPtr doc, XMLNode* n, xmlNodePtr p, int root = 0)
 {
 	xmlNodePtr node;
 
+	if (n->is_fragment()) {
+		xmlDocPtr fragment = xmlReadMemory (n->content().c_str(), n->content().length(), NULL, NULL, XML_PARSE_HUGE);
+		if (fragment) {
+			node = xmlDocCopyNode (xmlDocGetRootElement (fragment), doc, 1);
+			if (root) {
+				xmlDocSetRootElement (doc, node);
+			} else {
+				xmlAddChild (p, node);
+			}
+			xmlFreeDoc (fragment);
+		}
+		return;
+	}
+
 	if (root) {
 		node = doc->children = xmlNewDocNode(doc, 0, (const xmlChar*) n->name().c_str(), 0);
 	} else {
@@ -797,6 +840,8 @@ XMLNode::dump (ostream& s, string p) const
 {
 	if (_is_content) {
 		s << p << "  " << content() << "\n";
+	} else if (_is_fragment) {
+		s << p << content() << "\n";
 	} else {
 		s << p << "<" << _name;
 		for (XMLPropertyList::const_iterator i = _proplist.begin(); i != _proplist.end(); ++i) {
@@ -811,3 +856,173 @@ XMLNode::dump (ostream& s, string p) const
 		s << p << "</" << _name << ">\n";
 	}
 }
+
+/** Writer */
+
+/* the amount of output to collect before writing it to the file */
+static const size_t WRITER_BUFFER_SIZE = 65536;
+
+/* libxml2 limits indentation to 60 characters */
+static const int WRITER_MAX_INDENT_LEVEL = 30;
+
+static void
+escape_text (string& out, const string& in)
+{
+	for (string::const_iterator c = in.begin(); c != in.end(); ++c) {
+		switch (*c) {
+		case '<':  out += "&lt;"; break;
+		case '>':  out += "&gt;"; break;
+		case '&':  out += "&amp;"; break;
+		case '\r': out += "&#13;"; break;
+		default:   out += *c; break;
+		}
+	}
+}
+
+static void
+escape_attribute (string& out, const string& in)
+{
+	for (string::const_iterator c = in.begin(); c != in.end(); ++c) {
+		switch (*c) {
+		case '<':  out += "&lt;"; break;
+		case '>':  out += "&gt;"; break;
+		case '&':  out += "&amp;"; break;
+		case '"':  out += "&quot;"; break;
+		case '\n': out += "&#10;"; break;
+		case '\r': out += "&#13;"; break;
+		case '\t': out += "&#9;"; break;
+		default:   out += *c; break;
+		}
+	}
+}
+
+XMLWriter::XMLWriter ()
+	: _file (0)
+	, _ok (true)
+{
+}
+
+XMLWriter::XMLWriter (const string& filename)
+	: _file (g_fopen (filename.c_str(), "wb"))
+	, _ok (_file != 0)
+{
+	_buf.reserve (WRITER_BUFFER_SIZE * 2);
+	_buf = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+}
+
+XMLWriter::~XMLWriter ()
+{
+	if (_file) {
+		fclose (_file);
+	}
+}
+
+void
+XMLWriter::write (const XMLNode& node)
+{
+	write_node (node, 0, true);
+	_buf += '\n';
+	flush ();
+}
+
+bool
+XMLWriter::finish ()
+{
+	flush ();
+
+	if (_file) {
+		if (fclose (_file) != 0) {
+			_ok = false;
+		}
+		_file = 0;
+	}
+
+	return _ok;
+}
+
+string
+XMLWriter::serialize (const XMLNode& node)
+{
+	XMLWriter writer;
+	writer.write_node (node, 0, false);
+	return writer._buf;
+}
+
+void
+XMLWriter::flush ()
+{
+	if (!_file) {
+		return;
+	}
+
+	if (_ok && !_buf.empty () && fwrite (_buf.data (), 1, _buf.size (), _file) != _buf.size ()) {
+		_ok = false;
+	}
+
+	_buf.clear ();
+}
+
+void
+XMLWriter::write_node (const XMLNode& node, int depth, bool format)
+{
+	if (node.is_fragment ()) {
+		_buf += node.content ();
+		return;
+	}
+
+	if (node.is_content ()) {
+		escape_text (_buf, node.content ());
+		return;
+	}
+
+	_buf += '<';
+	_buf += node.name ();
+
+	const XMLPropertyList& props = node.properties ();
+	for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+		_buf += ' ';
+		_buf += (*i)->name ();
+		_buf += "=\"";
+		escape_attribute (_buf, (*i)->value ());
+		_buf += '"';
+	}
+
+	const XMLNodeList& children = node.children ();
+
+	if (children.empty ()) {
+		_buf += "/>";
+		return;
+	}
+
+	_buf += '>';
+
+	/* like libxml2, do not add whitespace to mixed content */
+	bool format_children = format;
+	for (XMLNodeConstIterator i = children.begin (); i != children.end () && format_children; ++i) {
+		if ((*i)->is_content ()) {
+			format_children = false;
+		}
+	}
+
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		if (format_children) {
+			_buf += '\n';
+			_buf.append (2 * std::min (depth + 1, WRITER_MAX_INDENT_LEVEL), ' ');
+		}
+
+		write_node (**i, depth + 1, format_children);
+
+		if (_buf.size () > WRITER_BUFFER_SIZE) {
+			flush ();
+		}
+	}
+
+	if (format_children) {
+		_buf += '\n';
+		_buf.append (2 * std::min (depth, WRITER_MAX_INDENT_LEVEL), ' ');
+	}
+
+	_buf += "</";
+	_buf += node.name ();
+	_buf += '>';
+}
@@ -41,6 +41,7 @@
 #include "pbd/types_convert.h"
 #include "pbd/xml++.h"
 
+#include "midi++/parser.h"
 #include "midi++/port.h"
 
 #include "ardour/async_midi_port.h"
@@ -67,8 +68,20 @@ using namespace std;
 
 #define midi_ui_context() MidiControlUI::instance() /* a UICallback-derived object that specifies the event loop for signal handling */
 
+/* note off, note on, controller, program change and pitchbend
+ * on 16 channels with 128 note/controller/program numbers each
+ */
+static const size_t dispatch_size = 5 * 16 * 128;
+
+/* feedback messages sent per feedback interval, more changes stay queued */
+static const int max_feedback_messages = 64;
+
 GenericMidiControlProtocol::GenericMidiControlProtocol (Session& s)
 	: ControlProtocol (s, _("Generic MIDI"))
+	, _feedback_queue (0)
+	, _feedback_serial (0)
+	, _feedback_slots (dispatch_size, (MIDIControllable*) 0)
+	, _dispatch (dispatch_size)
 	, connection_state (ConnectionState (0))
 	, _motorised (false)
 	, _threshold (10)
@@ -111,6 +124,20 @@ GenericMidiControlProtocol::GenericMidiControlProtocol (Session& s)
 	Controllable::CreateBinding.connect_same_thread (*this, boost::bind (&GenericMidiControlProtocol::create_binding, this, _1, _2, _3));
 	Controllable::DeleteBinding.connect_same_thread (*this, boost::bind (&GenericMidiControlProtocol::delete_binding, this, _1));
 
+	/* incoming messages are looked up in _dispatch rather than each
+	 * binding connecting to the parser. These are emitted by the
+	 * MidiControlUI's event loop thread, too.
+	 */
+
+	MIDI::Parser* p = _input_port->parser ();
+	for (int chn = 0; p && chn < 16; ++chn) {
+		p->channel_note_off[chn].connect_same_thread (_dispatch_connections, boost::bind (&GenericMidiControlProtocol::dispatch_note, this, _1, _2, (MIDI::channel_t) chn, false));
+		p->channel_note_on[chn].connect_same_thread (_dispatch_connections, boost::bind (&GenericMidiControlProtocol::dispatch_note, this, _1, _2, (MIDI::channel_t) chn, true));
+		p->channel_controller[chn].connect_same_thread (_dispatch_connections, boost::bind (&GenericMidiControlProtocol::dispatch_controller, this, _1, _2, (MIDI::channel_t) chn));
+		p->channel_program_change[chn].connect_same_thread (_dispatch_connections, boost::bind (&GenericMidiControlProtocol::dispatch_program_change, this, _1, _2, (MIDI::channel_t) chn));
+		p->channel_pitchbend[chn].connect_same_thread (_dispatch_connections, boost::bind (&GenericMidiControlProtocol::dispatch_pitchbend, this, _1, _2, (MIDI::channel_t) chn));
+	}
+
 	/* this signal is emitted by the process() callback, and if
 	 * send_feedback() is going to do anything, it should do it in the
 	 * context of the process() callback itself.
@@ -133,6 +160,7 @@ GenericMidiControlProtocol::GenericMidiControlProtocol (Session& s)
 
 GenericMidiControlProtocol::~GenericMidiControlProtocol ()
 {
+	_dispatch_connections.drop_connections ();
 	drop_all ();
 	tear_down_gui ();
 }
@@ -321,9 +349,7 @@ GenericMidiControlProtocol::_send_feedback ()
 	/* This is executed in RT "process" context", so no blocking calls
 	 */
 
-	const int32_t bufsize = 16 * 1024; /* XXX too big */
-	MIDI::byte buf[bufsize];
-	int32_t bsize = bufsize;
+	MIDI::byte buf[16];
 
 	/* XXX: due to bugs in some ALSA / JACK MIDI bridges, we have to do separate
 	   writes for each controllable here; if we send more than one MIDI message
@@ -336,12 +362,308 @@ GenericMidiControlProtocol::_send_feedback ()
 		return;
 	}
 
-	for (MIDIControllables::iterator r = controllables.begin(); r != controllables.end(); ++r) {
-		MIDI::byte* end = (*r)->write_feedback (buf, bsize);
+	Glib::Threads::Mutex::Lock fl (_feedback_lock, Glib::Threads::TRY_LOCK);
+	if (!fl.locked ()) {
+		return;
+	}
+
+	MIDIControllable* queued = take_feedback_queue ();
+
+	/* several controllables may be bound to the same message, the one
+	 * that changed last wins the slot.
+	 */
+	for (MIDIControllable* q = queued; q; q = q->_next_feedback) {
+		size_t const slot = dispatch_slot (q->get_control_type (), q->get_control_channel (), q->get_control_additional ());
+		if (slot >= dispatch_size) {
+			continue;
+		}
+		MIDIControllable* w = _feedback_slots[slot];
+		if (!w || (gint) ((guint) g_atomic_int_get (&q->_feedback_serial) - (guint) g_atomic_int_get (&w->_feedback_serial)) > 0) {
+			_feedback_slots[slot] = q;
+		}
+	}
+
+	int n_sent = 0;
+
+	for (MIDIControllable* q = queued; q; ) {
+		MIDIControllable* next = q->_next_feedback;
+
+		/* changes from here on queue it again */
+		g_atomic_int_set (&q->_feedback_queued, 0);
+
+		size_t const slot = dispatch_slot (q->get_control_type (), q->get_control_channel (), q->get_control_additional ());
+
+		if (slot < dispatch_size) {
+			if (_feedback_slots[slot] != q) {
+				/* superseded by a later change */
+				q = next;
+				continue;
+			}
+			_feedback_slots[slot] = 0;
+		}
+
+		if (n_sent >= max_feedback_messages) {
+			push_feedback (q);
+			q = next;
+			continue;
+		}
+
+		int32_t bsize = sizeof (buf);
+		MIDI::byte* end = q->write_feedback (buf, bsize);
+
 		if (end != buf) {
 			_output_port->write (buf, (int32_t) (end - buf), 0);
+			++n_sent;
+		}
+
+		q = next;
+	}
+}
+
+void
+GenericMidiControlProtocol::queue_feedback (MIDIControllable* mc)
+{
+	/* Changed may still be emitted (in another thread) while the
+	 * controllable is destroyed. ::dequeue_feedback() marks it dying and
+	 * then waits for pushers: either it sees this one, or this one sees
+	 * that it is dying (the atomic ops are full barriers).
+	 */
+	g_atomic_int_inc (&mc->_feedback_pushers);
+
+	if (!g_atomic_int_get (&mc->_feedback_dying)) {
+		g_atomic_int_set (&mc->_feedback_serial, g_atomic_int_add (&_feedback_serial, 1));
+		push_feedback (mc);
+	}
+
+	g_atomic_int_dec_and_test (&mc->_feedback_pushers);
+}
+
+void
+GenericMidiControlProtocol::push_feedback (MIDIControllable* mc)
+{
+	/* a controllable is queued at most once, it sends its current value */
+	if (!g_atomic_int_compare_and_exchange (&mc->_feedback_queued, 0, 1)) {
+		return;
+	}
+
+	gpointer head;
+	do {
+		head = g_atomic_pointer_get (&_feedback_queue);
+		mc->_next_feedback = static_cast<MIDIControllable*> (head);
+	} while (!g_atomic_pointer_compare_and_exchange (&_feedback_queue, head, mc));
+}
+
+MIDIControllable*
+GenericMidiControlProtocol::take_feedback_queue ()
+{
+	/* caller must hold _feedback_lock */
+	gpointer head;
+	do {
+		head = g_atomic_pointer_get (&_feedback_queue);
+	} while (!g_atomic_pointer_compare_and_exchange (&_feedback_queue, head, 0));
+
+	return static_cast<MIDIControllable*> (head);
+}
+
+void
+GenericMidiControlProtocol::dequeue_feedback (MIDIControllable* mc)
+{
+	/* called when mc is destroyed: it is not queued again from here on */
+	g_atomic_int_set (&mc->_feedback_dying, 1);
+
+	while (g_atomic_int_get (&mc->_feedback_pushers)) {
+		/* a change that is being queued right now, this is short */
+		g_usleep (10);
+	}
+
+	/* waits for ::_send_feedback() to finish with it */
+	Glib::Threads::Mutex::Lock lm (_feedback_lock);
+
+	if (!g_atomic_int_get (&mc->_feedback_queued)) {
+		return;
+	}
+
+	for (MIDIControllable* q = take_feedback_queue (); q; ) {
+		MIDIControllable* next = q->_next_feedback;
+		g_atomic_int_set (&q->_feedback_queued, 0);
+		if (q != mc) {
+			push_feedback (q);
+		}
+		q = next;
+	}
+}
+
+void
+GenericMidiControlProtocol::queue_all_feedback ()
+{
+	Glib::Threads::Mutex::Lock lm (controllables_lock);
+
+	for (MIDIControllables::iterator i = controllables.begin(); i != controllables.end(); ++i) {
+		queue_feedback (*i);
+	}
+}
+
+size_t
+GenericMidiControlProtocol::dispatch_slot (MIDI::eventType ev, MIDI::channel_t chn, MIDI::byte num)
+{
+	size_t type;
+
+	switch (ev) {
+	case MIDI::off:
+		type = 0;
+		break;
+	case MIDI::on:
+		type = 1;
+		break;
+	case MIDI::controller:
+		type = 2;
+		break;
+	case MIDI::program:
+		type = 3;
+		break;
+	case MIDI::pitchbend:
+		type = 4;
+		num = 0;
+		break;
+	default:
+		return dispatch_size;
+	}
+
+	return (type * 16 + (chn & 0xf)) * 128 + (num & 0x7f);
+}
+
+size_t
+GenericMidiControlProtocol::dispatch_slots (MIDIControllable* mc, size_t slots[2])
+{
+	MIDI::eventType const ev = mc->get_control_type ();
+	size_t n = 0;
+
+	switch (ev) {
+	case MIDI::off:
+	case MIDI::on:
+		slots[n++] = dispatch_slot (ev, mc->get_control_channel (), mc->get_control_additional ());
+		if (mc->_momentary) {
+			/* toggles back and forth between noteOn and noteOff */
+			slots[n++] = dispatch_slot (ev == MIDI::on ? MIDI::off : MIDI::on, mc->get_control_channel (), mc->get_control_additional ());
+		}
+		break;
+	case MIDI::controller:
+	case MIDI::program:
+	case MIDI::pitchbend:
+		slots[n++] = dispatch_slot (ev, mc->get_control_channel (), mc->get_control_additional ());
+		break;
+	default:
+		break;
+	}
+
+	return n;
+}
+
+void
+GenericMidiControlProtocol::bind_controllable (MIDIControllable* mc)
+{
+	size_t slots[2];
+	size_t const n = dispatch_slots (mc, slots);
+
+	if (n == 0) {
+		return;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (_dispatch_lock);
+		for (size_t i = 0; i < n; ++i) {
+			BoundControllables& bound (_dispatch[slots[i]]);
+			if (find (bound.begin(), bound.end(), mc) == bound.end()) {
+				bound.push_back (mc);
+			}
 		}
 	}
+
+	if (mc->get_controllable ()) {
+		queue_feedback (mc);
+	}
+}
+
+void
+GenericMidiControlProtocol::unbind_controllable (MIDIControllable* mc)
+{
+	size_t slots[2];
+	size_t const n = dispatch_slots (mc, slots);
+
+	Glib::Threads::Mutex::Lock lm (_dispatch_lock);
+	for (size_t i = 0; i < n; ++i) {
+		BoundControllables& bound (_dispatch[slots[i]]);
+		bound.erase (remove (bound.begin(), bound.end(), mc), bound.end());
+	}
+}
+
+bool
+GenericMidiControlProtocol::bound_controllables (BoundControllables& bound, MIDI::eventType ev, MIDI::channel_t chn, MIDI::byte num)
+{
+	/* copy, a binding may change while the message is handled */
+	Glib::Threads::Mutex::Lock lm (_dispatch_lock);
+	bound = _dispatch[dispatch_slot (ev, chn, num)];
+	return !bound.empty ();
+}
+
+void
+GenericMidiControlProtocol::dispatch_note (MIDI::Parser& p, MIDI::EventTwoBytes* tb, MIDI::channel_t chn, bool on)
+{
+	BoundControllables bound;
+
+	if (!bound_controllables (bound, on ? MIDI::on : MIDI::off, chn, tb->note_number)) {
+		return;
+	}
+
+	for (BoundControllables::const_iterator i = bound.begin(); i != bound.end(); ++i) {
+		if (on) {
+			(*i)->midi_sense_note_on (p, tb);
+		} else {
+			(*i)->midi_sense_note_off (p, tb);
+		}
+	}
+}
+
+void
+GenericMidiControlProtocol::dispatch_controller (MIDI::Parser& p, MIDI::EventTwoBytes* tb, MIDI::channel_t chn)
+{
+	BoundControllables bound;
+
+	if (!bound_controllables (bound, MIDI::controller, chn, tb->controller_number)) {
+		return;
+	}
+
+	for (BoundControllables::const_iterator i = bound.begin(); i != bound.end(); ++i) {
+		(*i)->midi_sense_controller (p, tb);
+	}
+}
+
+void
+GenericMidiControlProtocol::dispatch_program_change (MIDI::Parser& p, MIDI::byte program, MIDI::channel_t chn)
+{
+	BoundControllables bound;
+
+	if (!bound_controllables (bound, MIDI::program, chn, program)) {
+		return;
+	}
+
+	for (BoundControllables::const_iterator i = bound.begin(); i != bound.end(); ++i) {
+		(*i)->midi_sense_program_change (p, program);
+	}
+}
+
+void
+GenericMidiControlProtocol::dispatch_pitchbend (MIDI::Parser& p, MIDI::pitchbend_t pb, MIDI::channel_t chn)
+{
+	BoundControllables bound;
+
+	if (!bound_controllables (bound, MIDI::pitchbend, chn, 0)) {
+		return;
+	}
+
+	for (BoundControllables::const_iterator i = bound.begin(); i != bound.end(); ++i) {
+		(*i)->midi_sense_pitchbend (p, pb);
+	}
 }
 
 bool
@@ -717,6 +1039,12 @@ GenericMidiControlProtocol::set_feedback (bool yn)
 {
 	do_feedback = yn;
 	last_feedback_time = 0;
+
+	if (yn) {
+		/* bring the surface up to date */
+		queue_all_feedback ();
+	}
+
 	return 0;
 }
 
@@ -21,8 +21,11 @@
 #define ardour_generic_midi_control_protocol_h
 
 #include <list>
+#include <vector>
 #include <glibmm/threads.h>
 
+#include "midi++/types.h"
+
 #include "ardour/types.h"
 #include "ardour/port.h"
 
@@ -39,6 +42,7 @@ namespace ARDOUR {
 }
 
 namespace MIDI {
+    class Parser;
     class Port;
 }
 
@@ -110,6 +114,14 @@ class GenericMidiControlProtocol : public ARDOUR::ControlProtocol {
 
 	PBD::Signal0<void> ConnectionChange;
 
+	/* called by MIDIControllable when its MIDI binding changes */
+	void bind_controllable (MIDIControllable*);
+	void unbind_controllable (MIDIControllable*);
+
+	/* called by MIDIControllable when its value changed, from any thread */
+	void queue_feedback (MIDIControllable*);
+	void dequeue_feedback (MIDIControllable*);
+
   private:
 	boost::shared_ptr<ARDOUR::Bundle> _input_bundle;
 	boost::shared_ptr<ARDOUR::Bundle> _output_bundle;
@@ -123,6 +135,38 @@ class GenericMidiControlProtocol : public ARDOUR::ControlProtocol {
 	void _send_feedback ();
 	void  send_feedback ();
 
+	/** Controllables whose value changed since they last sent feedback:
+	 * an intrusive LIFO that any thread pushes to without locking and
+	 * ::_send_feedback() takes as a whole, under _feedback_lock.
+	 */
+	gpointer _feedback_queue;
+	gint     _feedback_serial;
+	Glib::Threads::Mutex _feedback_lock;
+	void push_feedback (MIDIControllable*);
+	MIDIControllable* take_feedback_queue ();
+	void queue_all_feedback ();
+
+	/** most recently changed controllable per dispatch slot, only used
+	 * by ::_send_feedback() */
+	std::vector<MIDIControllable*> _feedback_slots;
+
+	/** Bound controllables by (message type, channel, note/controller/program
+	 * number), incoming messages are passed to them directly.
+	 */
+	typedef std::vector<MIDIControllable*> BoundControllables;
+	std::vector<BoundControllables> _dispatch;
+	Glib::Threads::Mutex _dispatch_lock;
+	PBD::ScopedConnectionList _dispatch_connections;
+
+	static size_t dispatch_slots (MIDIControllable*, size_t slots[2]);
+	static size_t dispatch_slot (MIDI::eventType, MIDI::channel_t, MIDI::byte);
+	bool bound_controllables (BoundControllables&, MIDI::eventType, MIDI::channel_t, MIDI::byte);
+
+	void dispatch_note (MIDI::Parser&, MIDI::EventTwoBytes*, MIDI::channel_t, bool on);
+	void dispatch_controller (MIDI::Parser&, MIDI::EventTwoBytes*, MIDI::channel_t);
+	void dispatch_program_change (MIDI::Parser&, MIDI::byte, MIDI::channel_t);
+	void dispatch_pitchbend (MIDI::Parser&, MIDI::pitchbend_t, MIDI::channel_t);
+
 	typedef std::list<MIDIControllable*> MIDIControllables;
 	MIDIControllables controllables;
 
@@ -50,6 +50,11 @@ MIDIControllable::MIDIControllable (GenericMidiControlProtocol* s, MIDI::Parser&
 	, controllable (0)
 	, _parser (p)
 	, _momentary (m)
+	, _feedback_queued (0)
+	, _feedback_serial (0)
+	, _feedback_pushers (0)
+	, _feedback_dying (0)
+	, _next_feedback (0)
 {
 	_learned = false; /* from URI */
 	_ctltype = Ctl_Momentary;
@@ -67,8 +72,14 @@ MIDIControllable::MIDIControllable (GenericMidiControlProtocol* s, MIDI::Parser&
 
 MIDIControllable::MIDIControllable (GenericMidiControlProtocol* s, MIDI::Parser& p, Controllable& c, bool m)
 	: _surface (s)
+	, controllable (0)
 	, _parser (p)
 	, _momentary (m)
+	, _feedback_queued (0)
+	, _feedback_serial (0)
+	, _feedback_pushers (0)
+	, _feedback_dying (0)
+	, _next_feedback (0)
 {
 	set_controllable (&c);
 
@@ -87,6 +98,8 @@ MIDIControllable::MIDIControllable (GenericMidiControlProtocol* s, MIDI::Parser&
 
 MIDIControllable::~MIDIControllable ()
 {
+	controllable_change_connection.disconnect ();
+	_surface->dequeue_feedback (this);
 	drop_external_control ();
 }
 
@@ -107,6 +120,7 @@ MIDIControllable::midi_forget ()
 	midi_sense_connection[0].disconnect ();
 	midi_sense_connection[1].disconnect ();
 	midi_learn_connection.disconnect ();
+	_surface->unbind_controllable (this);
 }
 
 void
@@ -127,6 +141,7 @@ MIDIControllable::set_controllable (Controllable* c)
 	}
 
 	controllable_death_connection.disconnect ();
+	controllable_change_connection.disconnect ();
 
 	controllable = c;
 
@@ -142,9 +157,19 @@ MIDIControllable::set_controllable (Controllable* c)
 		controllable->Destroyed.connect (controllable_death_connection, MISSING_INVALIDATOR,
 						 boost::bind (&MIDIControllable::drop_controllable, this, _1),
 						 MidiControlUI::instance());
+		/* may be emitted by any thread, including the process thread */
+		controllable->Changed.connect_same_thread (controllable_change_connection,
+		                                           boost::bind (&MIDIControllable::controllable_changed, this));
+		_surface->queue_feedback (this);
 	}
 }
 
+void
+MIDIControllable::controllable_changed ()
+{
+	_surface->queue_feedback (this);
+}
+
 void
 MIDIControllable::midi_rebind (channel_t c)
 {
@@ -583,46 +608,36 @@ MIDIControllable::bind_midi (channel_t chn, eventType ev, MIDI::byte additional)
 	int chn_i = chn;
 	switch (ev) {
 	case MIDI::off:
-		_parser.channel_note_off[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_note_off, this, _1, _2));
-
-		/* if this is a togglee, connect to noteOn as well,
+		/* if this is a togglee, the surface passes noteOn as well,
 		   and we'll toggle back and forth between the two.
 		*/
-
-		if (_momentary) {
-			_parser.channel_note_on[chn_i].connect_same_thread (midi_sense_connection[1], boost::bind (&MIDIControllable::midi_sense_note_on, this, _1, _2));
-		}
-
 		_control_description = "MIDI control: NoteOff";
 		break;
 
 	case MIDI::on:
-		_parser.channel_note_on[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_note_on, this, _1, _2));
-		if (_momentary) {
-			_parser.channel_note_off[chn_i].connect_same_thread (midi_sense_connection[1], boost::bind (&MIDIControllable::midi_sense_note_off, this, _1, _2));
-		}
 		_control_description = "MIDI control: NoteOn";
 		break;
 
 	case MIDI::controller:
-		_parser.channel_controller[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_controller, this, _1, _2));
 		snprintf (buf, sizeof (buf), "MIDI control: Controller %d", control_additional);
 		_control_description = buf;
 		break;
 
 	case MIDI::program:
-		_parser.channel_program_change[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_program_change, this, _1, _2));
 		_control_description = "MIDI control: ProgramChange";
 		break;
 
 	case MIDI::pitchbend:
-		_parser.channel_pitchbend[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_pitchbend, this, _1, _2));
 		_control_description = "MIDI control: Pitchbend";
 		break;
 
 	default:
 		break;
 	}
+
+	/* incoming messages are dispatched by the surface */
+	_surface->bind_controllable (this);
+
 	DEBUG_TRACE (DEBUG::GenericMidi, string_compose ("Controlable: bind_midi: %1 on Channel %2 value %3 \n", _control_description, chn_i + 1, (int) additional));
 }
 
@@ -22,6 +22,8 @@
 
 #include <string>
 
+#include <glib.h>
+
 #include "midi++/types.h"
 
 #include "pbd/controllable.h"
@@ -111,6 +113,8 @@ class MIDIControllable : public PBD::Stateful
         int lookup_controllable();
 
   private:
+	/* the surface dispatches incoming messages and queues feedback */
+	friend class GenericMidiControlProtocol;
 
 	int max_value_for_type () const;
 
@@ -131,6 +135,18 @@ class MIDIControllable : public PBD::Stateful
 	PBD::ScopedConnection midi_sense_connection[2];
 	PBD::ScopedConnection midi_learn_connection;
         PBD::ScopedConnection controllable_death_connection;
+	PBD::ScopedConnection controllable_change_connection;
+	/** non-zero while this is in the surface's feedback queue */
+	gint             _feedback_queued;
+	/** when the value last changed, of all controllables that share a
+	 * MIDI message only the most recently changed one sends feedback.
+	 */
+	gint             _feedback_serial;
+	/** number of threads that are queuing this for feedback right now */
+	gint             _feedback_pushers;
+	/** set when this is being destroyed, it is not queued any more */
+	gint             _feedback_dying;
+	MIDIControllable* _next_feedback;
 	/** the type of MIDI message that is used for this control */
 	MIDI::eventType  control_type;
 	MIDI::byte       control_additional;
@@ -143,6 +159,7 @@ class MIDIControllable : public PBD::Stateful
 	bool            _bank_relative;
 
 	void drop_controllable (PBD::Controllable*);
+	void controllable_changed ();
 
 	void midi_receiver (MIDI::Parser &p, MIDI::byte *, size_t);
 	void midi_sense_note (MIDI::Parser &, MIDI::EventTwoBytes *, bool is_on);
@@ -45,6 +45,7 @@
 #include "ardour/monitor_control.h"
 #include "ardour/dB.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/meter.h"
 #include "ardour/panner.h"
 #include "ardour/panner_shell.h"
 #include "ardour/pannable.h"
@@ -111,6 +112,7 @@ OSC::OSC (Session& s, uint32_t port)
 	, bank_dirty (false)
 	, observer_busy (true)
 	, scrub_speed (0)
+	, _bundle_feedback (false)
 	, gui (0)
 {
 	_instance = this;
@@ -6191,6 +6193,12 @@ OSC::periodic (void)
 			session->request_locate (scrub_place, false);
 		}
 	}
+	/* meters are read once per strip, feedback is sent as one bundle per surface */
+	{
+		Glib::Threads::Mutex::Lock lm (_lo_lock);
+		_bundle_feedback = true;
+	}
+
 	for (uint32_t it = 0; it < _surface.size(); it++) {
 		OSCSurface* sur = &_surface[it];
 		OSCSelectObserver* so;
@@ -6213,6 +6221,10 @@ OSC::periodic (void)
 		}
 
 	}
+
+	flush_tick_bundles ();
+	_tick_meters.clear ();
+
 	for (FakeTouchMap::iterator x = _touch_timeout.begin(); x != _touch_timeout.end();) {
 		_touch_timeout[(*x).first] = (*x).second - 1;
 		if (!(*x).second) {
@@ -6788,9 +6800,7 @@ OSC::float_message (string path, float val, lo_address addr)
 	reply = lo_message_new ();
 	lo_message_add_float (reply, (float) val);
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
+	send_message (path, reply, addr);
 	_lo_lock.unlock ();
 
 	return 0;
@@ -6808,9 +6818,7 @@ OSC::float_message_with_id (std::string path, uint32_t ssid, float value, bool i
 	}
 	lo_message_add_float (msg, value);
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
+	send_message (path, msg, addr);
 	_lo_lock.unlock ();
 	return 0;
 }
@@ -6824,9 +6832,7 @@ OSC::int_message (string path, int val, lo_address addr)
 	reply = lo_message_new ();
 	lo_message_add_int32 (reply, (float) val);
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
+	send_message (path, reply, addr);
 	_lo_lock.unlock ();
 
 	return 0;
@@ -6844,9 +6850,7 @@ OSC::int_message_with_id (std::string path, uint32_t ssid, int value, bool in_li
 	}
 	lo_message_add_int32 (msg, value);
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
+	send_message (path, msg, addr);
 	_lo_lock.unlock ();
 	return 0;
 }
@@ -6860,9 +6864,7 @@ OSC::text_message (string path, string val, lo_address addr)
 	reply = lo_message_new ();
 	lo_message_add_string (reply, val.c_str());
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
+	send_message (path, reply, addr);
 	_lo_lock.unlock ();
 
 	return 0;
@@ -6881,11 +6883,84 @@ OSC::text_message_with_id (std::string path, uint32_t ssid, std::string val, boo
 
 	lo_message_add_string (msg, val.c_str());
 
+	send_message (path, msg, addr);
+	_lo_lock.unlock ();
+	return 0;
+}
+
+/* larger bundles are split, to keep datagrams reasonably small */
+static const uint32_t max_bundle_messages = 32;
+
+void
+OSC::send_message (std::string const& path, lo_message msg, lo_address addr)
+{
+	/* caller must hold _lo_lock */
+#ifdef HAVE_LO_BUNDLE_FREE_RECURSIVE
+	if (_bundle_feedback) {
+		TickBundle& tb (_tick_bundles[addr]);
+		if (!tb.bundle) {
+			tb.bundle = lo_bundle_new (LO_TT_IMMEDIATE);
+		}
+		/* the bundle takes ownership of the message, it is freed
+		 * by lo_bundle_free_recursive() after sending.
+		 */
+		lo_bundle_add_message (tb.bundle, path.c_str(), msg);
+		if (++tb.messages >= max_bundle_messages) {
+			flush_tick_bundle (tb, addr);
+		}
+		return;
+	}
+#endif
 	lo_send_message (addr, path.c_str(), msg);
 	Glib::usleep(1);
 	lo_message_free (msg);
-	_lo_lock.unlock ();
-	return 0;
+}
+
+void
+OSC::flush_tick_bundle (TickBundle& tb, lo_address addr)
+{
+	/* caller must hold _lo_lock */
+#ifdef HAVE_LO_BUNDLE_FREE_RECURSIVE
+	if (tb.bundle) {
+		lo_send_bundle (addr, tb.bundle);
+		lo_bundle_free_recursive (tb.bundle);
+	}
+#endif
+	tb.bundle = 0;
+	tb.messages = 0;
+}
+
+void
+OSC::flush_tick_bundles ()
+{
+	Glib::Threads::Mutex::Lock lm (_lo_lock);
+
+	for (TickBundles::iterator i = _tick_bundles.begin(); i != _tick_bundles.end(); ++i) {
+		flush_tick_bundle (i->second, i->first);
+	}
+	/* addresses may go away before the next tick */
+	_tick_bundles.clear ();
+	_bundle_feedback = false;
+}
+
+float
+OSC::strip_meter (boost::shared_ptr<Stripable> s)
+{
+	TickMeters::const_iterator i = _tick_meters.find (s->id ());
+
+	if (i != _tick_meters.end ()) {
+		return i->second;
+	}
+
+	float now_meter = -193;
+
+	if (s->peak_meter ()) {
+		now_meter = s->peak_meter ()->meter_level (0, MeterMCP);
+	}
+
+	_tick_meters[s->id ()] = now_meter;
+
+	return now_meter;
 }
 
 // we have to have a sorted list of stripables that have sends pointed at our aux
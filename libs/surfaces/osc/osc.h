@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 #include <bitset>
+#include <map>
 
 #include <sys/time.h>
 #include <pthread.h>
@@ -96,6 +97,11 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	int int_message_with_id (std::string, uint32_t ssid, int value, bool in_line, lo_address addr);
 	int text_message_with_id (std::string path, uint32_t ssid, std::string val, bool in_line, lo_address addr);
 
+	/** the meter level of a strip, read once per tick for all surfaces
+	 * that show it. Only valid in the observers' tick().
+	 */
+	float strip_meter (boost::shared_ptr<ARDOUR::Stripable>);
+
 	int send_group_list (lo_address addr);
 
 	int start ();
@@ -819,6 +825,27 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	int cancel_all_solos ();
 	bool periodic (void);
 	sigc::connection periodic_connection;
+
+	/* feedback sent during a tick is collected into OSC bundles, one
+	 * per surface address, and sent at the end of the tick instead of
+	 * one datagram (and sleep) per message. Protected by _lo_lock.
+	 */
+	struct TickBundle {
+		TickBundle () : bundle (0), messages (0) {}
+		lo_bundle bundle;
+		uint32_t  messages;
+	};
+	typedef std::map<lo_address, TickBundle> TickBundles;
+	TickBundles _tick_bundles;
+	bool _bundle_feedback;
+
+	void send_message (std::string const& path, lo_message msg, lo_address addr);
+	void flush_tick_bundle (TickBundle&, lo_address);
+	void flush_tick_bundles ();
+
+	/* keyed by ID, a strip may be deleted and its address reused between ticks */
+	typedef std::map<PBD::ID, float> TickMeters;
+	TickMeters _tick_meters;
 	PBD::ScopedConnectionList session_connections;
 
 	void debugmsg (const char *prefix, const char *path, const char* types, lo_arg **argv, int argc);
@@ -300,7 +300,7 @@ OSCGlobalObserver::tick ()
 	}
 	if (feedback[7] || feedback[8] || feedback[9]) { // meters enabled
 		// the only meter here is master
-		float now_meter = session->master_out()->peak_meter()->meter_level(0, MeterMCP);
+		float now_meter = _osc.strip_meter (session->master_out());
 		if (now_meter < -94) now_meter = -193;
 		if (_last_meter != now_meter) {
 			if (feedback[7] || feedback[8]) {
@@ -589,11 +589,7 @@ OSCSelectObserver::tick ()
 	_tick_busy = true;
 	if (feedback[7] || feedback[8] || feedback[9]) { // meters enabled
 		float now_meter;
-		if (_strip->peak_meter()) {
-			now_meter = _strip->peak_meter()->meter_level(0, MeterMCP);
-		} else {
-			now_meter = -193;
-		}
+		now_meter = _osc.strip_meter (_strip);
 		if (now_meter < -120) now_meter = -193;
 		if (_last_meter != now_meter) {
 			if (feedback[7] || feedback[8]) {
@@ -8,7 +8,10 @@
 #include "pbd/basename.h"
 #include "pbd/enumwriter.h"
 
+#include "ardour/audio_track.h"
+#include "ardour/audioplaylist.h"
 #include "ardour/broadcast_info.h"
+#include "ardour/export_channel.h"
 #include "ardour/export_handler.h"
 #include "ardour/export_status.h"
 #include "ardour/export_timespan.h"
@@ -30,6 +33,7 @@ struct ExportSettings
 		, _sample_format (ExportFormatBase::SF_16)
 		, _normalize (false)
 		, _bwf (false)
+		, _stems (false)
 	{}
 
 	std::string samplerate () const
@@ -58,6 +62,7 @@ struct ExportSettings
 	ExportFormatBase::SampleFormat _sample_format;
 	bool _normalize;
 	bool _bwf;
+	bool _stems;
 };
 
 static int export_session (Session *session,
@@ -115,16 +120,18 @@ static int export_session (Session *session,
 
 	/* add master outs as default */
 	IO* master_out = session->master_out()->output().get();
-	if (!master_out) {
+	if (!master_out && !settings._stems) {
 		PBD::warning << _("Export Util: No Master Out Ports to Connect for Audio Export") << endmsg;
 		return -1;
 	}
 
-	for (uint32_t n = 0; n < master_out->n_ports().n_audio(); ++n) {
-		PortExportChannel * channel = new PortExportChannel ();
-		channel->add_port (master_out->audio (n));
-		ExportChannelPtr chan_ptr (channel);
-		ccp->register_channel (chan_ptr);
+	if (!settings._stems) {
+		for (uint32_t n = 0; n < master_out->n_ports().n_audio(); ++n) {
+			PortExportChannel * channel = new PortExportChannel ();
+			channel->add_port (master_out->audio (n));
+			ExportChannelPtr chan_ptr (channel);
+			ccp->register_channel (chan_ptr);
+		}
 	}
 
 	/* output filename */
@@ -148,17 +155,51 @@ static int export_session (Session *session,
 		b->set_from_session (*session, tsp->get_start ());
 	}
 
-	cout << "* Writing " << Glib::build_filename (fnp->get_folder(), tsp->name() + ".wav") << endl;
-
-
 	/* output */
 	fnp->set_timespan(tsp);
 	fnp->include_label = false;
 
 	/* do audio export */
 	fmp->set_soundcloud_upload(false);
-	session->get_export_handler()->add_export_config (tsp, ccp, fmp, fnp, b);
-	session->get_export_handler()->do_export();
+
+	if (settings._stems) {
+		/* one file per track, read directly from the track's playlist */
+		boost::shared_ptr<RouteList> rl = session->get_routes ();
+		for (RouteList::const_iterator i = rl->begin(); i != rl->end(); ++i) {
+			boost::shared_ptr<AudioTrack> track = boost::dynamic_pointer_cast<AudioTrack> (*i);
+			if (!track) {
+				continue;
+			}
+			boost::shared_ptr<AudioPlaylist> playlist = boost::dynamic_pointer_cast<AudioPlaylist> (track->playlist ());
+			if (!playlist) {
+				continue;
+			}
+
+			ExportChannelConfigPtr stem = session->get_export_handler()->add_channel_config();
+			stem->set_name (track->name ());
+			for (uint32_t n = 0; n < track->n_channels().n_audio(); ++n) {
+				stem->register_channel (ExportChannelPtr (new PlaylistExportChannel (playlist, n)));
+			}
+
+			ExportFilenamePtr stem_fnp = session->get_export_handler()->add_filename_copy (fnp);
+			stem_fnp->include_channel_config = true;
+
+			cout << "* Writing " << Glib::build_filename (fnp->get_folder(), tsp->name() + "_" + track->name () + ".wav") << endl;
+			session->get_export_handler()->add_export_config (tsp, stem, fmp, stem_fnp, b);
+		}
+	} else {
+		cout << "* Writing " << Glib::build_filename (fnp->get_folder(), tsp->name() + ".wav") << endl;
+		session->get_export_handler()->add_export_config (tsp, ccp, fmp, fnp, b);
+	}
+
+	int64_t const start_time = g_get_monotonic_time ();
+
+	if (session->get_export_handler()->raw_stem_export_possible ()) {
+		/* no need to freewheel the engine, render in parallel */
+		session->get_export_handler()->do_raw_stem_export();
+	} else {
+		session->get_export_handler()->do_export();
+	}
 
 	boost::shared_ptr<ARDOUR::ExportStatus> status = session->get_export_status ();
 
@@ -179,13 +220,16 @@ static int export_session (Session *session,
 			printf ("* Exporting...            \r");
 			break;
 		}
-		Glib::usleep (1000000);
+		Glib::usleep (100000);
 	}
 	printf("\n");
 
+	double const elapsed = (g_get_monotonic_time () - start_time) / 1e6;
+	double const duration = (end - start) / (double) session->nominal_sample_rate ();
+
 	status->finish ();
 
-	printf ("* Done.\n");
+	printf ("* Done. Exported %.1f sec in %.1f sec (%.1fx realtime).\n", duration, elapsed, elapsed > 0 ? duration / elapsed : 0.);
 	return 0;
 }
 
@@ -200,11 +244,14 @@ static void usage (int status) {
   -n, --normalize            normalize signal level (to 0dBFS)\n\
   -o, --output  <file>       export output file name\n\
   -s, --samplerate <rate>    samplerate to use\n\
+  -S, --stems                export one file per audio-track (no processing)\n\
   -V, --version              print version information and exit\n\
 \n");
 	printf ("\n\
 This tool exports the session-range of a given ardour-session to a wave file,\n\
 using the master-bus outputs.\n\
+With --stems, the playlist of every audio-track is exported to a file of its\n\
+own instead. Stems are rendered in parallel, without running the engine.\n\
 By default a 16bit signed .wav file at session-rate is exported.\n\
 If the no output-file is given, the session's export dir is used.\n\
 \n\
@@ -221,7 +268,7 @@ int main (int argc, char* argv[])
 	ExportSettings settings;
 	std::string outfile;
 
-	const char *optstring = "b:Bhno:s:V";
+	const char *optstring = "b:Bhno:s:SV";
 
 	const struct option longopts[] = {
 		{ "bitdepth",   1, 0, 'b' },
@@ -230,6 +277,7 @@ int main (int argc, char* argv[])
 		{ "normalize",  0, 0, 'n' },
 		{ "output",     1, 0, 'o' },
 		{ "samplerate", 1, 0, 's' },
+		{ "stems",      0, 0, 'S' },
 		{ "version",    0, 0, 'V' },
 	};
 
@@ -285,6 +333,10 @@ int main (int argc, char* argv[])
 				}
 				break;
 
+			case 'S':
+				settings._stems = true;
+				break;
+
 			case 'V':
 				printf ("ardour-utils version %s\n\n", VERSIONSTRING);
 				printf ("Copyright (C) GPL 2015,2017 Robin Gareus <robin@gareus.org>\n");
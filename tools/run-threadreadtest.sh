@@ -23,6 +23,7 @@ while [ $# -gt 1 ] ; do
 	-M) args="$args -M"; shift ;;
 	-D) args="$args -D"; shift ;;
 	-R) args="$args -R"; shift ;;
+	-A) args="$args -A"; shift ;;
         *) break ;;
     esac
 done
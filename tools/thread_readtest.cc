@@ -1,4 +1,6 @@
-/* g++ -o thread_readtest thread_readtest.cc `pkg-config --cflags --libs glibmm-2.4` -lm */
+/* g++ -o thread_readtest thread_readtest.cc `pkg-config --cflags --libs glibmm-2.4` -lm -lrt
+ * (add -DHAVE_LIBURING ... -luring to use io_uring for the async batch mode)
+ */
 
 #ifndef _WIN32
 #  define HAVE_MMAP
@@ -20,6 +22,15 @@
 #  include <sys/mman.h>
 #endif
 
+#ifndef _WIN32
+#  define HAVE_POSIX_AIO
+#  include <aio.h>
+#endif
+
+#ifdef HAVE_LIBURING
+#  include <liburing.h>
+#endif
+
 #include <glibmm.h>
 
 char* data = 0;
@@ -27,7 +38,8 @@ char* data = 0;
 void
 usage ()
 {
-	fprintf (stderr, "thread_readtest [ -b BLOCKSIZE ] [ -l FILELIMIT] [ -n NTHREADS ] [ -D ] [ -R ] [ -M ] filename-template\n");
+	fprintf (stderr, "thread_readtest [ -b BLOCKSIZE ] [ -l FILELIMIT] [ -n NTHREADS ] [ -D ] [ -R ] [ -M ] [ -A ] filename-template\n");
+	fprintf (stderr, "  -A : instead of a thread-pool, submit the reads of all files as one asynchronous batch\n");
 }
 
 Glib::Threads::Cond pool_run;
@@ -155,11 +167,122 @@ run_thread_pool (int* files, int nfiles)
 	return 0;
 }
 
+/* Asynchronous batch: read block N of every file with a single
+ * submission, this is what the butler does with async-disk-reads enabled.
+ */
+
+#define AIO_QUEUE_DEPTH 64
+
+char** batch_data = 0;
+
+#ifdef HAVE_LIBURING
+struct io_uring ring;
+bool ring_ok = false;
+#endif
+
+const char*
+async_backend ()
+{
+#ifdef HAVE_LIBURING
+	if (ring_ok) {
+		return "io_uring";
+	}
+#endif
+#ifdef HAVE_POSIX_AIO
+	return "POSIX AIO";
+#else
+	return "none";
+#endif
+}
+
+void
+build_async_batch (int nfiles, size_t block_size)
+{
+	batch_data = (char**) malloc (sizeof (char*) * nfiles);
+	for (int n = 0; n < nfiles; ++n) {
+		batch_data[n] = (char*) malloc (sizeof (char) * block_size);
+	}
+#ifdef HAVE_LIBURING
+	ring_ok = io_uring_queue_init (AIO_QUEUE_DEPTH, &ring, 0) == 0;
+#endif
+}
+
+int
+run_async_batch (int* files, int nfiles, size_t block_size, uint64_t offset)
+{
+	int errors = 0;
+
+#ifdef HAVE_LIBURING
+	if (ring_ok) {
+		int queued = 0;
+		int inflight = 0;
+		while (queued < nfiles || inflight > 0) {
+			while (queued < nfiles && inflight < AIO_QUEUE_DEPTH) {
+				struct io_uring_sqe* sqe = io_uring_get_sqe (&ring);
+				if (!sqe) {
+					break;
+				}
+				io_uring_prep_read (sqe, files[queued], batch_data[queued], block_size, offset);
+				++queued;
+				++inflight;
+			}
+			if (io_uring_submit_and_wait (&ring, 1) < 0) {
+				return -1;
+			}
+			struct io_uring_cqe* cqe;
+			while (inflight > 0 && io_uring_peek_cqe (&ring, &cqe) == 0) {
+				if (cqe->res != (int) block_size) {
+					++errors;
+				}
+				io_uring_cqe_seen (&ring, cqe);
+				--inflight;
+			}
+		}
+		return errors ? -1 : 0;
+	}
+#endif
+
+#ifdef HAVE_POSIX_AIO
+	struct aiocb  cbs[AIO_QUEUE_DEPTH];
+	struct aiocb* list[AIO_QUEUE_DEPTH];
+
+	for (int n = 0; n < nfiles; n += AIO_QUEUE_DEPTH) {
+		const int cnt = (nfiles - n) < AIO_QUEUE_DEPTH ? (nfiles - n) : AIO_QUEUE_DEPTH;
+		for (int i = 0; i < cnt; ++i) {
+			memset (&cbs[i], 0, sizeof (struct aiocb));
+			cbs[i].aio_fildes = files[n + i];
+			cbs[i].aio_offset = offset;
+			cbs[i].aio_buf = batch_data[n + i];
+			cbs[i].aio_nbytes = block_size;
+			cbs[i].aio_lio_opcode = LIO_READ;
+			list[i] = &cbs[i];
+		}
+		if (lio_listio (LIO_WAIT, list, cnt, 0) != 0 && errno != EIO && errno != EINTR) {
+			fprintf (stderr, "lio_listio failed: %s\n", strerror (errno));
+			return -1;
+		}
+		for (int i = 0; i < cnt; ++i) {
+			while (aio_error (&cbs[i]) == EINPROGRESS) {
+				const struct aiocb* cb = &cbs[i];
+				aio_suspend (&cb, 1, 0);
+			}
+			if (aio_return (&cbs[i]) != (ssize_t) block_size) {
+				++errors;
+			}
+		}
+	}
+	return errors ? -1 : 0;
+#else
+	fprintf (stderr, "async reads are not supported on this platform\n");
+	return -1;
+#endif
+}
+
 int
 main (int argc, char* argv[])
 {
 	int* files;
-	char optstring[] = "b:DRMl:q";
+	char optstring[] = "b:DRMAl:n:q";
 	uint32_t block_size = 64 * 1024 * 4;
 	int max_files = -1;
 	int nthreads = 16;
@@ -172,10 +295,12 @@ main (int argc, char* argv[])
 	void  **addr;
 	size_t *flen;
 #endif
+	int use_async = 0;
 	const struct option longopts[] = {
 		{ "blocksize", 1, 0, 'b' },
 		{ "direct", 0, 0, 'D' },
 		{ "mmap", 0, 0, 'M' },
+		{ "async", 0, 0, 'A' },
 		{ "noreadahead", 0, 0, 'R' },
 		{ "limit", 1, 0, 'l' },
 		{ "nthreads", 16, 0, 'n' },
@@ -212,6 +337,9 @@ main (int argc, char* argv[])
 			use_mmap = 1;
 #endif
 			break;
+		case 'A':
+			use_async = 1;
+			break;
 		case 'R':
 #ifdef __APPLE__
 			noreadahead = 1;
@@ -334,13 +462,28 @@ main (int argc, char* argv[])
 	double var_s = 0;
 	uint64_t cnt = 0;
 
-	build_thread_pool (nthreads, block_size);
+	if (use_async) {
+		build_async_batch (nfiles, block_size);
+		if (!quiet) {
+			printf ("# Using asynchronous batch reads (%s).\n", async_backend ());
+		}
+	} else {
+		build_thread_pool (nthreads, block_size);
+		if (!quiet) {
+			printf ("# Using %d threads.\n", nthreads);
+		}
+	}
 
 	while (1) {
 		gint64 before;
 		before = g_get_monotonic_time();
 
-		if (run_thread_pool (files, nfiles)) {
+		if (use_async) {
+			if (run_async_batch (files, nfiles, block_size, _read)) {
+				/* end of file or read error */
+				goto out;
+			}
+		} else if (run_thread_pool (files, nfiles)) {
 			fprintf (stderr, "thread pool error\n");
 			goto out;
 		}